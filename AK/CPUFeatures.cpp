@@ -25,6 +25,18 @@ static CPUIDResult cpuid(u32 leaf, u32 subleaf)
         : "0"(leaf), "2"(subleaf));
     return result;
 }
+
+#        if AK_CAN_CODEGEN_FOR_X86_AVX2
+static u64 xgetbv(u32 xcr)
+{
+    u32 eax;
+    u32 edx;
+    asm("xgetbv"
+        : "=a"(eax), "=d"(edx)
+        : "c"(xcr));
+    return (static_cast<u64>(edx) << 32) | eax;
+}
+#        endif
 #    endif
 
 CPUFeatures Detail::detect_cpu_features_uncached()
@@ -48,6 +60,16 @@ CPUFeatures Detail::detect_cpu_features_uncached()
     if (cpuid1.ecx >> 25 & 1)
         result |= CPUFeatures::X86_AES;
 #        endif
+#        if AK_CAN_CODEGEN_FOR_X86_AVX2
+    // The kernel also has to save and restore the YMM registers for us (OSXSAVE, and XCR0 bits 1 and 2).
+    if ((cpuid7.ebx >> 5 & 1) && (cpuid1.ecx >> 27 & 1) && (xgetbv(0) & 0b110) == 0b110)
+        result |= CPUFeatures::X86_AVX2;
+#        endif
+#        if AK_CAN_CODEGEN_FOR_X86_PCLMUL
+    // Users of PCLMULQDQ also get to use SSSE3 (for PSHUFB), which every such CPU has anyway.
+    if ((cpuid1.ecx >> 1 & 1) && (cpuid1.ecx >> 9 & 1))
+        result |= CPUFeatures::X86_PCLMUL;
+#        endif
 #    endif
 
     return result;
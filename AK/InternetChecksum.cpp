@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CPUFeatures.h>
+#include <AK/InternetChecksum.h>
+#include <AK/StdLibExtras.h>
+
+#ifndef KERNEL
+#    include <AK/SIMD.h>
+#endif
+
+namespace AK {
+
+static constexpr u16 fold(u64 sum)
+{
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return static_cast<u16>(sum);
+}
+
+// Sums up whole 32-bit words. Since 2^16 is congruent to 1 modulo 2^16 - 1, a 32-bit word
+// counts as much as the two 16-bit words it is made of, and a 64-bit accumulator leaves
+// room for more carries than we'll ever see.
+ALWAYS_INLINE static u64 sum_tail(u8 const* data, size_t size)
+{
+    u64 sum = 0;
+    for (; size >= sizeof(u32); data += sizeof(u32), size -= sizeof(u32)) {
+        u32 word;
+        __builtin_memcpy(&word, data, sizeof(word));
+        sum += word;
+    }
+    if (size >= sizeof(u16)) {
+        u16 word;
+        __builtin_memcpy(&word, data, sizeof(word));
+        sum += word;
+        data += sizeof(u16);
+        size -= sizeof(u16);
+    }
+    if (size == 1) {
+        // A trailing byte is padded with a zero byte to form a word.
+        u8 const padded_word[2] = { *data, 0 };
+        u16 word;
+        __builtin_memcpy(&word, padded_word, sizeof(word));
+        sum += word;
+    }
+    return sum;
+}
+
+#ifndef KERNEL
+// Every lane adds up the low and high halves of its 32-bit words separately, so that it can
+// take 65535 of them before the carries would get lost.
+template<typename VectorType>
+ALWAYS_INLINE static u64 sum_vectors(u8 const*& data, size_t& size)
+{
+    static constexpr size_t lane_count = sizeof(VectorType) / sizeof(u32);
+    static constexpr size_t max_vectors_per_round = 65535;
+
+    u64 sum = 0;
+    while (size >= sizeof(VectorType)) {
+        auto vector_count = min(size / sizeof(VectorType), max_vectors_per_round);
+        VectorType low_halves {};
+        VectorType high_halves {};
+        for (size_t i = 0; i < vector_count; ++i) {
+            VectorType words;
+            __builtin_memcpy(&words, data + i * sizeof(VectorType), sizeof(words));
+            low_halves += words & 0xffff;
+            high_halves += words >> 16;
+        }
+        for (size_t lane = 0; lane < lane_count; ++lane)
+            sum += static_cast<u64>(low_halves[lane]) + high_halves[lane];
+        data += vector_count * sizeof(VectorType);
+        size -= vector_count * sizeof(VectorType);
+    }
+    return sum;
+}
+#endif
+
+template<CPUFeatures>
+static u16 one_complement_sum_impl(ReadonlyBytes);
+
+template<>
+u16 one_complement_sum_impl<CPUFeatures::None>(ReadonlyBytes bytes)
+{
+    auto const* data = bytes.data();
+    auto size = bytes.size();
+    u64 sum = 0;
+#ifndef KERNEL
+    // The kernel doesn't touch the vector registers. Elsewhere, this gets us SSE2 on x86-64.
+    sum += sum_vectors<SIMD::u32x4>(data, size);
+#endif
+    sum += sum_tail(data, size);
+    return fold(sum);
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] u16 one_complement_sum_impl<CPUFeatures::X86_AVX2>(ReadonlyBytes bytes)
+{
+    auto const* data = bytes.data();
+    auto size = bytes.size();
+    u64 sum = sum_vectors<SIMD::u32x8>(data, size);
+    sum += sum_vectors<SIMD::u32x4>(data, size);
+    sum += sum_tail(data, size);
+    return fold(sum);
+}
+#endif
+
+static u16 (*const one_complement_sum)(ReadonlyBytes) = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &one_complement_sum_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &one_complement_sum_impl<CPUFeatures::None>;
+}();
+
+void InternetChecksum::add(ReadonlyBytes bytes)
+{
+    u16 sum = one_complement_sum(bytes);
+    // After an odd number of bytes, everything that follows is shifted by one byte relative to
+    // the words we've been summing up. Swapping the bytes of the sum accounts for that.
+    if (m_has_odd_length)
+        sum = static_cast<u16>((sum << 8) | (sum >> 8));
+    m_sum += sum;
+    if (bytes.size() % 2 == 1)
+        m_has_odd_length = !m_has_odd_length;
+}
+
+NetworkOrdered<u16> InternetChecksum::finish() const
+{
+    u16 sum = convert_between_host_and_network_endian(fold(m_sum));
+    return static_cast<u16>(~sum);
+}
+
+u16 InternetChecksum::update(u16 checksum, u16 old_value, u16 new_value)
+{
+    // HC' = ~(~HC + ~m + m')
+    u64 sum = static_cast<u16>(~checksum);
+    sum += static_cast<u16>(~old_value);
+    sum += new_value;
+    return static_cast<u16>(~fold(sum));
+}
+
+u16 InternetChecksum::update(u16 checksum, u32 old_value, u32 new_value)
+{
+    checksum = update(checksum, static_cast<u16>(old_value >> 16), static_cast<u16>(new_value >> 16));
+    return update(checksum, static_cast<u16>(old_value), static_cast<u16>(new_value));
+}
+
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Endian.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// The 16-bit one's complement checksum used by IPv4, ICMP, TCP and UDP (RFC 1071).
+// Data can be added in chunks of any size, odd ones included.
+class InternetChecksum {
+public:
+    void add(ReadonlyBytes);
+    NetworkOrdered<u16> finish() const;
+
+    // Computes the checksum that results from changing a 16-bit or 32-bit word of the
+    // checksummed data, without having to look at the rest of it (RFC 1624, eqn. 3).
+    // All values are in host byte order.
+    static u16 update(u16 checksum, u16 old_value, u16 new_value);
+    static u16 update(u16 checksum, u32 old_value, u32 new_value);
+
+private:
+    // Summed up in host byte order, which results in the byte-swapped sum on little-endian
+    // machines. Reordering bytes commutes with the one's complement sum, so finish() can
+    // simply swap it back.
+    u64 m_sum { 0 };
+    bool m_has_odd_length { false };
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::InternetChecksum;
+#endif
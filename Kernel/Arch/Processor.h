@@ -29,6 +29,7 @@ enum class InterruptsState {
 
 namespace Memory {
 class PageDirectory;
+class TLBFlushBatch;
 }
 
 struct TrapFrame;
@@ -68,6 +69,7 @@ public:
 
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void flush_tlb(Memory::TLBFlushBatch const&);
 
     static void flush_instruction_cache(VirtualAddress vaddr, size_t byte_count);
 
@@ -254,9 +256,7 @@ struct ProcessorMessage {
         ProcessorMessage* next; // only valid while in the pool
         alignas(CallbackFunction) u8 callback_storage[sizeof(CallbackFunction)];
         struct {
-            Memory::PageDirectory const* page_directory;
-            u8* ptr;
-            size_t page_count;
+            Memory::TLBFlushBatch const* batch;
         } flush_tlb;
     };
 
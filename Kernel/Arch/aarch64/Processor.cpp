@@ -15,6 +15,7 @@
 #include <Kernel/Arch/aarch64/CPU.h>
 #include <Kernel/Arch/aarch64/CPUID.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
@@ -108,6 +109,12 @@ void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, VirtualAddress va
     flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    batch.flush_local();
+}
+
 template<typename T>
 void ProcessorBase<T>::flush_instruction_cache(VirtualAddress vaddr, size_t byte_count)
 {
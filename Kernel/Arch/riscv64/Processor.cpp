@@ -11,6 +11,7 @@
 #include <Kernel/Firmware/DeviceTree/DeviceTree.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/Panic.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
@@ -251,6 +252,13 @@ void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, VirtualAddress va
     flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    // FIXME: Use the SBI RFENCE extension to flush the TLB of other harts when we support SMP on riscv64.
+    batch.flush_local();
+}
+
 template<typename T>
 void ProcessorBase<T>::flush_instruction_cache(VirtualAddress, size_t)
 {
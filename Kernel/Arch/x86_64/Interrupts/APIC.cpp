@@ -476,13 +476,18 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
         write_register(APIC_REG_LD, (read_register(APIC_REG_LD) & 0x00ffffff) | (cpu << 24));
 
         // read it back to make sure it's actually set
-        apic_id = read_register(APIC_REG_LD) >> 24;
+        [[maybe_unused]] u32 logical_apic_id = read_register(APIC_REG_LD) >> 24;
+        dbgln_if(APIC_DEBUG, "CPU #{} logical APIC ID: {}", cpu, logical_apic_id);
+
+        // NOTE: Interrupts from the IOAPIC and MSIs are sent in physical destination mode,
+        //       so they need the physical APIC ID, not the logical one.
+        apic_id = read_register(APIC_REG_ID) >> 24;
     }
 
     dbgln_if(APIC_DEBUG, "CPU #{} apic id: {}", cpu, apic_id);
     Processor::current().info().set_apic_id(apic_id);
 
-    dbgln_if(APIC_DEBUG, "Enabling local APIC for CPU #{}, logical APIC ID: {}", cpu, apic_id);
+    dbgln_if(APIC_DEBUG, "Enabling local APIC for CPU #{}", cpu);
 
     if (cpu == 0) {
         SpuriousInterruptHandler::initialize(IRQ_APIC_SPURIOUS);
@@ -33,6 +33,7 @@
 
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 
 namespace Kernel {
 
@@ -865,10 +866,18 @@ void ProcessorBase<T>::flush_entire_tlb_local()
 template<typename T>
 void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!Memory::is_user_address(vaddr) || Process::current().thread_count() > 1))
-        Processor::smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
+    Memory::TLBFlushBatch batch(*page_directory);
+    batch.add(vaddr, page_count);
+    batch.flush();
+}
+
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::TLBFlushBatch const& batch)
+{
+    if (s_smp_enabled)
+        Processor::smp_flush_tlb(batch);
     else
-        flush_tlb_local(vaddr, page_count);
+        batch.flush_local();
 }
 
 template<typename T>
@@ -877,6 +886,12 @@ void ProcessorBase<T>::flush_instruction_cache(VirtualAddress, size_t)
     // The instruction and data cache are coherent on x86, so we don't need to do anything here.
 }
 
+void Processor::load_cr3(FlatPtr cr3)
+{
+    m_active_cr3.store(cr3);
+    write_cr3(cr3);
+}
+
 void Processor::smp_return_to_pool(ProcessorMessage& msg)
 {
     ProcessorMessage* next = nullptr;
@@ -1035,19 +1050,17 @@ bool Processor::smp_process_pending_messages()
             case ProcessorMessage::Callback:
                 msg->invoke_callback();
                 break;
-            case ProcessorMessage::FlushTlb:
-                if (Memory::is_user_address(VirtualAddress(msg->flush_tlb.ptr))) {
-                    // We assume that we don't cross into kernel land!
-                    VERIFY(Memory::is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
-                    if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
-                        // This processor isn't using this page directory right now, we can ignore this request
-                        dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
-                        break;
-                    }
+            case ProcessorMessage::FlushTlb: {
+                auto const& batch = *msg->flush_tlb.batch;
+                if (!batch.includes_kernel_addresses() && read_cr3() != batch.page_directory().cr3()) {
+                    // We switched away from this page directory since the request was sent, which already flushed its mappings.
+                    dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush TLB", current_id());
+                    break;
                 }
-                flush_tlb_local(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
+                batch.flush_local();
                 break;
             }
+            }
 
             bool is_async = msg->async; // Need to cache this value *before* dropping the ref count!
             auto prev_refs = msg->refs.fetch_sub(1u, AK::MemoryOrder::memory_order_acq_rel);
@@ -1173,17 +1186,52 @@ void Processor::smp_unicast(u32 cpu, Function<void()> callback, bool async)
     smp_unicast_message(cpu, msg, async);
 }
 
-void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
+void Processor::smp_flush_tlb(Memory::TLBFlushBatch const& batch)
 {
+    ScopedCritical critical;
+    auto& current_processor = Processor::current();
+
+    // Kernel mappings are global, so any processor may have cached them. User mappings can only
+    // be cached by processors that are running their page directory right now, since we don't use
+    // PCIDs and loading another page directory drops all non-global TLB entries.
+    bool is_global = batch.includes_kernel_addresses();
+    auto cr3 = batch.page_directory().cr3();
+
+    // Our page table updates must be visible before we look at the active page directories.
+    // Otherwise, a processor that is just switching to this one could miss both them and our request.
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+
+    Array<Processor*, MAX_CPU_COUNT> targets;
+    size_t target_count = 0;
+    for_each(
+        [&](Processor& proc) {
+            if (&proc != &current_processor && (is_global || proc.m_active_cr3.load() == cr3))
+                targets[target_count++] = &proc;
+        });
+
+    bool should_flush_locally = is_global || read_cr3() == cr3;
+    if (target_count == 0) {
+        if (should_flush_locally)
+            batch.flush_local();
+        return;
+    }
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Flush TLB on {} cpus", current_processor.id(), target_count);
+
     auto& msg = smp_get_from_pool();
     msg.async = false;
     msg.type = ProcessorMessage::FlushTlb;
-    msg.flush_tlb.page_directory = page_directory;
-    msg.flush_tlb.ptr = vaddr.as_ptr();
-    msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
+    msg.flush_tlb.batch = &batch;
+    msg.refs.store(target_count, AK::MemoryOrder::memory_order_release);
+    for (size_t i = 0; i < target_count; ++i) {
+        // Processors that already had messages queued will see ours without another IPI.
+        if (targets[i]->smp_enqueue_message(msg))
+            APIC::the().send_ipi(targets[i]->id());
+    }
+
     // While the other processors handle this request, we'll flush ours
-    flush_tlb_local(vaddr, page_count);
+    if (should_flush_locally)
+        batch.flush_local();
     // Now wait until everybody is done as well
     smp_broadcast_wait_sync(msg);
 }
@@ -1279,7 +1327,7 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     Processor::set_fs_base(to_thread->arch_specific_data().fs_base);
 
     if (from_regs.cr3 != to_regs.cr3)
-        write_cr3(to_regs.cr3);
+        processor.load_cr3(to_regs.cr3);
 
     to_thread->set_cpu(processor.id());
 
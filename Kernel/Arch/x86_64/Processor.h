@@ -79,6 +79,9 @@ private:
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // The page directory this processor is running, so TLB shootdowns can skip processors that can't have cached its mappings.
+    Atomic<FlatPtr> m_active_cr3 { 0 };
+
     void gdt_init();
     void write_raw_gdt_entry(u16 selector, u32 low, u32 high);
     void write_gdt_entry(u16 selector, Descriptor& descriptor);
@@ -153,7 +156,10 @@ public:
     bool smp_process_pending_messages();
 
     static void smp_unicast(u32 cpu, Function<void()>, bool async);
-    static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void smp_flush_tlb(Memory::TLBFlushBatch const&);
+
+    // Loads another page directory, which must be done through here so that TLB shootdowns know about it.
+    void load_cr3(FlatPtr);
 
     static void set_fs_base(FlatPtr);
 };
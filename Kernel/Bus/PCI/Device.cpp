@@ -7,6 +7,7 @@
 #include <AK/AnyOf.h>
 #include <Kernel/Arch/Interrupts.h>
 #include <Kernel/Arch/PCIMSI.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/BarMapping.h>
 #include <Kernel/Bus/PCI/Device.h>
@@ -133,7 +134,10 @@ PhysicalAddress Device::msix_table_entry_address(u8 irq)
 // mainly useful for MSI/MSIx based interrupt mechanism where the driver
 // needs to program. If the PCI device doesn't support MSIx interrupts, then
 // this function will just return the irq used for pin based interrupt.
-ErrorOr<u8> Device::allocate_irq(u8 index)
+// With MSIx, the interrupt is delivered to `destination_processor`, so
+// drivers with per-processor queues can handle completions on the processor
+// that submitted the work.
+ErrorOr<u8> Device::allocate_irq(u8 index, u8 destination_processor)
 {
     if (Checked<u8>::addition_would_overflow(m_interrupt_range.m_start_irq, index))
         return Error::from_errno(EINVAL);
@@ -141,9 +145,13 @@ ErrorOr<u8> Device::allocate_irq(u8 index)
     if ((m_interrupt_range.m_type == InterruptType::MSIX) && is_msix_capable()) {
         auto entry_ptr = TRY(Memory::map_typed_writable<MSIxTableEntry volatile>(msix_table_entry_address(index + m_interrupt_range.m_start_irq)));
         entry_ptr->data = msi_data_register(m_interrupt_range.m_start_irq + index, false, false);
-        // TODO: we map all the IRQs to cpu 0 by default. We could attach
-        //  cpu affinity in the future where specific LAPIC id could be used.
-        u64 addr = msi_address_register(0, false, false);
+        if (destination_processor >= Processor::count())
+            return Error::from_errno(EINVAL);
+        // NOTE: The MSI address only has room for an 8-bit APIC ID.
+        auto destination_id = msi_destination_id(destination_processor);
+        if (destination_id > NumericLimits<u8>::max())
+            return Error::from_errno(ENOTSUP);
+        u64 addr = msi_address_register(destination_id, false, false);
         entry_ptr->address_low = addr & 0xffffffff;
         entry_ptr->address_high = addr >> 32;
 
@@ -157,7 +165,7 @@ ErrorOr<u8> Device::allocate_irq(u8 index)
             return Error::from_errno(EINVAL);
 
         auto data = msi_data_register(m_interrupt_range.m_start_irq + index, false, false);
-        auto addr = msi_address_register(0, false, false);
+        auto addr = msi_address_register(msi_destination_id(0), false, false);
         for (auto& capability : m_pci_identifier->capabilities()) {
             if (capability.id().value() == PCI::Capabilities::ID::MSI) {
                 capability.write32(msi_address_low_offset, addr & 0xffffffff);
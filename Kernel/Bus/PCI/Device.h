@@ -53,7 +53,7 @@ public:
     void enable_extended_message_signalled_interrupts();
     void disable_extended_message_signalled_interrupts();
     ErrorOr<InterruptType> reserve_irqs(u8 number_of_irqs, bool msi);
-    ErrorOr<u8> allocate_irq(u8 index);
+    ErrorOr<u8> allocate_irq(u8 index, u8 destination_processor = 0);
     PCI::InterruptType get_interrupt_type();
     void enable_interrupt(u8 irq);
     void disable_interrupt(u8 irq);
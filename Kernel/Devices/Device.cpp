@@ -119,6 +119,12 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Device::open(int options)
 
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
+    if (can_start_requests_concurrently()) {
+        // NOTE: Requests that were started concurrently never went through the queue.
+        evaluate_block_conditions();
+        return;
+    }
+
     SpinlockLocker lock(m_requests_lock);
     VERIFY(!m_requests.is_empty());
     VERIFY(m_requests.first().ptr() == &completed_request);
@@ -52,6 +52,10 @@ public:
     virtual void will_be_destroyed() override;
     virtual ErrorOr<void> after_inserting();
     virtual bool is_openable_by_jailed_processes() const { return false; }
+
+    // NOTE: Requests to a device are started one after another by default. Devices that can
+    //       have several requests in flight at once start every request as soon as it is made.
+    virtual bool can_start_requests_concurrently() const { return false; }
     void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
 
     template<typename AsyncRequestType, typename... Args>
@@ -59,6 +63,10 @@ public:
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
         SpinlockLocker lock(m_requests_lock);
+        if (can_start_requests_concurrently()) {
+            request->do_start(move(lock));
+            return request;
+        }
         bool was_empty = m_requests.is_empty();
         TRY(m_requests.try_append(request));
         if (was_empty)
@@ -440,7 +440,8 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, QueueType
         .dbbuf_eventidx = move(eventidx_doorbell_regs),
     };
 
-    auto irq = TRY(allocate_irq(qid));
+    // NOTE: IO queue qid belongs to processor qid - 1, so completions are handled on the processor that submitted them.
+    auto irq = TRY(allocate_irq(qid, qid - 1));
 
     m_queues.append(TRY(NVMeQueue::try_create(*this, qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), move(sq_dma_region), move(doorbell), queue_type)));
     dbgln_if(NVME_DEBUG, "NVMe: Created IO Queue with QID{}", m_queues.size());
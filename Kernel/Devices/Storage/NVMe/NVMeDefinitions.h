@@ -100,6 +100,7 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 
 static constexpr u16 ADMIN_QUEUE_SIZE = 2;
 static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+static constexpr u16 IO_MAX_PAGES_PER_REQUEST = IO_QUEUE_SIZE / 2;
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
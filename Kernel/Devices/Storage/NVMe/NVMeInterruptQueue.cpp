@@ -7,19 +7,26 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeDefinitions.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeInterruptQueue.h>
-#include <Kernel/Tasks/WorkQueue.h>
+#include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
 
-ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
 {
-    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(rw_dma_region), rw_dma_page, qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
+    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(rw_dma_region), move(rw_dma_pages), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
+    TRY(queue->m_pending_completions.with([q_depth](auto& completions) { return completions.try_ensure_capacity(q_depth); }));
+    TRY(queue->m_completions_in_progress.try_ensure_capacity(q_depth));
+
+    auto name = TRY(KString::formatted("NVMe Queue {} Completions", qid));
+    auto [process, _] = TRY(Process::create_kernel_process(name->view(), [queue = queue.ptr()]() { queue->completion_thread(); }));
+    queue->m_completion_process = move(process);
+
     queue->initialize_interrupt_queue();
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : NVMeQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
+UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : NVMeQueue(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
     , PCI::IRQHandler(device, irq)
 {
 }
@@ -31,30 +38,38 @@ void NVMeInterruptQueue::initialize_interrupt_queue()
 
 bool NVMeInterruptQueue::handle_irq()
 {
-    return process_cq() ? true : false;
-}
-
-void NVMeInterruptQueue::submit_sqe(NVMeSubmission& sub)
-{
-    NVMeQueue::submit_sqe(sub);
+    if (process_cq() == 0)
+        return false;
+    // Everything drained by this IRQ is handed to the completion thread in one go.
+    m_completion_wait_queue.wake_all();
+    return true;
 }
 
 void NVMeInterruptQueue::complete_current_request(u16 cmdid, u16 status)
 {
-    auto work_item_creation_result = g_io_work->try_queue([this, cmdid, status]() {
-        NVMeQueue::complete_current_request(cmdid, status);
+    // NOTE: Completing a read copies its data to the request's buffer, which may be a user buffer
+    //       that isn't paged in. We can't take a page fault while handling an IRQ, so defer that.
+    m_pending_completions.with([&](auto& completions) {
+        VERIFY(completions.size() < completions.capacity());
+        completions.unchecked_append({ cmdid, status });
     });
+}
 
-    if (work_item_creation_result.is_error()) {
-        m_requests.with([cmdid, status](auto& requests) {
-            auto& request_pdu = requests.get(cmdid).release_value();
-            auto current_request = request_pdu.request;
-
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
-            request_pdu.clear();
+void NVMeInterruptQueue::completion_thread()
+{
+    while (!Process::current().is_dying()) {
+        m_pending_completions.with([&](auto& completions) {
+            swap(completions, m_completions_in_progress);
         });
+        if (m_completions_in_progress.is_empty()) {
+            m_completion_wait_queue.wait_forever("NVMe"sv);
+            continue;
+        }
+        for (auto& completion : m_completions_in_progress)
+            NVMeQueue::complete_current_request(completion.cmdid, completion.status);
+        m_completions_in_progress.clear_with_capacity();
     }
+    Process::current().sys$exit(0);
+    VERIFY_NOT_REACHED();
 }
 }
@@ -6,25 +6,42 @@
 
 #pragma once
 
+#include <AK/Vector.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeQueue.h>
 #include <Kernel/Interrupts/PCIIRQHandler.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Tasks/WaitQueue.h>
 
 namespace Kernel {
 
 class NVMeInterruptQueue : public NVMeQueue
     , public PCI::IRQHandler {
 public:
-    static ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
-    void submit_sqe(NVMeSubmission& submission) override;
+    static ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
     virtual ~NVMeInterruptQueue() override {};
     virtual StringView purpose() const override { return "NVMe"sv; }
     void initialize_interrupt_queue();
 
 protected:
-    NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
+    NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
-private:
     virtual void complete_current_request(u16 cmdid, u16 status) override;
+
+private:
     bool handle_irq() override;
+    void completion_thread();
+
+    struct Completion {
+        u16 cmdid;
+        u16 status;
+    };
+
+    // NOTE: Every command identifier is completed at most once before it is released again, and it is only
+    //       released by the completion thread. So neither list can hold more than q_depth completions, and
+    //       both are allocated up front, which lets the IRQ handler queue completions without allocating.
+    SpinlockProtected<Vector<Completion>, LockRank::Interrupts> m_pending_completions {};
+    Vector<Completion> m_completions_in_progress;
+    WaitQueue m_completion_wait_queue;
+    RefPtr<Process> m_completion_process;
 };
 }
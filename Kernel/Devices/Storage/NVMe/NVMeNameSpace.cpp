@@ -27,16 +27,13 @@ UNMAP_AFTER_INIT NVMeNameSpace::NVMeNameSpace(LUNAddress logical_unit_number_add
 
 void NVMeNameSpace::start_request(AsyncBlockDeviceRequest& request)
 {
+    // NOTE: Every processor submits to its own queue, whose completion interrupt is delivered back to it as well.
     auto index = Processor::current_id();
     auto& queue = m_queues.at(index);
-    // TODO: For now we support only IO transfers of size PAGE_SIZE (Going along with the current constraint in the block layer)
-    // Eventually remove this constraint by using the PRP2 field in the submission struct and remove block layer constraint for NVMe driver.
-    VERIFY(request.block_count() <= (PAGE_SIZE / block_size()));
+    // The queue splits the request into one command per page, so the block size must not exceed PAGE_SIZE.
+    VERIFY(block_size() <= PAGE_SIZE);
+    VERIFY(request.block_count() <= max_blocks_per_request());
 
-    if (request.request_type() == AsyncBlockDeviceRequest::Read) {
-        queue->read(request, m_nsid, request.block_index(), request.block_count());
-    } else {
-        queue->write(request, m_nsid, request.block_index(), request.block_count());
-    }
+    queue->submit_request(request, m_nsid);
 }
 }
@@ -27,6 +27,8 @@ public:
 
     CommandSet command_set() const override { return CommandSet::NVMe; }
     void start_request(AsyncBlockDeviceRequest& request) override;
+    virtual bool can_start_requests_concurrently() const override { return true; }
+    virtual size_t max_blocks_per_request() const override { return IO_MAX_PAGES_PER_REQUEST * (PAGE_SIZE / block_size()); }
 
 private:
     NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid);
@@ -4,7 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <Kernel/Arch/Delay.h>
+#include <AK/Array.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeController.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeInterruptQueue.h>
 #include <Kernel/Devices/Storage/NVMe/NVMePollQueue.h>
@@ -14,24 +14,25 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalRAMPage> rw_dma_page;
+    // Note: Allocate a DMA page for every command identifier, so all commands of the queue can be in flight at once.
+    //  A single command never transfers more than 4096 bytes (NVMeQueue::submit_request takes care of it)
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages;
     // FIXME: Synchronize DMA buffer accesses correctly and set the MemoryType to NonCacheable.
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page, Memory::MemoryType::IO));
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages(q_depth * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages, Memory::MemoryType::IO));
 
-    if (rw_dma_page.is_null())
+    if (rw_dma_pages.size() < q_depth)
         return ENOMEM;
 
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), move(rw_dma_pages), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
     : m_rw_dma_region(move(rw_dma_region))
     , m_qid(qid)
     , m_admin_queue(qid == 0)
@@ -39,7 +40,7 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     , m_cq_dma_region(move(cq_dma_region))
     , m_sq_dma_region(move(sq_dma_region))
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
+    , m_rw_dma_pages(move(rw_dma_pages))
 
 {
     m_requests.with([q_depth](auto& requests) {
@@ -69,95 +70,147 @@ void NVMeQueue::update_cqe_head()
 u32 NVMeQueue::process_cq()
 {
     u32 nr_of_processed_cqes = 0;
-    m_requests.with([this, &nr_of_processed_cqes](auto& requests) {
-        while (cqe_available()) {
-            u16 status;
-            u16 cmdid;
-            ++nr_of_processed_cqes;
+    for (;;) {
+        u16 status;
+        u16 cmdid;
+        {
+            // NOTE: Both the interrupt handler and submitters waiting for a free slot may reap completions.
+            SpinlockLocker lock(m_cq_lock);
+            if (!cqe_available())
+                break;
             status = CQ_STATUS_FIELD(m_cqe_array[m_cq_head].status);
             cmdid = m_cqe_array[m_cq_head].command_id;
             dbgln_if(NVME_DEBUG, "NVMe: Completion with status {:x} and command identifier {}. CQ_HEAD: {}", status, cmdid, m_cq_head);
+            update_cqe_head();
+        }
+        ++nr_of_processed_cqes;
 
+        m_requests.with([cmdid](auto& requests) {
             if (!requests.contains(cmdid)) {
                 dmesgln("Bogus cmd id: {}", cmdid);
                 VERIFY_NOT_REACHED();
             }
-            complete_current_request_impl(cmdid, status, requests);
-            update_cqe_head();
-        }
-    });
+        });
+        complete_current_request(cmdid, status);
+    }
     if (nr_of_processed_cqes) {
+        SpinlockLocker lock(m_cq_lock);
         update_cq_doorbell();
     }
     return nr_of_processed_cqes;
 }
 
-void NVMeQueue::submit_sqe(NVMeSubmission& sub)
+Optional<u16> NVMeQueue::try_reserve_cid(NVMeIO& io)
+{
+    return m_requests.with([this, &io](auto& requests) -> Optional<u16> {
+        // NOTE: One slot always stays unused, so the submission queue can never overflow.
+        if (requests.size() >= m_qdepth - 1)
+            return {};
+
+        u16 cid = m_last_cid;
+        do {
+            cid = (cid + 1) % m_qdepth;
+        } while (requests.contains(cid));
+
+        m_last_cid = cid;
+        requests.set(cid, move(io));
+        return cid;
+    });
+}
+
+u16 NVMeQueue::reserve_cid(NVMeIO& io)
+{
+    for (;;) {
+        if (auto cid = try_reserve_cid(io); cid.has_value())
+            return cid.release_value();
+        wait_for_free_slot();
+    }
+}
+
+void NVMeQueue::wait_for_free_slot()
+{
+    // NOTE: Command identifiers are released by retire_command(), which wakes us up. If that happens
+    //       before we get to block here, the wait queue remembers the wake-up and we return right away.
+    m_free_slot_wait_queue.wait_forever("NVMe queue full"sv);
+}
+
+void NVMeQueue::submit_sqes(Span<NVMeSubmission> submissions)
 {
     SpinlockLocker lock(m_sq_lock);
 
-    memcpy(&m_sqe_array[m_sq_tail], &sub, sizeof(NVMeSubmission));
-    {
-        u32 temp_sq_tail = m_sq_tail + 1;
-        if (temp_sq_tail == m_qdepth)
-            m_sq_tail = 0;
-        else
-            m_sq_tail = temp_sq_tail;
+    for (auto& sub : submissions) {
+        memcpy(&m_sqe_array[m_sq_tail], &sub, sizeof(NVMeSubmission));
+        {
+            u32 temp_sq_tail = m_sq_tail + 1;
+            if (temp_sq_tail == m_qdepth)
+                m_sq_tail = 0;
+            else
+                m_sq_tail = temp_sq_tail;
+        }
+
+        dbgln_if(NVME_DEBUG, "NVMe: Submission with command identifier {}. SQ_TAIL: {}", sub.cmdid, m_sq_tail);
     }
 
-    dbgln_if(NVME_DEBUG, "NVMe: Submission with command identifier {}. SQ_TAIL: {}", sub.cmdid, m_sq_tail);
+    // NOTE: The controller only looks at the tail once we ring the doorbell,
+    //       so a single doorbell write covers the whole batch.
     update_sq_doorbell();
 }
 
-void NVMeQueue::complete_current_request_impl(u16 cmdid, u16 status, HashMap<u16, NVMeIO>& requests)
+void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
 {
-    auto& request_pdu = requests.get(cmdid).release_value();
-    auto current_request = request_pdu.request;
-    AsyncDeviceRequest::RequestResult req_result = AsyncDeviceRequest::Success;
-
-    ScopeGuard guard = [&req_result, status, &request_pdu] {
-        if (request_pdu.request)
-            request_pdu.request->complete(req_result);
-        if (request_pdu.end_io_handler)
-            request_pdu.end_io_handler(status);
-        request_pdu.clear();
-    };
-
-    // There can be submission without any request associated with it such as with
-    // admin queue commands during init. If there is no request, we are done
-    if (!current_request)
-        return;
+    // NOTE: The command identifier stays reserved until retire_command(), so nobody can reuse its DMA page
+    //       while we copy out of it. That is also why we don't need to hold any lock during the copy.
+    RefPtr<NVMeRequest> nvme_request;
+    size_t buffer_offset = 0;
+    size_t length = 0;
+    m_requests.with([&](auto& requests) {
+        auto& request_pdu = requests.get(cmdid).release_value();
+        nvme_request = request_pdu.request;
+        buffer_offset = request_pdu.buffer_offset;
+        length = request_pdu.length;
+    });
 
+    auto result = AsyncDeviceRequest::Success;
     if (status) {
-        req_result = AsyncBlockDeviceRequest::Failure;
-        return;
+        result = AsyncDeviceRequest::Failure;
+    } else if (nvme_request && nvme_request->request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
+        auto& block_request = *nvme_request->request;
+        if (auto copy_result = block_request.write_to_buffer(block_request.buffer(), rw_dma_buffer(cmdid), buffer_offset, length); copy_result.is_error())
+            result = AsyncDeviceRequest::MemoryFault;
     }
 
-    if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-        if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
-            req_result = AsyncBlockDeviceRequest::MemoryFault;
-            return;
-        }
-    }
+    retire_command(cmdid, status, result);
 }
 
-void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
+void NVMeQueue::retire_command(u16 cmdid, u16 status, AsyncDeviceRequest::RequestResult result)
 {
-    m_requests.with([this, cmdid, status](auto& requests) {
-        complete_current_request_impl(cmdid, status, requests);
+    RefPtr<NVMeRequest> request_to_complete;
+    auto request_pdu = m_requests.with([&](auto& requests) {
+        auto request_pdu = requests.take(cmdid).release_value();
+        // There can be submission without any request associated with it such as with
+        // admin queue commands during init.
+        if (auto& nvme_request = request_pdu.request) {
+            if (result != AsyncDeviceRequest::Success && nvme_request->result == AsyncDeviceRequest::Success)
+                nvme_request->result = result;
+            VERIFY(nvme_request->commands_pending > 0);
+            if (--nvme_request->commands_pending == 0)
+                request_to_complete = nvme_request;
+        }
+        return request_pdu;
     });
+    m_free_slot_wait_queue.wake_all();
+
+    if (request_pdu.end_io_handler)
+        request_pdu.end_io_handler(status);
+    if (request_to_complete)
+        request_to_complete->request->complete(request_to_complete->result);
 }
 
 u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
 {
-    // For now let's use sq tail as a unique command id.
     u16 cmd_status;
-    u16 cid = get_request_cid();
-    sub.cmdid = cid;
-
-    m_requests.with([this, &sub, &cmd_status](auto& requests) {
-        requests.set(sub.cmdid, { nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
-    });
+    NVMeIO io { nullptr, 0, 0, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } };
+    sub.cmdid = reserve_cid(io);
     submit_sqe(sub);
 
     // FIXME: Only sync submissions (usually used for admin commands) use a WaitQueue based IO. Eventually we need to
@@ -166,48 +219,76 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return cmd_status;
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::submit_request(AsyncBlockDeviceRequest& request, u16 nsid)
 {
-    NVMeSubmission sub {};
-    sub.op = OP_NVME_READ;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
+    // NOTE: Every command transfers at most one page, through the DMA page of its command identifier.
+    //       Commands are collected into batches, so that a whole batch only costs a single doorbell write.
+    static constexpr size_t max_submissions_per_doorbell = 16;
+
+    VERIFY(request.block_size() <= PAGE_SIZE);
+    u32 const blocks_per_command = PAGE_SIZE / request.block_size();
+    u32 const command_count = ceil_div(request.block_count(), blocks_per_command);
+    bool const is_read = request.request_type() == AsyncBlockDeviceRequest::Read;
+
+    auto nvme_request = adopt_ref_if_nonnull(new (nothrow) NVMeRequest(request, command_count));
+    if (!nvme_request) {
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
 
-    full_memory_barrier();
-    submit_sqe(sub);
-}
+    Array<NVMeSubmission, max_submissions_per_doorbell> batch {};
+    size_t batch_size = 0;
+
+    for (u32 command_index = 0; command_index < command_count; ++command_index) {
+        u32 first_block = command_index * blocks_per_command;
+        u32 block_count = min(blocks_per_command, request.block_count() - first_block);
+        NVMeIO io { nvme_request, first_block * request.block_size(), block_count * request.block_size(), nullptr };
+        auto buffer_offset = io.buffer_offset;
+        auto length = io.length;
+
+        Optional<u16> cid;
+        while (!(cid = try_reserve_cid(io)).has_value()) {
+            // The queue is full, so let the controller see what we have so far, and wait for some of it to complete.
+            if (batch_size > 0) {
+                submit_sqes(batch.span().trim(batch_size));
+                batch_size = 0;
+            }
+            wait_for_free_slot();
+        }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
-{
-    NVMeSubmission sub {};
-
-    sub.op = OP_NVME_WRITE;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
+        if (!is_read) {
+            if (auto result = request.read_from_buffer(request.buffer(), rw_dma_buffer(cid.value()), buffer_offset, length); result.is_error()) {
+                // Don't submit the rest of the request, the commands that are already in flight will still complete it.
+                m_requests.with([&](auto& requests) {
+                    requests.remove(cid.value());
+                    if (nvme_request->result == AsyncDeviceRequest::Success)
+                        nvme_request->result = AsyncDeviceRequest::MemoryFault;
+                    nvme_request->commands_pending -= command_count - command_index;
+                    if (nvme_request->commands_pending == 0)
+                        request.complete(nvme_request->result);
+                });
+                break;
+            }
+        }
 
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
-        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
-        return;
+        auto& sub = batch[batch_size++];
+        sub = {};
+        sub.op = is_read ? OP_NVME_READ : OP_NVME_WRITE;
+        sub.cmdid = cid.value();
+        sub.rw.nsid = nsid;
+        sub.rw.slba = AK::convert_between_host_and_little_endian(request.block_index() + first_block);
+        // No. of lbas is 0 based
+        sub.rw.length = AK::convert_between_host_and_little_endian((block_count - 1) & 0xFFFF);
+        sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_pages[cid.value()]->paddr().as_ptr()));
+
+        if (batch_size == max_submissions_per_doorbell) {
+            submit_sqes(batch.span());
+            batch_size = 0;
+        }
     }
 
-    full_memory_barrier();
-    submit_sqe(sub);
+    if (batch_size > 0)
+        submit_sqes(batch.span().trim(batch_size));
 }
 
 UNMAP_AFTER_INIT NVMeQueue::~NVMeQueue() = default;
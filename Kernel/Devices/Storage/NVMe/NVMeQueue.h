@@ -11,6 +11,7 @@
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
 #include <Kernel/Bus/PCI/Device.h>
+#include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeDefinitions.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Library/LockRefPtr.h>
@@ -37,15 +38,24 @@ enum class QueueType {
     IRQ
 };
 
-class AsyncBlockDeviceRequest;
-
-struct NVMeIO {
-    void clear()
+// NOTE: A request is split into one command per page of its buffer, and only completes
+//       once all of those commands have completed.
+struct NVMeRequest : public AtomicRefCounted<NVMeRequest> {
+    NVMeRequest(AsyncBlockDeviceRequest& request, u32 command_count)
+        : request(request)
+        , commands_pending(command_count)
     {
-        request = nullptr;
-        end_io_handler = nullptr;
     }
-    RefPtr<AsyncBlockDeviceRequest> request;
+
+    NonnullRefPtr<AsyncBlockDeviceRequest> const request;
+    u32 commands_pending { 0 };
+    AsyncDeviceRequest::RequestResult result { AsyncDeviceRequest::Success };
+};
+
+struct NVMeIO {
+    RefPtr<NVMeRequest> request;
+    size_t buffer_offset { 0 };
+    size_t length { 0 };
     Function<void(u16 status)> end_io_handler;
 };
 
@@ -55,9 +65,9 @@ public:
     static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type);
     bool is_admin_queue() { return m_admin_queue; }
     u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    virtual void submit_sqe(NVMeSubmission&);
+    void submit_request(AsyncBlockDeviceRequest& request, u16 nsid);
+    void submit_sqe(NVMeSubmission& sub) { submit_sqes({ &sub, 1 }); }
+    virtual void submit_sqes(Span<NVMeSubmission>);
     virtual ~NVMeQueue();
 
 protected:
@@ -83,25 +93,21 @@ protected:
             m_db_regs.mmio_reg->sq_tail = m_sq_tail;
     }
 
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
+    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
-    [[nodiscard]] u32 get_request_cid()
-    {
-        u32 expected_tag = m_tag.load(AK::memory_order_acquire);
-
-        for (;;) {
-            u32 cid = expected_tag + 1;
-            if (cid == m_qdepth)
-                cid = 0;
-            if (m_tag.compare_exchange_strong(expected_tag, cid, AK::memory_order_acquire))
-                return cid;
-        }
-    }
+    // Hands out a free command identifier for `io`, or nothing if every slot of the queue is in use.
+    [[nodiscard]] Optional<u16> try_reserve_cid(NVMeIO& io);
+    [[nodiscard]] u16 reserve_cid(NVMeIO& io);
+    // Called when every command identifier is in use, returns once one of them might have been released.
+    virtual void wait_for_free_slot();
 
+    // Copies the data of a completed read to its request, and then releases the command identifier.
+    // This may touch user memory, so it must not be called from an interrupt handler.
     virtual void complete_current_request(u16 cmdid, u16 status);
+    void retire_command(u16 cmdid, u16 status, AsyncDeviceRequest::RequestResult);
 
 private:
-    void complete_current_request_impl(u16 cmdid, u16 status, HashMap<u16, NVMeIO>& requests);
+    u8* rw_dma_buffer(u16 cid) { return m_rw_dma_region->vaddr().offset(cid * PAGE_SIZE).as_ptr(); }
     bool cqe_available();
     void update_cqe_head();
     void update_cq_doorbell()
@@ -121,16 +127,19 @@ private:
     u8 m_cq_valid_phase { 1 };
     u16 m_sq_tail {};
     u16 m_cq_head {};
+    Spinlock<LockRank::Interrupts> m_cq_lock {};
     bool m_admin_queue { false };
     u32 m_qdepth {};
-    Atomic<u32> m_tag { 0 }; // used for the cid in a submission queue entry
+    u16 m_last_cid { 0 }; // protected by m_requests
     Spinlock<LockRank::Interrupts> m_sq_lock {};
     OwnPtr<Memory::Region> m_cq_dma_region;
     Span<NVMeSubmission> m_sqe_array;
     OwnPtr<Memory::Region> m_sq_dma_region;
     Span<NVMeCompletion> m_cqe_array;
     WaitQueue m_sync_wait_queue;
+    WaitQueue m_free_slot_wait_queue;
     Doorbell m_db_regs;
-    NonnullRefPtr<Memory::PhysicalRAMPage const> const m_rw_dma_page;
+    // NOTE: Every command identifier has its own page to transfer data through.
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> const m_rw_dma_pages;
 };
 }
@@ -67,6 +67,10 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
     virtual void prepare_for_unplug() { m_partitions.clear(); }
 
+    // NOTE: Most controllers use a single page for their DMA buffer, so by default
+    // a single request never transfers more than PAGE_SIZE at a time.
+    virtual size_t max_blocks_per_request() const { return m_blocks_per_page; }
+
     Vector<NonnullRefPtr<StorageDevicePartition>> const& partitions() const { return m_partitions; }
 
     void add_partition(NonnullRefPtr<StorageDevicePartition> disk_partition) { MUST(m_partitions.try_append(disk_partition)); }
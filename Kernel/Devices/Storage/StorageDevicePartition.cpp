@@ -22,6 +22,7 @@ StorageDevicePartition::StorageDevicePartition(StorageDevice& device, MinorNumbe
     : BlockDevice(MajorAllocation::BlockDeviceFamily::StoragePartition, minor_number, device.block_size())
     , m_device(device)
     , m_metadata(metadata)
+    , m_can_start_requests_concurrently(device.can_start_requests_concurrently())
 {
 }
 
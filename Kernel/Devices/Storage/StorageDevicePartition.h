@@ -22,6 +22,7 @@ public:
     virtual ~StorageDevicePartition();
 
     virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual bool can_start_requests_concurrently() const override { return m_can_start_requests_concurrently; }
 
     // ^BlockDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
@@ -41,6 +42,7 @@ private:
 
     LockWeakPtr<StorageDevice> m_device;
     Partition::DiskPartitionMetadata m_metadata;
+    bool const m_can_start_requests_concurrently { false };
 };
 
 }
@@ -46,4 +46,8 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = 0;
     stats.kmalloc_call_count = s_kmalloc_call_count;
     stats.kfree_call_count = s_kfree_call_count;
+    stats.bytes_in_magazines = 0;
+    stats.magazine_hit_count = 0;
+    stats.magazine_refill_count = 0;
+    stats.magazine_drain_count = 0;
 }
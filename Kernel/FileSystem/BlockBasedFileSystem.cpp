@@ -4,13 +4,21 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
+#include <AK/Array.h>
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
 
+static constexpr size_t max_read_ahead_batch_size = 64;
+static constexpr size_t max_write_back_batch_size = 64;
+
 struct CacheEntry {
     IntrusiveListNode<CacheEntry> list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
@@ -18,24 +26,39 @@ struct CacheEntry {
     bool has_data { false };
 };
 
-class DiskCache {
+// NOTE: Each shard is an independent LRU cache with its own lock, so that accesses to
+//       blocks that hash to different shards can proceed in parallel. Shards allocate
+//       their entries lazily in chunks, grow up to a budget that is derived from the
+//       amount of free physical memory at mount time, and give chunks back again when
+//       the system runs low on memory.
+class DiskCacheShard {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    static constexpr size_t EntriesPerChunk = 64;
+    static constexpr size_t MissesBetweenMemoryPressureChecks = 256;
+
+    DiskCacheShard(size_t block_size, size_t max_entry_count, MutexProtected<OwnPtr<KBuffer>>& write_back_buffer)
+        : m_block_size(block_size)
+        , m_max_entry_count(max_entry_count)
+        , m_write_back_buffer(write_back_buffer)
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * fs.logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
     }
 
-    ~DiskCache() = default;
+    ~DiskCacheShard()
+    {
+        // NOTE: The entries live inside the chunks, so they have to be unlinked before the chunks go away.
+        m_dirty_list.clear();
+        m_clean_list.clear();
+    }
 
     bool is_dirty() const { return !m_dirty_list.is_empty(); }
     bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
 
+    bool has_data_for(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        auto it = m_hash.find(block_index);
+        return it != m_hash.end() && it->value->has_data;
+    }
+
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
@@ -52,12 +75,20 @@ public:
         m_clean_list.prepend(entry);
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    // Moves the entry to the back of the LRU list without any data, so that it gets reused first.
+    void forget(CacheEntry& entry)
+    {
+        remove_from_hash(entry);
+        entry.has_data = false;
+        m_clean_list.append(entry);
+    }
+
+    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index)
     {
         auto it = m_hash.find(block_index);
         if (it == m_hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
+        auto& entry = *it->value;
         VERIFY(entry.block_index == block_index);
         if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
             // Cache hit! Promote the entry to the front of the list.
@@ -66,51 +97,256 @@ public:
         return &entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem& fs) const
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem const& fs)
     {
         if (auto* entry = get(block_index))
             return entry;
 
+        if (++m_misses_since_memory_pressure_check >= MissesBetweenMemoryPressureChecks) {
+            m_misses_since_memory_pressure_check = 0;
+            if (system_is_low_on_memory())
+                release_one_clean_chunk();
+        }
+
+        if (m_unused_entry_count == 0 && m_entry_count < m_max_entry_count && !system_is_low_on_memory()) {
+            // Growing is only a performance optimization, so failing to do so is not an error.
+            (void)try_grow();
+        }
+
         if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            fs.flush_writes_impl();
-            return ensure(block_index, fs);
+            // Not a single clean entry! Flush this shard's writes and try again.
+            if (!is_dirty())
+                TRY(try_grow());
+            else
+                flush_dirty_entries(fs);
         }
 
         VERIFY(m_clean_list.last());
         auto& new_entry = *m_clean_list.last();
         m_clean_list.prepend(new_entry);
 
-        m_hash.remove(new_entry.block_index);
+        remove_from_hash(new_entry);
         TRY(m_hash.try_set(block_index, &new_entry));
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        if (m_unused_entry_count > 0)
+            --m_unused_entry_count;
 
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    size_t flush_dirty_entries(BlockBasedFileSystem const& fs)
+    {
+        size_t count = 0;
+        Vector<CacheEntry*> dirty_entries;
+        bool can_batch = true;
+        for (auto& entry : m_dirty_list) {
+            if (dirty_entries.try_append(&entry).is_error()) {
+                can_batch = false;
+                break;
+            }
+        }
+
+        if (!can_batch) {
+            for (auto& entry : m_dirty_list) {
+                write_back(fs, entry.block_index.value() * m_block_size, entry.data, m_block_size);
+                ++count;
+            }
+            mark_all_clean();
+            return count;
+        }
+
+        // NOTE: Runs of consecutive blocks are written back with a single request each,
+        //       so that the device gets to handle them as one batch.
+        quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+        m_write_back_buffer.with_exclusive([&](auto& batch_buffer) {
+            for (size_t i = 0; i < dirty_entries.size();) {
+                auto first_block_index = dirty_entries[i]->block_index.value();
+                size_t run_length = 1;
+                while (i + run_length < dirty_entries.size() && run_length < max_write_back_batch_size && dirty_entries[i + run_length]->block_index.value() == first_block_index + run_length)
+                    ++run_length;
+
+                if (run_length == 1 || !batch_buffer) {
+                    for (size_t j = 0; j < run_length; ++j)
+                        write_back(fs, (first_block_index + j) * m_block_size, dirty_entries[i + j]->data, m_block_size);
+                } else {
+                    for (size_t j = 0; j < run_length; ++j)
+                        memcpy(batch_buffer->data() + j * m_block_size, dirty_entries[i + j]->data, m_block_size);
+                    write_back(fs, first_block_index * m_block_size, batch_buffer->data(), run_length * m_block_size);
+                }
+
+                count += run_length;
+                i += run_length;
+            }
+        });
+        mark_all_clean();
+        return count;
+    }
+
+private:
+    struct Chunk {
+        explicit Chunk(NonnullOwnPtr<KBuffer> block_data)
+            : block_data(move(block_data))
+        {
+        }
+
+        NonnullOwnPtr<KBuffer> block_data;
+        Array<CacheEntry, EntriesPerChunk> entries;
+    };
+
+    static void write_back(BlockBasedFileSystem const& fs, u64 offset, u8* data, size_t size)
+    {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        size_t nwritten = 0;
+        while (nwritten < size) {
+            auto result = fs.file_description().write(offset + nwritten, buffer.offset(nwritten), size - nwritten);
+            if (result.is_error() || result.value() == 0)
+                return;
+            nwritten += result.value();
+        }
+    }
+
+    static bool system_is_low_on_memory()
+    {
+        // NOTE: We consider memory to be low once less than 1/32 of physical memory is left uncommitted.
+        auto info = MM.get_system_memory_info();
+        return info.physical_pages_uncommitted < info.physical_pages / 32;
+    }
+
+    void remove_from_hash(CacheEntry& entry)
+    {
+        // NOTE: Entries that have never been used share the default block index,
+        //       so make sure we only drop the mapping if it actually points at this entry.
+        auto it = m_hash.find(entry.block_index);
+        if (it != m_hash.end() && it->value == &entry)
+            m_hash.remove(it);
+    }
+
+    ErrorOr<void> try_grow()
+    {
+        auto block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, EntriesPerChunk * m_block_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+        auto chunk = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Chunk(move(block_data))));
+        TRY(m_chunks.try_append(move(chunk)));
+
+        auto& new_chunk = *m_chunks.last();
+        for (size_t i = 0; i < EntriesPerChunk; ++i) {
+            auto& entry = new_chunk.entries[i];
+            entry.data = new_chunk.block_data->data() + i * m_block_size;
+            // NOTE: Unused entries go to the back of the LRU list, so they are picked before evicting anything.
+            m_clean_list.append(entry);
+        }
+        m_entry_count += EntriesPerChunk;
+        m_unused_entry_count = EntriesPerChunk;
+        return {};
+    }
+
+    void release_one_clean_chunk()
+    {
+        // NOTE: Always keep at least one chunk around, so the shard remains usable.
+        if (m_chunks.size() <= 1)
+            return;
+
+        for (size_t chunk_index = m_chunks.size(); chunk_index-- > 0;) {
+            auto& chunk = *m_chunks[chunk_index];
+            bool has_dirty_entries = any_of(chunk.entries, [&](auto const& entry) { return entry_is_dirty(entry); });
+            if (has_dirty_entries)
+                continue;
+
+            for (auto& entry : chunk.entries) {
+                remove_from_hash(entry);
+                m_clean_list.remove(entry);
+            }
+            m_chunks.remove(chunk_index);
+            m_entry_count -= EntriesPerChunk;
+            m_unused_entry_count = 0;
+            dbgln_if(BBFS_DEBUG, "DiskCacheShard: Released a chunk due to memory pressure, {} entries left", m_entry_count);
+            return;
+        }
+    }
+
+    size_t const m_block_size { 0 };
+    size_t const m_max_entry_count { 0 };
+    size_t m_entry_count { 0 };
+    size_t m_unused_entry_count { 0 };
+    size_t m_misses_since_memory_pressure_check { 0 };
+    MutexProtected<OwnPtr<KBuffer>>& m_write_back_buffer;
+
+    // NOTE: m_chunks must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
+    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_chunks is destroyed.
+    Vector<NonnullOwnPtr<Chunk>> m_chunks;
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    IntrusiveList<&CacheEntry::list_node> m_clean_list;
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+};
+
+class DiskCache {
+public:
+    static constexpr size_t ShardCount = 16;
+    static constexpr size_t MinimumEntryCount = ShardCount * DiskCacheShard::EntriesPerChunk;
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(size_t block_size)
+    {
+        // NOTE: Allow the cache to grow up to 1/8 of the memory that is available right now.
+        //       Shards only allocate their entries once they are actually needed.
+        auto info = MM.get_system_memory_info();
+        size_t budget = (info.physical_pages_uncommitted * PAGE_SIZE / 8) / block_size;
+        size_t entries_per_shard = ceil_div(max(budget, MinimumEntryCount), ShardCount);
+        entries_per_shard = align_up_to(entries_per_shard, DiskCacheShard::EntriesPerChunk);
+
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache));
+        // NOTE: Write-back is still possible block by block, so not getting this buffer is not an error.
+        auto write_back_buffer = KBuffer::try_create_with_size("BlockBasedFS: Write-back batch"sv, max_write_back_batch_size * block_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+        if (!write_back_buffer.is_error()) {
+            cache->m_write_back_buffer.with_exclusive([&](auto& buffer) {
+                buffer = write_back_buffer.release_value();
+            });
+        }
+        // NOTE: Likewise, read-ahead falls back to reading block by block without this one.
+        auto read_ahead_buffer = KBuffer::try_create_with_size("BlockBasedFS: Read-ahead batch"sv, max_read_ahead_batch_size * block_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+        if (!read_ahead_buffer.is_error()) {
+            cache->m_read_ahead_buffer.with_exclusive([&](auto& buffer) {
+                buffer = read_ahead_buffer.release_value();
+            });
+        }
+        for (auto& shard : cache->m_shards) {
+            auto new_shard = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCacheShard(block_size, entries_per_shard, cache->m_write_back_buffer)));
+            shard.with_exclusive([&](auto& shard_ptr) {
+                shard_ptr = move(new_shard);
+            });
+        }
+        return cache;
+    }
+
+    // NOTE: Neighbouring blocks are kept in the same shard, so that they can be written back together.
+    static constexpr size_t BlocksPerStripe = max_write_back_batch_size;
+
+    MutexProtected<OwnPtr<DiskCacheShard>>& shard_for(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        return m_shards[u64_hash(block_index.value() / BlocksPerStripe) % ShardCount];
+    }
+
+    MutexProtected<OwnPtr<KBuffer>>& read_ahead_buffer() { return m_read_ahead_buffer; }
 
     template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void for_each_shard(Callback callback)
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        for (auto& shard : m_shards) {
+            shard.with_exclusive([&](auto& shard_ptr) {
+                callback(*shard_ptr);
+            });
+        }
     }
 
 private:
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    DiskCache() = default;
+
+    // NOTE: Runs of consecutive dirty blocks are gathered here to be written back with a single request.
+    //       Shards that flush at the same time take turns using it.
+    MutexProtected<OwnPtr<KBuffer>> m_write_back_buffer;
+    // NOTE: Runs of uncached blocks are read ahead into this buffer with a single request, then copied into their entries.
+    MutexProtected<OwnPtr<KBuffer>> m_read_ahead_buffer;
+    Array<MutexProtected<OwnPtr<DiskCacheShard>>, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -126,13 +362,7 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size(), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
-
-    m_cache.with_exclusive([&](auto& cache) {
-        cache = move(disk_cache);
-    });
+    m_cache = TRY(DiskCache::try_create(logical_block_size()));
     return {};
 }
 
@@ -149,9 +379,14 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache->shard_for(index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
-            flush_specific_block_if_needed(index);
+            // NOTE: A cached copy of the block would go stale, so drop it. Whatever part of a dirty block we don't overwrite has to reach the disk first, though.
+            if (auto* entry = cache->get(index)) {
+                if (count < logical_block_size())
+                    flush_specific_block_if_needed(index);
+                cache->forget(*entry);
+            }
             u64 base_offset = index.value() * logical_block_size() + offset;
             auto nwritten = TRY(file_description().write(base_offset, data, count));
             VERIFY(nwritten == count);
@@ -223,16 +458,23 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache->shard_for(index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
+            // NOTE: Uncached readers (like the page cache) keep the data around themselves, so a clean copy
+            //       of the block, such as one warmed up by read-ahead, isn't needed anymore once it's been read.
+            if (auto* entry = cache->get(index); entry && entry->has_data) {
+                TRY(buffer->write(entry->data + offset, count));
+                if (!cache->entry_is_dirty(*entry))
+                    cache->forget(*entry);
+                return {};
+            }
             u64 base_offset = index.value() * logical_block_size() + offset;
             auto nread = TRY(file_description().read(*buffer, base_offset, count));
             VERIFY(nread == count);
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index, const_cast<BlockBasedFileSystem&>(*this)));
+        auto* entry = TRY(cache->ensure(index, *this));
         if (!entry->has_data) {
             auto base_offset = index.value() * logical_block_size();
             auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
@@ -262,9 +504,67 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
+ErrorOr<void> BlockBasedFileSystem::read_ahead_blocks(BlockIndex index, size_t count) const
+{
+    VERIFY(m_device_block_size);
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead_blocks {}, count={}", index, count);
+
+    size_t i = 0;
+    while (i < count) {
+        if (is_block_cached(BlockIndex { index.value() + i })) {
+            ++i;
+            continue;
+        }
+        size_t run_length = 1;
+        while (i + run_length < count && run_length < max_read_ahead_batch_size && !is_block_cached(BlockIndex { index.value() + i + run_length }))
+            ++run_length;
+        TRY(read_uncached_blocks_into_cache(BlockIndex { index.value() + i }, run_length));
+        i += run_length;
+    }
+    return {};
+}
+
+bool BlockBasedFileSystem::is_block_cached(BlockIndex index) const
+{
+    return m_cache->shard_for(index).with_exclusive([&](auto& cache) {
+        return cache->has_data_for(index);
+    });
+}
+
+ErrorOr<void> BlockBasedFileSystem::read_uncached_blocks_into_cache(BlockIndex index, size_t count) const
+{
+    VERIFY(count <= max_read_ahead_batch_size);
+    auto block_size = logical_block_size();
+    return m_cache->read_ahead_buffer().with_exclusive([&](auto& batch_buffer) -> ErrorOr<void> {
+        if (!batch_buffer) {
+            for (size_t i = 0; i < count; ++i)
+                TRY(read_block(BlockIndex { index.value() + i }, nullptr, 0, 0, true));
+            return {};
+        }
+
+        auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(batch_buffer->data());
+        auto nread = TRY(file_description().read(kernel_buffer, index.value() * block_size, count * block_size));
+
+        for (size_t i = 0; i < nread / block_size; ++i) {
+            BlockIndex block_index { index.value() + i };
+            TRY(m_cache->shard_for(block_index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
+                auto* entry = TRY(cache->ensure(block_index, *this));
+                // NOTE: Someone may have read or written this block while we were waiting for the device.
+                //       The cached data is at least as recent as ours in that case, so leave it alone.
+                if (entry->has_data)
+                    return {};
+                memcpy(entry->data, batch_buffer->data() + i * block_size, block_size);
+                entry->has_data = true;
+                return {};
+            }));
+        }
+        return {};
+    });
+}
+
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
-    m_cache.with_exclusive([&](auto& cache) {
+    m_cache->shard_for(index).with_exclusive([&](auto& cache) {
         if (!cache->is_dirty())
             return;
         auto* entry = cache->get(index);
@@ -281,18 +581,13 @@ void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    m_cache->for_each_shard([&](DiskCacheShard& shard) {
+        if (!shard.is_dirty())
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+        count += shard.flush_dirty_entries(*this);
     });
+    if (count)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
@@ -22,6 +22,8 @@ public:
     virtual ErrorOr<void> flush_writes() override;
     void flush_writes_impl();
 
+    virtual bool supports_page_cache() const override { return true; }
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -30,6 +32,9 @@ protected:
     ErrorOr<void> read_block(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset = 0, bool allow_cache = true) const;
     ErrorOr<void> read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
 
+    // Populates the cache with the given blocks, batching consecutive uncached blocks into a single device request.
+    ErrorOr<void> read_ahead_blocks(BlockIndex, size_t count) const;
+
     ErrorOr<void> raw_read(BlockIndex, UserOrKernelBuffer&);
     ErrorOr<void> raw_write(BlockIndex, UserOrKernelBuffer const&);
 
@@ -43,8 +48,10 @@ protected:
 
 private:
     void flush_specific_block_if_needed(BlockIndex index);
+    bool is_block_cached(BlockIndex index) const;
+    ErrorOr<void> read_uncached_blocks_into_cache(BlockIndex index, size_t count) const;
 
-    mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    OwnPtr<DiskCache> m_cache;
 };
 
 }
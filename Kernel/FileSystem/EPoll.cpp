@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// Guards Interest::m_description and the per-description interest lists.
+static Spinlock<LockRank::None> s_description_link_lock {};
+
+static u32 events_from_unblocked_flags(BlockFlags unblocked_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblocked_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (!has_flag(unblocked_flags, BlockFlags::WriteHangUp) && has_flag(unblocked_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(unblocked_flags, BlockFlags::WritePriority))
+        events |= EPOLLWRBAND;
+    if (has_flag(unblocked_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    return events;
+}
+
+ErrorOr<NonnullRefPtr<EPoll>> EPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EPoll);
+}
+
+EPoll::~EPoll()
+{
+    (void)close();
+}
+
+EPoll::Interest::Interest(EPoll& epoll, int fd, OpenFileDescription& description, epoll_event const& event)
+    : m_epoll(epoll)
+    , m_fd(fd)
+    , m_file(description.file())
+    , m_events(event.events)
+    , m_data(event.data)
+{
+}
+
+EPoll::Interest::~Interest()
+{
+    VERIFY(!m_description_list_node.is_in_list());
+    VERIFY(!m_ready_list_node.is_in_list());
+}
+
+RefPtr<OpenFileDescription> EPoll::Interest::strong_description() const
+{
+    SpinlockLocker lock(s_description_link_lock);
+    if (!m_description || !m_description->try_ref())
+        return nullptr;
+    return adopt_ref(*m_description);
+}
+
+bool EPoll::Interest::refers_to(OpenFileDescription const& description) const
+{
+    SpinlockLocker lock(s_description_link_lock);
+    return m_description == &description;
+}
+
+void EPoll::Interest::update(epoll_event const& event)
+{
+    m_events = event.events;
+    m_data = event.data;
+    m_is_disabled.store(false, AK::MemoryOrder::memory_order_release);
+}
+
+BlockFlags EPoll::Interest::block_flags() const
+{
+    // Like poll(), always report errors and hang-ups.
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    if (m_events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (m_events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (m_events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (m_events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (m_events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+void EPoll::Interest::block_conditions_were_evaluated()
+{
+    // We don't know what changed, so queue ourselves and let collect_ready_events() find out.
+    if (!is_disabled())
+        m_epoll.enqueue(*this);
+}
+
+void EPoll::enqueue(Interest& interest)
+{
+    bool was_empty = m_ready_list.with([&](auto& list) {
+        if (interest.m_ready_list_node.is_in_list())
+            return false;
+        bool was_empty = list.is_empty();
+        list.append(interest);
+        return was_empty;
+    });
+
+    // can_read() only changes when the list stops being empty.
+    if (was_empty)
+        evaluate_block_conditions();
+}
+
+void EPoll::unlink(Interest& interest)
+{
+    interest.m_file->blocker_set().remove_observer(interest);
+    {
+        SpinlockLocker lock(s_description_link_lock);
+        interest.m_description_list_node.remove();
+        interest.m_description = nullptr;
+    }
+    m_ready_list.with([&](auto& list) { list.remove(interest); });
+}
+
+ErrorOr<void> EPoll::add_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // FIXME: Allow nesting EPolls once we can detect cycles between them.
+    if (description.is_epoll())
+        return EINVAL;
+
+    auto new_interest = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Interest(*this, fd, description, event)));
+    auto& interest = *new_interest;
+
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        if (auto it = interests.find(fd); it != interests.end()) {
+            if (it->value->refers_to(description))
+                return EEXIST;
+            // The fd was closed and reused without removing the interest first, so the old one is stale.
+            unlink(*it->value);
+            interests.remove(it);
+        }
+        TRY(interests.try_set(fd, move(new_interest)));
+
+        {
+            SpinlockLocker lock(s_description_link_lock);
+            interest.m_description = &description;
+            description.epoll_interests({}).append(interest);
+        }
+        description.blocker_set().add_observer(interest);
+
+        // The file may already be ready, and it won't tell us until its state changes again.
+        enqueue(interest);
+        return {};
+    });
+}
+
+ErrorOr<void> EPoll::modify_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        auto it = interests.find(fd);
+        if (it == interests.end() || !it->value->refers_to(description))
+            return ENOENT;
+        auto& interest = *it->value;
+        interest.update(event);
+        enqueue(interest);
+        return {};
+    });
+}
+
+ErrorOr<void> EPoll::remove_interest(int fd, OpenFileDescription& description)
+{
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<void> {
+        auto it = interests.find(fd);
+        if (it == interests.end() || !it->value->refers_to(description))
+            return ENOENT;
+        unlink(*it->value);
+        interests.remove(it);
+        return {};
+    });
+}
+
+ErrorOr<size_t> EPoll::collect_ready_events(Span<epoll_event> events)
+{
+    return m_interests.with_exclusive([&](auto& interests) -> ErrorOr<size_t> {
+        // Level-triggered interests that are still ready go back to the end of the list.
+        // Only look at the interests that were queued when we started, so we don't see them twice.
+        size_t remaining = m_ready_list.with([](auto& list) { return list.size_slow(); });
+        size_t count = 0;
+
+        for (; remaining > 0 && count < events.size(); --remaining) {
+            auto* interest = m_ready_list.with([](auto& list) { return list.take_first(); });
+            if (!interest)
+                break;
+
+            auto description = interest->strong_description();
+            if (!description) {
+                // The description has been destroyed, so this interest can never become ready again.
+                auto fd = interest->fd();
+                unlink(*interest);
+                interests.remove(fd);
+                continue;
+            }
+
+            if (interest->is_disabled())
+                continue;
+
+            auto unblocked_flags = description->should_unblock(interest->block_flags());
+            auto ready_events = events_from_unblocked_flags(unblocked_flags);
+            if (ready_events == 0)
+                continue;
+
+            events[count++] = { .events = ready_events, .data = interest->data() };
+
+            if (interest->events() & EPOLLONESHOT)
+                interest->disable();
+            else if (!(interest->events() & EPOLLET))
+                enqueue(*interest);
+        }
+        return count;
+    });
+}
+
+void EPoll::description_will_be_destroyed(Badge<OpenFileDescription>, OpenFileDescription& description)
+{
+    SpinlockLocker lock(s_description_link_lock);
+    auto& interests = description.epoll_interests({});
+    while (auto* interest = interests.take_first()) {
+        interest->m_description = nullptr;
+        // We can't take the EPoll's interest lock here, so let the next wait clean up after us.
+        interest->m_epoll.enqueue(*interest);
+    }
+}
+
+bool EPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_ready_list.with([](auto& list) { return !list.is_empty(); });
+}
+
+ErrorOr<void> EPoll::close()
+{
+    m_interests.with_exclusive([this](auto& interests) {
+        for (auto& it : interests)
+            unlink(*it.value);
+        interests.clear();
+    });
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return m_interests.with_shared([](auto& interests) -> ErrorOr<NonnullOwnPtr<KString>> {
+        return KString::formatted("EPoll:({})", interests.size());
+    });
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Badge.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Tasks/Thread.h>
+
+namespace Kernel {
+
+// An EPoll is a persistent set of file descriptions that a process wants readiness
+// notifications for. Unlike poll(), nothing is registered or unregistered per wait:
+// every interest observes its file's blocker set and puts itself on the ready list
+// whenever the file re-evaluates its block conditions. Waiting then only has to look
+// at the ready list, so its cost scales with the number of ready files.
+class EPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EPoll>> try_create();
+    virtual ~EPoll() override;
+
+    ErrorOr<void> add_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_interest(int fd, OpenFileDescription&);
+
+    // Fills in as many of the given events as there are ready interests. This never blocks.
+    ErrorOr<size_t> collect_ready_events(Span<epoll_event>);
+
+    static void description_will_be_destroyed(Badge<OpenFileDescription>, OpenFileDescription&);
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EPoll"sv; }
+    virtual bool is_epoll() const override { return true; }
+
+private:
+    EPoll() = default;
+
+    class Interest final : public FileBlockerSet::Observer {
+    public:
+        Interest(EPoll&, int fd, OpenFileDescription&, epoll_event const&);
+        virtual ~Interest() override;
+
+        int fd() const { return m_fd; }
+        RefPtr<OpenFileDescription> strong_description() const;
+        bool refers_to(OpenFileDescription const&) const;
+
+        void update(epoll_event const&);
+        u32 events() const { return m_events; }
+        epoll_data_t data() const { return m_data; }
+        Thread::FileBlocker::BlockFlags block_flags() const;
+
+        bool is_disabled() const { return m_is_disabled.load(AK::MemoryOrder::memory_order_acquire); }
+        void disable() { m_is_disabled.store(true, AK::MemoryOrder::memory_order_release); }
+
+        virtual void block_conditions_were_evaluated() override;
+
+    private:
+        friend class EPoll;
+
+        EPoll& m_epoll;
+        int const m_fd;
+        NonnullRefPtr<File> const m_file;
+
+        // Interests don't keep their description alive, otherwise closing a watched
+        // socket would never actually close the connection. The pointer is cleared by
+        // description_will_be_destroyed(), and both are guarded by the description link lock.
+        OpenFileDescription* m_description { nullptr };
+        IntrusiveListNode<Interest> m_description_list_node;
+
+        u32 m_events { 0 };
+        epoll_data_t m_data {};
+        Atomic<bool> m_is_disabled { false };
+
+        IntrusiveListNode<Interest> m_ready_list_node;
+    };
+
+    void enqueue(Interest&);
+    void unlink(Interest&);
+
+    using ReadyList = IntrusiveList<&Interest::m_ready_list_node>;
+    mutable SpinlockProtected<ReadyList, LockRank::None> m_ready_list;
+
+    MutexProtected<HashMap<int, NonnullOwnPtr<Interest>>> m_interests;
+
+public:
+    // Every OpenFileDescription keeps a list of the interests that refer to it.
+    using InterestList = IntrusiveList<&Interest::m_description_list_node>;
+};
+
+}
@@ -795,6 +795,10 @@ ErrorOr<void> Ext2FS::flush_writes()
             if (cached_inode == nullptr)
                 return true;
 
+            // Inodes of files that still exist are also kept around for as long as their page cache holds anything.
+            if (cached_inode->has_cached_pages() && cached_inode->m_raw_inode.i_links_count > 0)
+                return false;
+
             return cached_inode->ref_count() == 1 && !cached_inode->has_watchers();
         });
     }
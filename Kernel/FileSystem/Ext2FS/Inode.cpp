@@ -480,6 +480,26 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
 }
 
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    bool allow_cache = !description || !description->is_direct();
+    auto nread = TRY(read_bytes_impl(offset, count, buffer, allow_cache));
+
+    if (allow_cache && description) {
+        if (auto read_ahead_range = description->did_read(offset, nread); read_ahead_range.has_value()) {
+            schedule_read_ahead(read_ahead_range->offset, read_ahead_range->length);
+        }
+    }
+
+    return nread;
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    // The page cache already keeps the data in memory, so don't keep another copy in the block cache.
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -498,8 +518,6 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         return nread;
     }
 
-    bool allow_cache = !description || !description->is_direct();
-
     int const block_size = fs().logical_block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
@@ -534,6 +552,40 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     return nread;
 }
 
+ErrorOr<void> Ext2FSInode::read_ahead_locked(off_t offset, size_t length) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (static_cast<u64>(offset) >= size())
+        return {};
+    if (is_symlink() && size() < max_inline_symlink_length)
+        return {};
+
+    auto const block_size = fs().logical_block_size();
+    auto end = min(static_cast<u64>(offset) + length, size());
+    BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
+    BlockBasedFileSystem::BlockIndex last_block_logical_index = ceil_div(end, static_cast<u64>(block_size));
+
+    // Coalesce the blocks into runs that are contiguous on disk, so each run can be read with a single request.
+    BlockBasedFileSystem::BlockIndex run_start { 0 };
+    size_t run_length = 0;
+    for (auto logical_index = first_block_logical_index; logical_index < last_block_logical_index; logical_index = logical_index.value() + 1) {
+        auto block_index = TRY(m_block_view.get_block(logical_index));
+        if (run_length > 0 && block_index.value() == run_start.value() + run_length) {
+            ++run_length;
+            continue;
+        }
+        if (run_length > 0)
+            TRY(fs().read_ahead_blocks(run_start, run_length));
+        // NOTE: Holes don't have any blocks on disk, so there is nothing to read ahead.
+        run_start = block_index;
+        run_length = block_index.value() == 0 ? 0 : 1;
+    }
+    if (run_length > 0)
+        TRY(fs().read_ahead_blocks(run_start, run_length));
+    return {};
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     VERIFY(m_inode_lock.is_locked());
@@ -572,6 +624,20 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 }
 
 ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer const& data, OpenFileDescription* description)
+{
+    auto nwritten = TRY(write_bytes_impl(offset, count, data, !description || !description->is_direct()));
+    did_modify_contents();
+    return nwritten;
+}
+
+ErrorOr<size_t> Ext2FSInode::write_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer const& data)
+{
+    // NOTE: The contents were modified when the data entered the page cache, so writing it back mustn't touch
+    //       the timestamps (which may have been set explicitly since) or notify watchers again.
+    return write_bytes_impl(offset, count, data, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::write_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer const& data, bool allow_cache)
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -591,8 +657,6 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
         }
     }
 
-    bool allow_cache = !description || !description->is_direct();
-
     auto const block_size = fs().logical_block_size();
     auto new_size = max(static_cast<u64>(offset) + count, size());
 
@@ -624,8 +688,6 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
         nwritten += num_bytes_to_copy;
     }
 
-    did_modify_contents();
-
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={}", identifier(), size(), m_raw_inode.i_blocks);
     return nwritten;
 }
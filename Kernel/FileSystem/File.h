@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -23,8 +24,34 @@ class File;
 
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
+    // An observer hears about every evaluation of the block conditions without
+    // having a thread blocked on the file. EPoll uses this to track readiness.
+    class Observer {
+    public:
+        virtual ~Observer() = default;
+
+        // NOTE: This is called with the blocker set's lock held, so it must not block.
+        virtual void block_conditions_were_evaluated() = 0;
+
+    private:
+        friend class FileBlockerSet;
+        IntrusiveListNode<Observer> m_observer_list_node;
+    };
+
     FileBlockerSet() { }
 
+    void add_observer(Observer& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_observers.append(observer);
+    }
+
+    void remove_observer(Observer& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_observers.remove(observer);
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +67,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_observers)
+            observer.block_conditions_were_evaluated();
     }
+
+private:
+    IntrusiveList<&Observer::m_observer_list_node> m_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -119,6 +151,7 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_epoll() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
 
@@ -63,6 +63,9 @@ public:
 
     virtual bool is_file_backed() const { return false; }
 
+    // Whether the contents of regular files should be cached in their Inode's page cache.
+    virtual bool supports_page_cache() const { return false; }
+
     // Converts file types that are used internally by the filesystem to DT_* types
     virtual u8 internal_file_type_to_directory_entry_type(DirectoryEntryView const& entry) const { return entry.file_type; }
 
@@ -16,14 +16,22 @@
 #include <Kernel/FileSystem/VFSRootContext.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
 static Singleton<SpinlockProtected<Inode::AllInstancesList, LockRank::None>> s_all_instances;
 
+// Once less than 1/32 of physical memory is left, every page we add to a page cache evicts some clean ones first.
+static constexpr u64 page_cache_low_memory_divisor = 32;
+
+// Writers have to write back their dirty pages before they get to dirty any more than this (16 MiB).
+static constexpr size_t max_dirty_pages_per_inode = 4096;
+
 SpinlockProtected<Inode::AllInstancesList, LockRank::None>& Inode::all_instances()
 {
     return s_all_instances;
@@ -34,18 +42,21 @@ void Inode::sync_all()
     Vector<NonnullRefPtr<Inode>, 32> inodes;
     Inode::all_instances().with([&](auto& all_inodes) {
         for (auto& inode : all_inodes) {
-            if (inode.is_metadata_dirty())
+            if (inode.is_metadata_dirty() || inode.m_page_cache.has_dirty_pages())
                 inodes.append(inode);
         }
     });
 
     for (auto& inode : inodes) {
+        // Writing back file data may change the metadata, so it has to happen first.
+        (void)inode->write_back_cached_pages();
         (void)inode->flush_metadata();
     }
 }
 
 void Inode::sync()
 {
+    (void)write_back_cached_pages();
     (void)flush_metadata();
     auto result = fs().flush_writes();
     if (result.is_error()) {
@@ -85,6 +96,7 @@ Inode::~Inode()
 void Inode::will_be_destroyed()
 {
     MutexLocker locker(m_inode_lock);
+    (void)write_back_cached_pages_locked();
     if (m_metadata_dirty)
         (void)flush_metadata();
 }
@@ -92,7 +104,15 @@ void Inode::will_be_destroyed()
 ErrorOr<void> Inode::truncate(u64 size)
 {
     MutexLocker locker(m_inode_lock);
-    return truncate_locked(size);
+    TRY(truncate_locked(size));
+
+    m_page_cache.remove_pages_starting_at(ceil_div(size, static_cast<u64>(PAGE_SIZE)));
+    if (auto offset_in_page = size % PAGE_SIZE; offset_in_page != 0) {
+        // Whatever comes after the new end of the file has to read as zeroes if the file grows again.
+        if (auto page = m_page_cache.find_page(size / PAGE_SIZE))
+            MM.zero_physical_page_range(*page, offset_in_page, PAGE_SIZE - offset_in_page);
+    }
+    return {};
 }
 
 ErrorOr<size_t> Inode::write_bytes(off_t offset, size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description)
@@ -105,15 +125,58 @@ ErrorOr<size_t> Inode::prepare_and_write_bytes_locked(off_t offset, size_t lengt
 {
     VERIFY(m_inode_lock.is_locked());
     TRY(prepare_to_write_data());
-    return write_bytes_locked(offset, length, target_buffer, open_description);
+
+    // Writes within the file are absorbed by the page cache. Anything that changes the size of
+    // the file goes straight to the file system, and only updates the pages we already have.
+    if (can_use_page_cache(open_description) && static_cast<u64>(offset) + length <= size())
+        return write_bytes_to_page_cache_locked(offset, length, target_buffer);
+
+    auto nwritten = TRY(write_bytes_locked(offset, length, target_buffer, open_description));
+    if (uses_page_cache())
+        TRY(update_cached_pages_locked(offset, nwritten, target_buffer));
+    return nwritten;
 }
 
 ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
 {
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (uses_page_cache())
+        return read_bytes_from_page_cache_locked(offset, length, buffer, open_description);
     return read_bytes_locked(offset, length, buffer, open_description);
 }
 
+void Inode::schedule_read_ahead(off_t offset, size_t length) const
+{
+    // NOTE: Read-ahead has to wait for the disk, so it runs on its own work queue rather than holding up
+    //       the reader (and our lock). It's purely an optimization, so we don't care if it can't be queued.
+    (void)g_read_ahead_work->try_queue([inode = NonnullRefPtr<Inode const>(*this), offset, length] {
+        (void)inode->read_ahead(offset, length);
+    });
+}
+
+ErrorOr<void> Inode::read_ahead(off_t offset, size_t length) const
+{
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (!uses_page_cache())
+        return read_ahead_locked(offset, length);
+
+    // Read the pages straight into the page cache, so the data doesn't pass through the file system's cache.
+    auto file_size = size();
+    if (static_cast<u64>(offset) >= file_size)
+        return {};
+    u64 end_page_index = ceil_div(min<u64>(offset + length, file_size), static_cast<u64>(PAGE_SIZE));
+    for (u64 page_index = offset / PAGE_SIZE; page_index < end_page_index;) {
+        size_t page_count = min<u64>(end_page_index - page_index, max_pages_per_mapping);
+        CachedPages pages;
+        TRY(get_or_read_cached_pages_locked(page_index, page_count, pages));
+        // Don't push any more pages out of the cache for data that nobody has asked for yet.
+        if (pages.size() < page_count)
+            break;
+        page_index += page_count;
+    }
+    return {};
+}
+
 ErrorOr<size_t> Inode::read_until_filled_or_end(off_t offset, size_t length, UserOrKernelBuffer buffer, OpenFileDescription* open_description) const
 {
     auto remaining_length = length;
@@ -282,6 +345,355 @@ LockRefPtr<Memory::SharedInodeVMObject> Inode::shared_vmobject() const
     return m_shared_vmobject.strong_ref();
 }
 
+bool Inode::uses_page_cache() const
+{
+    return fs().supports_page_cache() && metadata().is_regular_file();
+}
+
+bool Inode::can_use_page_cache(OpenFileDescription const* open_description) const
+{
+    return uses_page_cache() && (!open_description || !open_description->is_direct());
+}
+
+static ErrorOr<NonnullOwnPtr<Memory::Region>> map_page_cache_pages(Span<NonnullRefPtr<Memory::PhysicalRAMPage>> pages)
+{
+    return MM.allocate_kernel_region_with_physical_pages(pages, "Inode page cache"sv, Memory::Region::Access::ReadWrite);
+}
+
+static ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> allocate_page_cache_page()
+{
+    // Start dropping clean pages before memory runs out entirely, so that everybody else still finds free pages.
+    auto memory_info = MM.get_system_memory_info();
+    if (memory_info.physical_pages_uncommitted < memory_info.physical_pages / page_cache_low_memory_divisor)
+        Inode::release_clean_cached_pages(Inode::page_cache_eviction_batch_size);
+
+    if (auto page_or_error = MM.allocate_physical_page(Memory::MemoryManager::ShouldZeroFill::No); !page_or_error.is_error())
+        return page_or_error.release_value();
+    if (Inode::release_clean_cached_pages(Inode::page_cache_eviction_batch_size) == 0)
+        return ENOMEM;
+    return MM.allocate_physical_page(Memory::MemoryManager::ShouldZeroFill::No);
+}
+
+size_t Inode::release_clean_cached_pages(size_t page_count)
+{
+    Vector<NonnullRefPtr<Inode>, 32> inodes;
+    Inode::all_instances().with([&](auto& all_inodes) {
+        for (auto& inode : all_inodes) {
+            if (inode.has_cached_pages() && inodes.try_append(inode).is_error())
+                break;
+        }
+    });
+
+    size_t released_page_count = 0;
+    for (auto& inode : inodes) {
+        if (released_page_count >= page_count)
+            break;
+        released_page_count += inode->m_page_cache.try_release_clean_pages(page_count - released_page_count);
+    }
+    return released_page_count;
+}
+
+RefPtr<Memory::PhysicalRAMPage> Inode::find_cached_page_locked(u64 page_index) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (auto page = m_page_cache.find_page(page_index))
+        return page;
+
+    // A shared mapping of the file may have held on to a page we dropped, and may even have modified it since.
+    auto shared_vmobject = m_shared_vmobject.strong_ref();
+    if (!shared_vmobject)
+        return nullptr;
+    auto page = shared_vmobject->resident_page(page_index);
+    if (!page)
+        return nullptr;
+    if (auto cached_page_or_error = m_page_cache.add_page(page_index, page.release_nonnull()); !cached_page_or_error.is_error())
+        return cached_page_or_error.release_value();
+    return shared_vmobject->resident_page(page_index);
+}
+
+void Inode::find_cached_pages_locked(u64 first_page_index, size_t page_count, CachedPages& pages) const
+{
+    VERIFY(page_count <= max_pages_per_mapping);
+    while (pages.size() < page_count) {
+        auto page = find_cached_page_locked(first_page_index + pages.size());
+        if (!page)
+            break;
+        pages.unchecked_append(page.release_nonnull());
+    }
+}
+
+ErrorOr<void> Inode::get_or_read_cached_pages_locked(u64 first_page_index, size_t page_count, CachedPages& pages) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(page_count <= max_pages_per_mapping);
+
+    while (pages.size() < page_count) {
+        find_cached_pages_locked(first_page_index, page_count, pages);
+        if (pages.size() == page_count)
+            break;
+
+        // Read in the whole run of pages we don't have yet with a single request.
+        u64 first_new_page_index = first_page_index + pages.size();
+        CachedPages new_pages;
+        bool is_out_of_memory = false;
+        while (pages.size() + new_pages.size() < page_count && !find_cached_page_locked(first_new_page_index + new_pages.size())) {
+            auto page_or_error = allocate_page_cache_page();
+            if (page_or_error.is_error()) {
+                is_out_of_memory = true;
+                break;
+            }
+            new_pages.unchecked_append(page_or_error.release_value());
+        }
+
+        if (!new_pages.is_empty()) {
+            auto region = TRY(map_page_cache_pages(new_pages.span()));
+            auto buffer = UserOrKernelBuffer::for_kernel_buffer(region->vaddr().as_ptr());
+            size_t length = new_pages.size() * PAGE_SIZE;
+            auto nread = TRY(read_bytes_for_page_cache_locked(first_new_page_index * PAGE_SIZE, length, buffer));
+            // Anything beyond the end of the file reads as zeroes.
+            memset(region->vaddr().offset(nread).as_ptr(), 0, length - nread);
+            for (size_t i = 0; i < new_pages.size(); ++i)
+                pages.unchecked_append(TRY(m_page_cache.add_page(first_new_page_index + i, new_pages[i])));
+        }
+
+        if (is_out_of_memory) {
+            if (pages.is_empty())
+                return ENOMEM;
+            break;
+        }
+    }
+    return {};
+}
+
+ErrorOr<RefPtr<Memory::PhysicalRAMPage>> Inode::cached_page(u64 page_index)
+{
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    VERIFY(uses_page_cache());
+    if (page_index * PAGE_SIZE >= size())
+        return nullptr;
+
+    CachedPages pages;
+    TRY(get_or_read_cached_pages_locked(page_index, 1, pages));
+    return pages.take_first();
+}
+
+ErrorOr<size_t> Inode::read_bytes_from_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+
+    auto file_size = size();
+    if (static_cast<u64>(offset) >= file_size)
+        return 0;
+    length = min<u64>(length, file_size - offset);
+
+    // O_DIRECT reads still see what we have cached, but don't add anything to the cache.
+    bool should_fill_cache = can_use_page_cache(open_description);
+
+    size_t nread = 0;
+    while (nread < length) {
+        u64 position = offset + nread;
+        size_t offset_in_first_page = position % PAGE_SIZE;
+        size_t page_count = min(ceil_div(offset_in_first_page + length - nread, static_cast<size_t>(PAGE_SIZE)), max_pages_per_mapping);
+
+        CachedPages pages;
+        if (should_fill_cache) {
+            if (auto result = get_or_read_cached_pages_locked(position / PAGE_SIZE, page_count, pages); result.is_error() && result.error().code() != ENOMEM)
+                return result.release_error();
+        } else {
+            find_cached_pages_locked(position / PAGE_SIZE, page_count, pages);
+        }
+
+        if (pages.is_empty()) {
+            // Without a page to go through (or the memory for one), read straight from the file system.
+            size_t chunk_size = min(PAGE_SIZE - offset_in_first_page, length - nread);
+            auto buffer_offset = buffer.offset(nread);
+            auto nread_from_file_system = TRY(read_bytes_locked(position, chunk_size, buffer_offset, open_description));
+            nread += nread_from_file_system;
+            if (nread_from_file_system < chunk_size)
+                break;
+            continue;
+        }
+
+        auto region = TRY(map_page_cache_pages(pages.span()));
+        size_t chunk_size = min(pages.size() * PAGE_SIZE - offset_in_first_page, length - nread);
+        TRY(buffer.write(region->vaddr().offset(offset_in_first_page).as_ptr(), nread, chunk_size));
+        nread += chunk_size;
+    }
+
+    if (should_fill_cache && open_description) {
+        if (auto read_ahead_range = open_description->did_read(offset, nread); read_ahead_range.has_value()) {
+            schedule_read_ahead(read_ahead_range->offset, read_ahead_range->length);
+        }
+    }
+
+    return nread;
+}
+
+ErrorOr<size_t> Inode::write_bytes_to_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer const& data)
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (length == 0)
+        return 0;
+
+    // Make writers that dirty pages faster than the SyncTask writes them back wait for the disk.
+    if (m_page_cache.dirty_page_count() >= max_dirty_pages_per_inode)
+        TRY(write_back_cached_pages_locked());
+
+    auto write_to_cached_pages = [&](u64 position, size_t length_to_write, size_t max_page_count) -> ErrorOr<size_t> {
+        u64 first_page_index = position / PAGE_SIZE;
+        size_t offset_in_first_page = position % PAGE_SIZE;
+        size_t page_count = min(ceil_div(offset_in_first_page + length_to_write, static_cast<size_t>(PAGE_SIZE)), max_page_count);
+        size_t chunk_size = min(page_count * PAGE_SIZE - offset_in_first_page, length_to_write);
+
+        CachedPages pages;
+        Array<bool, max_pages_per_mapping> is_new_page {};
+        for (size_t i = 0; i < page_count; ++i) {
+            u64 page_index = first_page_index + i;
+            if (auto page = find_cached_page_locked(page_index)) {
+                pages.unchecked_append(page.release_nonnull());
+                continue;
+            }
+
+            // A page that gets overwritten entirely doesn't have to be read in first.
+            size_t start_in_page = i == 0 ? offset_in_first_page : 0;
+            size_t end_in_page = min(PAGE_SIZE, offset_in_first_page + chunk_size - i * PAGE_SIZE);
+            if (start_in_page == 0 && end_in_page == PAGE_SIZE) {
+                pages.unchecked_append(TRY(allocate_page_cache_page()));
+                is_new_page[i] = true;
+                continue;
+            }
+
+            CachedPages read_pages;
+            TRY(get_or_read_cached_pages_locked(page_index, 1, read_pages));
+            pages.unchecked_append(read_pages.take_first());
+        }
+
+        auto region = TRY(map_page_cache_pages(pages.span()));
+        TRY(data.read(region->vaddr().offset(offset_in_first_page).as_ptr(), position - offset, chunk_size));
+
+        // New pages only join the cache once they hold the data, so that a failed copy can't leave garbage behind.
+        for (size_t i = 0; i < page_count; ++i) {
+            if (is_new_page[i])
+                TRY(m_page_cache.add_page(first_page_index + i, pages[i]));
+            m_page_cache.set_page_dirty(first_page_index + i);
+        }
+        return chunk_size;
+    };
+
+    size_t nwritten = 0;
+    while (nwritten < length) {
+        u64 position = offset + nwritten;
+        auto chunk_size_or_error = write_to_cached_pages(position, length - nwritten, max_pages_per_mapping);
+
+        if (chunk_size_or_error.is_error() && chunk_size_or_error.error().code() == ENOMEM) {
+            // Our own dirty pages can't be dropped until they have been written back, so do that and try again with a single page.
+            TRY(write_back_cached_pages_locked());
+            release_clean_cached_pages(page_cache_eviction_batch_size);
+            chunk_size_or_error = write_to_cached_pages(position, length - nwritten, 1);
+        }
+
+        if (chunk_size_or_error.is_error() && chunk_size_or_error.error().code() == ENOMEM) {
+            // If there's still no memory for the page, write through to the file system instead.
+            // That's only safe if the page isn't cached, otherwise the cached copy would go stale.
+            if (find_cached_page_locked(position / PAGE_SIZE))
+                return chunk_size_or_error.release_error();
+            size_t chunk_size = min(PAGE_SIZE - position % PAGE_SIZE, length - nwritten);
+            chunk_size_or_error = write_bytes_for_page_cache_locked(position, chunk_size, data.offset(nwritten));
+        }
+
+        auto chunk_size = TRY(chunk_size_or_error);
+        if (chunk_size == 0)
+            break;
+        nwritten += chunk_size;
+    }
+
+    did_modify_contents();
+    return nwritten;
+}
+
+ErrorOr<void> Inode::update_cached_pages_locked(off_t offset, size_t length, UserOrKernelBuffer const& data)
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+
+    size_t nupdated = 0;
+    while (nupdated < length) {
+        u64 position = offset + nupdated;
+        size_t offset_in_first_page = position % PAGE_SIZE;
+        size_t page_count = min(ceil_div(offset_in_first_page + length - nupdated, static_cast<size_t>(PAGE_SIZE)), max_pages_per_mapping);
+
+        // Pages we don't have cached don't need updating.
+        CachedPages pages;
+        find_cached_pages_locked(position / PAGE_SIZE, page_count, pages);
+        size_t chunk_size = min(max<size_t>(pages.size(), 1) * PAGE_SIZE - offset_in_first_page, length - nupdated);
+        if (!pages.is_empty()) {
+            auto region = TRY(map_page_cache_pages(pages.span()));
+            TRY(data.read(region->vaddr().offset(offset_in_first_page).as_ptr(), nupdated, chunk_size));
+        }
+        nupdated += chunk_size;
+    }
+    return {};
+}
+
+bool Inode::mark_cached_page_dirty(u64 page_index)
+{
+    MutexLocker locker(m_inode_lock);
+    // NOTE: This also adds the page of our shared mapping back to the cache if it had been dropped.
+    (void)find_cached_page_locked(page_index);
+    if (!m_page_cache.find_page(page_index))
+        return false;
+    m_page_cache.set_page_dirty(page_index);
+    return true;
+}
+
+ErrorOr<void> Inode::write_back_cached_pages()
+{
+    MutexLocker locker(m_inode_lock);
+    return write_back_cached_pages_locked();
+}
+
+ErrorOr<void> Inode::write_back_cached_pages_locked()
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (!m_page_cache.has_dirty_pages())
+        return {};
+
+    auto dirty_pages = TRY(m_page_cache.take_dirty_pages());
+    auto file_size = size();
+
+    auto write_back = [&](u64 offset, CachedPages& pages) -> ErrorOr<void> {
+        auto region = TRY(map_page_cache_pages(pages.span()));
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(region->vaddr().as_ptr());
+        TRY(write_bytes_for_page_cache_locked(offset, min<u64>(pages.size() * PAGE_SIZE, file_size - offset), buffer));
+        return {};
+    };
+
+    for (size_t i = 0; i < dirty_pages.size();) {
+        u64 offset = dirty_pages[i].page_index * PAGE_SIZE;
+        if (offset >= file_size) {
+            ++i;
+            continue;
+        }
+
+        // Write back runs of consecutive pages with a single request.
+        CachedPages pages;
+        pages.unchecked_append(dirty_pages[i].page);
+        while (pages.size() < max_pages_per_mapping && i + pages.size() < dirty_pages.size() && dirty_pages[i + pages.size()].page_index == dirty_pages[i].page_index + pages.size())
+            pages.unchecked_append(dirty_pages[i + pages.size()].page);
+
+        if (auto result = write_back(offset, pages); result.is_error()) {
+            // Keep everything we didn't get to dirty, so that the next attempt picks it up again.
+            for (; i < dirty_pages.size(); ++i)
+                m_page_cache.set_page_dirty(dirty_pages[i].page_index);
+            return result.release_error();
+        }
+        i += pages.size();
+    }
+    return {};
+}
+
 template<typename T>
 static inline bool range_overlap(T start1, T len1, T start2, T len2)
 {
@@ -16,6 +16,7 @@
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/InodeIdentifier.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/ListedRefCounted.h>
 #include <Kernel/Library/LockWeakPtr.h>
@@ -55,6 +56,7 @@ public:
 
     ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*);
     ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
+    void schedule_read_ahead(off_t, size_t) const;
     ErrorOr<size_t> read_until_filled_or_end(off_t, size_t, UserOrKernelBuffer buffer, OpenFileDescription*) const;
     ErrorOr<void> truncate(u64);
 
@@ -93,6 +95,23 @@ public:
     static void sync_all();
     void sync();
 
+    // Returns the page cache page that holds the given page of the file, reading it in if needed,
+    // or nullptr if the page lies entirely beyond the end of the file.
+    ErrorOr<RefPtr<Memory::PhysicalRAMPage>> cached_page(u64 page_index);
+    ErrorOr<void> write_back_cached_pages();
+    // Marks a cached page that a shared mapping wrote to as dirty. Returns false if the page isn't cached.
+    bool mark_cached_page_dirty(u64 page_index);
+    // Updates the timestamps and notifies watchers once a shared mapping's writes have been marked dirty in the page cache.
+    void did_modify_cached_pages() { did_modify_contents(); }
+    bool has_cached_pages() const { return m_page_cache.has_pages(); }
+
+    // Whether read() and write() go through the page cache, which is the case for regular files on supporting file systems.
+    bool uses_page_cache() const;
+
+    // Drops up to the given number of clean, unmapped pages from the page caches of all Inodes.
+    static size_t release_clean_cached_pages(size_t page_count);
+    static constexpr size_t page_cache_eviction_batch_size = 64;
+
     bool has_watchers() const;
 
     ErrorOr<void> register_watcher(Badge<InodeWatcher>, InodeWatcher&);
@@ -122,9 +141,35 @@ protected:
 
     virtual ErrorOr<size_t> write_bytes_locked(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*) = 0;
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
+    virtual ErrorOr<void> read_ahead_locked(off_t, size_t) const { return {}; }
+
+    // Filling and writing back page cache pages goes through these. As the page cache already keeps
+    // the data in memory, file systems should avoid caching it a second time.
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer& buffer) const { return read_bytes_locked(offset, length, buffer, nullptr); }
+    virtual ErrorOr<size_t> write_bytes_for_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer const& data) { return write_bytes_locked(offset, length, data, nullptr); }
     virtual ErrorOr<void> truncate_locked(u64) { return {}; }
 
 private:
+    ErrorOr<void> read_ahead(off_t, size_t) const;
+
+    bool can_use_page_cache(OpenFileDescription const*) const;
+    RefPtr<Memory::PhysicalRAMPage> find_cached_page_locked(u64 page_index) const;
+
+    // Page cache pages are only mapped into kernel memory while we copy from or to them, this many at a time.
+    static constexpr size_t max_pages_per_mapping = 16;
+    using CachedPages = Vector<NonnullRefPtr<Memory::PhysicalRAMPage>, max_pages_per_mapping>;
+
+    // Appends the cached pages starting at the given page, up to the first one that isn't cached.
+    void find_cached_pages_locked(u64 first_page_index, size_t page_count, CachedPages&) const;
+    // Appends the given pages, reading in the ones that aren't cached yet. If memory runs out, this stops
+    // early and only fails with ENOMEM if it didn't get any pages at all.
+    ErrorOr<void> get_or_read_cached_pages_locked(u64 first_page_index, size_t page_count, CachedPages&) const;
+
+    ErrorOr<size_t> read_bytes_from_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
+    ErrorOr<size_t> write_bytes_to_page_cache_locked(off_t, size_t, UserOrKernelBuffer const& data);
+    ErrorOr<void> update_cached_pages_locked(off_t, size_t, UserOrKernelBuffer const& data);
+    ErrorOr<void> write_back_cached_pages_locked();
+
     struct Flock {
         off_t start;
         off_t len;
@@ -139,6 +184,7 @@ private:
     FileSystem& m_file_system;
     InodeIndex m_index { 0 };
     LockWeakPtr<Memory::SharedInodeVMObject> m_shared_vmobject;
+    mutable InodePageCache m_page_cache;
     LockWeakPtr<LocalSocket> m_bound_socket;
     SpinlockProtected<HashTable<InodeWatcher*>, LockRank::None> m_watchers {};
     bool m_metadata_dirty { false };
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <Kernel/FileSystem/InodePageCache.h>
+
+namespace Kernel {
+
+RefPtr<Memory::PhysicalRAMPage> InodePageCache::find_page(u64 page_index) const
+{
+    return m_state.with([&](auto const& state) -> RefPtr<Memory::PhysicalRAMPage> {
+        auto it = state.pages.find(page_index);
+        if (it == state.pages.end())
+            return nullptr;
+        return it->value.page;
+    });
+}
+
+ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> InodePageCache::add_page(u64 page_index, NonnullRefPtr<Memory::PhysicalRAMPage> page)
+{
+    return m_state.with([&](auto& state) -> ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> {
+        if (auto it = state.pages.find(page_index); it != state.pages.end())
+            return it->value.page;
+        TRY(state.pages.try_set(page_index, CachedPage { page, false }));
+        return page;
+    });
+}
+
+void InodePageCache::set_page_dirty(u64 page_index)
+{
+    m_state.with([&](auto& state) {
+        auto it = state.pages.find(page_index);
+        if (it == state.pages.end() || it->value.is_dirty)
+            return;
+        it->value.is_dirty = true;
+        ++state.dirty_page_count;
+    });
+}
+
+ErrorOr<Vector<InodePageCache::DirtyPage>> InodePageCache::take_dirty_pages()
+{
+    return m_state.with([&](auto& state) -> ErrorOr<Vector<DirtyPage>> {
+        Vector<DirtyPage> dirty_pages;
+        TRY(dirty_pages.try_ensure_capacity(state.dirty_page_count));
+        for (auto& it : state.pages) {
+            if (!it.value.is_dirty)
+                continue;
+            dirty_pages.unchecked_append({ it.key, it.value.page });
+            it.value.is_dirty = false;
+        }
+        state.dirty_page_count = 0;
+
+        // Write pages back in file order, which keeps the file system's block accesses sequential.
+        quick_sort(dirty_pages, [](auto& a, auto& b) { return a.page_index < b.page_index; });
+        return dirty_pages;
+    });
+}
+
+void InodePageCache::remove_pages_starting_at(u64 first_page_index)
+{
+    m_state.with([&](auto& state) {
+        state.pages.remove_all_matching([&](u64 page_index, CachedPage const& cached_page) {
+            if (page_index < first_page_index)
+                return false;
+            if (cached_page.is_dirty)
+                --state.dirty_page_count;
+            return true;
+        });
+    });
+}
+
+size_t InodePageCache::try_release_clean_pages(size_t page_count)
+{
+    return m_state.with([&](auto& state) {
+        size_t released_page_count = 0;
+        state.pages.remove_all_matching([&](u64, CachedPage const& cached_page) {
+            if (released_page_count >= page_count)
+                return false;
+            // Pages that are still mapped somewhere wouldn't be freed anyway.
+            if (cached_page.is_dirty || cached_page.page->ref_count() > 1)
+                return false;
+            ++released_page_count;
+            return true;
+        });
+        return released_page_count;
+    });
+}
+
+bool InodePageCache::has_pages() const
+{
+    return m_state.with([](auto const& state) { return !state.pages.is_empty(); });
+}
+
+bool InodePageCache::has_dirty_pages() const
+{
+    return m_state.with([](auto const& state) { return state.dirty_page_count > 0; });
+}
+
+size_t InodePageCache::dirty_page_count() const
+{
+    return m_state.with([](auto const& state) { return state.dirty_page_count; });
+}
+
+}
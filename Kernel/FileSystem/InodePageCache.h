@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/PhysicalRAMPage.h>
+
+namespace Kernel {
+
+// The pages of a regular file's contents that are currently held in memory, indexed by their
+// position in the file. read() and write() go through them, and shared mappings of the file map
+// the very same physical pages, so each page of cached file data only exists once.
+//
+// Pages modified by write() are only marked dirty here and written back to the file system later.
+// Clean pages that aren't mapped anywhere can be dropped at any time to relieve memory pressure.
+class InodePageCache {
+    AK_MAKE_NONCOPYABLE(InodePageCache);
+    AK_MAKE_NONMOVABLE(InodePageCache);
+
+public:
+    struct DirtyPage {
+        u64 page_index { 0 };
+        NonnullRefPtr<Memory::PhysicalRAMPage> page;
+    };
+
+    InodePageCache() = default;
+
+    RefPtr<Memory::PhysicalRAMPage> find_page(u64 page_index) const;
+
+    // Returns the page that ends up being cached, which is the one that's already there if someone else was faster.
+    ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> add_page(u64 page_index, NonnullRefPtr<Memory::PhysicalRAMPage>);
+
+    void set_page_dirty(u64 page_index);
+
+    // Marks all dirty pages clean and returns them, so that they can be written back without holding our lock.
+    ErrorOr<Vector<DirtyPage>> take_dirty_pages();
+
+    void remove_pages_starting_at(u64 first_page_index);
+
+    size_t try_release_clean_pages(size_t page_count);
+
+    bool has_pages() const;
+    bool has_dirty_pages() const;
+    size_t dirty_page_count() const;
+
+private:
+    struct CachedPage {
+        NonnullRefPtr<Memory::PhysicalRAMPage> page;
+        bool is_dirty { false };
+    };
+
+    struct State {
+        HashMap<u64, CachedPage> pages;
+        size_t dirty_page_count { 0 };
+    };
+
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
@@ -53,6 +53,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    EPoll::description_will_be_destroyed({}, *this);
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -313,6 +314,25 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_epoll() const
+{
+    return m_file->is_epoll();
+}
+
+EPoll const* OpenFileDescription::epoll() const
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll const*>(m_file.ptr());
+}
+
+EPoll* OpenFileDescription::epoll()
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_mount_file() const
 {
     return m_file->is_mount_file();
@@ -543,6 +563,11 @@ off_t OpenFileDescription::offset() const
     return m_state.with([](auto& state) { return state.current_offset; });
 }
 
+Optional<ReadAheadRange> OpenFileDescription::did_read(u64 offset, size_t count)
+{
+    return m_state.with([&](auto& state) { return state.read_ahead.did_access(offset, count); });
+}
+
 RefPtr<Custody const> OpenFileDescription::custody() const
 {
     return m_state.with([](auto& state) { return state.custody; });
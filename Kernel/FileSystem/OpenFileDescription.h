@@ -10,9 +10,11 @@
 #include <AK/Badge.h>
 #include <AK/RefPtr.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/ReadAheadState.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KBuffer.h>
 #include <Kernel/Memory/VirtualAddress.h>
@@ -80,6 +82,10 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_epoll() const;
+    EPoll const* epoll() const;
+    EPoll* epoll();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
@@ -125,10 +131,14 @@ public:
 
     off_t offset() const;
 
+    Optional<ReadAheadRange> did_read(u64 offset, size_t count);
+
     ErrorOr<void> chown(Credentials const& credentials, UserID, GroupID);
 
     FileBlockerSet& blocker_set();
 
+    EPoll::InterestList& epoll_interests(Badge<EPoll>) { return m_epoll_interests; }
+
     ErrorOr<void> apply_flock(Process const&, Userspace<flock const*>, ShouldBlock);
     ErrorOr<void> get_flock(Userspace<flock*>) const;
 
@@ -145,10 +155,14 @@ private:
     RefPtr<Inode> m_inode;
     NonnullRefPtr<File> const m_file;
 
+    // Guarded by EPoll's description link lock.
+    EPoll::InterestList m_epoll_interests;
+
     struct State {
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        ReadAheadState read_ahead;
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
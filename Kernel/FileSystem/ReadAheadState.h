@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+struct ReadAheadRange {
+    u64 offset { 0 };
+    u64 length { 0 };
+};
+
+// ReadAheadState detects sequential access patterns and decides how much data should be
+// read ahead of the current position. The window starts small as soon as an access follows
+// the previous one, doubles every time more data is read ahead, and closes again on the
+// first non-sequential access.
+class ReadAheadState {
+public:
+    static constexpr u64 MinimumWindowSize = 16 * KiB;
+    static constexpr u64 MaximumWindowSize = 256 * KiB;
+
+    Optional<ReadAheadRange> did_access(u64 offset, u64 length)
+    {
+        if (length == 0)
+            return {};
+
+        auto end = offset + length;
+        // NOTE: A first access has nothing to follow, so it doesn't count as sequential, even at offset 0.
+        if (!m_next_expected_offset.has_value() || offset != m_next_expected_offset.value()) {
+            m_next_expected_offset = end;
+            m_read_ahead_end = end;
+            m_window_size = 0;
+            return {};
+        }
+        m_next_expected_offset = end;
+
+        if (m_window_size == 0)
+            m_window_size = MinimumWindowSize;
+
+        // NOTE: Don't read ahead again until at least half of the previous window has been consumed.
+        if (m_read_ahead_end > end && m_read_ahead_end - end >= m_window_size / 2)
+            return {};
+
+        auto start = max(end, m_read_ahead_end);
+        m_read_ahead_end = end + m_window_size;
+        ReadAheadRange range { start, m_read_ahead_end - start };
+        m_window_size = min(m_window_size * 2, MaximumWindowSize);
+        return range;
+    }
+
+private:
+    Optional<u64> m_next_expected_offset;
+    u64 m_read_ahead_end { 0 };
+    u64 m_window_size { 0 };
+};
+
+}
@@ -41,6 +41,15 @@ ErrorOr<void> SysFSNetworkTCPStats::try_generate(KBufferBuilder& builder)
         TRY(obj.add("bytes_in"sv, socket.bytes_in()));
         TRY(obj.add("packets_out"sv, socket.packets_out()));
         TRY(obj.add("bytes_out"sv, socket.bytes_out()));
+        TRY(obj.add("retransmits"sv, socket.retransmits()));
+        auto& congestion_control = socket.congestion_control();
+        TRY(obj.add("congestion_control"sv, TCPCongestionControl::to_string(congestion_control.algorithm())));
+        TRY(obj.add("congestion_window"sv, congestion_control.congestion_window()));
+        TRY(obj.add("slow_start_threshold"sv, congestion_control.slow_start_threshold()));
+        TRY(obj.add("fast_retransmits"sv, congestion_control.fast_retransmits()));
+        TRY(obj.add("smoothed_rtt_us"sv, socket.smoothed_round_trip_time().to_microseconds()));
+        TRY(obj.add("rtt_variance_us"sv, socket.round_trip_time_variance().to_microseconds()));
+        TRY(obj.add("retransmission_timeout_ms"sv, socket.retransmission_timeout().to_milliseconds()));
         auto current_process_credentials = Process::current().credentials();
         if (current_process_credentials->is_superuser() || current_process_credentials->uid() == socket.origin_uid()) {
             TRY(obj.add("origin_pid"sv, socket.origin_pid().value()));
@@ -22,7 +22,9 @@ class Custody;
 class Device;
 class DeviceControlDevice;
 class DiskCache;
+class DiskCacheShard;
 class DoubleBuffer;
+class EPoll;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -85,6 +87,7 @@ class PhysicalRegion;
 class PrivateInodeVMObject;
 class Region;
 class SharedInodeVMObject;
+class TLBFlushBatch;
 class VMObject;
 class VirtualRange;
 }
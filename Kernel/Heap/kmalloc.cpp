@@ -7,9 +7,11 @@
 #include <AK/Assertions.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/PageDirectory.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -28,6 +30,9 @@ static_assert(is_power_of_two(CHUNK_SIZE));
 
 static constexpr size_t INITIAL_KMALLOC_MEMORY_SIZE = 16 * MiB;
 static constexpr size_t KMALLOC_DEFAULT_ALIGNMENT = 16;
+static constexpr size_t KMALLOC_SLABHEAP_COUNT = 6;
+static constexpr size_t KMALLOC_MAGAZINE_CAPACITY = 32;
+static constexpr size_t KMALLOC_MAGAZINE_BATCH_SIZE = KMALLOC_MAGAZINE_CAPACITY / 2;
 
 enum class CallerHasAcquiredLock {
     No,
@@ -108,6 +113,8 @@ public:
         return m_freelist == nullptr;
     }
 
+    size_t slab_size() const { return m_slab_size; }
+
     size_t allocated_bytes() const
     {
         return m_allocated_slabs * m_slab_size;
@@ -176,7 +183,11 @@ public:
 #ifndef HAS_ADDRESS_SANITIZER
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
 #endif
+        deallocate_scrubbed(ptr);
+    }
 
+    void deallocate_scrubbed(void* ptr)
+    {
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -353,7 +364,7 @@ struct KmallocGlobalData {
             return false;
         }
 
-        auto physical_pages_or_error = MM.commit_physical_pages(new_subheap_size / PAGE_SIZE);
+        auto physical_pages_or_error = MM.commit_physical_pages(new_subheap_size / PAGE_SIZE, Memory::MemoryManager::ShouldReclaimPageCache::No);
         if (physical_pages_or_error.is_error()) {
             dbgln_if(KMALLOC_DEBUG, "Out of address space when expanding kmalloc heap");
             return false;
@@ -423,7 +434,16 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
+
+    Optional<size_t> slabheap_index_for(size_t size, size_t alignment) const
+    {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size() && alignment <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
 
     bool expansion_in_progress { false };
 };
@@ -436,9 +456,108 @@ static size_t g_kfree_call_count;
 static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// NOTE: Every processor keeps a magazine of free slabs for each slab size, so that most small
+//       allocations and frees don't have to take s_lock. Magazines are refilled from and drained
+//       to the global slab heaps in batches of KMALLOC_MAGAZINE_BATCH_SIZE slabs.
+//       Magazines are only ever touched by their own processor with interrupts disabled.
+struct KmallocMagazine {
+    size_t count { 0 };
+    void* slabs[KMALLOC_MAGAZINE_CAPACITY] {};
+};
+
+struct KmallocPerProcessorData {
+    KmallocMagazine magazines[KMALLOC_SLABHEAP_COUNT] {};
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t magazine_hit_count { 0 };
+    size_t magazine_refill_count { 0 };
+    size_t magazine_drain_count { 0 };
+};
+
+static KmallocPerProcessorData s_per_processor_data[MAX_CPU_COUNT];
+
+// NOTE: The magazines get in the way of the precise shadow memory tracking done by KASAN.
+#ifdef HAS_ADDRESS_SANITIZER
+static constexpr bool s_magazines_available = false;
+#else
+static constexpr bool s_magazines_available = true;
+#endif
+static bool s_magazines_enabled { false };
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
+    s_magazines_enabled = s_magazines_available;
+}
+
+static void* try_allocate_from_magazine(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    if (!s_magazines_enabled || g_dump_kmalloc_stacks)
+        return nullptr;
+    auto slabheap_index = g_kmalloc_global->slabheap_index_for(size, alignment);
+    if (!slabheap_index.has_value())
+        return nullptr;
+    auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index.value()];
+
+    void* ptr = nullptr;
+    {
+        InterruptDisabler disabler;
+        auto& data = s_per_processor_data[Processor::current_id()];
+        auto& magazine = data.magazines[slabheap_index.value()];
+        if (magazine.count == 0) {
+            SpinlockLocker lock(s_lock);
+            while (magazine.count < KMALLOC_MAGAZINE_BATCH_SIZE) {
+                auto* slab = slabheap.allocate(slabheap.slab_size(), CallerWillInitializeMemory::Yes);
+                if (!slab)
+                    break;
+                magazine.slabs[magazine.count++] = slab;
+            }
+            ++data.magazine_refill_count;
+            if (magazine.count == 0)
+                return nullptr;
+        } else {
+            ++data.magazine_hit_count;
+        }
+
+        ++data.kmalloc_call_count;
+        ptr = magazine.slabs[--magazine.count];
+    }
+
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static bool try_deallocate_to_magazine(void* ptr, size_t size)
+{
+    if (!s_magazines_enabled || size > g_kmalloc_global->slabheaps[KMALLOC_SLABHEAP_COUNT - 1].slab_size())
+        return false;
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+
+    // NOTE: Allocations with a large alignment may have come from a bigger slab than their size suggests,
+    //       so we have to ask the slab block which size class this slab actually belongs to.
+    auto const* block = (KmallocSlabBlock const*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
+    auto slab_size = block->slab_size();
+    auto slabheap_index = g_kmalloc_global->slabheap_index_for(slab_size, 1);
+    VERIFY(slabheap_index.has_value());
+    VERIFY(g_kmalloc_global->slabheaps[slabheap_index.value()].slab_size() == slab_size);
+
+    memset(ptr, KFREE_SCRUB_BYTE, slab_size);
+
+    InterruptDisabler disabler;
+    auto& data = s_per_processor_data[Processor::current_id()];
+    auto& magazine = data.magazines[slabheap_index.value()];
+    if (magazine.count == KMALLOC_MAGAZINE_CAPACITY) {
+        SpinlockLocker lock(s_lock);
+        auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index.value()];
+        while (magazine.count > KMALLOC_MAGAZINE_CAPACITY - KMALLOC_MAGAZINE_BATCH_SIZE)
+            slabheap.deallocate_scrubbed(magazine.slabs[--magazine.count]);
+        ++data.magazine_drain_count;
+    }
+    magazine.slabs[magazine.count++] = ptr;
+
+    ++data.kfree_call_count;
+    return true;
 }
 
 UNMAP_AFTER_INIT void kmalloc_init()
@@ -450,6 +569,19 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
+static void record_kmalloc_perf_event(size_t size, void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread) {
+        // FIXME: By the time we check this, we have already allocated above.
+        //        This means that in the case of an infinite recursion, we can't catch it this way.
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
+    }
+}
+
 static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory, CallerHasAcquiredLock caller_has_acquired_lock)
 {
     // Catch bad callers allocating under spinlock.
@@ -460,6 +592,13 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
+    if (caller_has_acquired_lock == CallerHasAcquiredLock::No) {
+        if (auto* ptr = try_allocate_from_magazine(size, alignment, caller_will_initialize_memory)) {
+            record_kmalloc_perf_event(size, ptr);
+            return ptr;
+        }
+    }
+
     Optional<SpinlockLocker<Spinlock<Kernel::LockRank::None>>> maybe_lock = {};
     if (caller_has_acquired_lock == CallerHasAcquiredLock::No)
         maybe_lock = SpinlockLocker(s_lock);
@@ -472,17 +611,7 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     }
 
     void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
-
-    Thread* current_thread = Thread::current();
-    if (!current_thread)
-        current_thread = Processor::idle_thread();
-    if (current_thread) {
-        // FIXME: By the time we check this, we have already allocated above.
-        //        This means that in the case of an infinite recursion, we can't catch it this way.
-        VERIFY(current_thread->is_allocation_enabled());
-        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
-    }
-
+    record_kmalloc_perf_event(size, ptr);
     return ptr;
 }
 
@@ -534,6 +663,20 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (!ptr)
+        return;
+
+    if (try_deallocate_to_magazine(ptr, size)) {
+        Thread* current_thread = Thread::current();
+        if (!current_thread)
+            current_thread = Processor::idle_thread();
+        if (current_thread) {
+            VERIFY(current_thread->is_allocation_enabled());
+            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+        }
+        return;
+    }
+
     SpinlockLocker lock(s_lock);
     kfree_sized_impl(ptr, size);
 }
@@ -624,4 +767,23 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    stats.bytes_in_magazines = 0;
+    stats.magazine_hit_count = 0;
+    stats.magazine_refill_count = 0;
+    stats.magazine_drain_count = 0;
+
+    // NOTE: We don't lock the other processors' magazines, so these numbers are only a snapshot.
+    for (auto const& data : s_per_processor_data) {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i)
+            stats.bytes_in_magazines += data.magazines[i].count * g_kmalloc_global->slabheaps[i].slab_size();
+        stats.kmalloc_call_count += data.kmalloc_call_count;
+        stats.kfree_call_count += data.kfree_call_count;
+        stats.magazine_hit_count += data.magazine_hit_count;
+        stats.magazine_refill_count += data.magazine_refill_count;
+        stats.magazine_drain_count += data.magazine_drain_count;
+    }
+
+    // Slabs sitting in a magazine are free as far as the users of kmalloc are concerned.
+    stats.bytes_allocated -= stats.bytes_in_magazines;
+    stats.bytes_free += stats.bytes_in_magazines;
 }
@@ -12,6 +12,7 @@
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/PowerStateSwitchTask.h>
@@ -106,6 +107,16 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
             return EPERM;
     }
 
+    // Unmap the regions that are removed entirely up front, so that their mappings are flushed all at once.
+    // This has to be done before they are deallocated, which may free their physical pages.
+    {
+        TLBFlushBatch flush_batch(page_directory());
+        for (auto* region : regions) {
+            if (region->range().intersect(range_to_unmap).size() == region->size())
+                region->unmap(flush_batch);
+        }
+    }
+
     Vector<Region*, 2> new_regions;
 
     for (auto* old_region : regions) {
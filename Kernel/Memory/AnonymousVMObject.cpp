@@ -139,8 +139,18 @@ AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalRAMPage>>&& new_p
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
-        for (size_t i = 0; i < page_count(); ++i)
-            physical_pages()[i] = m_unused_committed_pages->take_one();
+        size_t i = 0;
+        while (i < page_count()) {
+            // Use physically contiguous memory where we can, so regions that line up with large pages can be mapped with them.
+            if (large_pages_are_supported && i % pages_per_large_page == 0 && page_count() - i >= pages_per_large_page) {
+                if (auto large_page = m_unused_committed_pages->take_large_page(); !large_page.is_error()) {
+                    for (auto& page : large_page.value())
+                        physical_pages()[i++] = move(page);
+                    continue;
+                }
+            }
+            physical_pages()[i++] = m_unused_committed_pages->take_one();
+        }
     } else {
         auto& initial_page = (strategy == AllocationStrategy::Reserve) ? MM.lazy_committed_page() : MM.shared_zero_page();
         for (size_t i = 0; i < page_count(); ++i)
@@ -267,6 +277,37 @@ NonnullRefPtr<PhysicalRAMPage> AnonymousVMObject::allocate_committed_page(Badge<
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_populate_large_page(Badge<Region>, size_t first_page_index)
+{
+    if constexpr (!large_pages_are_supported)
+        return false;
+    if (is_purgeable())
+        return false;
+
+    SpinlockLocker lock(m_lock);
+
+    auto pages = physical_pages().slice(first_page_index, pages_per_large_page);
+    bool all_lazy_committed = true;
+    bool all_shared_zero = true;
+    for (auto const& page : pages) {
+        all_lazy_committed &= page && page->is_lazy_committed_page();
+        all_shared_zero &= page && page->is_shared_zero_page();
+    }
+
+    // Pages we have committed to come out of our own commitment, others have to come from the uncommitted pool.
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> large_page = ENOMEM;
+    if (all_lazy_committed && m_unused_committed_pages.has_value())
+        large_page = m_unused_committed_pages->take_large_page();
+    else if (all_shared_zero)
+        large_page = MM.allocate_large_physical_page();
+    if (large_page.is_error())
+        return false;
+
+    for (size_t i = 0; i < pages_per_large_page; ++i)
+        pages[i] = move(large_page.value()[i]);
+    return true;
+}
+
 void AnonymousVMObject::reset_cow_map()
 {
     for (size_t i = 0; i < page_count(); ++i) {
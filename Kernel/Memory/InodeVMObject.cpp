@@ -71,7 +71,9 @@ int InodeVMObject::try_release_clean_pages(int page_amount)
 
     int count = 0;
     for (size_t i = 0; i < page_count() && count < page_amount; ++i) {
-        if (!m_dirty_pages.get(i) && m_physical_pages[i]) {
+        // NOTE: Pages that are shared with somebody else (like the inode's page cache) wouldn't be freed by
+        //       dropping our reference, so we leave them mapped.
+        if (!m_dirty_pages.get(i) && m_physical_pages[i] && m_physical_pages[i]->ref_count() == 1) {
             m_physical_pages[i] = nullptr;
             ++count;
         }
@@ -91,4 +93,10 @@ u32 InodeVMObject::writable_mappings() const
     return count;
 }
 
+Optional<ReadAheadRange> InodeVMObject::did_page_in(size_t page_index)
+{
+    SpinlockLocker locker(m_lock);
+    return m_read_ahead_state.did_access(page_index * PAGE_SIZE, PAGE_SIZE);
+}
+
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Bitmap.h>
+#include <Kernel/FileSystem/ReadAheadState.h>
 #include <Kernel/Memory/VMObject.h>
 #include <Kernel/UnixTypes.h>
 
@@ -30,6 +31,8 @@ public:
 
     u32 writable_mappings() const;
 
+    Optional<ReadAheadRange> did_page_in(size_t page_index);
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalRAMPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalRAMPage>>&&, Bitmap dirty_pages);
@@ -42,6 +45,7 @@ protected:
 
     NonnullRefPtr<Inode> const m_inode;
     Bitmap m_dirty_pages;
+    ReadAheadState m_read_ahead_state;
 };
 
 }
@@ -954,6 +954,16 @@ PhysicalAddress MemoryManager::get_physical_address(PhysicalRAMPage const& physi
     return PhysicalAddress((PhysicalPtr)physical_page_entry_index * PAGE_SIZE);
 }
 
+static bool is_large_page(PageDirectoryEntry const& pde)
+{
+#if ARCH(X86_64)
+    return pde.is_present() && pde.is_huge();
+#else
+    (void)pde;
+    return false;
+#endif
+}
+
 PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress vaddr)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -967,6 +977,10 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     if (!pde.is_present())
         return nullptr;
 
+    // Large pages don't have a page table, so there is no entry to return.
+    if (is_large_page(pde))
+        return nullptr;
+
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
 
@@ -979,6 +993,12 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    if (is_large_page(pd[page_directory_index])) {
+        // Someone wants to change a single page, so the large page has to be broken up first.
+        if (!split_large_page(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
     auto& pde = pd[page_directory_index];
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
@@ -1020,6 +1040,13 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    if (is_large_page(pd[page_directory_index])) {
+        // Regions release whole large pages with release_large_page(), so we only get here
+        // when a part of one is unmapped.
+        if (!split_large_page(page_directory, vaddr))
+            PANIC("MM: Unable to split large page to release {}", vaddr);
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
@@ -1044,6 +1071,117 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+void MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool executable, bool user_allowed)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % LARGE_PAGE_SIZE == 0);
+    VERIFY(paddr.get() % LARGE_PAGE_SIZE == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    // The whole page table belongs to this large page, so nothing else can be using it.
+    Optional<PhysicalAddress> replaced_page_table;
+    if (pde.is_present() && !pde.is_huge())
+        replaced_page_table = PhysicalAddress { pde.page_table_base() };
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_present(true);
+    pde.set_writable(writable);
+    pde.set_user_allowed(user_allowed);
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!executable);
+
+    if (replaced_page_table.has_value()) {
+        // NOTE: Other processors may still be walking the old page table through their TLBs and paging structure caches,
+        //       so it can only be freed once they've all been flushed.
+        flush_tlb(&page_directory, vaddr, LARGE_PAGE_SIZE / PAGE_SIZE);
+        get_physical_page_entry(*replaced_page_table).allocated.physical_page.unref();
+    }
+#else
+    (void)page_directory;
+    (void)vaddr;
+    (void)paddr;
+    (void)writable;
+    (void)executable;
+    (void)user_allowed;
+    VERIFY_NOT_REACHED();
+#endif
+}
+
+bool MemoryManager::release_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    if (vaddr.get() % LARGE_PAGE_SIZE != 0)
+        return false;
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!is_large_page(pde))
+        return false;
+    pde.clear();
+    return true;
+}
+
+bool MemoryManager::split_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    if (page_table_or_error.is_error()) {
+        dbgln("MM: Unable to allocate page table to split large page at {}", vaddr);
+        return false;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    // Allocating the page table may have purged memory and used the quickmap, so look the entry up again.
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    VERIFY(is_large_page(pde));
+
+    // Every small page keeps the permissions that the large page had.
+    auto* ptes = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        auto& pte = ptes[i];
+        pte.clear();
+        pte.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+        pte.set_present(true);
+        pte.set_writable(pde.is_writable());
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+    }
+
+    pde.clear();
+    pde.set_page_table_base(page_table->paddr().get());
+    pde.set_user_allowed(true);
+    pde.set_present(true);
+    pde.set_writable(true);
+    pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    flush_tlb(&page_directory, VirtualAddress { vaddr.get() & ~(LARGE_PAGE_SIZE - 1) }, pages_per_large_page);
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    VERIFY_NOT_REACHED();
+#endif
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     ProcessorSpecific<MemoryManagerData>::initialize();
@@ -1224,7 +1362,9 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region(size_t size
         name_kstring = TRY(KString::try_create(name));
     auto vmobject = TRY(AnonymousVMObject::try_create_with_size(size, strategy));
     auto region = TRY(Region::create_unplaced(move(vmobject), 0, move(name_kstring), access, memory_type));
-    TRY(m_global_data.with([&](auto& global_data) { return global_data.region_tree.place_anywhere(*region, RandomizeVirtualAddress::No, size); }));
+    // Line big regions up with large pages, so that they can be mapped with them.
+    size_t alignment = (large_pages_are_supported && size >= LARGE_PAGE_SIZE) ? LARGE_PAGE_SIZE : PAGE_SIZE;
+    TRY(m_global_data.with([&](auto& global_data) { return global_data.region_tree.place_anywhere(*region, RandomizeVirtualAddress::No, size, alignment); }));
     TRY(region->map(kernel_page_directory()));
     return region;
 }
@@ -1268,20 +1408,31 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region_with_vmobje
     return region;
 }
 
-ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count)
+ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count, ShouldReclaimPageCache should_reclaim_page_cache)
 {
     VERIFY(page_count > 0);
-    auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
-        if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
-            dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
-            return ENOMEM;
-        }
+    size_t available_page_count = 0;
+    auto try_commit = [&] {
+        return m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+            if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
+                available_page_count = global_data.system_memory_info.physical_pages_uncommitted;
+                return ENOMEM;
+            }
 
-        global_data.system_memory_info.physical_pages_uncommitted -= page_count;
-        global_data.system_memory_info.physical_pages_committed += page_count;
-        return CommittedPhysicalPageSet { {}, page_count };
-    });
+            global_data.system_memory_info.physical_pages_uncommitted -= page_count;
+            global_data.system_memory_info.physical_pages_committed += page_count;
+            return CommittedPhysicalPageSet { {}, page_count };
+        });
+    };
+    auto result = try_commit();
+    if (result.is_error() && should_reclaim_page_cache == ShouldReclaimPageCache::Yes) {
+        // Clean page cache pages can always be read in again, so they shouldn't stand in the way of a commit.
+        // NOTE: Freeing the pages takes the global lock, so this can't happen while we're holding it.
+        if (Inode::release_clean_cached_pages(page_count - available_page_count) > 0)
+            result = try_commit();
+    }
     if (result.is_error()) {
+        dbgln("MM: Unable to commit {} pages, have only {}", page_count, available_page_count);
         Process::for_each_ignoring_process_lists([&](Process const& process) {
             size_t amount_resident = 0;
             size_t amount_shared = 0;
@@ -1386,59 +1537,76 @@ NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(B
 
 ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge, MemoryType memory_type_for_zero_fill)
 {
-    return m_global_data.with([&](auto& global_data) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
-        auto page = find_free_physical_page(false, global_data);
-        bool purged_pages = false;
-
-        if (!page) {
-            // We didn't have a single free physical page. Let's try to free something up!
-            // First, we look for a purgeable VMObject in the volatile state.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_anonymous())
-                    return IterationDecision::Continue;
-                auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
-                if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
-                    return IterationDecision::Continue;
-                if (auto purged_page_count = anonymous_vmobject.purge()) {
-                    dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                    page = find_free_physical_page(false, global_data);
-                    purged_pages = true;
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
+    auto try_allocate = [&] {
+        return m_global_data.with([&](auto& global_data) {
+            return find_free_physical_page(false, global_data);
+        });
+    };
+
+    // NOTE: Freeing pages takes the global lock, so we must not be holding it while we try to free something up.
+    //       That also means somebody else may grab the pages we freed before we do, in which case we keep looking.
+    auto page = try_allocate();
+    bool purged_pages = false;
+
+    if (!page) {
+        // We didn't have a single free physical page. Let's try to free something up!
+        // First, we look for a purgeable VMObject in the volatile state.
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_anonymous())
                 return IterationDecision::Continue;
-            });
-        }
-        if (!page) {
-            // Second, we look for a file-backed VMObject with clean pages.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_inode())
-                    return IterationDecision::Continue;
-                auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
-                if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
-                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false, global_data);
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
+            auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+            if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
                 return IterationDecision::Continue;
-            });
-        }
-        if (!page) {
-            dmesgln("MM: no physical pages available");
-            return ENOMEM;
+            if (auto purged_page_count = anonymous_vmobject.purge()) {
+                dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
+                purged_pages = true;
+                return IterationDecision::Break;
+            }
+            return IterationDecision::Continue;
+        });
+        if (purged_pages)
+            page = try_allocate();
+    }
+    if (!page) {
+        // Second, we look for a file-backed VMObject with clean pages that nobody else holds on to.
+        bool released_pages = false;
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_inode())
+                return IterationDecision::Continue;
+            auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
+            if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
+                dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
+                released_pages = true;
+                return IterationDecision::Break;
+            }
+            return IterationDecision::Continue;
+        });
+        if (released_pages)
+            page = try_allocate();
+    }
+    if (!page) {
+        // Third, we drop clean pages from the page cache. Mapped files share those pages with their InodeVMObjects,
+        // so this is where most clean file pages actually get freed.
+        if (auto released_page_count = Inode::release_clean_cached_pages(Inode::page_cache_eviction_batch_size)) {
+            dbgln("MM: Page cache release saved the day! Released {} pages from the page cache", released_page_count);
+            page = try_allocate();
         }
+    }
+    if (!page) {
+        dmesgln("MM: no physical pages available");
+        return ENOMEM;
+    }
 
-        if (should_zero_fill == ShouldZeroFill::Yes) {
-            auto* ptr = quickmap_page(*page, memory_type_for_zero_fill);
-            memset(ptr, 0, PAGE_SIZE);
-            unquickmap_page();
-        }
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(*page, memory_type_for_zero_fill);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
 
-        if (did_purge)
-            *did_purge = purged_pages;
-        return page.release_nonnull();
-    });
+    if (did_purge)
+        *did_purge = purged_pages;
+    return page.release_nonnull();
 }
 
 ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill)
@@ -1472,6 +1640,56 @@ ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguo
     return physical_pages;
 }
 
+ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::find_free_large_physical_page(GlobalData& global_data)
+{
+    for (auto& physical_region : global_data.physical_regions) {
+        auto physical_pages = physical_region->take_contiguous_free_pages(pages_per_large_page, LARGE_PAGE_SIZE);
+        if (!physical_pages.is_empty()) {
+            global_data.system_memory_info.physical_pages_used += pages_per_large_page;
+            return physical_pages;
+        }
+    }
+    return ENOMEM;
+}
+
+void MemoryManager::zero_fill_physical_pages(Span<NonnullRefPtr<PhysicalRAMPage>> physical_pages)
+{
+    for (auto& page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(*page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+}
+
+ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_committed_large_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
+{
+    auto physical_pages = TRY(m_global_data.with([&](auto& global_data) -> ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> {
+        VERIFY(global_data.system_memory_info.physical_pages_committed >= pages_per_large_page);
+        auto physical_pages = TRY(find_free_large_physical_page(global_data));
+        global_data.system_memory_info.physical_pages_committed -= pages_per_large_page;
+        return physical_pages;
+    }));
+    if (should_zero_fill == ShouldZeroFill::Yes)
+        zero_fill_physical_pages(physical_pages);
+    return physical_pages;
+}
+
+ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_large_physical_page(ShouldZeroFill should_zero_fill)
+{
+    auto physical_pages = TRY(m_global_data.with([&](auto& global_data) -> ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> {
+        // We need to make sure we don't touch pages that we have committed to
+        if (global_data.system_memory_info.physical_pages_uncommitted < pages_per_large_page)
+            return ENOMEM;
+        auto physical_pages = TRY(find_free_large_physical_page(global_data));
+        global_data.system_memory_info.physical_pages_uncommitted -= pages_per_large_page;
+        return physical_pages;
+    }));
+    if (should_zero_fill == ShouldZeroFill::Yes)
+        zero_fill_physical_pages(physical_pages);
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
@@ -1637,6 +1855,15 @@ NonnullRefPtr<PhysicalRAMPage> CommittedPhysicalPageSet::take_one()
     return MM.allocate_committed_physical_page({}, MemoryManager::ShouldZeroFill::Yes);
 }
 
+ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> CommittedPhysicalPageSet::take_large_page()
+{
+    if (m_page_count < pages_per_large_page)
+        return ENOMEM;
+    auto physical_pages = TRY(MM.allocate_committed_large_physical_page({}));
+    m_page_count -= pages_per_large_page;
+    return physical_pages;
+}
+
 void CommittedPhysicalPageSet::uncommit_one()
 {
     VERIFY(m_page_count > 0);
@@ -1651,6 +1878,15 @@ void MemoryManager::copy_physical_page(PhysicalRAMPage& physical_page, u8 page_b
     unquickmap_page();
 }
 
+void MemoryManager::zero_physical_page_range(PhysicalRAMPage& physical_page, size_t offset_in_page, size_t size)
+{
+    VERIFY(offset_in_page + size <= PAGE_SIZE);
+    InterruptDisabler disabler;
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memset(quickmapped_page + offset_in_page, 0, size);
+    unquickmap_page();
+}
+
 ErrorOr<NonnullOwnPtr<Memory::Region>> MemoryManager::create_identity_mapped_region(PhysicalAddress address, size_t size)
 {
     auto vmobject = TRY(Memory::AnonymousVMObject::try_create_for_physical_range(address, size));
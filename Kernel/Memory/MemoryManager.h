@@ -34,6 +34,16 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return x & ~(PAGE_SIZE - 1);
 }
 
+// A large page is mapped by a single page directory entry instead of a whole page table,
+// so it only takes up a single TLB entry.
+#if ARCH(X86_64)
+static constexpr bool large_pages_are_supported = true;
+#else
+static constexpr bool large_pages_are_supported = false;
+#endif
+static constexpr size_t LARGE_PAGE_SIZE = 2 * MiB;
+static constexpr size_t pages_per_large_page = LARGE_PAGE_SIZE / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - g_boot_info.physical_to_virtual_offset;
@@ -116,6 +126,7 @@ public:
     size_t page_count() const { return m_page_count; }
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> take_one();
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> take_large_page();
     void uncommit_one();
 
     void operator=(CommittedPhysicalPageSet&&) = delete;
@@ -162,12 +173,19 @@ public:
         Yes
     };
 
-    ErrorOr<CommittedPhysicalPageSet> commit_physical_pages(size_t page_count);
+    // Reclaiming clean page cache pages frees kernel memory, which kmalloc can't allow while it expands its heap.
+    enum class ShouldReclaimPageCache {
+        No,
+        Yes,
+    };
+    ErrorOr<CommittedPhysicalPageSet> commit_physical_pages(size_t page_count, ShouldReclaimPageCache = ShouldReclaimPageCache::Yes);
     void uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, size_t page_count);
 
     NonnullRefPtr<PhysicalRAMPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalRAMPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr, MemoryType memory_type_for_zero_fill = MemoryType::Normal);
     ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill);
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_committed_large_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_large_physical_page(ShouldZeroFill = ShouldZeroFill::Yes);
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, MemoryType = MemoryType::Normal);
@@ -228,6 +246,7 @@ public:
     PhysicalAddress get_physical_address(PhysicalRAMPage const&);
 
     void copy_physical_page(PhysicalRAMPage&, u8 page_buffer[PAGE_SIZE]);
+    void zero_physical_page_range(PhysicalRAMPage&, size_t offset_in_page, size_t size);
 
     IterationDecision for_each_physical_memory_range(Function<IterationDecision(PhysicalMemoryRange const&)>);
 
@@ -268,6 +287,8 @@ private:
     static void flush_tlb(PageDirectory const*, VirtualAddress, size_t page_count = 1);
 
     RefPtr<PhysicalRAMPage> find_free_physical_page(bool, GlobalData&);
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> find_free_large_physical_page(GlobalData&);
+    void zero_fill_physical_pages(Span<NonnullRefPtr<PhysicalRAMPage>>);
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalRAMPage& page, MemoryType memory_type = Memory::MemoryType::Normal)
     {
@@ -287,6 +308,10 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    void map_large_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool executable, bool user_allowed);
+    bool release_large_page(PageDirectory&, VirtualAddress);
+    bool split_large_page(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
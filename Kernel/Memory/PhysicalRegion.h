@@ -35,7 +35,7 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(size_t);
 
     RefPtr<PhysicalRAMPage> take_free_page();
-    Vector<NonnullRefPtr<PhysicalRAMPage>> take_contiguous_free_pages(size_t count);
+    Vector<NonnullRefPtr<PhysicalRAMPage>> take_contiguous_free_pages(size_t count, PhysicalSize alignment = PAGE_SIZE);
     void return_page(PhysicalAddress);
 
 private:
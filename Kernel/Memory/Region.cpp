@@ -7,6 +7,8 @@
 #include <AK/StringView.h>
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Arch/PageFault.h>
+#include <Kernel/Arch/SafeMem.h>
+#include <Kernel/Arch/SmapDisabler.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
@@ -16,6 +18,7 @@
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/Region.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/Thread.h>
@@ -98,7 +101,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::create_unplaced(NonnullLockRefPtr<VMObjec
     return adopt_nonnull_own_or_enomem(new (nothrow) Region(move(vmobject), offset_in_vmobject, move(name), access, memory_type, shared));
 }
 
-ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
+ErrorOr<NonnullOwnPtr<Region>> Region::try_clone(TLBFlushBatch& flush_batch)
 {
     VERIFY(Process::has_current());
 
@@ -128,7 +131,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
 
     // Set up a COW region. The parent (this) region becomes COW as well!
     if (is_writable())
-        remap();
+        remap(flush_batch);
 
     OwnPtr<KString> clone_region_name;
     if (m_name)
@@ -266,6 +269,57 @@ bool Region::map_individual_page_impl(size_t page_index, PhysicalAddress paddr,
     return true;
 }
 
+Optional<PhysicalAddress> Region::large_page_physical_base(size_t page_index, ShouldLockVMObject should_lock_vmobject) const
+{
+    if constexpr (!large_pages_are_supported)
+        return {};
+
+    // A large page has to cover its whole page table's worth of address space, all with the same permissions.
+    if (vaddr_from_page_index(page_index).get() % LARGE_PAGE_SIZE != 0 || page_index + pages_per_large_page > page_count())
+        return {};
+    if (!vmobject().is_anonymous() || m_memory_type != MemoryType::Normal || !is_readable())
+        return {};
+
+    auto find_base = [&]() -> Optional<PhysicalAddress> {
+        VERIFY(vmobject().m_lock.is_locked());
+        auto pages = vmobject().physical_pages().slice(translate_to_vmobject_page(page_index), pages_per_large_page);
+        if (!pages[0] || pages[0]->paddr().get() % LARGE_PAGE_SIZE != 0)
+            return {};
+        auto base = pages[0]->paddr();
+        for (size_t i = 0; i < pages_per_large_page; ++i) {
+            auto const& page = pages[i];
+            if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page())
+                return {};
+            if (page->paddr() != base.offset(i * PAGE_SIZE))
+                return {};
+            // Pages that still have to be copied on write need their own read-only mapping.
+            if (should_cow(page_index + i))
+                return {};
+        }
+        return base;
+    };
+
+    if (should_lock_vmobject == ShouldLockVMObject::Yes) {
+        SpinlockLocker locker(vmobject().m_lock);
+        return find_base();
+    }
+    return find_base();
+}
+
+void Region::map_large_page_impl(size_t page_index, PhysicalAddress paddr)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+
+    bool user_allowed = page_vaddr.get() >= USER_RANGE_BASE && is_user_address(page_vaddr);
+    if (is_mmap() && !user_allowed) {
+        PANIC("About to map mmap'ed page at a kernel address");
+    }
+
+    MM.map_large_page(*m_page_directory, page_vaddr, paddr, is_writable(), is_executable(), user_allowed);
+}
+
 bool Region::map_individual_page_impl(size_t page_index, ShouldLockVMObject should_lock_vmobject)
 {
     RefPtr<PhysicalRAMPage> page = nullptr;
@@ -297,14 +351,28 @@ void Region::unmap(ShouldFlushTLB should_flush_tlb)
     unmap_with_locks_held(should_flush_tlb, pd_locker);
 }
 
+void Region::unmap(TLBFlushBatch& flush_batch)
+{
+    if (!m_page_directory)
+        return;
+    VERIFY(&flush_batch.page_directory() == m_page_directory.ptr());
+    flush_batch.add(range());
+    unmap(ShouldFlushTLB::No);
+}
+
 void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLocker<RecursiveSpinlock<LockRank::None>>&)
 {
     if (!m_page_directory)
         return;
     size_t count = page_count();
-    for (size_t i = 0; i < count; ++i) {
+    for (size_t i = 0; i < count;) {
         auto vaddr = vaddr_from_page_index(i);
+        if (count - i >= pages_per_large_page && MM.release_large_page(*m_page_directory, vaddr)) {
+            i += pages_per_large_page;
+            continue;
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
+        ++i;
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
         MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
@@ -329,6 +397,11 @@ ErrorOr<void> Region::map_impl(PageDirectory& page_directory, ShouldLockVMObject
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (auto large_page_base = large_page_physical_base(page_index, should_lock_vmobject); large_page_base.has_value()) {
+            map_large_page_impl(page_index, *large_page_base);
+            page_index += pages_per_large_page;
+            continue;
+        }
         if (!map_individual_page_impl(page_index, should_lock_vmobject))
             break;
         ++page_index;
@@ -367,14 +440,14 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, PhysicalAddress paddr,
     return ENOMEM;
 }
 
-void Region::remap_impl(ShouldLockVMObject should_lock_vmobject)
+void Region::remap_impl(ShouldLockVMObject should_lock_vmobject, ShouldFlushTLB should_flush_tlb)
 {
     VERIFY(m_page_directory);
     ErrorOr<void> result;
     if (m_vmobject->is_mmio())
-        result = map(*m_page_directory, static_cast<MMIOVMObject const&>(*m_vmobject).base_address());
+        result = map(*m_page_directory, static_cast<MMIOVMObject const&>(*m_vmobject).base_address(), should_flush_tlb);
     else
-        result = map_impl(*m_page_directory, should_lock_vmobject, ShouldFlushTLB::Yes);
+        result = map_impl(*m_page_directory, should_lock_vmobject, should_flush_tlb);
     if (result.is_error())
         TODO();
 }
@@ -389,6 +462,13 @@ void Region::remap()
     remap_impl(ShouldLockVMObject::Yes);
 }
 
+void Region::remap(TLBFlushBatch& flush_batch)
+{
+    VERIFY(&flush_batch.page_directory() == m_page_directory.ptr());
+    remap_impl(ShouldLockVMObject::Yes, ShouldFlushTLB::No);
+    flush_batch.add(range());
+}
+
 void Region::clear_to_zero()
 {
     VERIFY(vmobject().is_anonymous());
@@ -528,6 +608,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (!m_shared && try_handle_zero_fault_with_large_page(page_index_in_region))
+        return PageFaultResponse::Continue;
+
     RefPtr<PhysicalRAMPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -570,6 +653,37 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+bool Region::try_handle_zero_fault_with_large_page(size_t page_index_in_region)
+{
+    if constexpr (!large_pages_are_supported)
+        return false;
+    if (m_memory_type != MemoryType::Normal || !is_readable() || !is_writable())
+        return false;
+
+    auto large_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(LARGE_PAGE_SIZE - 1) };
+    if (!m_range.contains(VirtualRange { large_page_vaddr, LARGE_PAGE_SIZE }))
+        return false;
+
+    // If none of the surrounding pages have been touched yet, fault them all in at once.
+    auto first_page_index_in_region = page_index_from_address(large_page_vaddr);
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_populate_large_page({}, translate_to_vmobject_page(first_page_index_in_region)))
+        return false;
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    if (auto large_page_base = large_page_physical_base(first_page_index_in_region, ShouldLockVMObject::Yes); large_page_base.has_value()) {
+        map_large_page_impl(first_page_index_in_region, *large_page_base);
+    } else {
+        // Something (like a fork) got in the way, but the pages are populated now, so they still have to be mapped.
+        for (size_t i = 0; i < pages_per_large_page; ++i) {
+            if (!map_individual_page_impl(first_page_index_in_region + i, ShouldLockVMObject::Yes))
+                return false;
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, large_page_vaddr, pages_per_large_page);
+    return true;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -617,9 +731,43 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
 
+    if (inode.uses_page_cache()) {
+        // Mappings map the inode's page cache pages directly, so their contents exist only once.
+        // Private mappings get a copy of their own once they write to a page, see handle_dirty_on_write_fault().
+        auto page_or_error = inode.cached_page(page_index_in_vmobject);
+        if (page_or_error.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while reading from inode", page_or_error.error());
+            return PageFaultResponse::ShouldCrash;
+        }
+        auto page = page_or_error.release_value();
+        if (!page)
+            return PageFaultResponse::BusError;
+
+        if (auto read_ahead_range = inode_vmobject.did_page_in(page_index_in_vmobject); read_ahead_range.has_value())
+            inode.schedule_read_ahead(read_ahead_range->offset, read_ahead_range->length);
+
+        if (is_executable()) {
+            InterruptDisabler disabler;
+            u8* page_ptr = MM.quickmap_page(*page);
+            Processor::flush_instruction_cache(VirtualAddress { page_ptr }, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+
+        SpinlockLocker locker(inode_vmobject.m_lock);
+        if (physical_page_slot.is_null())
+            physical_page_slot = page;
+        // NOTE: A private mapping must never write to the page cache page, so we leave it clean (and thus read-only).
+        //       The write will fault again, and handle_dirty_on_write_fault() makes the copy.
+        if (mark_page_dirty && inode_vmobject.is_shared_inode())
+            inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
+        if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot, ShouldLockVMObject::No))
+            return PageFaultResponse::OutOfMemory;
+        return PageFaultResponse::Continue;
+    }
+
+    u8 page_buffer[PAGE_SIZE];
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
     auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
@@ -638,6 +786,9 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     if (nread < PAGE_SIZE)
         memset(page_buffer + nread, 0, PAGE_SIZE - nread);
 
+    if (auto read_ahead_range = inode_vmobject.did_page_in(page_index_in_vmobject); read_ahead_range.has_value())
+        inode.schedule_read_ahead(read_ahead_range->offset, read_ahead_range->length);
+
     // Allocate a new physical page, and copy the read inode contents into it.
     auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
     if (new_physical_page_or_error.is_error()) {
@@ -692,6 +843,8 @@ PageFaultResponse Region::handle_dirty_on_write_fault(size_t page_index_in_regio
         SpinlockLocker locker(inode_vmobject.m_lock);
 
         if (!physical_page_slot.is_null()) {
+            if (inode_vmobject.is_private_inode() && inode_vmobject.inode().uses_page_cache())
+                return handle_private_page_cache_write_fault(page_index_in_region);
             dbgln_if(PAGE_FAULT_DEBUG, "handle_dirty_on_write_fault: Marking page dirty and remapping.");
             inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
             if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot, ShouldLockVMObject::No))
@@ -706,6 +859,44 @@ PageFaultResponse Region::handle_dirty_on_write_fault(size_t page_index_in_regio
     return handle_inode_fault(page_index_in_region, true);
 }
 
+PageFaultResponse Region::handle_private_page_cache_write_fault(size_t page_index_in_region)
+{
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    VERIFY(inode_vmobject.m_lock.is_locked());
+    auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
+    auto& physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
+
+    // Clean pages of private mappings are still the inode's page cache pages, so make a copy before the first write.
+    dbgln_if(PAGE_FAULT_DEBUG, "handle_dirty_on_write_fault: Copying page cache page for private mapping.");
+    auto page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+    if (page_or_error.is_error()) {
+        dmesgln("MM: handle_dirty_on_write_fault was unable to allocate a physical page");
+        return PageFaultResponse::OutOfMemory;
+    }
+    auto page = page_or_error.release_value();
+
+    auto vaddr = this->vaddr().offset(page_index_in_region * PAGE_SIZE);
+    {
+        u8* dest_ptr = MM.quickmap_page(*page);
+        SmapDisabler disabler;
+        void* fault_at;
+        if (!safe_memcpy(dest_ptr, vaddr.as_ptr(), PAGE_SIZE, fault_at)) {
+            dbgln("handle_dirty_on_write_fault: Error copying page {}/{} to {} at {}", physical_page_slot->paddr(), vaddr, page->paddr(), VirtualAddress(fault_at));
+            MM.unquickmap_page();
+            return PageFaultResponse::ShouldCrash;
+        }
+        if (is_executable())
+            Processor::flush_instruction_cache(VirtualAddress { dest_ptr }, PAGE_SIZE);
+        MM.unquickmap_page();
+    }
+
+    physical_page_slot = move(page);
+    inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
+    if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot, ShouldLockVMObject::No))
+        return PageFaultResponse::OutOfMemory;
+    return PageFaultResponse::Continue;
+}
+
 RefPtr<PhysicalRAMPage> Region::physical_page_locked(size_t index) const
 {
     VERIFY(vmobject().m_lock.is_locked());
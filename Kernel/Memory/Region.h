@@ -105,7 +105,9 @@ public:
 
     PageFaultResponse handle_fault(PageFault const&);
 
-    ErrorOr<NonnullOwnPtr<Region>> try_clone();
+    // If this region is private and writable, its own pages are made copy-on-write as well.
+    // Flushing their stale writable mappings is left to the given batch.
+    ErrorOr<NonnullOwnPtr<Region>> try_clone(TLBFlushBatch&);
 
     [[nodiscard]] bool contains(VirtualAddress vaddr) const
     {
@@ -205,10 +207,12 @@ public:
     ErrorOr<void> map(PageDirectory&, ShouldFlushTLB = ShouldFlushTLB::Yes);
     ErrorOr<void> map(PageDirectory&, PhysicalAddress, ShouldFlushTLB = ShouldFlushTLB::Yes);
     void unmap(ShouldFlushTLB = ShouldFlushTLB::Yes);
+    void unmap(TLBFlushBatch&);
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock<LockRank::None>>& pd_locker);
 
     void remap_with_locked_vmobject();
     void remap();
+    void remap(TLBFlushBatch&);
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
@@ -253,13 +257,18 @@ private:
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index, bool mark_page_dirty = false);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalRAMPage& page_in_slot_at_time_of_fault);
     [[nodiscard]] PageFaultResponse handle_dirty_on_write_fault(size_t page_index);
+    [[nodiscard]] PageFaultResponse handle_private_page_cache_write_fault(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, ShouldLockVMObject);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalRAMPage>, ShouldLockVMObject);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, PhysicalAddress);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, PhysicalAddress, bool readable, bool writeable, ShouldLockVMObject);
 
-    void remap_impl(ShouldLockVMObject should_lock_vmobject);
+    [[nodiscard]] Optional<PhysicalAddress> large_page_physical_base(size_t page_index, ShouldLockVMObject) const;
+    void map_large_page_impl(size_t page_index, PhysicalAddress);
+    [[nodiscard]] bool try_handle_zero_fault_with_large_page(size_t page_index);
+
+    void remap_impl(ShouldLockVMObject should_lock_vmobject, ShouldFlushTLB = ShouldFlushTLB::Yes);
 
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 
@@ -51,7 +53,9 @@ SharedInodeVMObject::SharedInodeVMObject(SharedInodeVMObject const& other, Fixed
 
 ErrorOr<void> SharedInodeVMObject::sync(off_t offset_in_pages, size_t pages)
 {
-    return TRY(sync_impl(offset_in_pages, pages, true));
+    TRY(sync_impl(offset_in_pages, pages, true));
+    // The writes above only ended up in the inode's page cache.
+    return m_inode->write_back_cached_pages();
 }
 
 ErrorOr<void> SharedInodeVMObject::sync_before_destroying()
@@ -59,39 +63,66 @@ ErrorOr<void> SharedInodeVMObject::sync_before_destroying()
     return TRY(sync_impl(0, page_count(), false));
 }
 
-ErrorOr<void> SharedInodeVMObject::sync_impl(off_t offset_in_pages, size_t pages, bool should_remap)
+RefPtr<PhysicalRAMPage> SharedInodeVMObject::resident_page(size_t page_index) const
 {
     SpinlockLocker locker(m_lock);
+    if (page_index >= page_count())
+        return nullptr;
+    return m_physical_pages[page_index];
+}
 
-    size_t highest_page_to_flush = min(page_count(), offset_in_pages + pages);
-
-    AK::Vector<size_t> pages_to_flush = {};
-    TRY(pages_to_flush.try_ensure_capacity(highest_page_to_flush - offset_in_pages));
-
-    for (size_t page_index = offset_in_pages; page_index < highest_page_to_flush; ++page_index) {
-        auto& physical_page = m_physical_pages[page_index];
-        if (physical_page && is_page_dirty(page_index))
-            pages_to_flush.append(page_index);
+ErrorOr<void> SharedInodeVMObject::sync_impl(off_t offset_in_pages, size_t pages, bool should_remap)
+{
+    Vector<size_t> pages_to_flush;
+    Vector<NonnullRefPtr<PhysicalRAMPage>> physical_pages_to_flush;
+    {
+        SpinlockLocker locker(m_lock);
+
+        size_t highest_page_to_flush = min(page_count(), offset_in_pages + pages);
+
+        TRY(pages_to_flush.try_ensure_capacity(highest_page_to_flush - offset_in_pages));
+        TRY(physical_pages_to_flush.try_ensure_capacity(highest_page_to_flush - offset_in_pages));
+
+        for (size_t page_index = offset_in_pages; page_index < highest_page_to_flush; ++page_index) {
+            auto& physical_page = m_physical_pages[page_index];
+            if (physical_page && is_page_dirty(page_index)) {
+                pages_to_flush.unchecked_append(page_index);
+                physical_pages_to_flush.unchecked_append(*physical_page);
+            }
+        }
+
+        if (pages_to_flush.size() == 0)
+            return {};
+
+        // Mark pages as clean and remap regions before writing the pages to disk.
+        // This makes the pages read-only while we are flushing them to disk. Any writes will page-fault and mark them dirty again.
+        if (should_remap) {
+            for (auto it = pages_to_flush.begin(); it != pages_to_flush.end(); ++it)
+                set_page_dirty(*it, false);
+            remap_regions_locked();
+        }
     }
 
-    if (pages_to_flush.size() == 0)
-        return {};
-
-    // Mark pages as clean and remap regions before writing the pages to disk.
-    // This makes the pages read-only while we are flushing them to disk. Any writes will page-fault and block until we release the lock.
-    if (should_remap) {
-        for (auto it = pages_to_flush.begin(); it != pages_to_flush.end(); ++it)
-            set_page_dirty(*it, false);
-        remap_regions_locked();
-    }
+    // NOTE: Writing to the inode may block, so we must not hold our lock while doing so.
+    bool did_mark_cached_pages_dirty = false;
+    ScopeGuard notify_inode = [&] {
+        if (did_mark_cached_pages_dirty)
+            m_inode->did_modify_cached_pages();
+    };
+    for (size_t i = 0; i < pages_to_flush.size(); ++i) {
+        // Our pages are the inode's page cache pages, so there's nothing to copy.
+        if (m_inode->uses_page_cache() && m_inode->mark_cached_page_dirty(pages_to_flush[i])) {
+            did_mark_cached_pages_dirty = true;
+            continue;
+        }
 
-    for (auto it = pages_to_flush.begin(); it != pages_to_flush.end(); ++it) {
-        size_t page_index = *it;
-        auto& physical_page = m_physical_pages[page_index];
         u8 page_buffer[PAGE_SIZE];
 
-        MM.copy_physical_page(*physical_page, page_buffer);
-        TRY(m_inode->write_bytes(page_index * PAGE_SIZE, PAGE_SIZE, UserOrKernelBuffer::for_kernel_buffer(page_buffer), nullptr));
+        {
+            InterruptDisabler disabler;
+            MM.copy_physical_page(*physical_pages_to_flush[i], page_buffer);
+        }
+        TRY(m_inode->write_bytes(pages_to_flush[i] * PAGE_SIZE, PAGE_SIZE, UserOrKernelBuffer::for_kernel_buffer(page_buffer), nullptr));
     }
 
     return {};
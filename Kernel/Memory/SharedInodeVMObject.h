@@ -22,6 +22,8 @@ public:
     ErrorOr<void> sync(off_t offset_in_pages, size_t pages);
     ErrorOr<void> sync_before_destroying();
 
+    RefPtr<PhysicalRAMPage> resident_page(size_t page_index) const;
+
 private:
     virtual bool is_shared_inode() const override { return true; }
 
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
+
+namespace Kernel::Memory {
+
+TLBFlushBatch::TLBFlushBatch(PageDirectory const& page_directory)
+    : m_page_directory(page_directory)
+{
+}
+
+TLBFlushBatch::~TLBFlushBatch()
+{
+    flush();
+}
+
+void TLBFlushBatch::add(VirtualAddress vaddr, size_t page_count)
+{
+    if (page_count == 0)
+        return;
+
+    bool is_kernel_address = !is_user_address(vaddr);
+    if (m_should_flush_entire_tlb) {
+        // Dropping all non-global entries already takes care of any other user mapping.
+        if (!is_kernel_address)
+            return;
+        flush();
+    }
+
+    if (is_kernel_address)
+        m_includes_kernel_addresses = true;
+    m_page_count += page_count;
+
+    if (!m_ranges.is_empty() && m_ranges.last().end() == vaddr) {
+        auto& last_range = m_ranges.last();
+        last_range = VirtualRange { last_range.base(), last_range.size() + page_count * PAGE_SIZE };
+    } else if (m_ranges.size() < max_ranges) {
+        m_ranges.unchecked_append(VirtualRange { vaddr, page_count * PAGE_SIZE });
+    } else if (m_includes_kernel_addresses) {
+        // Kernel mappings are global, so they can only be invalidated individually.
+        flush();
+        add(vaddr, page_count);
+        return;
+    } else {
+        m_should_flush_entire_tlb = true;
+    }
+
+    if (!m_includes_kernel_addresses && m_page_count > max_pages_to_flush_individually)
+        m_should_flush_entire_tlb = true;
+    if (m_should_flush_entire_tlb)
+        m_ranges.clear_with_capacity();
+}
+
+void TLBFlushBatch::flush()
+{
+    if (is_empty())
+        return;
+    Processor::flush_tlb(*this);
+    clear();
+}
+
+void TLBFlushBatch::flush_local() const
+{
+    if (m_should_flush_entire_tlb) {
+        Processor::flush_entire_tlb_local();
+        return;
+    }
+    for (auto const& range : m_ranges)
+        Processor::flush_tlb_local(range.base(), range.size() / PAGE_SIZE);
+}
+
+void TLBFlushBatch::clear()
+{
+    m_ranges.clear_with_capacity();
+    m_page_count = 0;
+    m_includes_kernel_addresses = false;
+    m_should_flush_entire_tlb = false;
+}
+
+}
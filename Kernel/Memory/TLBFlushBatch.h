@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Vector.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Memory/VirtualRange.h>
+
+namespace Kernel::Memory {
+
+// Collects the ranges of a page directory whose mappings have been changed or removed,
+// so that all of them can be flushed from the TLBs at once. Flushing a batch interrupts
+// every other processor that may have cached its mappings exactly once, no matter how
+// many ranges it contains.
+//
+// The batch must be flushed before any physical page that was mapped in one of its
+// ranges can be freed. The destructor flushes whatever is still pending.
+class TLBFlushBatch {
+    AK_MAKE_NONCOPYABLE(TLBFlushBatch);
+    AK_MAKE_NONMOVABLE(TLBFlushBatch);
+
+public:
+    static constexpr size_t max_ranges = 16;
+
+    // Past this many pages, dropping all non-global TLB entries is cheaper than invalidating them one by one.
+    static constexpr size_t max_pages_to_flush_individually = 32;
+
+    explicit TLBFlushBatch(PageDirectory const&);
+    ~TLBFlushBatch();
+
+    void add(VirtualAddress, size_t page_count);
+    void add(VirtualRange const& range) { add(range.base(), range.size() / PAGE_SIZE); }
+
+    void flush();
+
+    // Invalidates the batch's ranges on the current processor only.
+    void flush_local() const;
+
+    PageDirectory const& page_directory() const { return m_page_directory; }
+    bool is_empty() const { return m_ranges.is_empty() && !m_should_flush_entire_tlb; }
+
+    // Kernel mappings are global and shared by all address spaces, so every processor may have cached them.
+    bool includes_kernel_addresses() const { return m_includes_kernel_addresses; }
+
+private:
+    void clear();
+
+    PageDirectory const& m_page_directory;
+    Vector<VirtualRange, max_ranges> m_ranges;
+    size_t m_page_count { 0 };
+    bool m_includes_kernel_addresses { false };
+    bool m_should_flush_entire_tlb { false };
+};
+
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <AK/InternetChecksum.h>
 #include <AK/Types.h>
 
 namespace Kernel {
@@ -22,32 +23,4 @@ enum class TransportProtocol : u8 {
     ICMPv6 = 58,
 };
 
-class InternetChecksum {
-public:
-    void add(ReadonlyBytes bytes)
-    {
-        VERIFY(!m_uneven_payload);
-        Span<u16 const> words { bit_cast<u16 const*>(bytes.data()), bytes.size() / 2 };
-        for (u16 w : words) {
-            m_checksum += AK::convert_between_host_and_network_endian(w);
-            if (m_checksum & 0x80000000)
-                m_checksum = (m_checksum & 0xffff) | (m_checksum >> 16);
-        }
-        if (bytes.size() % 2 == 1) {
-            m_checksum += (bytes.last()) << 8;
-            m_uneven_payload = true;
-        }
-    }
-    NetworkOrdered<u16> finish()
-    {
-        while (m_checksum >> 16)
-            m_checksum = (m_checksum & 0xffff) + (m_checksum >> 16);
-        return ~m_checksum & 0xffff;
-    }
-
-private:
-    u32 m_checksum { 0 };
-    bool m_uneven_payload { false };
-};
-
 }
@@ -221,7 +221,8 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_link()
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 {
-    out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
+    // Interrupt rate of 125 microseconds. We switch to polling when that isn't enough, so there's no need to delay packets any further.
+    out32(REG_INTERRUPT_RATE, 488);
     out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
     in32(REG_INTERRUPT_CAUSE_READ);
     enable_irq();
@@ -268,7 +269,7 @@ bool E1000NetworkAdapter::handle_irq()
         dbgln_if(E1000_DEBUG, "E1000: RX buffer overrun");
     }
     if (status & INTERRUPT_RXT0) {
-        receive();
+        receive_or_schedule_poll();
     }
 
     m_wait_queue.wake_all();
@@ -428,11 +429,12 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
 }
 
-void E1000NetworkAdapter::receive()
+size_t E1000NetworkAdapter::poll_receive(size_t budget)
 {
-    u32 rx_current;
-    for (;;) {
-        rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
+    SpinlockLocker locker(m_receive_lock);
+    size_t received = 0;
+    for (; received < budget; ++received) {
+        u32 rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
         rx_current = (rx_current + 1) % number_of_rx_descriptors;
         if (!(m_rx_descriptors[rx_current].status & 1))
             break;
@@ -444,6 +446,12 @@ void E1000NetworkAdapter::receive()
         m_rx_descriptors[rx_current].status = 0;
         out32(REG_RXDESCTAIL, rx_current);
     }
+    return received;
+}
+
+void E1000NetworkAdapter::set_receive_interrupts_enabled(bool enabled)
+{
+    out32(enabled ? REG_INTERRUPT_MASK_SET : REG_INTERRUPT_MASK_CLEAR, INTERRUPT_RXT0 | INTERRUPT_RXO);
 }
 
 i32 E1000NetworkAdapter::link_speed()
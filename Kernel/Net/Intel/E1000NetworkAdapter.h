@@ -12,6 +12,7 @@
 #include <Kernel/Bus/PCI/Device.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Library/IOWindow.h>
+#include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Security/Random.h>
 
@@ -28,6 +29,7 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual size_t poll_receive(size_t budget) override;
     virtual bool link_up() override { return m_link_up; }
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
@@ -87,7 +89,7 @@ protected:
     u16 in16(u16 address);
     u32 in32(u16 address);
 
-    void receive();
+    virtual void set_receive_interrupts_enabled(bool) override;
 
     static constexpr size_t number_of_rx_descriptors = 256;
     static constexpr size_t number_of_tx_descriptors = 256;
@@ -101,6 +103,7 @@ protected:
     NonnullOwnPtr<Memory::Region> m_tx_buffer_region;
     Array<void*, number_of_rx_descriptors> m_rx_buffers;
     Array<void*, number_of_tx_descriptors> m_tx_buffers;
+    Spinlock<LockRank::None> m_receive_lock {};
     SetOnce m_has_eeprom;
     bool m_link_up { false };
     EntropySource m_entropy_source;
@@ -4,10 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Debug.h>
 #include <Kernel/Heap/kmalloc.h>
-#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/StdLib.h>
 #include <Kernel/Net/EtherType.h>
+#include <Kernel/Net/IP/SocketTuple.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Tasks/Process.h>
@@ -103,73 +105,187 @@ void NetworkAdapter::fill_in_ipv6_header(PacketWithTimestamp& packet, IPv6Addres
     ipv6.set_hop_limit(hop_limit);
 }
 
+void NetworkAdapter::set_receive_queue_count(size_t count)
+{
+    VERIFY(count >= 1 && count <= max_receive_queues);
+    m_receive_queue_count = count;
+}
+
+size_t NetworkAdapter::receive_queue_for_frame(ReadonlyBytes frame) const
+{
+    if (m_receive_queue_count == 1)
+        return 0;
+
+    // Anything that doesn't belong to an IPv4 flow (ARP, IPv6, ...) is rare enough to all go to the first queue.
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *bit_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+    auto& ipv4 = *static_cast<IPv4Packet const*>(eth.payload());
+
+    // Steer by the tuple of the socket that will receive the packet, i.e. from its point of view.
+    // Only the first fragment of a packet carries the ports, so fragments are steered by address alone.
+    u16 local_port = 0;
+    u16 peer_port = 0;
+    auto protocol = static_cast<TransportProtocol>(ipv4.protocol());
+    if (!ipv4.is_a_fragment() && (protocol == TransportProtocol::TCP || protocol == TransportProtocol::UDP)) {
+        // The transport header starts after any IPv4 options, and both TCP and UDP begin with the two ports.
+        // A bogus header length is left for the IPv4 layer to reject; we only have to stay inside the frame.
+        size_t header_length = ipv4.internet_header_length() * 4;
+        size_t transport_header_offset = sizeof(EthernetFrameHeader) + header_length;
+        if (header_length >= sizeof(IPv4Packet) && frame.size() >= transport_header_offset + 2 * sizeof(u16)) {
+            auto ports = frame.slice(transport_header_offset, 2 * sizeof(u16));
+            peer_port = (static_cast<u16>(ports[0]) << 8) | ports[1];
+            local_port = (static_cast<u16>(ports[2]) << 8) | ports[3];
+        }
+    }
+
+    IPv4SocketTuple tuple { ipv4.destination(), local_port, ipv4.source(), peer_port };
+    return Traits<IPv4SocketTuple>::hash(tuple) % m_receive_queue_count;
+}
+
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
 {
-    InterruptDisabler disabler;
     m_packets_in++;
     m_bytes_in += payload.size();
 
-    if (m_packet_queue_size == max_packet_buffers) {
+    if (m_packet_queue_size.load(AK::MemoryOrder::memory_order_relaxed) >= max_packet_buffers) {
         m_packets_dropped++;
         return;
     }
 
-    auto packet = acquire_packet_buffer(payload.size());
+    // Allocating from an interrupt handler is not an option, so only use preallocated buffers there.
+    auto packet = take_receive_packet_buffer(payload.size());
+    if (!packet && !Processor::current_in_irq() && !Processor::in_critical())
+        packet = acquire_packet_buffer(payload.size());
     if (!packet) {
-        dbgln("Discarding packet because we're out of memory");
+        m_packets_dropped++;
+        dbgln_if(NETWORK_TASK_DEBUG, "Discarding packet because we're out of packet buffers");
         return;
     }
 
     memcpy(packet->buffer->data(), payload.data(), payload.size());
 
-    m_packet_queue.append(*packet);
-    m_packet_queue_size++;
+    auto queue_index = receive_queue_for_frame(payload);
+    m_receive_queues[queue_index].with([&](auto& queue) {
+        queue.append(*packet);
+    });
+    m_packet_queue_size.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
 
     if (on_receive)
-        on_receive();
+        on_receive(queue_index);
+}
+
+bool NetworkAdapter::has_queued_packets(size_t queue_index) const
+{
+    return m_receive_queues[queue_index].with([](auto& queue) { return !queue.is_empty(); });
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+size_t NetworkAdapter::dequeue_packet(size_t queue_index, u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
 {
-    InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
+    auto packet_with_timestamp = m_receive_queues[queue_index].with([](auto& queue) { return queue.take_first(); });
+    if (!packet_with_timestamp)
         return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    m_packet_queue_size--;
+    m_packet_queue_size.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
     packet_timestamp = packet_with_timestamp->timestamp;
     auto& packet_buffer = packet_with_timestamp->buffer;
     size_t packet_size = packet_buffer->size();
     VERIFY(packet_size <= buffer_size);
     memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
+    if (packet_with_timestamp->is_receive_buffer)
+        m_unused_receive_packets.with([&](auto& unused_packets) { unused_packets.append(*packet_with_timestamp); });
+    else
+        release_packet_buffer(*packet_with_timestamp);
     return packet_size;
 }
 
-RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
+void NetworkAdapter::receive_or_schedule_poll()
 {
-    auto packet = m_unused_packets.with([size](auto& unused_packets) -> RefPtr<PacketWithTimestamp> {
-        if (unused_packets.is_empty())
-            return nullptr;
+    if (is_receive_poll_pending())
+        return;
+    if (poll_receive(receive_poll_budget) < receive_poll_budget)
+        return;
 
-        auto unused_packet = unused_packets.take_first();
+    // There is more where that came from, so stop interrupting and let the NetworkTask catch up.
+    set_receive_interrupts_enabled(false);
+    bool expected = false;
+    if (!m_receive_poll_pending.compare_exchange_strong(expected, true, AK::MemoryOrder::memory_order_acq_rel))
+        return;
+    if (on_receive_poll_scheduled)
+        on_receive_poll_scheduled();
+}
 
-        if (unused_packet->buffer->capacity() >= size)
-            return unused_packet;
+void NetworkAdapter::complete_receive_poll()
+{
+    m_receive_poll_pending.store(false, AK::MemoryOrder::memory_order_release);
+    set_receive_interrupts_enabled(true);
+    // Packets that arrived after the last poll might not have raised an interrupt.
+    receive_or_schedule_poll();
+}
+
+ErrorOr<void> NetworkAdapter::preallocate_packet_buffers(size_t count)
+{
+    // Frames that don't fit into a page (e.g. on the loopback adapter) are still allocated on demand.
+    auto buffer_size = min<size_t>(mtu() + sizeof(EthernetFrameHeader), PAGE_SIZE);
+    for (size_t i = 0; i < count; ++i) {
+        auto buffer = TRY(KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, buffer_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+        auto packet = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) PacketWithTimestamp { move(buffer), {} }));
+        release_packet_buffer(*packet);
+    }
+    return {};
+}
+
+ErrorOr<void> NetworkAdapter::preallocate_receive_packet_buffers(size_t count)
+{
+    auto buffer_size = mtu() + sizeof(EthernetFrameHeader);
+    for (size_t i = 0; i < count; ++i) {
+        auto buffer = TRY(KBuffer::try_create_with_size("NetworkAdapter: Receive packet buffer"sv, buffer_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+        auto packet = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) PacketWithTimestamp { move(buffer), {} }));
+        packet->is_receive_buffer = true;
+        m_unused_receive_packets.with([&](auto& unused_packets) { unused_packets.append(*packet); });
+    }
+    return {};
+}
+
+template<typename PacketList>
+static RefPtr<PacketWithTimestamp> take_packet_buffer_from_list(PacketList& packets, size_t size)
+{
+    for (auto& packet : packets) {
+        if (packet.buffer->capacity() < size)
+            continue;
+        NonnullRefPtr<PacketWithTimestamp> taken_packet = packet;
+        packets.remove(packet);
+        taken_packet->timestamp = kgettimeofday();
+        taken_packet->buffer->set_size(size);
+        return taken_packet;
+    }
+    return nullptr;
+}
 
-        unused_packets.append(*unused_packet);
-        return nullptr;
+RefPtr<PacketWithTimestamp> NetworkAdapter::take_unused_packet_buffer(size_t size)
+{
+    return m_unused_packets.with([size](auto& unused_packets) {
+        return take_packet_buffer_from_list(unused_packets, size);
     });
+}
 
-    if (packet) {
-        packet->timestamp = kgettimeofday();
-        packet->buffer->set_size(size);
+RefPtr<PacketWithTimestamp> NetworkAdapter::take_receive_packet_buffer(size_t size)
+{
+    return m_unused_receive_packets.with([size](auto& unused_packets) {
+        return take_packet_buffer_from_list(unused_packets, size);
+    });
+}
+
+RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
+{
+    if (auto packet = take_unused_packet_buffer(size))
         return packet;
-    }
 
     auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
-    packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
+    auto packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
     if (!packet)
         return {};
     packet->buffer->set_size(size);
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Function.h>
@@ -18,6 +20,7 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/ICMP.h>
 #include <Kernel/Net/IP/ARP.h>
@@ -42,6 +45,8 @@ struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp>
 
     NonnullOwnPtr<KBuffer> buffer;
     UnixDateTime timestamp;
+    // Set for the buffers that are reserved for receiving, see NetworkAdapter::preallocate_receive_packet_buffers().
+    bool is_receive_buffer { false };
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
 };
 
@@ -92,9 +97,16 @@ public:
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, TransportProtocol, size_t, u8 type_of_service, u8 ttl);
     void fill_in_ipv6_header(PacketWithTimestamp&, IPv6Address const&, MACAddress const&, IPv6Address const&, TransportProtocol, size_t, u8 hop_limit);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+    // Received packets are spread over several queues by flow, so that every queue can be
+    // processed in parallel without ever reordering the packets of a single connection.
+    static constexpr size_t max_receive_queues = 8;
 
-    bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
+    size_t receive_queue_count() const { return m_receive_queue_count; }
+    void set_receive_queue_count(size_t);
+
+    size_t dequeue_packet(size_t queue_index, u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+
+    bool has_queued_packets(size_t queue_index) const;
 
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
@@ -112,7 +124,31 @@ public:
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
     constexpr size_t ipv6_payload_offset() const { return layer3_payload_offset() + sizeof(IPv6PacketHeader); }
 
-    Function<void()> on_receive;
+    Function<void(size_t queue_index)> on_receive;
+
+    // Under load, drivers stop taking an interrupt per received batch and instead have the
+    // NetworkTask poll them for at most receive_poll_budget packets at a time, until they run dry.
+    static constexpr size_t receive_poll_budget = 64;
+
+    // Hands up to `budget` received packets to did_receive() and returns how many there were.
+    virtual size_t poll_receive(size_t budget)
+    {
+        (void)budget;
+        return 0;
+    }
+    bool is_receive_poll_pending() const { return m_receive_poll_pending.load(AK::MemoryOrder::memory_order_acquire); }
+    void complete_receive_poll();
+
+    Function<void()> on_receive_poll_scheduled;
+
+    // Preallocates packet buffers, so that sending doesn't have to allocate.
+    ErrorOr<void> preallocate_packet_buffers(size_t count);
+
+    // Preallocates MTU-sized buffers for received frames. These are kept apart from the buffers used for sending,
+    // which e.g. TCP holds on to until its segments are acknowledged, so that a busy sender can never starve the
+    // receive path (and with it the acknowledgements it is waiting for). Receiving from an interrupt handler only
+    // uses these buffers.
+    ErrorOr<void> preallocate_receive_packet_buffers(size_t count);
 
     void send_packet(ReadonlyBytes);
 
@@ -120,6 +156,9 @@ protected:
     NetworkAdapter(StringView);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
     void did_receive(ReadonlyBytes);
+    // To be called when the device signals received packets. Switches to polling if there are too many.
+    void receive_or_schedule_poll();
+    virtual void set_receive_interrupts_enabled(bool) { }
     virtual void send_raw(ReadonlyBytes) = 0;
     void autoconfigure_link_local_ipv6();
 
@@ -136,9 +175,16 @@ private:
 
     using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
 
-    PacketList m_packet_queue;
-    size_t m_packet_queue_size { 0 };
+    size_t receive_queue_for_frame(ReadonlyBytes) const;
+    RefPtr<PacketWithTimestamp> take_unused_packet_buffer(size_t);
+    RefPtr<PacketWithTimestamp> take_receive_packet_buffer(size_t);
+
+    Array<SpinlockProtected<PacketList, LockRank::None>, max_receive_queues> m_receive_queues {};
+    size_t m_receive_queue_count { 1 };
+    Atomic<size_t> m_packet_queue_size { 0 };
+    Atomic<bool> m_receive_poll_pending { false };
     SpinlockProtected<PacketList, LockRank::None> m_unused_packets {};
+    SpinlockProtected<PacketList, LockRank::None> m_unused_receive_packets {};
     FixedStringBuffer<IFNAMSIZ> m_name;
     u32 m_packets_in { 0 };
     u32 m_bytes_in { 0 };
@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
@@ -30,6 +32,7 @@
 
 namespace Kernel {
 
+static void handle_frame(u8 const* buffer, size_t frame_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size, RefPtr<NetworkAdapter> adapter);
 static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
@@ -41,42 +44,87 @@ static void send_delayed_tcp_ack(TCPSocket& socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter);
 static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
+static bool poll_adapters();
 
-static Thread* network_task = nullptr;
-static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
+static constexpr size_t preallocated_packet_buffers = 256;
+// Enough to absorb a few polls worth of packets without having to allocate while receiving.
+static constexpr size_t preallocated_receive_packet_buffers = 256;
+
+// Every worker owns one receive queue of each adapter, and with it every flow that hashes to it.
+struct NetworkWorker {
+    size_t index { 0 };
+    Thread* thread { nullptr };
+    WaitQueue packet_wait_queue;
+    HashTable<NonnullRefPtr<TCPSocket>> delayed_ack_sockets;
+};
+
+static Array<NetworkWorker*, NetworkAdapter::max_receive_queues> s_workers;
+static size_t s_worker_count = 0;
 
 [[noreturn]] static void NetworkTask_main(void*);
 
 void NetworkTask::spawn()
 {
-    auto [_, first_thread] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr));
-    network_task = first_thread;
+    s_worker_count = clamp<size_t>(Processor::count(), 1, NetworkAdapter::max_receive_queues);
+    for (size_t i = 0; i < s_worker_count; ++i)
+        s_workers[i] = new NetworkWorker { .index = i };
+
+    // The first worker configures the adapters and then starts the others.
+    (void)MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, s_workers[0]));
+}
+
+static NetworkWorker* current_worker()
+{
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        if (s_workers[i]->thread == current_thread)
+            return s_workers[i];
+    }
+    return nullptr;
 }
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    return current_worker() != nullptr;
 }
 
-void NetworkTask_main(void*)
+void NetworkTask_main(void* data)
 {
-    delayed_ack_sockets = new HashTable<NonnullRefPtr<TCPSocket>>;
+    auto& worker = *static_cast<NetworkWorker*>(data);
+    worker.thread = Thread::current();
 
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
-    NetworkingManagement::the().for_each([&](auto& adapter) {
-        dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
+    if (worker.index == 0) {
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
-        if (adapter.class_name() == "LoopbackAdapter"sv) {
-            adapter.set_ipv4_address({ 127, 0, 0, 1 });
-            adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
-        }
+            if (adapter.class_name() == "LoopbackAdapter"sv) {
+                adapter.set_ipv4_address({ 127, 0, 0, 1 });
+                adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
+            }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
-        };
-    });
+            if (auto result = adapter.preallocate_packet_buffers(preallocated_packet_buffers); result.is_error())
+                dmesgln("NetworkTask: Failed to preallocate packet buffers for {}: {}", adapter.name(), result.error());
+            // The loopback adapter receives straight from send_raw(), so it can always allocate.
+            if (adapter.adapter_type() != NetworkAdapter::Type::Loopback) {
+                if (auto result = adapter.preallocate_receive_packet_buffers(preallocated_receive_packet_buffers); result.is_error())
+                    dmesgln("NetworkTask: Failed to preallocate receive packet buffers for {}: {}", adapter.name(), result.error());
+            }
+
+            adapter.set_receive_queue_count(s_worker_count);
+            adapter.on_receive = [](size_t queue_index) {
+                s_workers[queue_index]->packet_wait_queue.wake_all();
+            };
+            adapter.on_receive_poll_scheduled = [] {
+                s_workers[0]->packet_wait_queue.wake_all();
+            };
+        });
+
+        for (size_t i = 1; i < s_worker_count; ++i) {
+            auto name = MUST(KString::formatted("Network Task #{}", i));
+            (void)MUST(Process::current().create_kernel_thread(NetworkTask_main, s_workers[i], THREAD_PRIORITY_NORMAL, name->view(), THREAD_AFFINITY_DEFAULT, false));
+        }
+        dmesgln("NetworkTask: Processing received packets on {} threads", s_worker_count);
+    }
 
     size_t buffer_size = 64 * KiB;
     auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
@@ -94,49 +142,81 @@ void NetworkTask_main(void*)
 
     while (!Process::current().is_dying()) {
         flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
-        size_t packet_size = 0;
-        if (!pending_packets) {
-            auto timeout_time = Duration::from_milliseconds(500);
-            auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
-        } else {
+        // Retransmissions and receive polling aren't tied to the flows of any particular worker, so one of them is enough.
+        bool did_poll = false;
+        if (worker.index == 0) {
+            retransmit_tcp_packets();
+            did_poll = poll_adapters();
+        }
+
+        // Handle a batch of packets before looking at the timers and adapters again.
+        size_t handled_packets = 0;
+        for (; handled_packets < NetworkAdapter::receive_poll_budget; ++handled_packets) {
+            size_t packet_size = 0;
             NetworkingManagement::the().for_each([&](auto& adapter) {
-                if (packet_size || !adapter.has_queued_packets()) {
+                if (packet_size || !adapter.has_queued_packets(worker.index)) {
                     return;
                 }
-                packet_size = adapter.dequeue_packet(meta.buffer, buffer_size, meta.packet_timestamp);
-                pending_packets--;
-                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
+                packet_size = adapter.dequeue_packet(worker.index, meta.buffer, buffer_size, meta.packet_timestamp);
+                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask #{}: Dequeued packet from {} ({} bytes)", worker.index, adapter.name(), packet_size);
                 meta.adapter = adapter;
             });
+            if (!packet_size)
+                break;
+            handle_frame(meta.buffer, packet_size, meta.packet_timestamp, meta.adapter);
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)meta.buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size, meta.adapter);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, meta.packet_timestamp, meta.adapter);
-            break;
-        case EtherType::IPv6:
-            handle_ipv6(eth, packet_size, meta.packet_timestamp, meta.adapter);
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+
+        if (handled_packets == 0 && !did_poll) {
+            // If a packet arrives before we start waiting, the wake-up is remembered and we return right away.
+            auto timeout_time = TCPSocket::retransmit_timer_granularity;
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = worker.packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
         }
     }
     Process::current().sys$exit(0);
     VERIFY_NOT_REACHED();
 }
 
+void handle_frame(u8 const* buffer, size_t frame_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter)
+{
+    if (frame_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", frame_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)buffer;
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), frame_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, frame_size, adapter);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, frame_size, packet_timestamp, adapter);
+        break;
+    case EtherType::IPv6:
+        handle_ipv6(eth, frame_size, packet_timestamp, adapter);
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
+bool poll_adapters()
+{
+    // Don't keep the adapter list locked while polling.
+    Vector<NonnullRefPtr<NetworkAdapter>, 8> adapters_to_poll;
+    NetworkingManagement::the().for_each([&](auto& adapter) {
+        if (adapter.is_receive_poll_pending())
+            (void)adapters_to_poll.try_append(adapter);
+    });
+
+    for (auto& adapter : adapters_to_poll) {
+        if (adapter->poll_receive(NetworkAdapter::receive_poll_budget) < NetworkAdapter::receive_poll_budget)
+            adapter->complete_receive_poll();
+    }
+    return !adapters_to_poll.is_empty();
+}
+
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size, RefPtr<NetworkAdapter> adapter)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -476,13 +556,17 @@ void send_delayed_tcp_ack(TCPSocket& socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    // A socket's packets are always handled by the same worker, so its delayed ACK is flushed by that worker too.
+    auto* worker = current_worker();
+    VERIFY(worker);
+    worker->delayed_ack_sockets.set(move(socket));
 }
 
 void flush_delayed_tcp_acks()
 {
+    auto& delayed_ack_sockets = current_worker()->delayed_ack_sockets;
     Vector<NonnullRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : delayed_ack_sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(*socket));
@@ -491,12 +575,12 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
+    if (remaining_sockets.size() != delayed_ack_sockets.size()) {
+        delayed_ack_sockets.clear();
         if (remaining_sockets.size() > 0)
             dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
+            delayed_ack_sockets.set(move(socket));
     }
 }
 
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+// RFC 5681, section 3.2: three duplicate ACKs are taken as an indication that a segment has been lost.
+static constexpr u32 duplicate_ack_threshold = 3;
+
+// Keeps the window arithmetic below comfortably inside of 32 bits. This is larger than
+// anything the peer can advertise with the maximum window scale of 14 anyway.
+static constexpr u64 maximum_congestion_window = 1 * GiB;
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(Algorithm algorithm, u32 maximum_segment_size)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPNewRenoCongestionControl(maximum_segment_size)));
+    case Algorithm::Cubic:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPCubicCongestionControl(maximum_segment_size)));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "newreno"sv || name == "reno"sv)
+        return Algorithm::NewReno;
+    if (name == "cubic"sv)
+        return Algorithm::Cubic;
+    return {};
+}
+
+StringView TCPCongestionControl::to_string(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return "newreno"sv;
+    case Algorithm::Cubic:
+        return "cubic"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+TCPCongestionControl::TCPCongestionControl(u32 maximum_segment_size)
+    : m_maximum_segment_size(maximum_segment_size)
+{
+    // RFC 6928: IW = min(10*MSS, max(2*MSS, 14600))
+    m_congestion_window = min(10 * maximum_segment_size, max(2 * maximum_segment_size, 14600u));
+}
+
+TCPCongestionControl::Action TCPCongestionControl::on_ack(u32 ack_number, u32 acked_bytes, u32 bytes_in_flight, MonotonicTime now)
+{
+    m_duplicate_acks = 0;
+
+    switch (m_recovery) {
+    case Recovery::None:
+        increase_window(acked_bytes, now);
+        return Action::None;
+    case Recovery::Fast:
+        if (tcp_sequence_number_is_before_or_at(m_recovery_point, ack_number)) {
+            // Full acknowledgement, deflate the window again (RFC 6582, section 3.2, step 3).
+            m_congestion_window = min(m_slow_start_threshold, max(bytes_in_flight, m_maximum_segment_size) + m_maximum_segment_size);
+            m_recovery = Recovery::None;
+            return Action::None;
+        }
+        // Partial acknowledgement: the segment after the one we just retransmitted was lost as well
+        // (RFC 6582, section 3.2, step 4).
+        m_congestion_window -= min(m_congestion_window, acked_bytes);
+        if (acked_bytes >= m_maximum_segment_size)
+            m_congestion_window += m_maximum_segment_size;
+        m_congestion_window = max(m_congestion_window, m_maximum_segment_size);
+        return Action::RetransmitFirstUnackedPacket;
+    case Recovery::Loss:
+        increase_window(acked_bytes, now);
+        if (tcp_sequence_number_is_before_or_at(m_recovery_point, ack_number)) {
+            m_recovery = Recovery::None;
+            return Action::None;
+        }
+        // Everything that was in flight when the timer expired is presumed lost, so resend it one
+        // segment per ACK instead of waiting for another timeout for each of them.
+        return Action::RetransmitFirstUnackedPacket;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+TCPCongestionControl::Action TCPCongestionControl::on_duplicate_ack(u32 next_sequence_number, u32 bytes_in_flight, MonotonicTime now)
+{
+    if (m_recovery == Recovery::Fast) {
+        // Every further duplicate ACK means another segment has left the network (RFC 5681, section 3.2, step 4).
+        m_congestion_window = min<u64>(static_cast<u64>(m_congestion_window) + m_maximum_segment_size, maximum_congestion_window);
+        return Action::None;
+    }
+    if (m_recovery == Recovery::Loss)
+        return Action::None;
+
+    if (++m_duplicate_acks < duplicate_ack_threshold)
+        return Action::None;
+
+    m_duplicate_acks = 0;
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    m_congestion_window = m_slow_start_threshold + duplicate_ack_threshold * m_maximum_segment_size;
+    m_recovery = Recovery::Fast;
+    m_recovery_point = next_sequence_number;
+    ++m_fast_retransmits;
+    return Action::RetransmitFirstUnackedPacket;
+}
+
+void TCPCongestionControl::on_retransmit_timeout(u32 next_sequence_number, u32 bytes_in_flight, MonotonicTime now)
+{
+    // RFC 5681, section 3.1: ssthresh must not be lowered again when the same segment times out repeatedly.
+    if (m_recovery != Recovery::Loss)
+        m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    m_congestion_window = m_maximum_segment_size;
+    m_duplicate_acks = 0;
+    m_recovery = Recovery::Loss;
+    m_recovery_point = next_sequence_number;
+}
+
+void TCPCongestionControl::increase_window_in_slow_start(u32 acked_bytes)
+{
+    // Appropriate byte counting with L = 2 (RFC 3465), so delayed ACKs don't halve the growth rate.
+    auto increase = min(acked_bytes, 2 * m_maximum_segment_size);
+    m_congestion_window = min<u64>(static_cast<u64>(m_congestion_window) + increase, maximum_congestion_window);
+}
+
+void TCPNewRenoCongestionControl::increase_window(u32 acked_bytes, MonotonicTime)
+{
+    if (is_in_slow_start()) {
+        increase_window_in_slow_start(acked_bytes);
+        return;
+    }
+
+    // Congestion avoidance: one segment per window's worth of acknowledged data (RFC 5681, section 3.1).
+    m_bytes_acked_in_congestion_avoidance += acked_bytes;
+    if (m_bytes_acked_in_congestion_avoidance >= m_congestion_window) {
+        m_bytes_acked_in_congestion_avoidance -= m_congestion_window;
+        m_congestion_window = min<u64>(static_cast<u64>(m_congestion_window) + m_maximum_segment_size, maximum_congestion_window);
+    }
+}
+
+u32 TCPNewRenoCongestionControl::slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime)
+{
+    m_bytes_acked_in_congestion_avoidance = 0;
+    return max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+}
+
+static u64 integer_cube_root(u64 value)
+{
+    // 2642245 is the largest number whose cube still fits into 64 bits.
+    u64 low = 0;
+    u64 high = 2642245;
+    while (low < high) {
+        auto middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+// W_cubic(t) = C * (t - K)^3 + W_max with C = 0.4 segments/s^3 (RFC 9438, section 4.2).
+u64 TCPCubicCongestionControl::cubic_window_at(i64 milliseconds_since_epoch_start) const
+{
+    // Clamping to 1000 seconds keeps the cube within 64 bits.
+    auto offset = clamp<i64>(milliseconds_since_epoch_start - m_milliseconds_to_window_max, -1'000'000, 1'000'000);
+    // 0.4 * (offset / 1000)^3 segments, expressed in thousandths of a segment.
+    auto millisegments = 4 * offset * offset * offset / 10'000'000;
+    auto window = static_cast<i64>(m_window_max) + millisegments * m_maximum_segment_size / 1000;
+    return clamp<i64>(window, m_maximum_segment_size, maximum_congestion_window);
+}
+
+void TCPCubicCongestionControl::increase_window(u32 acked_bytes, MonotonicTime now)
+{
+    if (is_in_slow_start()) {
+        increase_window_in_slow_start(acked_bytes);
+        return;
+    }
+
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        m_reno_friendly_window = m_congestion_window;
+        if (m_congestion_window < m_window_max) {
+            // K = cbrt((W_max - cwnd) / C), in milliseconds.
+            auto segments_to_window_max = (m_window_max - m_congestion_window) * 2'500'000'000ull / m_maximum_segment_size;
+            m_milliseconds_to_window_max = integer_cube_root(segments_to_window_max);
+        } else {
+            m_milliseconds_to_window_max = 0;
+            m_window_max = m_congestion_window;
+        }
+    }
+
+    auto target = cubic_window_at((now - m_epoch_start.value()).to_milliseconds());
+
+    // Grow at least as fast as Reno would, with alpha = 3 * (1 - beta) / (1 + beta) ~ 0.529 (RFC 9438, section 4.3).
+    m_reno_friendly_window += static_cast<u64>(acked_bytes) * m_maximum_segment_size * 529 / (1000ull * m_congestion_window);
+    target = max(target, m_reno_friendly_window);
+
+    // The target is limited to 1.5 times the current window (RFC 9438, section 4.2).
+    target = min(target, static_cast<u64>(m_congestion_window) * 3 / 2);
+
+    if (target > m_congestion_window) {
+        auto increase = max<u64>((target - m_congestion_window) * acked_bytes / m_congestion_window, 1);
+        m_congestion_window = min(static_cast<u64>(m_congestion_window) + increase, maximum_congestion_window);
+        return;
+    }
+
+    // Right at the plateau, probe very slowly: one segment every 100 windows.
+    m_bytes_acked_while_above_target += acked_bytes;
+    if (m_bytes_acked_while_above_target >= 100ull * m_congestion_window) {
+        m_bytes_acked_while_above_target = 0;
+        m_congestion_window = min<u64>(static_cast<u64>(m_congestion_window) + m_maximum_segment_size, maximum_congestion_window);
+    }
+}
+
+u32 TCPCubicCongestionControl::slow_start_threshold_after_loss(u32, MonotonicTime)
+{
+    m_epoch_start.clear();
+    m_bytes_acked_while_above_target = 0;
+
+    u64 window = m_congestion_window;
+    if (window < m_last_window_max) {
+        // Fast convergence: release bandwidth to newer flows sooner (RFC 9438, section 4.7).
+        m_last_window_max = window;
+        m_window_max = window * 17 / 20;
+    } else {
+        m_last_window_max = window;
+        m_window_max = window;
+    }
+
+    // Multiplicative decrease with beta = 0.7 (RFC 9438, section 4.6).
+    return max<u64>(window * 7 / 10, 2 * m_maximum_segment_size);
+}
+
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Kernel {
+
+// TCP sequence numbers wrap around, so they have to be compared modulo 2^32 (RFC 793, section 3.3).
+constexpr bool tcp_sequence_number_is_before_or_at(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
+// Sender-side congestion control for a TCPSocket.
+// The loss recovery state machine (RFC 5681 fast retransmit and RFC 6582 NewReno fast recovery)
+// is shared, while subclasses decide how the congestion window grows and how far it is reduced on loss.
+class TCPCongestionControl {
+public:
+    enum class Algorithm {
+        NewReno,
+        Cubic,
+    };
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(Algorithm, u32 maximum_segment_size);
+    static Optional<Algorithm> algorithm_from_name(StringView);
+    static StringView to_string(Algorithm);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual Algorithm algorithm() const = 0;
+
+    enum class Action {
+        None,
+        RetransmitFirstUnackedPacket,
+    };
+
+    // An ACK advanced the left edge of the send window by acked_bytes.
+    Action on_ack(u32 ack_number, u32 acked_bytes, u32 bytes_in_flight, MonotonicTime now);
+    // An ACK that acknowledged nothing new while data was outstanding (RFC 5681, section 2).
+    Action on_duplicate_ack(u32 next_sequence_number, u32 bytes_in_flight, MonotonicTime now);
+    void on_retransmit_timeout(u32 next_sequence_number, u32 bytes_in_flight, MonotonicTime now);
+
+    void set_maximum_segment_size(u32 maximum_segment_size) { m_maximum_segment_size = maximum_segment_size; }
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+    bool is_in_recovery() const { return m_recovery != Recovery::None; }
+    u32 fast_retransmits() const { return m_fast_retransmits; }
+
+protected:
+    explicit TCPCongestionControl(u32 maximum_segment_size);
+
+    // Grows the window for newly acknowledged data outside of loss recovery.
+    virtual void increase_window(u32 acked_bytes, MonotonicTime now) = 0;
+    // Returns the new slow start threshold once a loss has been detected.
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) = 0;
+
+    void increase_window_in_slow_start(u32 acked_bytes);
+
+    u32 m_maximum_segment_size { 0 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+
+private:
+    enum class Recovery {
+        None,
+        // Entered after three duplicate ACKs.
+        Fast,
+        // Entered after a retransmission timeout, the window restarts from one segment.
+        Loss,
+    };
+
+    Recovery m_recovery { Recovery::None };
+    u32 m_recovery_point { 0 };
+    u32 m_duplicate_acks { 0 };
+    u32 m_fast_retransmits { 0 };
+};
+
+class TCPNewRenoCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPNewRenoCongestionControl(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::NewReno; }
+
+private:
+    virtual void increase_window(u32 acked_bytes, MonotonicTime now) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) override;
+
+    u32 m_bytes_acked_in_congestion_avoidance { 0 };
+};
+
+// CUBIC as described in RFC 9438, computed in integer arithmetic since the kernel can't use the FPU.
+class TCPCubicCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPCubicCongestionControl(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::Cubic; }
+
+private:
+    virtual void increase_window(u32 acked_bytes, MonotonicTime now) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) override;
+
+    u64 cubic_window_at(i64 milliseconds_since_epoch_start) const;
+
+    Optional<MonotonicTime> m_epoch_start;
+    u64 m_window_max { 0 };
+    u64 m_last_window_max { 0 };
+    i64 m_milliseconds_to_window_max { 0 };
+    u64 m_reno_friendly_window { 0 };
+    u32 m_bytes_acked_while_above_target { 0 };
+};
+
+}
@@ -26,23 +26,22 @@ namespace Kernel {
 
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
-    sockets_by_tuple().for_each_shared([&](auto const& it) {
+    MUST(sockets_by_tuple().try_for_each_shared([&](auto const& it) -> ErrorOr<void> {
         callback(*it.value);
-    });
+        return {};
+    }));
 }
 
 ErrorOr<void> TCPSocket::try_for_each(Function<ErrorOr<void>(TCPSocket const&)> callback)
 {
-    return sockets_by_tuple().with_shared([&](auto const& sockets) -> ErrorOr<void> {
-        for (auto& it : sockets)
-            TRY(callback(*it.value));
-        return {};
+    return sockets_by_tuple().try_for_each_shared([&](auto const& it) -> ErrorOr<void> {
+        return callback(*it.value);
     });
 }
 
 bool TCPSocket::unref() const
 {
-    bool did_hit_zero = sockets_by_tuple().with_exclusive([&](auto& table) {
+    bool did_hit_zero = sockets_by_tuple().with_exclusive(tuple(), [&](auto& table) {
         if (deref_base())
             return false;
         table.remove(tuple());
@@ -116,42 +115,44 @@ MutexProtected<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& TCPSocket::closing_
     return *s_socket_closing;
 }
 
-static Singleton<MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>> s_socket_tuples;
+static Singleton<TCPSocketTable> s_socket_tuples;
 
-MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& TCPSocket::sockets_by_tuple()
+TCPSocketTable& TCPSocket::sockets_by_tuple()
 {
     return *s_socket_tuples;
 }
 
 RefPtr<TCPSocket> TCPSocket::from_tuple(IPv4SocketTuple const& tuple)
 {
-    return sockets_by_tuple().with_shared([&](auto const& table) -> RefPtr<TCPSocket> {
-        auto exact_match = table.get(tuple);
-        if (exact_match.has_value())
-            return { *exact_match.value() };
+    // Each of these tuples may live in a different stripe of the table.
+    auto lookup = [](IPv4SocketTuple const& tuple) {
+        return sockets_by_tuple().with_shared(tuple, [&](auto const& table) -> RefPtr<TCPSocket> {
+            auto match = table.get(tuple);
+            if (match.has_value())
+                return { *match.value() };
+            return {};
+        });
+    };
 
-        auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
-        auto address_match = table.get(address_tuple);
-        if (address_match.has_value())
-            return { *address_match.value() };
+    if (auto exact_match = lookup(tuple))
+        return exact_match;
 
-        auto wildcard_tuple = IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0);
-        auto wildcard_match = table.get(wildcard_tuple);
-        if (wildcard_match.has_value())
-            return { *wildcard_match.value() };
+    auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
+    if (auto address_match = lookup(address_tuple))
+        return address_match;
 
-        return {};
-    });
+    auto wildcard_tuple = IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0);
+    return lookup(wildcard_tuple);
 }
 ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const& new_local_address, u16 new_local_port, IPv4Address const& new_peer_address, u16 new_peer_port)
 {
     auto tuple = IPv4SocketTuple(new_local_address, new_local_port, new_peer_address, new_peer_port);
-    return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<NonnullRefPtr<TCPSocket>> {
+    return sockets_by_tuple().with_exclusive(tuple, [&](auto& table) -> ErrorOr<NonnullRefPtr<TCPSocket>> {
         if (table.contains(tuple))
             return EEXIST;
 
         auto receive_buffer = TRY(try_create_receive_buffer());
-        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer), m_congestion_control->algorithm()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -179,16 +180,19 @@ void TCPSocket::release_to_originator()
 
 void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
 {
+    // Connections to the same listening socket may be established on different network workers at once.
+    MutexLocker locker(mutex());
     VERIFY(m_pending_release_for_accept.contains(socket->tuple()));
     m_pending_release_for_accept.remove(socket->tuple());
     // FIXME: Should we observe this error somehow?
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
-    , m_last_retransmit_time(TimeManagement::the().monotonic_time())
+    , m_retransmit_timer_start(TimeManagement::the().monotonic_time())
+    , m_congestion_control(move(congestion_control))
     , m_timer(timer)
 {
 }
@@ -200,12 +204,17 @@ TCPSocket::~TCPSocket()
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
-ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+// The congestion window is sized before we know which adapter the socket will use,
+// so assume an Ethernet MTU until protocol_send() tells us otherwise.
+static constexpr u32 default_maximum_segment_size = 1500 - sizeof(IPv4Packet) - sizeof(TCPPacket);
+
+ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, TCPCongestionControl::Algorithm congestion_control_algorithm)
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
     auto timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer));
+    auto congestion_control = TRY(TCPCongestionControl::try_create(congestion_control_algorithm, default_maximum_segment_size));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer, move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -233,6 +242,7 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
     size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    m_congestion_control->set_maximum_segment_size(mss);
 
     data_length = min(data_length, mss);
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
@@ -319,6 +329,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            bool was_empty = unacked_packets.packets.is_empty();
             auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
@@ -326,6 +337,14 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
                 return;
             }
             unacked_packets.size += payload_size;
+
+            auto now = TimeManagement::the().monotonic_time();
+            // RFC 6298, section 5.1: start the timer when there was nothing outstanding yet.
+            if (was_empty)
+                m_retransmit_timer_start = now;
+            if (!m_round_trip_time_measurement.has_value())
+                m_round_trip_time_measurement = RoundTripTimeMeasurement { m_sequence_number, now };
+
             enqueue_for_retransmit();
         });
         if (append_failed)
@@ -345,27 +364,34 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        auto now = TimeManagement::the().monotonic_time();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // The window in a SYN is never scaled (RFC 7323, section 2.2).
+        bool window_changed = false;
+        if (!packet.has_syn()) {
+            u32 send_window_size = packet.window_size() << m_send_window_scale;
+            window_changed = send_window_size != m_send_window_size;
+            m_send_window_size = send_window_size;
+        }
+
         int removed = 0;
+        u32 acked_bytes = 0;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
                 dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-                if (packet.ack_number <= ack_number) {
+                if (tcp_sequence_number_is_before_or_at(packet.ack_number, ack_number)) {
                     auto old_adapter = packet.adapter.strong_ref();
                     if (old_adapter)
                         old_adapter->release_packet_buffer(*packet.buffer);
                     TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
-                    }
                     auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
                     unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
+                    acked_bytes += payload_size;
                     unacked_packets.packets.take_first();
                     removed++;
                 } else {
@@ -373,6 +399,27 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                 }
             }
 
+            if (m_round_trip_time_measurement.has_value() && tcp_sequence_number_is_before_or_at(m_round_trip_time_measurement->sequence_number, ack_number)) {
+                update_round_trip_time(now - m_round_trip_time_measurement->send_time);
+                m_round_trip_time_measurement.clear();
+            }
+
+            auto action = TCPCongestionControl::Action::None;
+            if (removed > 0) {
+                // RFC 6298, section 5.3: restart the timer whenever new data is acknowledged.
+                m_retransmit_timer_start = now;
+                m_retransmit_attempts = 0;
+                action = m_congestion_control->on_ack(ack_number, acked_bytes, unacked_packets.size, now);
+            } else if (!unacked_packets.packets.is_empty() && !window_changed && size == packet.header_size() && !packet.has_syn() && !packet.has_fin()) {
+                auto& first_unacked = unacked_packets.packets.first();
+                auto& first_unacked_tcp_packet = *(TCPPacket const*)(first_unacked.buffer->buffer->data() + first_unacked.ipv4_payload_offset);
+                if (first_unacked_tcp_packet.sequence_number() == ack_number)
+                    action = m_congestion_control->on_duplicate_ack(m_sequence_number, unacked_packets.size, now);
+            }
+
+            if (action == TCPCongestionControl::Action::RetransmitFirstUnackedPacket && !unacked_packets.packets.is_empty())
+                retransmit_first_unacked_packet(unacked_packets);
+
             if (unacked_packets.packets.is_empty()) {
                 m_retransmit_attempts = 0;
                 dequeue_for_retransmit();
@@ -380,12 +427,41 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        if (removed > 0 || window_changed)
+            evaluate_block_conditions();
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::update_round_trip_time(Duration sample)
+{
+    auto sample_us = sample.to_microseconds();
+    if (!m_has_round_trip_time_sample) {
+        // RFC 6298, section 2.2
+        m_smoothed_round_trip_time = sample;
+        m_round_trip_time_variance = Duration::from_microseconds(sample_us / 2);
+        m_has_round_trip_time_sample = true;
+    } else {
+        // RFC 6298, section 2.3, with alpha = 1/8 and beta = 1/4
+        auto smoothed_us = m_smoothed_round_trip_time.to_microseconds();
+        auto variance_us = m_round_trip_time_variance.to_microseconds();
+        auto deviation_us = smoothed_us > sample_us ? smoothed_us - sample_us : sample_us - smoothed_us;
+        m_round_trip_time_variance = Duration::from_microseconds((3 * variance_us + deviation_us) / 4);
+        m_smoothed_round_trip_time = Duration::from_microseconds((7 * smoothed_us + sample_us) / 8);
+    }
+
+    // RTO = SRTT + max(G, 4 * RTTVAR)
+    auto variance_term = Duration::from_microseconds(4 * m_round_trip_time_variance.to_microseconds());
+    auto timeout = m_smoothed_round_trip_time + max(retransmit_timer_granularity, variance_term);
+    m_retransmission_timeout = clamp(timeout, minimum_retransmission_timeout, maximum_retransmission_timeout);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) rtt sample {}us, srtt {}us, rttvar {}us, rto {}ms", this, sample_us,
+        m_smoothed_round_trip_time.to_microseconds(), m_round_trip_time_variance.to_microseconds(), m_retransmission_timeout.to_milliseconds());
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -404,15 +480,12 @@ bool TCPSocket::should_delay_next_ack() const
 
 NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
 {
-    union PseudoHeader {
-        struct [[gnu::packed]] {
-            IPv4Address source;
-            IPv4Address destination;
-            u8 zero;
-            u8 protocol;
-            NetworkOrdered<u16> payload_size;
-        } header;
-        u16 raw[6];
+    struct [[gnu::packed]] PseudoHeader {
+        IPv4Address source;
+        IPv4Address destination;
+        u8 zero;
+        u8 protocol;
+        NetworkOrdered<u16> payload_size;
     };
     static_assert(sizeof(PseudoHeader) == 12);
 
@@ -420,35 +493,14 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     packet_size += payload_size;
     VERIFY(!packet_size.has_overflow());
 
-    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)TransportProtocol::TCP, packet_size.value() } };
+    PseudoHeader pseudo_header { source, destination, 0, (u8)TransportProtocol::TCP, packet_size.value() };
 
-    u32 checksum = 0;
-    auto* raw_pseudo_header = pseudo_header.raw;
-    for (size_t i = 0; i < sizeof(pseudo_header) / sizeof(u16); ++i) {
-        checksum += AK::convert_between_host_and_network_endian(raw_pseudo_header[i]);
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
-    auto* raw_packet = bit_cast<u16*>(&packet);
-    for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
-        checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
     VERIFY(packet.data_offset() * 4 == packet.header_size());
-    auto* raw_payload = bit_cast<u16*>(packet.payload());
-    for (size_t i = 0; i < payload_size / sizeof(u16); ++i) {
-        checksum += AK::convert_between_host_and_network_endian(raw_payload[i]);
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
-    if (payload_size & 1) {
-        u16 expanded_byte = ((u8 const*)packet.payload())[payload_size - 1] << 8;
-        checksum += expanded_byte;
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
-    return ~(checksum & 0xffff);
+    InternetChecksum checksum;
+    checksum.add({ &pseudo_header, sizeof(pseudo_header) });
+    checksum.add({ &packet, packet.header_size() });
+    checksum.add({ packet.payload(), payload_size });
+    return checksum.finish();
 }
 
 ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
@@ -459,6 +511,19 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
     MutexLocker locker(mutex());
 
     switch (option) {
+    case TCP_CONGESTION: {
+        // Switching algorithms mid-connection would need the window state translated between them,
+        // so only allow picking one before the connection is set up.
+        if (m_state != State::Closed && m_state != State::Listen)
+            return EISCONN;
+        auto name = TRY(Process::get_syscall_name_string_fixed_buffer<TCP_CA_NAME_MAX>(static_ptr_cast<char const*>(user_value), user_value_size));
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name.representable_view());
+        if (!algorithm.has_value())
+            return ENOENT;
+        if (algorithm.value() != m_congestion_control->algorithm())
+            m_congestion_control = TRY(TCPCongestionControl::try_create(algorithm.value(), default_maximum_segment_size));
+        return {};
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -476,6 +541,15 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
     TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
 
     switch (option) {
+    case TCP_CONGESTION: {
+        auto name = TCPCongestionControl::to_string(m_congestion_control->algorithm());
+        auto length = name.length() + 1;
+        if (size < length)
+            return EINVAL;
+        TRY(copy_to_user(static_ptr_cast<char*>(value), name.characters_without_null_termination(), length));
+        size = length;
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -502,33 +576,36 @@ ErrorOr<void> TCPSocket::protocol_bind()
         constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
         u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-        return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<void> {
-            u16 port = first_scan_port;
-            while (true) {
-                IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
-
-                auto it = table.find(proposed_tuple);
-                if (it == table.end()) {
-                    set_local_port(port);
-                    m_registered_socket_tuple = proposed_tuple;
-                    table.set(proposed_tuple, this);
-                    dbgln_if(TCP_SOCKET_DEBUG, "...allocated port {}, tuple {}", port, proposed_tuple.to_string());
-                    return {};
-                }
-                ++port;
-                if (port > last_ephemeral_port)
-                    port = first_ephemeral_port;
-                if (port == first_scan_port)
-                    break;
+        u16 port = first_scan_port;
+        while (true) {
+            IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
+
+            // Every candidate tuple may belong to a different stripe, so claim them one at a time.
+            bool claimed = sockets_by_tuple().with_exclusive(proposed_tuple, [&](auto& table) {
+                if (table.contains(proposed_tuple))
+                    return false;
+                set_local_port(port);
+                m_registered_socket_tuple = proposed_tuple;
+                table.set(proposed_tuple, this);
+                return true;
+            });
+            if (claimed) {
+                dbgln_if(TCP_SOCKET_DEBUG, "...allocated port {}, tuple {}", port, proposed_tuple.to_string());
+                return {};
             }
-            return set_so_error(EADDRINUSE);
-        });
+            ++port;
+            if (port > last_ephemeral_port)
+                port = first_ephemeral_port;
+            if (port == first_scan_port)
+                break;
+        }
+        return set_so_error(EADDRINUSE);
     } else {
         // Verify that the user-supplied port is not already used by someone else.
-        bool ok = sockets_by_tuple().with_exclusive([&](auto& table) -> bool {
-            if (table.contains(tuple()))
+        auto socket_tuple = tuple();
+        bool ok = sockets_by_tuple().with_exclusive(socket_tuple, [&](auto& table) -> bool {
+            if (table.contains(socket_tuple))
                 return false;
-            auto socket_tuple = tuple();
             m_registered_socket_tuple = socket_tuple;
             table.set(socket_tuple, this);
             return true;
@@ -563,15 +640,19 @@ ErrorOr<void> TCPSocket::protocol_connect(OpenFileDescription& description)
         // it will already be registered in the TCPSocket sockets_by_tuple table, under the previous
         // socket tuple. We replace the entry in the table to ensure it is also properly removed on
         // socket deletion, to prevent a dangling reference.
-        TRY(sockets_by_tuple().with_exclusive([this](auto& table) -> ErrorOr<void> {
-            auto removed = table.remove(*m_registered_socket_tuple);
-            VERIFY(removed);
-            if (table.contains(tuple()))
+        // The two tuples may live in different stripes, so claim the new one before giving up the old one.
+        auto socket_tuple = tuple();
+        TRY(sockets_by_tuple().with_exclusive(socket_tuple, [&](auto& table) -> ErrorOr<void> {
+            if (table.contains(socket_tuple))
                 return set_so_error(EADDRINUSE);
-            table.set(tuple(), this);
+            table.set(socket_tuple, this);
             return {};
         }));
-        m_registered_socket_tuple = tuple();
+        sockets_by_tuple().with_exclusive(*m_registered_socket_tuple, [this](auto& table) {
+            auto removed = table.remove(*m_registered_socket_tuple);
+            VERIFY(removed);
+        });
+        m_registered_socket_tuple = socket_tuple;
     }
 
     m_sequence_number = get_good_random<u32>();
@@ -674,18 +755,19 @@ void TCPSocket::retransmit_packets()
 {
     auto now = TimeManagement::the().monotonic_time();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    // RFC 6298, section 5.5: back off exponentially for every retransmission of the same segment.
+    // According to RFC 1122 we must do this even for SYN packets.
+    auto timeout = m_retransmission_timeout;
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts && timeout < maximum_retransmission_timeout; i++)
+        timeout += timeout;
+    timeout = min(timeout, maximum_retransmission_timeout);
 
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (m_retransmit_timer_start + timeout > now)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
-    m_last_retransmit_time = now;
+    m_retransmit_timer_start = now;
     ++m_retransmit_attempts;
 
     if (m_retransmit_attempts > maximum_retransmits) {
@@ -695,47 +777,73 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (unacked_packets.packets.is_empty())
+            return;
+        m_congestion_control->on_retransmit_timeout(m_sequence_number, unacked_packets.size, now);
+        // Only the oldest segment is resent right away. The congestion window is down to a single
+        // segment now, and the rest follows as ACKs come in.
+        retransmit_first_unacked_packet(unacked_packets);
+    });
+}
+
+void TCPSocket::retransmit_first_unacked_packet(UnackedPackets& unacked_packets)
+{
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     auto routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return;
+    retransmit_packet(unacked_packets.packets.first(), routing_decision);
+}
 
-    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-        for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
 
-            auto packet_buffer = packet.buffer->bytes();
+    // Acknowledge everything we've received since the segment was first sent. Only the acknowledgment
+    // number changes, so the checksum can be patched instead of summing up the whole segment again.
+    auto& tcp_packet = *bit_cast<TCPPacket*>(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+    if (tcp_packet.has_ack() && tcp_packet.ack_number() != m_ack_number) {
+        tcp_packet.set_checksum(InternetChecksum::update(tcp_packet.checksum(), tcp_packet.ack_number(), m_ack_number));
+        tcp_packet.set_ack_number(m_ack_number);
+        m_last_ack_number_sent = m_ack_number;
+        m_last_ack_sent_time = TimeManagement::the().monotonic_time();
+    }
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
-        }
-    });
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+    m_retransmits++;
+
+    // Karn's algorithm: an ACK can't tell us which transmission it is for anymore.
+    m_round_trip_time_measurement.clear();
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -746,11 +854,10 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
+    // Non-blocking writers are held to the congestion and receive windows as well, they just get EAGAIN
+    // instead of waiting for them to open up again.
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return unacked_packets.size + size <= effective_send_window();
     });
 }
 }
@@ -15,6 +15,8 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IP/Socket.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+#include <Kernel/Net/TCPSocketTable.h>
 #include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
@@ -23,7 +25,7 @@ class TCPSocket final : public IPv4Socket {
 public:
     static void for_each(Function<void(TCPSocket const&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(TCPSocket const&)>);
-    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, TCPCongestionControl::Algorithm = TCPCongestionControl::Algorithm::NewReno);
     virtual ~TCPSocket() override;
 
     virtual bool unref() const override;
@@ -136,6 +138,12 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmits() const { return m_retransmits; }
+
+    TCPCongestionControl const& congestion_control() const { return *m_congestion_control; }
+    Duration smoothed_round_trip_time() const { return m_smoothed_round_trip_time; }
+    Duration round_trip_time_variance() const { return m_round_trip_time_variance; }
+    Duration retransmission_timeout() const { return m_retransmission_timeout; }
 
     void set_send_window_scale(size_t scale)
     {
@@ -154,7 +162,7 @@ public:
 
     bool should_delay_next_ack() const;
 
-    static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
+    static TCPSocketTable& sockets_by_tuple();
     static RefPtr<TCPSocket> from_tuple(IPv4SocketTuple const& tuple);
 
     static MutexProtected<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& closing_sockets();
@@ -165,6 +173,8 @@ public:
     void release_to_originator();
     void release_for_accept(NonnullRefPtr<TCPSocket>);
 
+    // The NetworkTask checks for expired retransmission timers at least this often.
+    static constexpr Duration retransmit_timer_granularity = Duration::from_milliseconds(100);
     void retransmit_packets();
 
     virtual ErrorOr<void> close() override;
@@ -180,7 +190,7 @@ protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -198,6 +208,9 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    void update_round_trip_time(Duration sample);
+    u32 effective_send_window() const { return min(m_send_window_size, m_congestion_control->congestion_window()); }
+
     static constexpr size_t receive_window_scale()
     {
         auto buffer_size_bit_length = AK::log2(receive_buffer_size) + 1;
@@ -234,6 +247,9 @@ private:
 
     MutexProtected<UnackedPackets> m_unacked_packets;
 
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+    void retransmit_first_unacked_packet(UnackedPackets&);
+
     u32 m_duplicate_acks { 0 };
 
     u32 m_last_ack_number_sent { 0 };
@@ -243,8 +259,27 @@ private:
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
-    MonotonicTime m_last_retransmit_time;
+    MonotonicTime m_retransmit_timer_start;
     u32 m_retransmit_attempts { 0 };
+    u32 m_retransmits { 0 };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+
+    // Round-trip time estimation as per RFC 6298. Only one segment is timed at a time,
+    // and the measurement is dropped once anything is retransmitted (Karn's algorithm).
+    static constexpr Duration initial_retransmission_timeout = Duration::from_seconds(1);
+    // Like most other stacks we go below RFC 6298's conservative minimum of one second.
+    static constexpr Duration minimum_retransmission_timeout = Duration::from_milliseconds(200);
+    static constexpr Duration maximum_retransmission_timeout = Duration::from_seconds(60);
+    struct RoundTripTimeMeasurement {
+        u32 sequence_number { 0 };
+        MonotonicTime send_time;
+    };
+    Optional<RoundTripTimeMeasurement> m_round_trip_time_measurement;
+    bool m_has_round_trip_time_sample { false };
+    Duration m_smoothed_round_trip_time;
+    Duration m_round_trip_time_variance;
+    Duration m_retransmission_timeout { initial_retransmission_timeout };
 
     // Default to maximum window size. receive_tcp_packet() will update from the
     // peer's advertised window size.
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Net/IP/SocketTuple.h>
+
+namespace Kernel {
+
+class TCPSocket;
+
+// The table of all registered TCP sockets, keyed by their tuple. Every incoming segment
+// looks its socket up here, so instead of a single lock, the table is split into stripes
+// that are locked independently. Operations on connections that land in different
+// stripes never contend with each other, and lookups only ever take a shared lock.
+class TCPSocketTable {
+public:
+    static constexpr size_t stripe_count = 64;
+
+    using Stripe = HashMap<IPv4SocketTuple, TCPSocket*>;
+
+    // Runs the callback with the stripe that the given tuple belongs to locked.
+    // Only that tuple may be looked up or modified from within the callback.
+    template<typename Callback>
+    decltype(auto) with_shared(IPv4SocketTuple const& tuple, Callback callback) const
+    {
+        return stripe_for(tuple).with_shared(move(callback));
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(IPv4SocketTuple const& tuple, Callback callback)
+    {
+        return stripe_for(tuple).with_exclusive(move(callback));
+    }
+
+    // Visits every socket, locking one stripe at a time. Sockets that are added or
+    // removed concurrently may or may not be visited.
+    template<typename Callback>
+    ErrorOr<void> try_for_each_shared(Callback callback) const
+    {
+        for (auto& stripe : m_stripes) {
+            TRY(stripe.with_shared([&](auto const& sockets) -> ErrorOr<void> {
+                for (auto& it : sockets)
+                    TRY(callback(it));
+                return {};
+            }));
+        }
+        return {};
+    }
+
+private:
+    static size_t stripe_index(IPv4SocketTuple const& tuple)
+    {
+        // The stripes' HashMaps bucket by the same hash, so mix it before picking a
+        // stripe. Otherwise all keys in a stripe would share their low bits.
+        return int_hash(Traits<IPv4SocketTuple>::hash(tuple)) % stripe_count;
+    }
+
+    MutexProtected<Stripe>& stripe_for(IPv4SocketTuple const& tuple) { return m_stripes[stripe_index(tuple)]; }
+    MutexProtected<Stripe> const& stripe_for(IPv4SocketTuple const& tuple) const { return m_stripes[stripe_index(tuple)]; }
+
+    Array<MutexProtected<Stripe>, stripe_count> m_stripes;
+};
+
+}
@@ -198,23 +198,7 @@ void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: handle_queue_update {}", queue_index);
 
     if (queue_index == RECEIVEQ) {
-        // FIXME: Disable interrupts while receiving as recommended by the spec.
-        auto& queue = get_queue(RECEIVEQ);
-        SpinlockLocker queue_lock(queue.lock());
-        size_t used;
-        VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
-
-        while (!popped_chain.is_empty()) {
-            VERIFY(popped_chain.length() == 1);
-            popped_chain.for_each([&](PhysicalAddress addr, size_t length) {
-                size_t offset = addr.as_ptr() - m_rx_buffers->start_of_region().as_ptr();
-                auto* message = reinterpret_cast<VirtIONetHdr*>(m_rx_buffers->vaddr().offset(offset).as_ptr());
-                did_receive({ message->frame, length - sizeof(VirtIONetHdr) });
-            });
-
-            supply_chain_and_notify(RECEIVEQ, popped_chain);
-            popped_chain = queue.pop_used_buffer_chain(used);
-        }
+        receive_or_schedule_poll();
     } else if (queue_index == TRANSMITQ) {
         auto& queue = get_queue(TRANSMITQ);
         SpinlockLocker queue_lock(queue.lock());
@@ -234,6 +218,39 @@ void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
     }
 }
 
+size_t VirtIONetworkAdapter::poll_receive(size_t budget)
+{
+    auto& queue = get_queue(RECEIVEQ);
+    SpinlockLocker queue_lock(queue.lock());
+    size_t received = 0;
+    for (; received < budget; ++received) {
+        size_t used;
+        VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
+        if (popped_chain.is_empty())
+            break;
+
+        VERIFY(popped_chain.length() == 1);
+        popped_chain.for_each([&](PhysicalAddress addr, size_t length) {
+            size_t offset = addr.as_ptr() - m_rx_buffers->start_of_region().as_ptr();
+            auto* message = reinterpret_cast<VirtIONetHdr*>(m_rx_buffers->vaddr().offset(offset).as_ptr());
+            did_receive({ message->frame, length - sizeof(VirtIONetHdr) });
+        });
+
+        supply_chain_and_notify(RECEIVEQ, popped_chain);
+    }
+    return received;
+}
+
+void VirtIONetworkAdapter::set_receive_interrupts_enabled(bool enabled)
+{
+    // As recommended by the spec, we don't want to be notified about buffers while we are polling for them.
+    auto& queue = get_queue(RECEIVEQ);
+    if (enabled)
+        queue.enable_interrupts();
+    else
+        queue.disable_interrupts();
+}
+
 static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ring, u8 const* data, size_t length)
 {
     UserOrKernelBuffer buf = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data));
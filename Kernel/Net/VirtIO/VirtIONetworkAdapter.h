@@ -42,6 +42,8 @@ private:
 
     // NetworkAdapter
     virtual void send_raw(ReadonlyBytes) override;
+    virtual size_t poll_receive(size_t budget) override;
+    virtual void set_receive_interrupts_enabled(bool) override;
 
 private:
     VirtIO::Configuration const* m_device_config { nullptr };
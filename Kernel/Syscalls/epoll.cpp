@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// Arbitrary limit, so a single wait can't make us allocate an unbounded amount of memory.
+static constexpr int maximum_events_per_wait = 1024;
+
+ErrorOr<FlatPtr> Process::sys$epoll_create(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto epoll = TRY(EPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(epoll)));
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & EPOLL_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(Userspace<Syscall::SC_epoll_ctl_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto epoll_description = TRY(open_file_description(params.epoll_fd));
+    if (!epoll_description->is_epoll())
+        return EINVAL;
+    auto& epoll = *epoll_description->epoll();
+
+    auto description = TRY(open_file_description(params.fd));
+    if (description == epoll_description)
+        return EINVAL;
+
+    epoll_event event {};
+    if (params.op != EPOLL_CTL_DEL)
+        TRY(copy_from_user(&event, params.event));
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        TRY(epoll.add_interest(params.fd, *description, event));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(epoll.modify_interest(params.fd, *description, event));
+        return 0;
+    case EPOLL_CTL_DEL:
+        TRY(epoll.remove_interest(params.fd, *description));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.max_events <= 0)
+        return EINVAL;
+
+    auto epoll_description = TRY(open_file_description(params.epoll_fd));
+    if (!epoll_description->is_epoll())
+        return EINVAL;
+    auto& epoll = *epoll_description->epoll();
+
+    Optional<Duration> deadline;
+    bool should_block = true;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        should_block = !timeout_time.is_zero();
+        deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + timeout_time;
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    Vector<epoll_event, 32> events;
+    TRY(events.try_resize(min(params.max_events, maximum_events_per_wait)));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    for (;;) {
+        auto event_count = TRY(epoll.collect_ready_events(events.span()));
+        if (event_count > 0) {
+            TRY(copy_n_to_user(params.events, events.data(), event_count));
+            return event_count;
+        }
+        if (!should_block)
+            return 0;
+
+        // The ready list may only hold interests that turn out not to be ready anymore,
+        // in which case we simply go around again. The deadline stays the same, so those
+        // wakeups don't restart the timeout.
+        Thread::BlockTimeout timeout;
+        if (deadline.has_value()) {
+            if (TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) >= *deadline)
+                return 0;
+            timeout = Thread::BlockTimeout(true, &deadline.value(), nullptr, CLOCK_MONOTONIC_COARSE);
+        }
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto result = current_thread->block<Thread::ReadBlocker>(timeout, *epoll_description, unblock_flags);
+        if (result == Thread::BlockResult::InterruptedByTimeout)
+            return 0;
+        if (result.was_interrupted())
+            return EINTR;
+    }
+}
+
+}
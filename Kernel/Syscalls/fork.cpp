@@ -9,6 +9,7 @@
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/Memory/Region.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
@@ -135,9 +136,12 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         return child->address_space().with([&](auto& child_space) -> ErrorOr<void> {
             if (parent_space->enforces_syscall_regions())
                 child_space->set_enforces_syscall_regions();
+            // Making our private regions copy-on-write changes most of our mappings,
+            // so flush all of them at once instead of once per region.
+            Memory::TLBFlushBatch parent_flush_batch(parent_space->page_directory());
             for (auto& region : parent_space->region_tree().regions()) {
                 dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
-                auto region_clone = TRY(region.try_clone());
+                auto region_clone = TRY(region.try_clone(parent_flush_batch));
                 TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
                 TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
                 (void)region_clone.leak_ptr();
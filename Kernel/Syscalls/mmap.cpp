@@ -17,6 +17,7 @@
 #include <Kernel/Memory/PrivateInodeVMObject.h>
 #include <Kernel/Memory/Region.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Tasks/PerformanceEventBuffer.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
@@ -120,6 +121,7 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
     bool map_noreserve = flags & MAP_NORESERVE;
     bool map_randomized = flags & MAP_RANDOMIZED;
     bool map_fixed_noreplace = flags & MAP_FIXED_NOREPLACE;
+    bool map_hugetlb = flags & MAP_HUGETLB;
 
     if (map_shared && map_private)
         return EINVAL;
@@ -135,6 +137,14 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
     if (map_stack && (!map_private || !map_anonymous))
         return EINVAL;
 
+    // Large pages are only a hint, but they need memory that we can allocate up front.
+    if (map_hugetlb && (!map_anonymous || map_noreserve || map_stack || (flags & MAP_PURGEABLE)))
+        return EINVAL;
+
+    // Anonymous memory that spans whole large pages is lined up with them, so that it can be mapped with them.
+    if (Memory::large_pages_are_supported && map_anonymous && !(flags & MAP_PURGEABLE) && rounded_size >= Memory::LARGE_PAGE_SIZE)
+        alignment = max(alignment, Memory::LARGE_PAGE_SIZE);
+
     Memory::VirtualRange requested_range { VirtualAddress { addr }, rounded_size };
     if (addr && !(map_fixed || map_fixed_noreplace)) {
         // If there's an address but MAP_FIXED wasn't specified, the address is just a hint.
@@ -150,6 +160,9 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
 
     if (map_anonymous) {
         auto strategy = map_noreserve ? AllocationStrategy::None : AllocationStrategy::Reserve;
+        // Allocating everything now lets the whole mapping be backed by large pages right away.
+        if (map_hugetlb)
+            strategy = AllocationStrategy::AllocateNow;
 
         if (flags & MAP_PURGEABLE) {
             vmobject = TRY(Memory::AnonymousVMObject::try_create_purgeable_with_size(rounded_size, strategy));
@@ -308,6 +321,7 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
 
             // Finally, iterate over each region, either updating its access flags if the range covers it wholly,
             // or carving out a new subregion with the appropriate access flags set.
+            Memory::TLBFlushBatch flush_batch(space->page_directory());
             for (auto* old_region : regions) {
                 if (old_region->access() == Memory::prot_to_region_access_flags(prot))
                     continue;
@@ -319,7 +333,7 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
                     old_region->set_writable(prot & PROT_WRITE);
                     old_region->set_executable(prot & PROT_EXEC);
 
-                    old_region->remap();
+                    old_region->remap(flush_batch);
                     continue;
                 }
                 // Remove the old region from our regions tree, since were going to add another region
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t max_sendfile_chunk_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(Userspace<Syscall::SC_sendfile_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.count == 0)
+        return 0;
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", params.out_fd, params.in_fd, params.offset, params.count);
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    // We read from explicit offsets, so that we never consume data that we then fail to write.
+    if (!in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t start_offset;
+    if (params.offset) {
+        TRY(copy_from_user(&start_offset, params.offset));
+        if (start_offset < 0)
+            return EINVAL;
+    } else {
+        start_offset = in_description->offset();
+    }
+
+    // NOTE: The data is still copied through a kernel buffer on its way to the destination, but it never
+    //       has to visit userspace, and large files only take a few round trips through it.
+    auto buffer_size = min(align_up_to(params.count, PAGE_SIZE), max_sendfile_chunk_size);
+    auto kernel_buffer = TRY(KBuffer::try_create_with_size("sendfile"sv, buffer_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(kernel_buffer->data());
+
+    size_t total_sent = 0;
+    ErrorOr<void> result {};
+    while (total_sent < params.count) {
+        auto chunk_size = min(params.count - total_sent, buffer_size);
+        auto nread_or_error = in_description->read(buffer, start_offset + total_sent, chunk_size);
+        if (nread_or_error.is_error()) {
+            result = nread_or_error.release_error();
+            break;
+        }
+        auto nread = nread_or_error.release_value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            result = nwritten_or_error.release_error();
+            break;
+        }
+        total_sent += nwritten_or_error.value();
+        // A non-blocking destination may not take everything at once.
+        if (nwritten_or_error.value() < nread)
+            break;
+    }
+
+    if (total_sent == 0 && result.is_error())
+        return result.release_error();
+
+    off_t end_offset = start_offset + total_sent;
+    if (params.offset)
+        TRY(copy_to_user(params.offset, &end_offset));
+    else
+        TRY(in_description->seek(end_offset, SEEK_SET));
+
+    return total_sent;
+}
+
+}
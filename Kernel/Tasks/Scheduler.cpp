@@ -5,6 +5,7 @@
  */
 
 #include <AK/BuiltinWrappers.h>
+#include <AK/NumericLimits.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
@@ -44,9 +45,82 @@ struct ThreadReadyQueues {
     u32 mask {};
     static constexpr size_t count = sizeof(mask) * 8;
     Array<ThreadReadyQueue, count> queues;
+
+    Thread* find_next_runnable_thread(u32 affinity_mask)
+    {
+        auto priority_mask = mask;
+        while (priority_mask != 0) {
+            auto priority = bit_scan_forward(priority_mask);
+            VERIFY(priority > 0);
+            auto& ready_queue = queues[--priority];
+            for (auto& thread : ready_queue.thread_list) {
+                VERIFY(thread.m_runnable_priority == (int)priority);
+                if (thread.is_active())
+                    continue;
+                if (!(thread.affinity() & affinity_mask))
+                    continue;
+                return &thread;
+            }
+            priority_mask &= ~(1u << priority);
+        }
+        return nullptr;
+    }
+
+    Optional<u32> highest_runnable_priority(u32 affinity_mask)
+    {
+        auto* thread = find_next_runnable_thread(affinity_mask);
+        if (!thread)
+            return {};
+        return thread->m_runnable_priority;
+    }
+
+    void append(Thread& thread, u32 priority, u32 processor_id)
+    {
+        VERIFY(thread.m_runnable_priority < 0);
+        thread.m_runnable_priority = (int)priority;
+        thread.m_ready_queue_processor_id = processor_id;
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        auto& ready_queue = queues[priority];
+        bool was_empty = ready_queue.thread_list.is_empty();
+        ready_queue.thread_list.append(thread);
+        if (was_empty)
+            mask |= (1u << priority);
+    }
+
+    void remove(Thread& thread)
+    {
+        auto priority = thread.m_runnable_priority;
+        VERIFY(priority >= 0);
+        VERIFY(mask & (1u << priority));
+        auto& ready_queue = queues[priority];
+        thread.m_runnable_priority = -1;
+        ready_queue.thread_list.remove(thread);
+        if (ready_queue.thread_list.is_empty())
+            mask &= ~(1u << priority);
+    }
 };
 
-static Singleton<RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// NOTE: Every processor has its own set of ready queues, so that processors don't have to fight
+//       over a single lock and cache line whenever they look for something to run. Threads are
+//       queued on the processor they last ran on, and idle processors steal work from the others.
+//       Each set of queues is protected by its own lock only, g_scheduler_lock isn't needed to
+//       touch them. A thread that is migrated between processors is moved while holding the
+//       locks of both, so that it's always in a queue that dequeue_runnable_thread() can find.
+struct ProcessorReadyQueues {
+    RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None> queues {};
+    // NOTE: This is only a hint that lets other processors skip empty queues without taking their lock.
+    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> thread_count { 0 };
+    // NOTE: This is only ever touched by the owning processor from its timer interrupt.
+    u32 ticks_since_load_balance { 0 };
+};
+
+// Thread affinities are 32-bit masks, so we can't ever schedule anything on more processors than that.
+static constexpr size_t max_schedulable_processor_count = sizeof(u32) * 8;
+
+// Every processor looks for work on busier processors every this many ticks.
+static constexpr u32 load_balance_interval_in_ticks = 25;
+
+static Singleton<Array<ProcessorReadyQueues, max_schedulable_processor_count>> g_ready_queues;
 
 static RecursiveSpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -64,73 +138,150 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline u32 schedulable_processor_count()
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    // NOTE: Processor::count() isn't maintained on every architecture, so always assume there is at least one.
+    return clamp(Processor::count(), 1u, static_cast<u32>(max_schedulable_processor_count));
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+static u32 ready_queue_processor_for(Thread const& thread)
+{
+    auto processor_count = schedulable_processor_count();
+    auto schedulable_mask = processor_count == max_schedulable_processor_count ? NumericLimits<u32>::max() : (1u << processor_count) - 1;
+    auto affinity = thread.affinity() & schedulable_mask;
+    VERIFY(affinity != 0);
+
+    // Keep the thread on the processor it last ran on to preserve its cache locality.
+    auto last_processor = thread.cpu();
+    if (last_processor < processor_count && (affinity & (1u << last_processor)))
+        return last_processor;
+    return bit_scan_forward(affinity) - 1;
+}
+
+static Thread* take_runnable_thread_from(u32 processor_id, u32 affinity_mask)
+{
+    auto& processor_queues = (*g_ready_queues)[processor_id];
+    if (processor_queues.thread_count == 0)
+        return nullptr;
+
+    return processor_queues.queues.with([&](auto& ready_queues) -> Thread* {
+        auto* thread = ready_queues.find_next_runnable_thread(affinity_mask);
+        if (!thread)
+            return nullptr;
+        ready_queues.remove(*thread);
+        processor_queues.thread_count--;
+        return thread;
+    });
+}
+
+static Thread* steal_runnable_thread(u32 affinity_mask)
+{
+    auto processor_count = schedulable_processor_count();
+    auto current_id = Processor::current_id();
+
+    // Find the processor with the highest priority thread we could run, lower indices being higher priorities.
+    Optional<u32> victim_id;
+    u32 victim_priority = NumericLimits<u32>::max();
+    for (u32 i = 1; i < processor_count; ++i) {
+        auto id = (current_id + i) % processor_count;
+        auto& processor_queues = (*g_ready_queues)[id];
+        if (processor_queues.thread_count == 0)
+            continue;
+        auto priority = processor_queues.queues.with([&](auto& ready_queues) {
+            return ready_queues.highest_runnable_priority(affinity_mask);
+        });
+        if (priority.has_value() && priority.value() < victim_priority) {
+            victim_id = id;
+            victim_priority = priority.value();
         }
+    }
+    if (!victim_id.has_value())
+        return nullptr;
+
+    // NOTE: The victim's queues may have changed since we looked at them, in which case we just take what's best there now.
+    auto* thread = take_runnable_thread_from(victim_id.value(), affinity_mask);
+    if (thread)
+        dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", current_id, *thread, victim_id.value());
+    return thread;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
+static Thread* migrate_runnable_thread(u32 from_id, u32 to_id)
+{
+    auto& from_queues = (*g_ready_queues)[from_id];
+    auto& to_queues = (*g_ready_queues)[to_id];
+
+    // NOTE: Always take the locks in the same order, so that processors migrating threads to each other can't deadlock.
+    auto& first_queues = from_id < to_id ? from_queues : to_queues;
+    auto& second_queues = from_id < to_id ? to_queues : from_queues;
+    return first_queues.queues.with([&](auto& first_ready_queues) {
+        return second_queues.queues.with([&](auto& second_ready_queues) -> Thread* {
+            auto& from_ready_queues = from_id < to_id ? first_ready_queues : second_ready_queues;
+            auto& to_ready_queues = from_id < to_id ? second_ready_queues : first_ready_queues;
+
+            auto* thread = from_ready_queues.find_next_runnable_thread(1u << to_id);
+            if (!thread)
+                return nullptr;
+            from_ready_queues.remove(*thread);
+            from_queues.thread_count--;
+            to_ready_queues.append(*thread, thread_priority_to_priority_index(thread->priority()), to_id);
+            to_queues.thread_count++;
+            return thread;
+        });
     });
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+static void append_to_ready_queue(u32 processor_id, Thread& thread, u32 priority)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    auto& processor_queues = (*g_ready_queues)[processor_id];
+    processor_queues.queues.with([&](auto& ready_queues) {
+        ready_queues.append(thread, priority, processor_id);
+        processor_queues.thread_count++;
+    });
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+
+    auto* thread = take_runnable_thread_from(current_id, affinity_mask);
+    if (!thread)
+        thread = steal_runnable_thread(affinity_mask);
+
+    if (thread) {
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return *thread;
+    }
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+
+    auto& processor_queues = (*g_ready_queues)[current_id];
+    if (processor_queues.thread_count == 0)
         return nullptr;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    return processor_queues.queues.with([&](auto& ready_queues) {
+        return ready_queues.find_next_runnable_thread(affinity_mask);
     });
 }
 
@@ -139,43 +290,65 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
-            return false;
-        }
+    for (;;) {
+        auto processor_id = thread.m_ready_queue_processor_id.load();
+        auto& processor_queues = (*g_ready_queues)[processor_id];
+        auto result = processor_queues.queues.with([&](auto& ready_queues) -> Optional<bool> {
+            // NOTE: The thread may have been migrated to another processor before we got the lock.
+            if (thread.m_ready_queue_processor_id != processor_id)
+                return {};
+
+            if (thread.m_runnable_priority < 0) {
+                VERIFY(!thread.m_ready_queue_node.is_in_list());
+                return false;
+            }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
+            if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+                return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
-        return true;
-    });
+            ready_queues.remove(thread);
+            processor_queues.thread_count--;
+            return true;
+        });
+        if (result.has_value())
+            return result.value();
+    }
 }
 
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    append_to_ready_queue(ready_queue_processor_for(thread), thread, priority);
+}
 
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
-        ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
-    });
+void Scheduler::balance_load()
+{
+    auto processor_count = schedulable_processor_count();
+    if (processor_count < 2)
+        return;
+
+    auto current_id = Processor::current_id();
+    auto local_thread_count = (*g_ready_queues)[current_id].thread_count.load();
+
+    u32 busiest_id = current_id;
+    u32 busiest_thread_count = 0;
+    for (u32 id = 0; id < processor_count; ++id) {
+        auto thread_count = (*g_ready_queues)[id].thread_count.load();
+        if (id != current_id && thread_count > busiest_thread_count) {
+            busiest_id = id;
+            busiest_thread_count = thread_count;
+        }
+    }
+
+    // Only migrate a thread if doing so actually evens out the load, otherwise we'd just
+    // bounce threads (and their cache footprint) back and forth between processors.
+    if (busiest_id == current_id || busiest_thread_count < local_thread_count + 2)
+        return;
+
+    if (auto* thread = migrate_runnable_thread(busiest_id, current_id))
+        dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Migrated {} from processor {}", current_id, *thread, busiest_id);
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -440,6 +613,12 @@ void Scheduler::timer_tick()
         return;
     }
 
+    auto& processor_queues = (*g_ready_queues)[Processor::current_id()];
+    if (++processor_queues.ticks_since_load_balance >= load_balance_interval_in_ticks) {
+        processor_queues.ticks_since_load_balance = 0;
+        balance_load();
+    }
+
     if (current_thread->tick())
         return;
 
@@ -64,6 +64,7 @@ class Thread
     friend class Process;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ThreadReadyQueues;
 
 public:
     static Thread* current()
@@ -1094,6 +1095,8 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    // NOTE: This is only changed while holding the lock of the processor's ready queues, see dequeue_runnable_thread().
+    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> m_ready_queue_processor_id { 0 };
 
     friend class WaitQueue;
 
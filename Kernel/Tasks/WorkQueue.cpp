@@ -15,11 +15,15 @@ namespace Kernel {
 
 WorkQueue* g_io_work;
 WorkQueue* g_ata_work;
+WorkQueue* g_read_ahead_work;
 
 UNMAP_AFTER_INIT void WorkQueue::initialize()
 {
     g_io_work = new WorkQueue("IO WorkQueue Task"sv);
     g_ata_work = new WorkQueue("ATA WorkQueue Task"sv);
+    // NOTE: Read-ahead waits for the disk, and AHCI and VirtIO complete their requests on g_io_work,
+    //       so it needs a queue of its own as well.
+    g_read_ahead_work = new WorkQueue("Read-ahead WorkQueue Task"sv);
 }
 
 UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name)
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/InternetChecksum.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+
+static u16 reference_checksum(ReadonlyBytes bytes)
+{
+    u64 sum = 0;
+    for (size_t i = 0; i < bytes.size(); i += 2) {
+        u16 high = bytes[i];
+        u16 low = i + 1 < bytes.size() ? bytes[i + 1] : 0;
+        sum += (high << 8) | low;
+    }
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+    return static_cast<u16>(~sum);
+}
+
+static u16 checksum_of(ReadonlyBytes bytes)
+{
+    InternetChecksum checksum;
+    checksum.add(bytes);
+    return checksum.finish();
+}
+
+static Vector<u8> random_bytes(size_t size)
+{
+    Vector<u8> bytes;
+    bytes.resize(size);
+    fill_with_random(bytes);
+    return bytes;
+}
+
+TEST_CASE(ipv4_header)
+{
+    Array<u8, 20> header = {
+        0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+        0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8, 0x00, 0xc7
+    };
+    EXPECT_EQ(checksum_of(header), 0xb861);
+
+    // A header with the checksum filled in sums up to zero.
+    header[10] = 0xb8;
+    header[11] = 0x61;
+    EXPECT_EQ(checksum_of(header), 0);
+}
+
+TEST_CASE(empty_and_odd_lengths)
+{
+    EXPECT_EQ(checksum_of({}), 0xffff);
+
+    Array<u8, 1> one_byte = { 0x12 };
+    EXPECT_EQ(checksum_of(one_byte), static_cast<u16>(~0x1200));
+
+    Array<u8, 3> three_bytes = { 0x12, 0x34, 0x56 };
+    EXPECT_EQ(checksum_of(three_bytes), static_cast<u16>(~(0x1234 + 0x5600)));
+}
+
+TEST_CASE(matches_reference_for_all_sizes_and_alignments)
+{
+    auto bytes = random_bytes(512 + 3);
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t size = 0; size <= 512; ++size) {
+            auto span = bytes.span().slice(offset, size);
+            EXPECT_EQ(checksum_of(span), reference_checksum(span));
+        }
+    }
+}
+
+TEST_CASE(large_buffers_keep_all_carries)
+{
+    // All ones is the worst case for the carries, and this is big enough to need several rounds of vector sums.
+    Vector<u8> ones;
+    ones.resize(4 * MiB + 7);
+    ones.span().fill(0xff);
+    EXPECT_EQ(checksum_of(ones), reference_checksum(ones));
+
+    auto bytes = random_bytes(3 * MiB + 1);
+    EXPECT_EQ(checksum_of(bytes), reference_checksum(bytes));
+}
+
+TEST_CASE(chunks_of_any_size)
+{
+    auto bytes = random_bytes(1000);
+    auto expected = reference_checksum(bytes);
+
+    for (size_t chunk_size : { 1, 2, 3, 7, 64, 333 }) {
+        InternetChecksum checksum;
+        for (size_t offset = 0; offset < bytes.size(); offset += chunk_size)
+            checksum.add(bytes.span().slice(offset, min(chunk_size, bytes.size() - offset)));
+        EXPECT_EQ(static_cast<u16>(checksum.finish()), expected);
+    }
+}
+
+TEST_CASE(incremental_update)
+{
+    auto bytes = random_bytes(64);
+    for (size_t i = 0; i < 100; ++i) {
+        auto checksum = checksum_of(bytes);
+
+        auto word_offset = get_random_uniform(bytes.size() / 2) * 2;
+        u16 old_word = (bytes[word_offset] << 8) | bytes[word_offset + 1];
+        u16 new_word = get_random<u16>();
+        bytes[word_offset] = new_word >> 8;
+        bytes[word_offset + 1] = new_word & 0xff;
+        EXPECT_EQ(InternetChecksum::update(checksum, old_word, new_word), checksum_of(bytes));
+    }
+
+    // Changing a field to the same value must not turn 0x0000 into 0xffff or vice versa (RFC 1624, section 3).
+    Array<u8, 4> data = { 0x12, 0x34, 0xed, 0xcb };
+    auto checksum = checksum_of(data);
+    EXPECT_EQ(InternetChecksum::update(checksum, static_cast<u16>(0x1234), static_cast<u16>(0x1234)), checksum);
+}
+
+TEST_CASE(incremental_update_of_32_bit_word)
+{
+    auto bytes = random_bytes(20);
+    auto checksum = checksum_of(bytes);
+
+    u32 old_word = (bytes[12] << 24) | (bytes[13] << 16) | (bytes[14] << 8) | bytes[15];
+    u32 new_word = 0xc0a80001;
+    bytes[12] = 0xc0;
+    bytes[13] = 0xa8;
+    bytes[14] = 0x00;
+    bytes[15] = 0x01;
+    EXPECT_EQ(InternetChecksum::update(checksum, old_word, new_word), checksum_of(bytes));
+}
+
+BENCHMARK_CASE(checksum_full_sized_packets)
+{
+    auto packet = random_bytes(1500);
+    for (size_t i = 0; i < 100'000; ++i) {
+        auto result = checksum_of(packet);
+        AK::taint_for_optimizer(result);
+    }
+}
+
+BENCHMARK_CASE(checksum_large_buffer)
+{
+    auto buffer = random_bytes(64 * KiB);
+    for (size_t i = 0; i < 10'000; ++i) {
+        auto result = checksum_of(buffer);
+        AK::taint_for_optimizer(result);
+    }
+}
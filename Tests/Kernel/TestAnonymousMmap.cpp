@@ -5,6 +5,7 @@
  */
 
 #include <LibTest/TestCase.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
@@ -113,3 +114,89 @@ TEST_CASE(test_that_partial_munmap_does_not_break_cow)
         EXPECT(map[2 * PAGE_SIZE] == 'C');
     }
 }
+
+static constexpr size_t large_page_size = 2 * MiB;
+
+TEST_CASE(hugetlb_anonymous_mmap)
+{
+    size_t len = 2 * large_page_size;
+    char* map = (char*)mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+    EXPECT(map != MAP_FAILED);
+#if ARCH(X86_64)
+    EXPECT_EQ((FlatPtr)map % large_page_size, 0u);
+#endif
+
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i)
+        check_if_page_zeroed(map, i);
+
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i)
+        map[i * PAGE_SIZE] = (char)i;
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i)
+        EXPECT_EQ(map[i * PAGE_SIZE], (char)i);
+
+    EXPECT_EQ(munmap(map, len), 0);
+}
+
+TEST_CASE(hugetlb_requires_anonymous_memory)
+{
+    char* map = (char*)mmap(nullptr, large_page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_HUGETLB | MAP_NORESERVE, -1, 0);
+    EXPECT_EQ(map, MAP_FAILED);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+TEST_CASE(partial_munmap_and_mprotect_of_large_page)
+{
+    size_t len = 2 * large_page_size;
+    char* map = (char*)mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+    EXPECT(map != MAP_FAILED);
+
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i)
+        map[i * PAGE_SIZE] = '$';
+
+    // Punch a hole into the middle of the first large page, and make part of the second one read-only.
+    EXPECT_EQ(munmap(map + 16 * PAGE_SIZE, PAGE_SIZE), 0);
+    EXPECT_EQ(mprotect(map + large_page_size, PAGE_SIZE, PROT_READ), 0);
+
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i) {
+        if (i == 16)
+            continue;
+        EXPECT_EQ(map[i * PAGE_SIZE], '$');
+    }
+
+    map[15 * PAGE_SIZE] = 'A';
+    map[17 * PAGE_SIZE] = 'B';
+    map[large_page_size + PAGE_SIZE] = 'C';
+    EXPECT_EQ(map[15 * PAGE_SIZE], 'A');
+    EXPECT_EQ(map[17 * PAGE_SIZE], 'B');
+    EXPECT_EQ(map[large_page_size + PAGE_SIZE], 'C');
+
+    // Unmapping across the hole and the read-only page has to work as well.
+    EXPECT_EQ(munmap(map, len), 0);
+}
+
+TEST_CASE(large_page_is_copied_on_write_after_fork)
+{
+    size_t len = large_page_size;
+    char* map = (char*)mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+    EXPECT(map != MAP_FAILED);
+
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i)
+        map[i * PAGE_SIZE] = 'A';
+
+    pid_t pid = fork();
+    VERIFY(pid != -1);
+    if (pid == 0) {
+        for (size_t i = 0; i < len / PAGE_SIZE; i += 2)
+            map[i * PAGE_SIZE] = '!';
+        exit(EXIT_SUCCESS);
+    }
+
+    wait(nullptr);
+    for (size_t i = 0; i < len / PAGE_SIZE; ++i)
+        EXPECT_EQ(map[i * PAGE_SIZE], 'A');
+
+    // The parent's own writes must not leak into its other pages either.
+    map[0] = 'B';
+    EXPECT_EQ(map[0], 'B');
+    EXPECT_EQ(map[PAGE_SIZE], 'A');
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static void add_interest(int epoll_fd, int fd, u32 events)
+{
+    epoll_event event { .events = events, .data = { .fd = fd } };
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event));
+}
+
+static int wait_for_events(int epoll_fd, Span<epoll_event> events)
+{
+    return MUST(Core::System::epoll_wait(epoll_fd, events, 0));
+}
+
+TEST_CASE(level_triggered)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::write(pipe_fds[1], "ab"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+    EXPECT(events[0].events & EPOLLIN);
+
+    // Nothing has been read yet, so the pipe has to be reported again.
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    char buffer[2];
+    MUST(Core::System::read(pipe_fds[0], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(edge_triggered)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLET);
+
+    Array<epoll_event, 4> events;
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    // The data is still there, but nothing changed since we were told about it.
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::write(pipe_fds[1], "b"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(one_shot)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLONESHOT);
+
+    Array<epoll_event, 4> events;
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    // Modifying the interest re-arms it.
+    epoll_event event { .events = EPOLLIN | EPOLLONESHOT, .data = { .fd = pipe_fds[0] } };
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(interest_management)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    epoll_event event { .events = EPOLLIN, .data = { .fd = pipe_fds[0] } };
+    auto result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EEXIST);
+
+    result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[1], &event);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), ENOENT);
+
+    result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, epoll_fd, &event);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EINVAL);
+
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr));
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(closing_a_watched_fd_drops_the_interest)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN);
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    MUST(Core::System::close(pipe_fds[0]));
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    // The fd number can be registered again once it has been reused.
+    auto new_pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, new_pipe_fds[0], EPOLLIN);
+
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(new_pipe_fds[0]));
+    MUST(Core::System::close(new_pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(timeout_without_events)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    auto start = MonotonicTime::now_coarse();
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 50)), 0);
+    EXPECT((MonotonicTime::now_coarse() - start).to_milliseconds() >= 40);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/ScopeGuard.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <serenity.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// NOTE: /tmp doesn't go through the page cache, so these tests have to use a file on the root file system.
+static constexpr auto TEST_FILE_PATH = "/home/anon/.page_cache_test";
+
+static int create_test_file(size_t size, u8 fill)
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    u8 buffer[PAGE_SIZE];
+    memset(buffer, fill, sizeof(buffer));
+    for (size_t offset = 0; offset < size; offset += sizeof(buffer)) {
+        auto length = min(sizeof(buffer), size - offset);
+        VERIFY(write(fd, buffer, length) == static_cast<ssize_t>(length));
+    }
+    return fd;
+}
+
+static void read_exactly(int fd, off_t offset, u8* buffer, size_t length)
+{
+    VERIFY(lseek(fd, offset, SEEK_SET) == offset);
+    size_t nread = 0;
+    while (nread < length) {
+        auto rc = read(fd, buffer + nread, length - nread);
+        VERIFY(rc > 0);
+        nread += rc;
+    }
+}
+
+static u64 physical_pages_uncommitted()
+{
+    int fd = open("/sys/kernel/memstat", O_RDONLY);
+    VERIFY(fd >= 0);
+    char buffer[4096];
+    auto nread = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    VERIFY(nread > 0);
+    auto json = JsonValue::from_string(StringView { buffer, static_cast<size_t>(nread) });
+    VERIFY(!json.is_error());
+    return json.value().as_object().get_u64("physical_uncommitted"sv).value();
+}
+
+TEST_CASE(read_and_shared_mapping_see_each_others_writes)
+{
+    static constexpr size_t file_size = 4 * PAGE_SIZE;
+    int fd = create_test_file(file_size, 'A');
+    ScopeGuard cleanup = [&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    };
+
+    auto* mapping = static_cast<u8*>(mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    VERIFY(mapping != MAP_FAILED);
+    EXPECT_EQ(mapping[PAGE_SIZE + 1], 'A');
+
+    // A write() has to show up in a mapping that already has the page faulted in.
+    VERIFY(lseek(fd, PAGE_SIZE + 1, SEEK_SET) == PAGE_SIZE + 1);
+    VERIFY(write(fd, "B", 1) == 1);
+    EXPECT_EQ(mapping[PAGE_SIZE + 1], 'B');
+
+    // And a store through the mapping has to show up in read(), without an msync() in between.
+    mapping[3 * PAGE_SIZE + 7] = 'C';
+    u8 byte = 0;
+    read_exactly(fd, 3 * PAGE_SIZE + 7, &byte, 1);
+    EXPECT_EQ(byte, 'C');
+
+    EXPECT_EQ(munmap(mapping, file_size), 0);
+}
+
+TEST_CASE(truncated_data_does_not_come_back)
+{
+    static constexpr size_t file_size = 3 * PAGE_SIZE;
+    static constexpr size_t truncated_size = PAGE_SIZE + 100;
+    int fd = create_test_file(file_size, 'A');
+    ScopeGuard cleanup = [&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    };
+
+    // Pull the whole file into the page cache first.
+    u8 buffer[file_size];
+    read_exactly(fd, 0, buffer, file_size);
+
+    EXPECT_EQ(ftruncate(fd, truncated_size), 0);
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    EXPECT_EQ(read(fd, buffer, file_size), static_cast<ssize_t>(truncated_size));
+
+    EXPECT_EQ(ftruncate(fd, file_size), 0);
+    read_exactly(fd, 0, buffer, file_size);
+    for (size_t i = 0; i < truncated_size; ++i)
+        EXPECT_EQ(buffer[i], 'A');
+    for (size_t i = truncated_size; i < file_size; ++i)
+        EXPECT_EQ(buffer[i], 0);
+
+    auto* mapping = static_cast<u8*>(mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0));
+    VERIFY(mapping != MAP_FAILED);
+    EXPECT_EQ(mapping[truncated_size - 1], 'A');
+    EXPECT_EQ(mapping[truncated_size], 0);
+    EXPECT_EQ(mapping[2 * PAGE_SIZE], 0);
+    EXPECT_EQ(munmap(mapping, file_size), 0);
+}
+
+TEST_CASE(write_back_keeps_data_and_timestamps)
+{
+    static constexpr size_t file_size = 4 * PAGE_SIZE;
+    int fd = create_test_file(file_size, 'A');
+    ScopeGuard cleanup = [&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    };
+
+    // This write stays within the file, so it only dirties the page cache.
+    u8 buffer[file_size];
+    memset(buffer, 'B', PAGE_SIZE);
+    VERIFY(lseek(fd, 2 * PAGE_SIZE, SEEK_SET) == 2 * PAGE_SIZE);
+    VERIFY(write(fd, buffer, PAGE_SIZE) == PAGE_SIZE);
+
+    timespec const times[2] = { { 1000, 0 }, { 2000, 0 } };
+    EXPECT_EQ(futimens(fd, times), 0);
+
+    // Writing the dirty pages back is not a modification, so the timestamps must survive it.
+    EXPECT_EQ(fsync(fd), 0);
+    struct stat st;
+    EXPECT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(st.st_mtim.tv_sec, 2000);
+
+    // Drop the now clean pages, so that reading the file again has to go to the disk.
+    EXPECT(purge(PURGE_ALL_CLEAN_INODE) >= 0);
+    read_exactly(fd, 0, buffer, file_size);
+    for (size_t i = 0; i < file_size; ++i)
+        EXPECT_EQ(buffer[i], (i / PAGE_SIZE) == 2 ? 'B' : 'A');
+}
+
+TEST_CASE(commit_reclaims_clean_cached_pages)
+{
+    // Fill a good part of the uncommitted memory with clean cached pages.
+    size_t cached_page_count = min<u64>(physical_pages_uncommitted() / 4, 8192);
+    int fd = create_test_file(cached_page_count * PAGE_SIZE, 'A');
+    ScopeGuard cleanup = [&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    };
+    EXPECT_EQ(fsync(fd), 0);
+    u8 buffer[PAGE_SIZE];
+    for (size_t i = 0; i < cached_page_count; ++i)
+        read_exactly(fd, i * PAGE_SIZE, buffer, PAGE_SIZE);
+
+    // This can only be committed if the kernel gives back some of the cached pages first.
+    size_t size = (physical_pages_uncommitted() + cached_page_count / 2) * PAGE_SIZE;
+    auto* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    EXPECT_NE(mapping, MAP_FAILED);
+    if (mapping != MAP_FAILED)
+        EXPECT_EQ(munmap(mapping, size), 0);
+
+    // The file is still readable afterwards, it just comes from the disk again.
+    read_exactly(fd, 0, buffer, PAGE_SIZE);
+    EXPECT_EQ(buffer[0], 'A');
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+static int create_file_with_contents(StringView contents)
+{
+    char pattern[] = "/tmp/sendfile.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+    MUST(Core::System::write(fd, contents.bytes()));
+    return fd;
+}
+
+static ByteBuffer read_from_pipe(int fd, size_t size)
+{
+    auto buffer = MUST(ByteBuffer::create_zeroed(size));
+    auto nread = MUST(Core::System::read(fd, buffer.bytes()));
+    return MUST(buffer.slice(0, nread));
+}
+
+TEST_CASE(sendfile_with_offset)
+{
+    auto file_fd = create_file_with_contents("Well hello friends!"sv);
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+
+    off_t offset = 5;
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, &offset, 5)), 5u);
+    EXPECT_EQ(offset, 10);
+    EXPECT_EQ(StringView { read_from_pipe(pipe_fds[0], 32).bytes() }, "hello"sv);
+
+    // The file offset is left alone when an explicit offset is given.
+    EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), 19);
+
+    // Reading past the end of the file stops there.
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, &offset, 100)), 9u);
+    EXPECT_EQ(offset, 19);
+    EXPECT_EQ(StringView { read_from_pipe(pipe_fds[0], 32).bytes() }, " friends!"sv);
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, &offset, 100)), 0u);
+
+    MUST(Core::System::close(file_fd));
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
+
+TEST_CASE(sendfile_advances_file_offset)
+{
+    auto file_fd = create_file_with_contents("Well hello friends!"sv);
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+
+    MUST(Core::System::lseek(file_fd, 0, SEEK_SET));
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, nullptr, 4)), 4u);
+    EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), 4);
+    EXPECT_EQ(MUST(Core::System::sendfile(pipe_fds[1], file_fd, nullptr, 6)), 6u);
+    EXPECT_EQ(StringView { read_from_pipe(pipe_fds[0], 32).bytes() }, "Well hello"sv);
+
+    MUST(Core::System::close(file_fd));
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
+
+TEST_CASE(sendfile_larger_than_one_chunk)
+{
+    // Large enough that the kernel has to go through its buffer several times.
+    auto contents = MUST(ByteBuffer::create_uninitialized(300 * KiB + 123));
+    for (size_t i = 0; i < contents.size(); ++i)
+        contents[i] = i % 251;
+    auto file_fd = create_file_with_contents(StringView { contents.bytes() });
+    auto destination_fd = create_file_with_contents(""sv);
+
+    off_t offset = 0;
+    EXPECT_EQ(MUST(Core::System::sendfile(destination_fd, file_fd, &offset, contents.size())), contents.size());
+    EXPECT_EQ(offset, static_cast<off_t>(contents.size()));
+
+    auto sent = MUST(ByteBuffer::create_zeroed(contents.size()));
+    MUST(Core::System::lseek(destination_fd, 0, SEEK_SET));
+    size_t nread = 0;
+    while (nread < sent.size()) {
+        auto nread_now = MUST(Core::System::read(destination_fd, sent.bytes().slice(nread)));
+        if (nread_now == 0)
+            break;
+        nread += nread_now;
+    }
+    EXPECT_EQ(nread, contents.size());
+    EXPECT(sent == contents);
+
+    MUST(Core::System::close(file_fd));
+    MUST(Core::System::close(destination_fd));
+}
+
+TEST_CASE(sendfile_errors)
+{
+    auto file_fd = create_file_with_contents("Hi"sv);
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+
+    // The source has to be seekable.
+    auto result = Core::System::sendfile(pipe_fds[1], pipe_fds[0], nullptr, 1);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EINVAL);
+
+    // The destination has to be writable.
+    result = Core::System::sendfile(pipe_fds[0], file_fd, nullptr, 1);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EBADF);
+
+    off_t offset = -1;
+    result = Core::System::sendfile(pipe_fds[1], file_fd, &offset, 1);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EINVAL);
+
+    MUST(Core::System::close(file_fd));
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// NOTE: This is the boot drive, which is an NVMe drive in the default QEMU configuration.
+static constexpr auto STORAGE_DEVICE_PATH = "/dev/hda";
+
+static constexpr size_t thread_count = 8;
+static constexpr size_t rounds = 16;
+static constexpr size_t chunk_size = 128 * KiB;
+
+static void read_exactly(int fd, off_t offset, u8* buffer, size_t length)
+{
+    size_t nread = 0;
+    while (nread < length) {
+        auto rc = pread(fd, buffer + nread, length - nread, offset + nread);
+        VERIFY(rc > 0);
+        nread += rc;
+    }
+}
+
+struct ReaderContext {
+    int fd;
+    size_t index;
+    u8 const* expected;
+    Atomic<size_t>* mismatches;
+};
+
+static void* reader(void* argument)
+{
+    auto& context = *static_cast<ReaderContext*>(argument);
+    for (size_t round = 0; round < rounds; ++round) {
+        // Every round reads into a fresh mapping, so the completed reads have to page in the buffer they're copied to.
+        auto* buffer = static_cast<u8*>(mmap(nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        VERIFY(buffer != MAP_FAILED);
+        auto chunk = (context.index + round) % thread_count;
+        read_exactly(context.fd, chunk * chunk_size, buffer, chunk_size);
+        if (memcmp(buffer, context.expected + chunk * chunk_size, chunk_size) != 0)
+            ++*context.mismatches;
+        VERIFY(munmap(buffer, chunk_size) == 0);
+    }
+    return nullptr;
+}
+
+TEST_CASE(concurrent_reads_see_the_same_data)
+{
+    int fd = open(STORAGE_DEVICE_PATH, O_RDONLY);
+    VERIFY(fd >= 0);
+
+    static u8 expected[thread_count * chunk_size];
+    read_exactly(fd, 0, expected, sizeof(expected));
+
+    Atomic<size_t> mismatches = 0;
+    pthread_t threads[thread_count];
+    ReaderContext contexts[thread_count];
+    for (size_t i = 0; i < thread_count; ++i) {
+        contexts[i] = { fd, i, expected, &mismatches };
+        EXPECT_EQ(pthread_create(&threads[i], nullptr, reader, &contexts[i]), 0);
+    }
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    EXPECT_EQ(mismatches.load(), 0u);
+    close(fd);
+}
+
+TEST_CASE(read_into_inaccessible_buffer)
+{
+    int fd = open(STORAGE_DEVICE_PATH, O_RDONLY);
+    VERIFY(fd >= 0);
+
+    auto* inaccessible = mmap(nullptr, chunk_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    VERIFY(inaccessible != MAP_FAILED);
+
+    // Far more failing reads than a queue has command slots, so any slot that isn't released would be noticed.
+    for (size_t i = 0; i < 1024; ++i) {
+        EXPECT_EQ(pread(fd, inaccessible, chunk_size, 0), -1);
+        EXPECT_EQ(errno, EFAULT);
+    }
+
+    // The device still works afterwards.
+    u8 buffer[PAGE_SIZE];
+    read_exactly(fd, 0, buffer, sizeof(buffer));
+
+    EXPECT_EQ(munmap(inaccessible, chunk_size), 0);
+    close(fd);
+}
@@ -7,9 +7,13 @@
 #include <AK/JsonArray.h>
 #include <LibCore/File.h>
 #include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <string.h>
 #include <sys/socket.h>
 
 static constexpr u16 port = 1337;
@@ -141,6 +145,127 @@ TEST_CASE(tcp_bind_connect)
     }
 }
 
+static ByteString get_congestion_control(int fd)
+{
+    char name[TCP_CA_NAME_MAX];
+    socklen_t length = sizeof(name);
+    int rc = getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &length);
+    EXPECT_EQ(rc, 0);
+    if (rc < 0)
+        return {};
+    EXPECT_EQ(length, strlen(name) + 1);
+    return name;
+}
+
+static int set_congestion_control(int fd, StringView name)
+{
+    return setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name.characters_without_null_termination(), name.length());
+}
+
+TEST_CASE(tcp_congestion_sockopt)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(fd >= 0);
+
+    EXPECT_EQ(get_congestion_control(fd), "newreno"sv);
+
+    EXPECT_EQ(set_congestion_control(fd, "cubic"sv), 0);
+    EXPECT_EQ(get_congestion_control(fd), "cubic"sv);
+
+    // "reno" is accepted as an alias.
+    EXPECT_EQ(set_congestion_control(fd, "reno"sv), 0);
+    EXPECT_EQ(get_congestion_control(fd), "newreno"sv);
+
+    EXPECT_EQ(set_congestion_control(fd, "bbr"sv), -1);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(get_congestion_control(fd), "newreno"sv);
+
+    char name[4];
+    socklen_t length = sizeof(name);
+    EXPECT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &length), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(close(fd), 0);
+}
+
+TEST_CASE(tcp_congestion_sockopt_after_connect)
+{
+    pthread_t server = start_tcp_server();
+
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(client_fd >= 0);
+    EXPECT_EQ(set_congestion_control(client_fd, "cubic"sv), 0);
+
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int rc = connect(client_fd, (sockaddr*)(&sin), sizeof(sin));
+    EXPECT_EQ(rc, 0);
+
+    // The algorithm can't be switched once the connection is set up.
+    EXPECT_EQ(set_congestion_control(client_fd, "newreno"sv), -1);
+    EXPECT_EQ(errno, EISCONN);
+    EXPECT_EQ(get_congestion_control(client_fd), "cubic"sv);
+
+    u8 data = 'A';
+    int nwritten = send(client_fd, &data, sizeof(data), 0);
+    EXPECT_EQ(nwritten, 1);
+
+    rc = close(client_fd);
+    EXPECT_EQ(rc, 0);
+
+    rc = pthread_join(server, nullptr);
+    EXPECT_EQ(rc, 0);
+}
+
+TEST_CASE(tcp_non_blocking_send_respects_send_window)
+{
+    static constexpr u16 window_test_port = 1340;
+
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(server_fd >= 0);
+
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(window_test_port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int rc = bind(server_fd, (sockaddr*)(&sin), sizeof(sin));
+    EXPECT_EQ(rc, 0);
+    rc = listen(server_fd, 1);
+    EXPECT_EQ(rc, 0);
+
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(client_fd >= 0);
+    rc = connect(client_fd, (sockaddr*)(&sin), sizeof(sin));
+    EXPECT_EQ(rc, 0);
+    int accepted_fd = accept(server_fd, nullptr, nullptr);
+    EXPECT(accepted_fd >= 0);
+
+    rc = fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL) | O_NONBLOCK);
+    EXPECT_EQ(rc, 0);
+
+    // Nobody reads on the other end, so the peer's receive window has to close eventually, and a non-blocking
+    // sender must be told to back off rather than sending past it.
+    static constexpr size_t max_total_size = 16 * MiB;
+    u8 buffer[4096] {};
+    size_t total_sent = 0;
+    ssize_t nwritten = 0;
+    while (total_sent < max_total_size) {
+        nwritten = send(client_fd, buffer, sizeof(buffer), 0);
+        if (nwritten < 0)
+            break;
+        total_sent += nwritten;
+    }
+    EXPECT_EQ(nwritten, -1);
+    EXPECT_EQ(errno, EAGAIN);
+    EXPECT(total_sent < max_total_size);
+
+    EXPECT_EQ(close(client_fd), 0);
+    EXPECT_EQ(close(accepted_fd), 0);
+    EXPECT_EQ(close(server_fd), 0);
+}
+
 TEST_CASE(socket_connect_after_bind)
 {
     unlink("/tmp/tmp-client.test");
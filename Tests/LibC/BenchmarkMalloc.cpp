@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+static constexpr size_t thread_count = 4;
+static constexpr size_t iterations_per_thread = 100'000;
+static constexpr size_t live_allocation_count = 64;
+static constexpr size_t handoff_batch_size = 1000;
+static constexpr size_t handoff_batch_count = 200;
+
+static void* malloc_free_loop(void*)
+{
+    Array<void*, live_allocation_count> live {};
+    for (size_t i = 0; i < iterations_per_thread; ++i) {
+        auto slot = i % live_allocation_count;
+        free(live[slot]);
+        // Cycle through every small size class, from 16 up to 1008 bytes.
+        live[slot] = malloc(16 + (i * 16) % 1008);
+        if (!live[slot])
+            return reinterpret_cast<void*>(1);
+    }
+    for (auto* ptr : live)
+        free(ptr);
+    return nullptr;
+}
+
+// One thread allocates batches of chunks and hands them to another thread to free.
+struct Handoff {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t condition = PTHREAD_COND_INITIALIZER;
+    Array<void*, handoff_batch_size> batch {};
+    bool is_full { false };
+    bool is_done { false };
+};
+
+static void* free_handed_off_batches(void* arg)
+{
+    auto& handoff = *static_cast<Handoff*>(arg);
+    Array<void*, handoff_batch_size> batch;
+    while (true) {
+        pthread_mutex_lock(&handoff.mutex);
+        while (!handoff.is_full && !handoff.is_done)
+            pthread_cond_wait(&handoff.condition, &handoff.mutex);
+        if (!handoff.is_full) {
+            pthread_mutex_unlock(&handoff.mutex);
+            return nullptr;
+        }
+        batch = handoff.batch;
+        handoff.is_full = false;
+        pthread_cond_broadcast(&handoff.condition);
+        pthread_mutex_unlock(&handoff.mutex);
+
+        for (auto* ptr : batch)
+            free(ptr);
+    }
+}
+
+BENCHMARK_CASE(malloc_free_single_thread)
+{
+    EXPECT_EQ(malloc_free_loop(nullptr), nullptr);
+}
+
+BENCHMARK_CASE(malloc_free_multiple_threads)
+{
+    Array<pthread_t, thread_count> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, malloc_free_loop, nullptr), 0);
+
+    for (auto& thread : threads) {
+        void* result = nullptr;
+        EXPECT_EQ(pthread_join(thread, &result), 0);
+        EXPECT_EQ(result, nullptr);
+    }
+}
+
+BENCHMARK_CASE(malloc_in_one_thread_free_in_another)
+{
+    Handoff handoff;
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, free_handed_off_batches, &handoff), 0);
+
+    // Keep allocating the next batch while the other thread is still freeing the previous one.
+    Array<void*, handoff_batch_size> batch;
+    for (size_t i = 0; i < handoff_batch_count; ++i) {
+        for (size_t j = 0; j < batch.size(); ++j)
+            batch[j] = malloc(16 + (j * 16) % 1008);
+
+        pthread_mutex_lock(&handoff.mutex);
+        while (handoff.is_full)
+            pthread_cond_wait(&handoff.condition, &handoff.mutex);
+        handoff.batch = batch;
+        handoff.is_full = true;
+        pthread_cond_broadcast(&handoff.condition);
+        pthread_mutex_unlock(&handoff.mutex);
+    }
+
+    pthread_mutex_lock(&handoff.mutex);
+    handoff.is_done = true;
+    pthread_cond_broadcast(&handoff.condition);
+    pthread_mutex_unlock(&handoff.mutex);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+}
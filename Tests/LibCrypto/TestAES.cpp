@@ -465,3 +465,32 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+TEST_CASE(test_AES_GCM_128bit_long_message)
+{
+    // Long enough to go through GCM's chunking and GHASH's aggregated blocks, and not a multiple of the block size.
+    Crypto::Cipher::AESCipher::GCMMode cipher("\xfe\xff\xe9\x92\x86\x65\x73\x1c\x6d\x6a\x8f\x94\x67\x30\x83\x08"_b, 128, Crypto::Cipher::Intent::Encryption);
+    u8 result_tag[] { 0xd1, 0xf0, 0x4e, 0x10, 0xc0, 0x03, 0xb1, 0x73, 0x06, 0xd6, 0xa6, 0x84, 0xc5, 0x21, 0xc8, 0x68 };
+    u8 result_ct_tail[] { 0x39, 0x6c, 0x23, 0x8e, 0xf9, 0x42, 0x1a, 0x07, 0x76, 0x71, 0xd9, 0xa2, 0xe0, 0x57, 0x28, 0x7b };
+    auto iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b;
+    auto aad = "\xde\xad\xbe\xef\xfa\xaf\x11\xcc"_b;
+
+    auto in = ByteBuffer::create_uninitialized(2000).release_value();
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = static_cast<u8>(i * 7);
+
+    auto tag = ByteBuffer::create_uninitialized(16).release_value();
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    cipher.encrypt(in, out, iv, aad, tag);
+    EXPECT(memcmp(result_ct_tail, out.offset_pointer(out.size() - 16), 16) == 0);
+    EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
+
+    auto decrypted = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto consistency = cipher.decrypt(out, decrypted, iv, aad, tag);
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+    EXPECT_EQ(in.bytes(), decrypted.bytes());
+
+    out[1234] ^= 1;
+    consistency = cipher.decrypt(out, decrypted, iv, aad, tag);
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Inconsistent);
+}
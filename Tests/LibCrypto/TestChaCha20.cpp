@@ -5,6 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
+#include <AK/Random.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
 #include <LibTest/TestCase.h>
 
@@ -139,3 +140,125 @@ TEST_CASE(test_vector_3)
     auto expected = ReadonlyBytes { ciphertext, 127 };
     EXPECT_EQ(result, expected);
 }
+
+// Generated with OpenSSL. This goes through the 8-block and 4-block vector paths as well as the scalar tail,
+// and the block counter wraps around (carrying into the next word) in the middle of the first vector.
+TEST_CASE(test_vector_spanning_vectorized_blocks)
+{
+    u8 key[32] {
+        0xe9, 0x9c, 0xe8, 0x0b, 0x40, 0x72, 0x83, 0x6f, 0x94, 0xc3, 0x8b, 0x92, 0x85, 0x51, 0x02, 0x38,
+        0x15, 0x36, 0x2d, 0xac, 0x9a, 0xc2, 0xb2, 0xa8, 0x7c, 0xf4, 0x1a, 0xef, 0xee, 0x5e, 0x16, 0x96
+    };
+    u8 nonce[12] { 0xa2, 0x19, 0x53, 0x6b, 0xdf, 0xc9, 0xad, 0x9e, 0xb4, 0x2d, 0x3b, 0x0c };
+    u32 initial_block_counter { 0xfffffffe };
+    u8 plaintext[577] {
+        0xe8, 0x7c, 0x35, 0x22, 0x63, 0x59, 0x4a, 0xe1, 0x5e, 0x14, 0xcf, 0x73, 0x16, 0x50, 0x6b, 0x97,
+        0xae, 0x90, 0x92, 0x89, 0x84, 0x86, 0x33, 0x97, 0xe8, 0x11, 0x2b, 0x36, 0x2d, 0x88, 0x66, 0x64,
+        0xa7, 0xa2, 0xa7, 0xc6, 0x2b, 0x5e, 0x6f, 0x28, 0xb8, 0xc7, 0x9f, 0x46, 0x8f, 0x3f, 0x17, 0x12,
+        0xd7, 0xd0, 0xe5, 0xcc, 0xa1, 0x45, 0x10, 0x4e, 0x65, 0x24, 0x2b, 0x32, 0xe4, 0x8a, 0xe1, 0x9c,
+        0x18, 0x9d, 0x42, 0x4c, 0x87, 0x1a, 0xb7, 0x8a, 0x20, 0x2e, 0x8d, 0x73, 0x1a, 0xb5, 0x29, 0xe2,
+        0x79, 0xb5, 0xd1, 0x0f, 0x28, 0x0b, 0x9e, 0xd8, 0xd3, 0xd5, 0x87, 0x08, 0x5f, 0x84, 0xe3, 0x7c,
+        0xde, 0x70, 0x3c, 0x7c, 0x1c, 0x21, 0x92, 0x28, 0xe5, 0xc7, 0xfc, 0xb3, 0x2a, 0x70, 0xb9, 0x50,
+        0x98, 0xdb, 0x06, 0xfa, 0x8b, 0x2f, 0x25, 0x4d, 0xc6, 0x54, 0xe1, 0x8b, 0x81, 0x8c, 0xf3, 0xfb,
+        0x52, 0x72, 0x44, 0x15, 0xb4, 0x96, 0x2d, 0x93, 0xa8, 0xda, 0xb8, 0xda, 0xe7, 0x92, 0x18, 0x18,
+        0xa3, 0x92, 0xf3, 0x31, 0x6e, 0xe3, 0x59, 0xd9, 0xdb, 0x9f, 0x95, 0x5c, 0xd5, 0xc3, 0x80, 0x6b,
+        0xc8, 0xa7, 0x52, 0x74, 0xcb, 0x18, 0x11, 0x25, 0x65, 0x0a, 0x72, 0xfb, 0x3c, 0x32, 0xd6, 0x96,
+        0x24, 0x0c, 0x63, 0x09, 0x9c, 0x20, 0x93, 0xa4, 0x71, 0xdc, 0xe7, 0xb3, 0x30, 0x2a, 0x88, 0x24,
+        0x7b, 0x7f, 0xdd, 0x13, 0x6c, 0xa0, 0x2f, 0xbf, 0x12, 0xd8, 0xf8, 0x3d, 0x48, 0xb4, 0x03, 0x4e,
+        0x3c, 0x34, 0x4d, 0x70, 0x70, 0x3c, 0xd4, 0x20, 0xcb, 0xb6, 0xbf, 0xc3, 0xe4, 0xfb, 0x82, 0x4b,
+        0x86, 0xbc, 0x81, 0xfc, 0xbf, 0xc4, 0x10, 0xaf, 0x4a, 0xdb, 0xd3, 0x16, 0x9f, 0x41, 0x01, 0xf0,
+        0xe8, 0x36, 0x61, 0x2a, 0x26, 0xc3, 0xbb, 0x77, 0x51, 0x5f, 0xb4, 0xe1, 0x53, 0x5c, 0xa5, 0xae,
+        0xa8, 0xb2, 0xea, 0xd0, 0x28, 0x77, 0x08, 0x4f, 0x2f, 0x77, 0x53, 0xc0, 0xdd, 0xf4, 0x63, 0xd5,
+        0xac, 0xf1, 0x1e, 0x30, 0xfc, 0xe4, 0xc5, 0x3c, 0xf2, 0x36, 0x2f, 0x8f, 0x90, 0x3c, 0xdc, 0x14,
+        0x2d, 0xd3, 0x7b, 0x8f, 0xda, 0x55, 0x87, 0xe9, 0x09, 0x9a, 0x05, 0x90, 0xe0, 0xd5, 0x38, 0x49,
+        0x4b, 0xe0, 0x9f, 0xa1, 0x75, 0xc4, 0xdf, 0x93, 0xea, 0x8a, 0x46, 0x28, 0x92, 0x5f, 0x71, 0xa2,
+        0xfd, 0xcc, 0xdd, 0x17, 0xd2, 0x05, 0xeb, 0x45, 0x0e, 0x81, 0xd6, 0x5d, 0x84, 0x36, 0x17, 0x7e,
+        0xe0, 0xb3, 0xc3, 0xa1, 0x94, 0xcb, 0x8c, 0xf6, 0xf2, 0xbe, 0xc6, 0x06, 0xb1, 0x49, 0xa9, 0xf9,
+        0x84, 0x2c, 0x20, 0x10, 0x46, 0x23, 0xfc, 0x60, 0xef, 0x47, 0xfd, 0xff, 0x1d, 0x9e, 0x49, 0xeb,
+        0x1f, 0x95, 0x8e, 0x4a, 0xba, 0x1d, 0x22, 0x62, 0x12, 0x43, 0x7c, 0x72, 0x62, 0xc7, 0x2e, 0x51,
+        0xb7, 0x9c, 0x2d, 0xc7, 0x92, 0xcc, 0x92, 0x2b, 0xe7, 0x57, 0x3b, 0xc7, 0x57, 0x5d, 0x26, 0x6e,
+        0xa9, 0xd4, 0xc9, 0x44, 0x18, 0x0f, 0x2e, 0xc8, 0x62, 0xc0, 0x07, 0xfa, 0xf3, 0xb7, 0x37, 0x0d,
+        0xc0, 0x75, 0x1c, 0x04, 0xfa, 0x53, 0xe9, 0xf6, 0xb3, 0xae, 0xd4, 0xff, 0x56, 0x3e, 0x07, 0xe0,
+        0x22, 0x18, 0xdd, 0xbe, 0xfb, 0xca, 0xa8, 0x18, 0xe7, 0x0f, 0xbe, 0xde, 0xaf, 0xc3, 0x7e, 0x58,
+        0x98, 0xf4, 0x37, 0x23, 0x06, 0x83, 0xb2, 0x1a, 0xf6, 0x6e, 0xce, 0x6a, 0xa3, 0xca, 0x48, 0x4f,
+        0xa3, 0xca, 0x66, 0xbf, 0xd0, 0xed, 0xa7, 0xa1, 0x12, 0xae, 0xad, 0x62, 0x27, 0x20, 0x83, 0x49,
+        0x86, 0xa0, 0x9f, 0xc4, 0xe5, 0x73, 0x76, 0x12, 0x53, 0x15, 0x6f, 0x23, 0x88, 0xbb, 0x9a, 0xf0,
+        0xa6, 0xef, 0x6a, 0xa7, 0xaa, 0x9d, 0x79, 0x56, 0x62, 0x9c, 0xa0, 0x44, 0x95, 0x18, 0x7b, 0xbf,
+        0x96, 0x71, 0xe2, 0xb6, 0xe1, 0x57, 0x57, 0xb0, 0xca, 0x2d, 0x9a, 0xa8, 0x31, 0xc9, 0x70, 0x2c,
+        0x59, 0x20, 0x24, 0x7c, 0x29, 0xf9, 0xef, 0x7a, 0xc4, 0x5e, 0x7c, 0x5f, 0xc3, 0x4c, 0x6e, 0xa8,
+        0xce, 0xef, 0xb8, 0xfc, 0x9d, 0x88, 0x4f, 0xc6, 0x4d, 0x3c, 0x6a, 0x16, 0xa3, 0x0e, 0x59, 0xc8,
+        0x46, 0x33, 0x40, 0xee, 0xdb, 0x5b, 0x8c, 0x85, 0x11, 0x71, 0x07, 0x17, 0xf7, 0xee, 0x9d, 0x4f,
+        0xaa
+    };
+    u8 ciphertext[577] {
+        0x6b, 0x50, 0x22, 0x30, 0x65, 0x48, 0xd4, 0x93, 0x65, 0x6b, 0x4f, 0x35, 0x6b, 0xcf, 0xf9, 0xa2,
+        0x05, 0xb5, 0x58, 0xda, 0x1f, 0x04, 0x39, 0x74, 0x4e, 0x14, 0x4d, 0x3d, 0xf0, 0x82, 0x3d, 0xc2,
+        0x4c, 0x8a, 0x74, 0xbc, 0x52, 0xd2, 0xc1, 0x95, 0x53, 0x94, 0x57, 0xc1, 0x00, 0xe0, 0x26, 0x9d,
+        0x9b, 0x66, 0xc1, 0xaf, 0xe9, 0xea, 0x52, 0x71, 0x88, 0x4e, 0xbb, 0xff, 0xb4, 0x3e, 0x2c, 0x50,
+        0x7f, 0x72, 0x78, 0xa5, 0xc6, 0xa4, 0xc9, 0xdc, 0xc1, 0x41, 0x29, 0x71, 0xa3, 0xda, 0x9d, 0xf9,
+        0x9b, 0x10, 0xb7, 0xe3, 0x3a, 0x3b, 0xe9, 0x07, 0x70, 0xc9, 0x6e, 0x64, 0x27, 0xf4, 0x9f, 0x62,
+        0xcb, 0x94, 0xb3, 0x29, 0xa1, 0xfc, 0xe7, 0x8c, 0x03, 0xac, 0x5a, 0x3f, 0xf0, 0x62, 0x4a, 0x6a,
+        0x5d, 0xfe, 0xdc, 0xe6, 0xf6, 0x21, 0xa7, 0x49, 0x8d, 0x97, 0x38, 0xc3, 0xa3, 0x60, 0x28, 0xd4,
+        0x97, 0xcd, 0xfd, 0xf7, 0xa5, 0x82, 0x35, 0x07, 0x06, 0x35, 0x9d, 0x6f, 0xd4, 0x6f, 0xb6, 0xf1,
+        0xde, 0x56, 0x1a, 0xdc, 0x55, 0x6e, 0x67, 0x77, 0x6b, 0x9c, 0x84, 0x03, 0xc3, 0x10, 0x12, 0x2c,
+        0x8f, 0x5b, 0x66, 0xb0, 0xe9, 0x34, 0x63, 0x21, 0x50, 0x7d, 0xb9, 0xc1, 0x85, 0x9f, 0x65, 0x63,
+        0xbf, 0x19, 0x6e, 0x75, 0x34, 0xc4, 0x89, 0x1b, 0xdf, 0xea, 0xb4, 0xff, 0x0a, 0x6d, 0xa4, 0xe1,
+        0x7d, 0x41, 0x63, 0xc9, 0xc4, 0x73, 0x2d, 0x67, 0xff, 0x08, 0xc2, 0x53, 0xd5, 0x8a, 0x6c, 0x0e,
+        0xa9, 0xba, 0x1c, 0x54, 0x4c, 0x71, 0x89, 0x70, 0x92, 0xc9, 0x65, 0x3d, 0x46, 0x09, 0x58, 0x38,
+        0x8f, 0x80, 0x56, 0x7a, 0x78, 0x53, 0x21, 0xb7, 0x0c, 0xeb, 0xa5, 0xc8, 0xcf, 0x01, 0xe5, 0x52,
+        0x92, 0xff, 0x67, 0x30, 0x99, 0x3f, 0x65, 0xc5, 0x43, 0x49, 0x51, 0x08, 0xe1, 0x2f, 0xe5, 0xd2,
+        0xd9, 0x82, 0xe3, 0xe8, 0x72, 0x5e, 0xdb, 0x05, 0xe5, 0xde, 0xbe, 0x9d, 0xc5, 0xaa, 0x25, 0xb1,
+        0xf8, 0xcc, 0xae, 0xb0, 0x8b, 0x5a, 0x83, 0x2d, 0x9c, 0xb5, 0xb1, 0xea, 0x7b, 0x82, 0x70, 0xd3,
+        0x2a, 0xa4, 0x37, 0x7c, 0xab, 0x98, 0x6a, 0xd3, 0x2f, 0xa8, 0xe0, 0xb3, 0x78, 0x2a, 0xae, 0x49,
+        0x92, 0x2b, 0xe6, 0x17, 0xfb, 0x8c, 0x31, 0x32, 0x01, 0x7b, 0x28, 0x0f, 0x4f, 0xdd, 0x29, 0x97,
+        0x9f, 0x8b, 0xee, 0xe9, 0xb4, 0x74, 0xb1, 0x0c, 0xe0, 0x35, 0xe4, 0x1d, 0xe1, 0xb4, 0x8e, 0x51,
+        0x96, 0xa3, 0x86, 0xbb, 0x75, 0x2c, 0x17, 0xb8, 0x47, 0xb3, 0x37, 0x8e, 0x46, 0x3b, 0x64, 0x10,
+        0xc9, 0xe5, 0xbd, 0xb3, 0x11, 0x9d, 0x93, 0x47, 0x6a, 0x30, 0xa0, 0x2f, 0xce, 0x14, 0x46, 0x38,
+        0xcb, 0xda, 0xf8, 0x2a, 0xde, 0xd7, 0x0c, 0xdb, 0xdb, 0x79, 0xcc, 0x84, 0x30, 0x05, 0x11, 0x04,
+        0x97, 0x2b, 0xd8, 0x20, 0xa8, 0x9d, 0x96, 0x89, 0x9d, 0x41, 0x95, 0x0e, 0x8f, 0xfe, 0x5a, 0x13,
+        0x8a, 0x40, 0x64, 0xf5, 0xe5, 0xf5, 0x7b, 0x0f, 0xa6, 0x54, 0xfb, 0x30, 0x6c, 0x8c, 0x9e, 0xf6,
+        0xd0, 0x66, 0x44, 0x84, 0xfe, 0x6f, 0x89, 0x04, 0xb8, 0x38, 0x88, 0x2c, 0x23, 0x97, 0x66, 0x7b,
+        0xb5, 0x96, 0xd8, 0x3a, 0x75, 0x98, 0x95, 0xab, 0xde, 0x6c, 0xfb, 0x0c, 0x3b, 0x05, 0xb3, 0xaa,
+        0x84, 0xf4, 0x6f, 0x4b, 0x6c, 0xc1, 0xf2, 0xb7, 0xd2, 0x76, 0x1e, 0x2e, 0x67, 0x94, 0x9a, 0xfb,
+        0x00, 0xf4, 0xcc, 0xf0, 0x82, 0xcc, 0x99, 0x2b, 0xb4, 0x96, 0x58, 0x80, 0xd6, 0x11, 0x80, 0xda,
+        0x73, 0x0f, 0x10, 0xe3, 0xb7, 0x67, 0xb8, 0x1e, 0x1f, 0x8d, 0xa5, 0xe0, 0x2e, 0x95, 0x74, 0x49,
+        0xfb, 0x7e, 0xb3, 0x3a, 0xde, 0xe6, 0x49, 0xc1, 0xf4, 0x40, 0xbe, 0xdd, 0x1d, 0xa7, 0xf6, 0x32,
+        0xe5, 0xf7, 0xe5, 0x86, 0x92, 0xf7, 0x27, 0x31, 0xd2, 0x97, 0x59, 0xc8, 0xaf, 0x4f, 0xcc, 0x35,
+        0x4a, 0x24, 0xa0, 0xd8, 0xee, 0x78, 0xfa, 0xf9, 0x5b, 0x76, 0x0d, 0x0c, 0x37, 0x3b, 0xe7, 0x6a,
+        0xf4, 0x9a, 0x41, 0x92, 0xcd, 0x32, 0x93, 0x05, 0xcc, 0xb5, 0x78, 0x66, 0xf9, 0xb9, 0x62, 0x22,
+        0x50, 0xae, 0x7d, 0xd5, 0x87, 0x9e, 0x48, 0xbe, 0xa9, 0x28, 0x44, 0x4f, 0xab, 0x32, 0xe3, 0x08,
+        0x49
+    };
+
+    auto result = MUST(ByteBuffer::create_uninitialized(577));
+    auto output = result.bytes();
+    Crypto::Cipher::ChaCha20 cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, initial_block_counter);
+    cipher.encrypt(ReadonlyBytes { plaintext, 577 }, output);
+    auto expected = ReadonlyBytes { ciphertext, 577 };
+    EXPECT_EQ(result, expected);
+
+    // Each call starts on a fresh block, so pieces that are whole blocks must produce the same key stream.
+    auto split = MUST(ByteBuffer::create_uninitialized(577));
+    Crypto::Cipher::ChaCha20 split_cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, initial_block_counter);
+    size_t offset = 0;
+    for (size_t length : { 64, 256, 192, 65 }) {
+        auto piece = split.bytes().slice(offset, length);
+        split_cipher.encrypt(ReadonlyBytes { plaintext + offset, length }, piece);
+        offset += length;
+    }
+    EXPECT_EQ(split, expected);
+}
+
+BENCHMARK_CASE(encrypt)
+{
+    u8 key[32] {};
+    u8 nonce[12] {};
+    auto buffer = MUST(ByteBuffer::create_uninitialized(16 * MiB));
+    fill_with_random(buffer);
+    Crypto::Cipher::ChaCha20 cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 });
+    for (size_t i = 0; i < 10; ++i) {
+        auto output = buffer.bytes();
+        cipher.encrypt(buffer, output);
+        AK::taint_for_optimizer(buffer);
+    }
+}
@@ -207,3 +207,66 @@ TEST_CASE(test_aead_encrypt_and_decrypt)
     EXPECT(Crypto::AEAD::ChaCha20Poly1305::verify_tag(encrypted, decrypted));
     EXPECT_EQ(decrypted.bytes().slice(0, encrypted.bytes().size() - 16), plaintext.bytes());
 }
+
+// Generated with OpenSSL.
+TEST_CASE(test_aead_encrypt_block_aligned)
+{
+    // Neither the AAD nor the ciphertext need padding here, so no zero bytes may be fed to Poly1305 for them.
+    // The plaintext is also long enough for the vectorized paths of both ChaCha20 and Poly1305, with a block left over.
+    u8 aad[16] = {
+        0x49, 0x7b, 0x83, 0x51, 0x94, 0xff, 0xd3, 0xc7, 0x0a, 0x04, 0x93, 0xbf, 0x2d, 0x21, 0x33, 0x96
+    };
+    u8 key[32] = {
+        0x74, 0xf8, 0x93, 0x59, 0xbb, 0x0b, 0x5e, 0x7f, 0x21, 0x91, 0x2e, 0x29, 0x36, 0xb1, 0xa2, 0xfe,
+        0x03, 0xd4, 0x69, 0xf5, 0x8b, 0x0a, 0x2b, 0x89, 0x07, 0x10, 0x97, 0x32, 0xc7, 0xb0, 0x99, 0x26
+    };
+    u8 nonce[12] = { 0x3e, 0x24, 0x86, 0xa1, 0x1b, 0x56, 0xe1, 0xea, 0xb5, 0x1b, 0x47, 0x3f };
+    u8 plaintext[272] = {
+        0x40, 0x26, 0xc6, 0xd6, 0xc7, 0xa2, 0x9b, 0xbe, 0x73, 0x3b, 0x50, 0x1e, 0xba, 0x7e, 0x2d, 0x96,
+        0xb3, 0xfd, 0x36, 0xae, 0x78, 0xa5, 0x10, 0x8a, 0xc0, 0x41, 0x93, 0x83, 0xe0, 0x9a, 0x57, 0xf7,
+        0x9d, 0xc9, 0x5f, 0x78, 0x9a, 0x93, 0x42, 0x77, 0x7f, 0xa7, 0x0c, 0x7f, 0x4b, 0x97, 0xd1, 0x3e,
+        0x04, 0x92, 0x5d, 0xb3, 0x56, 0x94, 0x87, 0xc7, 0x25, 0x2c, 0x93, 0x60, 0x07, 0x22, 0xb5, 0xb0,
+        0xb3, 0xdd, 0x93, 0x40, 0xc6, 0xe4, 0xa1, 0xfe, 0xc3, 0x48, 0x30, 0x3b, 0x10, 0x60, 0xdb, 0x4f,
+        0x1c, 0xf7, 0x69, 0x48, 0xb9, 0xbf, 0xaf, 0xd8, 0xab, 0x0a, 0xdf, 0x4d, 0xc9, 0xf7, 0x30, 0x91,
+        0xde, 0xaa, 0xf4, 0x3d, 0x1e, 0xdc, 0x94, 0x7e, 0xd6, 0x4a, 0x53, 0x2c, 0x31, 0x3c, 0xcf, 0x7c,
+        0xd1, 0xac, 0xc9, 0x6c, 0x5b, 0x23, 0xfb, 0x0d, 0xe0, 0x94, 0x0c, 0x2b, 0x62, 0x4c, 0x05, 0xc3,
+        0x8a, 0x98, 0x08, 0x67, 0x67, 0x2c, 0x03, 0xec, 0xdb, 0x8f, 0x85, 0x71, 0x9f, 0x5b, 0x46, 0x4a,
+        0xbb, 0xbf, 0x20, 0x47, 0x97, 0xd5, 0xd1, 0x5e, 0x94, 0x85, 0xe3, 0x49, 0x61, 0x0c, 0x61, 0xc3,
+        0x3f, 0xe8, 0xa7, 0x4b, 0x6e, 0xb7, 0x37, 0x45, 0x01, 0xfc, 0xcf, 0x6a, 0x27, 0xe6, 0xea, 0xcc,
+        0xaf, 0x3d, 0xcb, 0x8c, 0xa9, 0xec, 0xc5, 0x1e, 0x06, 0x46, 0x64, 0xb0, 0xef, 0x2c, 0x0b, 0xaf,
+        0x92, 0x5f, 0xe7, 0xd2, 0x55, 0xc2, 0x53, 0xd3, 0x4d, 0xef, 0x63, 0x98, 0x79, 0x19, 0x31, 0xf1,
+        0xdf, 0xee, 0x79, 0x97, 0x7c, 0x3b, 0x1b, 0x39, 0xa9, 0x8e, 0x42, 0x11, 0xcb, 0x80, 0x19, 0xe3,
+        0x1d, 0x2e, 0x70, 0x75, 0x75, 0xa8, 0xb6, 0x9b, 0xd0, 0x83, 0x2d, 0x17, 0x05, 0x11, 0xfc, 0x17,
+        0xee, 0xe6, 0x25, 0xd1, 0xd1, 0xd0, 0x60, 0x6d, 0x90, 0x21, 0x68, 0x3b, 0x14, 0xe5, 0x4c, 0xce,
+        0x9f, 0xf2, 0x67, 0xc1, 0xc5, 0x31, 0x6d, 0x30, 0x19, 0xd1, 0x06, 0xe6, 0x92, 0x18, 0x53, 0xeb
+    };
+    u8 expected_ciphertext[272] = {
+        0x48, 0xa6, 0x16, 0x13, 0x6e, 0xee, 0x47, 0x5a, 0xc2, 0xa7, 0x57, 0x3e, 0x4b, 0x48, 0xff, 0x80,
+        0x59, 0x33, 0x0d, 0xbf, 0x9d, 0x4e, 0x02, 0x6a, 0xd8, 0xb5, 0x58, 0xd7, 0xc1, 0x10, 0x60, 0xc5,
+        0x98, 0xa2, 0xf6, 0x5d, 0x49, 0x3e, 0x1b, 0x6d, 0xd6, 0xc1, 0x70, 0x09, 0x72, 0x5c, 0xe1, 0x5a,
+        0x85, 0x35, 0x1b, 0xc6, 0x5b, 0x83, 0x0d, 0xee, 0x3d, 0xaf, 0x59, 0xb9, 0x24, 0xd7, 0xc3, 0xf7,
+        0x6b, 0xb3, 0xe4, 0x79, 0x22, 0xf6, 0x47, 0xd5, 0x25, 0x29, 0x04, 0x7e, 0x32, 0x82, 0x2d, 0x27,
+        0xe7, 0x37, 0x42, 0xb6, 0xda, 0x7e, 0x91, 0x90, 0xbc, 0xd4, 0x25, 0xff, 0x8a, 0x57, 0xff, 0xb8,
+        0xc6, 0x9c, 0x05, 0xd0, 0xb7, 0xd4, 0x58, 0x39, 0xb6, 0xac, 0xf2, 0x27, 0x2b, 0x0f, 0x18, 0x8d,
+        0x3b, 0xe9, 0x9b, 0xd6, 0x60, 0x2e, 0x20, 0x89, 0x72, 0x8e, 0xf4, 0x11, 0xe6, 0xaf, 0x36, 0xc0,
+        0xb4, 0xd9, 0x1b, 0x81, 0x2d, 0xed, 0x53, 0x2d, 0x5d, 0x90, 0xe5, 0x32, 0xe3, 0xc2, 0xef, 0x1d,
+        0xe8, 0xe0, 0xa2, 0x80, 0xb2, 0x5e, 0x5b, 0x20, 0x1a, 0x3a, 0x11, 0x68, 0x38, 0x98, 0x6a, 0x18,
+        0x72, 0x79, 0x99, 0x09, 0x45, 0x39, 0x55, 0xc2, 0x65, 0x07, 0x11, 0xaf, 0xd2, 0x76, 0x12, 0x8c,
+        0x26, 0x91, 0x27, 0xab, 0x34, 0x64, 0xe3, 0xf0, 0x82, 0x43, 0xe0, 0x22, 0x87, 0x4b, 0x03, 0xc7,
+        0xda, 0x67, 0xfe, 0xc6, 0x3d, 0xca, 0xa2, 0x7e, 0x5d, 0x1c, 0x91, 0xe4, 0x06, 0xba, 0x5d, 0x2b,
+        0x6f, 0xbc, 0x73, 0xd9, 0x2f, 0x64, 0x77, 0x53, 0x79, 0x8d, 0x24, 0xe3, 0xf2, 0xdd, 0x88, 0xdb,
+        0xe3, 0x0e, 0xc8, 0x63, 0x74, 0xee, 0x38, 0xbd, 0x9e, 0x25, 0x29, 0x5a, 0x32, 0x9a, 0x38, 0xfc,
+        0xa6, 0x8f, 0xa6, 0x73, 0xdc, 0xdc, 0xd5, 0x80, 0x96, 0x50, 0xa2, 0xe8, 0x3e, 0xe3, 0xcd, 0x5f,
+        0x9d, 0x02, 0xf0, 0x30, 0x9b, 0x80, 0x9c, 0x95, 0x91, 0xd5, 0xd8, 0x20, 0x7f, 0x3a, 0xdb, 0x0b
+    };
+    u8 expected_tag[16] = {
+        0x56, 0xba, 0xb6, 0xe9, 0x43, 0x82, 0x4a, 0xca, 0x64, 0x2e, 0xbb, 0xdb, 0xf0, 0x55, 0x40, 0xd8
+    };
+
+    Crypto::AEAD::ChaCha20Poly1305 aead(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 });
+    auto encrypted = MUST(aead.encrypt(ReadonlyBytes { aad, 16 }, ReadonlyBytes { plaintext, 272 }));
+
+    EXPECT_EQ(encrypted.size(), 272u + 16);
+    EXPECT_EQ(encrypted.bytes().slice(0, 272), (ReadonlyBytes { expected_ciphertext, 272 }));
+    EXPECT_EQ(encrypted.bytes().slice_from_end(16), (ReadonlyBytes { expected_tag, 16 }));
+}
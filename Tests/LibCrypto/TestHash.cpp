@@ -325,3 +325,21 @@ TEST_CASE(test_ghash_galois_field_multiply2)
     Crypto::Authentication::galois_multiply(z, x, y);
     EXPECT(memcmp(result, z, 4 * sizeof(u32)) == 0);
 }
+
+TEST_CASE(test_ghash_incremental_matches_process)
+{
+    u8 data[300];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = static_cast<u8>(i * 13 + 5);
+    ReadonlyBytes bytes { data, sizeof(data) };
+
+    Crypto::Authentication::GHash ghash("WellHelloFriends");
+    auto expected = ghash.process(bytes.trim(7), bytes);
+
+    ghash.begin(bytes.trim(7));
+    ghash.update(bytes.slice(0, 16));
+    ghash.update(bytes.slice(16, 160));
+    ghash.update(bytes.slice(176));
+    auto digest = ghash.finish();
+    EXPECT(memcmp(expected.data, digest.data, Crypto::Authentication::GHash::digest_size()) == 0);
+}
@@ -5,6 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
+#include <AK/Random.h>
 #include <LibCrypto/Authentication/Poly1305.h>
 #include <LibTest/TestCase.h>
 
@@ -303,3 +304,67 @@ TEST_CASE(test_vector_11)
     auto expected = ReadonlyBytes { expected_result, 16 };
     EXPECT_EQ(result, expected);
 }
+
+// Generated with OpenSSL. Long enough for the vectorized path, which takes four blocks at a time, and the updates
+// below leave partial blocks and vectors in between.
+TEST_CASE(test_vector_spanning_vectorized_blocks)
+{
+    u8 key[32] {
+        0xe6, 0x83, 0x55, 0x22, 0x34, 0x9d, 0x13, 0x1a, 0x41, 0x45, 0xc5, 0x3c, 0x0d, 0x31, 0xd2, 0x1a,
+        0x0a, 0xa9, 0x20, 0x45, 0xca, 0xdc, 0x4d, 0x31, 0xab, 0x55, 0x93, 0x92, 0xae, 0xbc, 0xab, 0x24
+    };
+
+    u8 message[333] {
+        0x78, 0x35, 0xc8, 0x3c, 0x90, 0x15, 0xfa, 0x74, 0x46, 0x0c, 0xfb, 0x2e, 0xa8, 0x09, 0x97, 0xbe,
+        0x0a, 0xff, 0xde, 0x45, 0xc7, 0x91, 0x42, 0xdd, 0x71, 0x2c, 0xb1, 0xe9, 0xe4, 0x5f, 0x7d, 0xe5,
+        0x3a, 0xb8, 0x53, 0xbd, 0x1e, 0x1d, 0x7d, 0x2a, 0x6b, 0xb6, 0x31, 0xfc, 0x32, 0xd9, 0xc8, 0xd6,
+        0x92, 0x3a, 0x5d, 0x9c, 0x93, 0x0a, 0x69, 0x76, 0x54, 0x41, 0x31, 0xd4, 0x45, 0xab, 0xff, 0xaa,
+        0x14, 0x53, 0x22, 0x63, 0x0c, 0x55, 0xcf, 0xfc, 0xf6, 0xd4, 0x8a, 0xb1, 0x59, 0xa0, 0x6b, 0x93,
+        0x12, 0x96, 0x40, 0x26, 0x92, 0x36, 0x65, 0x25, 0x79, 0xbd, 0x0c, 0x60, 0xe9, 0x64, 0x39, 0x1e,
+        0x70, 0x4e, 0x85, 0xdf, 0x66, 0xcc, 0xc9, 0x2a, 0x39, 0x37, 0x62, 0x60, 0x83, 0x91, 0xa2, 0x90,
+        0xc0, 0x93, 0xc6, 0xe1, 0x5d, 0xd0, 0x5d, 0x06, 0xae, 0x20, 0xa4, 0x43, 0xf6, 0x90, 0x6b, 0x03,
+        0x9d, 0x21, 0x47, 0x0f, 0xb9, 0x20, 0x56, 0x9e, 0x91, 0xf7, 0xe4, 0x35, 0xd5, 0x73, 0x99, 0x53,
+        0xdf, 0x2c, 0x0f, 0x0a, 0x3e, 0x61, 0x49, 0x11, 0xf7, 0xfc, 0xbf, 0x50, 0x7c, 0xf5, 0x59, 0xe9,
+        0x78, 0x51, 0x03, 0x63, 0x9a, 0xff, 0x52, 0xe5, 0xb0, 0x4f, 0x4a, 0x5f, 0xa2, 0x48, 0xef, 0x58,
+        0xc2, 0x15, 0x72, 0xdc, 0xe6, 0x33, 0x02, 0x8b, 0x93, 0x85, 0xe0, 0x1e, 0x55, 0x3a, 0xaf, 0x7c,
+        0x61, 0xa6, 0x56, 0x0d, 0x2f, 0x53, 0x72, 0x81, 0x62, 0xcd, 0xd7, 0x38, 0x12, 0xf7, 0x1a, 0xff,
+        0x78, 0xad, 0xa2, 0x57, 0x5d, 0x67, 0x6f, 0xbc, 0xe7, 0x52, 0x58, 0x6b, 0xdc, 0x29, 0x4f, 0xc4,
+        0x69, 0xc4, 0x9b, 0xee, 0x1d, 0x7f, 0x2b, 0xcc, 0xa0, 0x16, 0x6c, 0x06, 0xb5, 0xdd, 0xef, 0x5e,
+        0x82, 0xd3, 0x4a, 0xc2, 0xb4, 0xc2, 0x71, 0x4f, 0x3e, 0xb9, 0xe6, 0xfe, 0xa6, 0x4d, 0x6e, 0x27,
+        0x26, 0xb4, 0x4f, 0x67, 0xd7, 0xa3, 0xd6, 0x10, 0x6e, 0xd9, 0x57, 0xcc, 0x98, 0x5a, 0x2d, 0x65,
+        0x61, 0xd6, 0xca, 0x26, 0x79, 0x56, 0x4d, 0x5f, 0x4b, 0xf2, 0xad, 0x3e, 0x32, 0x25, 0x39, 0x27,
+        0x7d, 0x79, 0xca, 0x2f, 0x1e, 0xfe, 0x83, 0x55, 0xd3, 0x18, 0xbb, 0x22, 0x59, 0x2a, 0xde, 0x62,
+        0x53, 0xa0, 0x83, 0x42, 0x06, 0xea, 0x0b, 0x3d, 0xe1, 0x94, 0x5d, 0xfb, 0x7a, 0x9c, 0xf4, 0xec,
+        0x71, 0xe6, 0xc1, 0xc5, 0x5b, 0xfc, 0x14, 0x7c, 0x8c, 0x99, 0xf6, 0x86, 0xe3
+    };
+
+    u8 expected_result[16] {
+        0x62, 0xf6, 0xfb, 0xbc, 0x06, 0xd3, 0xf1, 0x02, 0x89, 0x5e, 0x5d, 0xe5, 0xa4, 0x05, 0x85, 0x07
+    };
+    auto expected = ReadonlyBytes { expected_result, 16 };
+
+    Crypto::Authentication::Poly1305 mac(ReadonlyBytes { key, 32 });
+    mac.update(ReadonlyBytes { message, 333 });
+    EXPECT_EQ(MUST(mac.digest()), expected);
+
+    Crypto::Authentication::Poly1305 split_mac(ReadonlyBytes { key, 32 });
+    size_t offset = 0;
+    for (size_t length : { 3, 13, 64, 190, 63 }) {
+        split_mac.update(ReadonlyBytes { message + offset, length });
+        offset += length;
+    }
+    EXPECT_EQ(MUST(split_mac.digest()), expected);
+}
+
+BENCHMARK_CASE(update)
+{
+    u8 key[32] {};
+    auto buffer = MUST(ByteBuffer::create_uninitialized(16 * MiB));
+    fill_with_random(buffer);
+    for (size_t i = 0; i < 10; ++i) {
+        Crypto::Authentication::Poly1305 mac(ReadonlyBytes { key, 32 });
+        mac.update(buffer);
+        (void)MUST(mac.digest());
+        AK::taint_for_optimizer(buffer);
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Hex.h>
+#include <LibHTTP/HPack.h>
+#include <LibTest/TestCase.h>
+
+static constexpr size_t max_header_list_size = 64 * KiB;
+
+static void expect_headers(Vector<HTTP::Header> const& headers, Vector<HTTP::Header> const& expected)
+{
+    EXPECT_EQ(headers.size(), expected.size());
+    for (size_t i = 0; i < min(headers.size(), expected.size()); ++i) {
+        EXPECT_EQ(headers[i].name, expected[i].name);
+        EXPECT_EQ(headers[i].value, expected[i].value);
+    }
+}
+
+TEST_CASE(huffman_round_trip)
+{
+    // RFC 7541 section C.4.1
+    auto encoded = MUST(decode_hex("f1e3c2e5f23a6ba0ab90f4ff"sv));
+    auto decoded = TRY_OR_FAIL(HTTP::HPack::huffman_decode(encoded));
+    EXPECT_EQ(StringView { decoded }, "www.example.com"sv);
+
+    ByteBuffer output;
+    TRY_OR_FAIL(HTTP::HPack::huffman_encode("www.example.com"sv.bytes(), output));
+    EXPECT_EQ(output, encoded);
+    EXPECT_EQ(HTTP::HPack::huffman_encoded_length("www.example.com"sv.bytes()), 12u);
+
+    ByteBuffer all_bytes;
+    for (size_t i = 0; i < 256; ++i)
+        all_bytes.append(static_cast<u8>(i));
+    ByteBuffer all_bytes_encoded;
+    TRY_OR_FAIL(HTTP::HPack::huffman_encode(all_bytes, all_bytes_encoded));
+    EXPECT_EQ(TRY_OR_FAIL(HTTP::HPack::huffman_decode(all_bytes_encoded)), all_bytes);
+}
+
+TEST_CASE(huffman_invalid_padding)
+{
+    // A whole byte of padding.
+    EXPECT(HTTP::HPack::huffman_decode(MUST(decode_hex("f1e3c2e5f23a6ba0ab90f4ffff"sv))).is_error());
+    // Padding that isn't a prefix of EOS.
+    EXPECT(HTTP::HPack::huffman_decode(MUST(decode_hex("f1e3c2e5f23a6ba0ab90f4fe"sv))).is_error());
+    // The EOS symbol itself.
+    EXPECT(HTTP::HPack::huffman_decode(MUST(decode_hex("ffffffff"sv))).is_error());
+}
+
+TEST_CASE(decode_requests)
+{
+    // RFC 7541 section C.4: Request Examples with Huffman Coding
+    HTTP::HPack::Decoder decoder { max_header_list_size };
+
+    expect_headers(TRY_OR_FAIL(decoder.decode(MUST(decode_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"sv)))),
+        {
+            { ":method", "GET" },
+            { ":scheme", "http" },
+            { ":path", "/" },
+            { ":authority", "www.example.com" },
+        });
+
+    expect_headers(TRY_OR_FAIL(decoder.decode(MUST(decode_hex("828684be5886a8eb10649cbf"sv)))),
+        {
+            { ":method", "GET" },
+            { ":scheme", "http" },
+            { ":path", "/" },
+            { ":authority", "www.example.com" },
+            { "cache-control", "no-cache" },
+        });
+
+    expect_headers(TRY_OR_FAIL(decoder.decode(MUST(decode_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"sv)))),
+        {
+            { ":method", "GET" },
+            { ":scheme", "https" },
+            { ":path", "/index.html" },
+            { ":authority", "www.example.com" },
+            { "custom-key", "custom-value" },
+        });
+}
+
+TEST_CASE(decode_responses_with_eviction)
+{
+    // RFC 7541 section C.6: Response Examples with Huffman Coding, with a 256 byte dynamic table.
+    HTTP::HPack::Decoder decoder { max_header_list_size, 256 };
+
+    expect_headers(TRY_OR_FAIL(decoder.decode(MUST(decode_hex("488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff6e919d29ad171863c78f0b97c8e9ae82ae43d3"sv)))),
+        {
+            { ":status", "302" },
+            { "cache-control", "private" },
+            { "date", "Mon, 21 Oct 2013 20:13:21 GMT" },
+            { "location", "https://www.example.com" },
+        });
+
+    expect_headers(TRY_OR_FAIL(decoder.decode(MUST(decode_hex("4883640effc1c0bf"sv)))),
+        {
+            { ":status", "307" },
+            { "cache-control", "private" },
+            { "date", "Mon, 21 Oct 2013 20:13:21 GMT" },
+            { "location", "https://www.example.com" },
+        });
+
+    expect_headers(TRY_OR_FAIL(decoder.decode(MUST(decode_hex("88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007"sv)))),
+        {
+            { ":status", "200" },
+            { "cache-control", "private" },
+            { "date", "Mon, 21 Oct 2013 20:13:22 GMT" },
+            { "location", "https://www.example.com" },
+            { "content-encoding", "gzip" },
+            { "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" },
+        });
+}
+
+TEST_CASE(decode_errors)
+{
+    HTTP::HPack::Decoder decoder { max_header_list_size };
+
+    // Index 0, and an index past the end of the (empty) dynamic table.
+    EXPECT(decoder.decode(MUST(decode_hex("80"sv))).is_error());
+    EXPECT(decoder.decode(MUST(decode_hex("be"sv))).is_error());
+    // A dynamic table size update that isn't at the start of the block.
+    EXPECT(decoder.decode(MUST(decode_hex("823f00"sv))).is_error());
+    // A dynamic table size update above the limit.
+    EXPECT(decoder.decode(MUST(decode_hex("3fe21f"sv))).is_error());
+    // A truncated string literal.
+    EXPECT(decoder.decode(MUST(decode_hex("400a6b6579"sv))).is_error());
+
+    // A tiny block that expands into a large header list.
+    HTTP::HPack::Decoder small_decoder { 1 * KiB };
+    ByteBuffer bomb;
+    for (size_t i = 0; i < 100; ++i)
+        bomb.append(0x82);
+    EXPECT(small_decoder.decode(bomb).is_error());
+}
+
+TEST_CASE(encode_round_trip)
+{
+    HTTP::HPack::Encoder encoder;
+    HTTP::HPack::Decoder decoder { max_header_list_size };
+
+    Vector<HTTP::Header> headers {
+        { ":method", "GET" },
+        { ":scheme", "https" },
+        { ":authority", "www.example.com" },
+        { ":path", "/style.css" },
+        { "user-agent", "Mozilla/5.0 (SerenityOS; x86_64) LibWeb+LibJS/1.0 Browser/1.0" },
+        { "accept", "*/*" },
+        { "cookie", "short" },
+        { "cookie", "a_cookie_that_is_long_enough_to_be_indexed=1" },
+    };
+
+    auto first_block = TRY_OR_FAIL(encoder.encode(headers));
+    expect_headers(TRY_OR_FAIL(decoder.decode(first_block)), headers);
+
+    // The second request should mostly be references into the dynamic table.
+    headers[3].value = "/script.js";
+    auto second_block = TRY_OR_FAIL(encoder.encode(headers));
+    expect_headers(TRY_OR_FAIL(decoder.decode(second_block)), headers);
+    EXPECT(second_block.size() < first_block.size() / 2);
+
+    // Shrinking and regrowing the table has to be announced to the decoder.
+    encoder.set_max_table_size_limit(0);
+    encoder.set_max_table_size_limit(4096);
+    auto third_block = TRY_OR_FAIL(encoder.encode(headers));
+    EXPECT_EQ(third_block[0], 0x20);
+    expect_headers(TRY_OR_FAIL(decoder.decode(third_block)), headers);
+}
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Socket.h>
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/Http2Connection.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// RFC 9113 section 6: Frame Definitions
+enum FrameType : u8 {
+    Data = 0x0,
+    Headers = 0x1,
+    ResetStream = 0x3,
+    Settings = 0x4,
+    Ping = 0x6,
+    GoAway = 0x7,
+    WindowUpdate = 0x8,
+    Continuation = 0x9,
+};
+
+enum FrameFlags : u8 {
+    EndStream = 0x1,
+    Ack = 0x1,
+    EndHeaders = 0x4,
+    Padded = 0x8,
+    Priority = 0x20,
+};
+
+static constexpr u16 settings_initial_window_size = 0x4;
+
+struct Frame {
+    u8 type { 0 };
+    u8 flags { 0 };
+    u32 stream_id { 0 };
+    ByteBuffer payload;
+};
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return (static_cast<u32>(bytes[0]) << 24) | (static_cast<u32>(bytes[1]) << 16) | (static_cast<u32>(bytes[2]) << 8) | bytes[3];
+}
+
+static ByteBuffer u32_payload(u32 value)
+{
+    return MUST(ByteBuffer::copy(to_array<u8>({ static_cast<u8>(value >> 24), static_cast<u8>(value >> 16), static_cast<u8>(value >> 8), static_cast<u8>(value) })));
+}
+
+struct Response : public RefCounted<Response> {
+    Optional<u32> status_code;
+    HTTP::HeaderMap headers;
+    ByteBuffer body;
+    bool finished { false };
+    Optional<HTTP::Http2ErrorCode> error;
+    bool can_retry { false };
+};
+
+static NonnullRefPtr<Response> record_response(HTTP::Http2Stream& stream)
+{
+    auto response = make_ref_counted<Response>();
+    stream.on_headers_received = [response](u32 status_code, HTTP::HeaderMap const& headers) {
+        response->status_code = status_code;
+        response->headers = headers;
+    };
+    stream.on_data_received = [response, &stream](ReadonlyBytes data) {
+        response->body.append(data);
+        stream.did_consume(data.size());
+    };
+    stream.on_finish = [response] {
+        response->finished = true;
+    };
+    stream.on_error = [response](HTTP::Http2ErrorCode code, bool can_retry) {
+        response->error = code;
+        response->can_retry = can_retry;
+    };
+    return response;
+}
+
+static Vector<HTTP::Header> get_request(StringView path = "/"sv)
+{
+    return {
+        { ":method", "GET" },
+        { ":scheme", "https" },
+        { ":authority", "localhost" },
+        { ":path", ByteString { path } },
+    };
+}
+
+// Plays the server side of an Http2Connection over a local socket pair, one scripted frame at a time.
+class ScriptedServer {
+public:
+    ScriptedServer()
+    {
+        int fds[2];
+        VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+        m_fd = fds[1];
+        VERIFY(fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK) == 0);
+
+        auto socket = MUST(Core::LocalSocket::adopt_fd(fds[0]));
+        MUST(socket->set_blocking(false));
+        socket->set_notifications_enabled(true);
+        connection = MUST(HTTP::Http2Connection::try_create(move(socket)));
+    }
+
+    ~ScriptedServer()
+    {
+        connection->close();
+        connection = nullptr;
+        close(m_fd);
+    }
+
+    // Lets the connection handle whatever we've sent, and flush whatever it queued up in response.
+    void pump()
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    }
+
+    void send_frame(u8 type, u8 flags, u32 stream_id, ReadonlyBytes payload = {})
+    {
+        ByteBuffer frame;
+        frame.append(static_cast<u8>(payload.size() >> 16));
+        frame.append(static_cast<u8>(payload.size() >> 8));
+        frame.append(static_cast<u8>(payload.size()));
+        frame.append(type);
+        frame.append(flags);
+        frame.append(u32_payload(stream_id));
+        frame.append(payload);
+
+        auto remaining = frame.bytes();
+        while (!remaining.is_empty()) {
+            auto nwritten = write(m_fd, remaining.data(), remaining.size());
+            if (nwritten < 0) {
+                VERIFY(errno == EAGAIN);
+                pump();
+                continue;
+            }
+            remaining = remaining.slice(nwritten);
+        }
+    }
+
+    void send_settings(Vector<Array<u32, 2>> settings = {})
+    {
+        ByteBuffer payload;
+        for (auto& [id, value] : settings) {
+            payload.append(static_cast<u8>(id >> 8));
+            payload.append(static_cast<u8>(id));
+            payload.append(u32_payload(value));
+        }
+        send_frame(FrameType::Settings, 0, 0, payload);
+    }
+
+    ByteBuffer encode_headers(Vector<HTTP::Header> const& headers)
+    {
+        return MUST(m_encoder.encode(headers));
+    }
+
+    void send_headers(u32 stream_id, Vector<HTTP::Header> const& headers, u8 flags = 0)
+    {
+        send_frame(FrameType::Headers, flags | FrameFlags::EndHeaders, stream_id, encode_headers(headers));
+    }
+
+    Vector<HTTP::Header> decode_headers(ReadonlyBytes block)
+    {
+        return MUST(m_decoder.decode(block));
+    }
+
+    // Everything the client has sent since the last call.
+    Vector<Frame> receive_frames()
+    {
+        pump();
+
+        u8 buffer[16 * KiB];
+        while (true) {
+            auto nread = recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (nread <= 0)
+                break;
+            m_input.append(buffer, nread);
+        }
+
+        size_t offset = 0;
+        if (!m_has_received_preface) {
+            auto preface = HTTP::Http2Connection::connection_preface;
+            VERIFY(m_input.size() >= preface.length());
+            EXPECT_EQ(StringView { m_input.bytes().trim(preface.length()) }, preface);
+            offset = preface.length();
+            m_has_received_preface = true;
+        }
+
+        Vector<Frame> frames;
+        while (m_input.size() - offset >= 9) {
+            auto data = m_input.bytes().slice(offset);
+            u32 length = (static_cast<u32>(data[0]) << 16) | (static_cast<u32>(data[1]) << 8) | data[2];
+            if (data.size() < 9 + length)
+                break;
+            frames.append({
+                .type = data[3],
+                .flags = data[4],
+                .stream_id = read_u32(data.slice(5)) & 0x7fffffff,
+                .payload = MUST(ByteBuffer::copy(data.slice(9, length))),
+            });
+            offset += 9 + length;
+        }
+        m_input = MUST(ByteBuffer::copy(m_input.bytes().slice(offset)));
+        return frames;
+    }
+
+    // Reads the client's connection preface, and answers it with our own SETTINGS.
+    void establish(Vector<Array<u32, 2>> settings = {})
+    {
+        auto frames = receive_frames();
+        EXPECT(frames.size() >= 2);
+        EXPECT_EQ(frames[0].type, FrameType::Settings);
+        EXPECT_EQ(frames[0].flags, 0);
+        EXPECT_EQ(frames[1].type, FrameType::WindowUpdate);
+        EXPECT_EQ(frames[1].stream_id, 0u);
+
+        send_settings(move(settings));
+        frames = receive_frames();
+        EXPECT_EQ(frames.size(), 1u);
+        EXPECT_EQ(frames[0].type, FrameType::Settings);
+        EXPECT_EQ(frames[0].flags, FrameFlags::Ack);
+    }
+
+    RefPtr<HTTP::Http2Connection> connection;
+
+private:
+    Core::EventLoop m_event_loop;
+    int m_fd { -1 };
+    ByteBuffer m_input;
+    bool m_has_received_preface { false };
+    HTTP::HPack::Encoder m_encoder;
+    HTTP::HPack::Decoder m_decoder { 64 * KiB };
+};
+
+static Optional<Frame> find_frame(Vector<Frame> const& frames, u8 type, u32 stream_id)
+{
+    for (auto& frame : frames) {
+        if (frame.type == type && frame.stream_id == stream_id)
+            return frame;
+    }
+    return {};
+}
+
+static size_t data_size(Vector<Frame> const& frames, u32 stream_id, bool* end_stream = nullptr)
+{
+    size_t size = 0;
+    for (auto& frame : frames) {
+        if (frame.type != FrameType::Data || frame.stream_id != stream_id)
+            continue;
+        size += frame.payload.size();
+        if (end_stream)
+            *end_stream = frame.flags & FrameFlags::EndStream;
+    }
+    return size;
+}
+
+static void expect_go_away(Vector<Frame> const& frames, HTTP::Http2ErrorCode code)
+{
+    auto go_away = find_frame(frames, FrameType::GoAway, 0);
+    EXPECT(go_away.has_value());
+    if (go_away.has_value()) {
+        EXPECT_EQ(go_away->payload.size(), 8u);
+        EXPECT_EQ(read_u32(go_away->payload.bytes().slice(4)), to_underlying(code));
+    }
+}
+
+TEST_CASE(request_and_response)
+{
+    ScriptedServer server;
+    server.establish();
+
+    auto stream = server.connection->open_stream(get_request("/index.html"sv), {});
+    auto response = record_response(stream);
+
+    auto frames = server.receive_frames();
+    EXPECT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].type, FrameType::Headers);
+    EXPECT_EQ(frames[0].stream_id, 1u);
+    EXPECT_EQ(frames[0].flags, FrameFlags::EndStream | FrameFlags::EndHeaders);
+    auto request_headers = server.decode_headers(frames[0].payload);
+    EXPECT_EQ(request_headers.size(), 4u);
+    EXPECT_EQ(request_headers[0].name, ":method"sv);
+    EXPECT_EQ(request_headers[3].value, "/index.html"sv);
+
+    // Frames of unknown types are ignored, PINGs are answered.
+    server.send_frame(0xfa, 0, 0, "whatever"sv.bytes());
+    server.send_frame(FrameType::Ping, 0, 0, "pingpong"sv.bytes());
+    frames = server.receive_frames();
+    EXPECT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].type, FrameType::Ping);
+    EXPECT_EQ(frames[0].flags, FrameFlags::Ack);
+    EXPECT_EQ(StringView { frames[0].payload }, "pingpong"sv);
+
+    server.send_headers(1, { { ":status", "200" }, { "content-type", "text/html" } });
+    server.send_frame(FrameType::Data, 0, 1, "Hello, "sv.bytes());
+    server.send_frame(FrameType::Data, FrameFlags::EndStream, 1, "friends!"sv.bytes());
+    server.pump();
+
+    EXPECT_EQ(response->status_code, 200u);
+    EXPECT_EQ(response->headers.get("content-type"), "text/html"sv);
+    EXPECT_EQ(StringView { response->body }, "Hello, friends!"sv);
+    EXPECT(response->finished);
+    EXPECT(!response->error.has_value());
+    EXPECT(server.connection->is_idle());
+    EXPECT(server.connection->is_usable());
+}
+
+TEST_CASE(oversized_frame_is_a_connection_error)
+{
+    ScriptedServer server;
+    server.establish();
+
+    auto stream = server.connection->open_stream(get_request(), {});
+    auto response = record_response(stream);
+    (void)server.receive_frames();
+
+    // We never announce a SETTINGS_MAX_FRAME_SIZE above the default of 16384.
+    server.send_frame(FrameType::Ping, 0, 0, ByteBuffer::create_zeroed(16385).release_value().bytes());
+    expect_go_away(server.receive_frames(), HTTP::Http2ErrorCode::FrameSizeError);
+    EXPECT_EQ(response->error, HTTP::Http2ErrorCode::FrameSizeError);
+    EXPECT(!response->can_retry);
+    EXPECT(!server.connection->is_usable());
+}
+
+TEST_CASE(continuation_frames)
+{
+    ScriptedServer server;
+    server.establish();
+
+    auto stream = server.connection->open_stream(get_request(), {});
+    auto response = record_response(stream);
+    (void)server.receive_frames();
+
+    auto block = server.encode_headers({ { ":status", "200" }, { "x-first", "one" }, { "x-second", "two" } });
+    auto split = block.size() / 2;
+    server.send_frame(FrameType::Headers, 0, 1, block.bytes().trim(split));
+    server.pump();
+    EXPECT(!response->status_code.has_value());
+
+    server.send_frame(FrameType::Continuation, FrameFlags::EndHeaders, 1, block.bytes().slice(split));
+    server.send_frame(FrameType::Data, FrameFlags::EndStream, 1, "ok"sv.bytes());
+    server.pump();
+    EXPECT_EQ(response->status_code, 200u);
+    EXPECT_EQ(response->headers.get("x-first"), "one"sv);
+    EXPECT_EQ(response->headers.get("x-second"), "two"sv);
+    EXPECT(response->finished);
+
+    // Nothing may come in between a HEADERS frame and the CONTINUATION frames that complete it.
+    auto second_stream = server.connection->open_stream(get_request(), {});
+    auto second_response = record_response(second_stream);
+    (void)server.receive_frames();
+
+    block = server.encode_headers({ { ":status", "200" }, { "x-third", "three" } });
+    server.send_frame(FrameType::Headers, 0, 3, block.bytes().trim(1));
+    server.send_frame(FrameType::Ping, 0, 0, "pingpong"sv.bytes());
+    expect_go_away(server.receive_frames(), HTTP::Http2ErrorCode::ProtocolError);
+    EXPECT_EQ(second_response->error, HTTP::Http2ErrorCode::ProtocolError);
+}
+
+TEST_CASE(padding)
+{
+    ScriptedServer server;
+    server.establish();
+
+    auto stream = server.connection->open_stream(get_request(), {});
+    auto response = record_response(stream);
+    (void)server.receive_frames();
+
+    // A padded HEADERS frame with the (deprecated) priority fields.
+    ByteBuffer headers;
+    headers.append(3);
+    headers.append(to_array<u8>({ 0, 0, 0, 0, 16 }));
+    headers.append(server.encode_headers({ { ":status", "200" } }));
+    headers.append(to_array<u8>({ 0, 0, 0 }));
+    server.send_frame(FrameType::Headers, FrameFlags::EndHeaders | FrameFlags::Padded | FrameFlags::Priority, 1, headers);
+
+    ByteBuffer data;
+    data.append(4);
+    data.append("body"sv.bytes());
+    data.append(to_array<u8>({ 0, 0, 0, 0 }));
+    server.send_frame(FrameType::Data, FrameFlags::EndStream | FrameFlags::Padded, 1, data);
+    server.pump();
+
+    EXPECT_EQ(response->status_code, 200u);
+    EXPECT_EQ(StringView { response->body }, "body"sv);
+    EXPECT(response->finished);
+
+    // Padding that doesn't fit into the frame is a connection error.
+    auto second_stream = server.connection->open_stream(get_request(), {});
+    auto second_response = record_response(second_stream);
+    (void)server.receive_frames();
+    server.send_headers(3, { { ":status", "200" } });
+    server.send_frame(FrameType::Data, FrameFlags::Padded, 3, to_array<u8>({ 4, 'a', 'b', 'c' }));
+    expect_go_away(server.receive_frames(), HTTP::Http2ErrorCode::ProtocolError);
+    EXPECT_EQ(second_response->error, HTTP::Http2ErrorCode::ProtocolError);
+}
+
+TEST_CASE(request_body_flow_control)
+{
+    ScriptedServer server;
+    server.establish();
+
+    static constexpr size_t body_size = 100'000;
+    auto request = get_request();
+    request[0].value = "POST";
+    auto stream = server.connection->open_stream(move(request), ByteBuffer::create_zeroed(body_size).release_value());
+    auto response = record_response(stream);
+
+    // Both windows start out at 65535 bytes.
+    bool end_stream = false;
+    auto frames = server.receive_frames();
+    EXPECT_EQ(frames[0].type, FrameType::Headers);
+    EXPECT_EQ(frames[0].flags, FrameFlags::EndHeaders);
+    EXPECT_EQ(data_size(frames, 1, &end_stream), 65535u);
+    EXPECT(!end_stream);
+
+    // Opening up the stream window doesn't help while the connection window is exhausted.
+    server.send_frame(FrameType::WindowUpdate, 0, 1, u32_payload(body_size));
+    EXPECT_EQ(data_size(server.receive_frames(), 1), 0u);
+
+    server.send_frame(FrameType::WindowUpdate, 0, 0, u32_payload(body_size));
+    EXPECT_EQ(data_size(server.receive_frames(), 1, &end_stream), body_size - 65535);
+    EXPECT(end_stream);
+
+    server.send_headers(1, { { ":status", "204" } }, FrameFlags::EndStream);
+    server.pump();
+    EXPECT_EQ(response->status_code, 204u);
+    EXPECT(response->finished);
+}
+
+TEST_CASE(response_body_flow_control)
+{
+    ScriptedServer server;
+    server.establish();
+
+    auto stream = server.connection->open_stream(get_request(), {});
+    auto response = record_response(stream);
+    (void)server.receive_frames();
+    server.send_headers(1, { { ":status", "200" } });
+
+    // The stream window is only topped up once half of it (512 KiB) has been consumed.
+    auto chunk = ByteBuffer::create_zeroed(16 * KiB).release_value();
+    for (size_t i = 0; i < 31; ++i)
+        server.send_frame(FrameType::Data, 0, 1, chunk);
+    EXPECT(!find_frame(server.receive_frames(), FrameType::WindowUpdate, 1).has_value());
+
+    server.send_frame(FrameType::Data, 0, 1, chunk);
+    auto frames = server.receive_frames();
+    auto window_update = find_frame(frames, FrameType::WindowUpdate, 1);
+    EXPECT(window_update.has_value());
+    if (window_update.has_value())
+        EXPECT_EQ(read_u32(window_update->payload), 512 * KiB);
+    // The connection window is a lot larger, so it doesn't need an update yet.
+    EXPECT(!find_frame(frames, FrameType::WindowUpdate, 0).has_value());
+
+    server.send_frame(FrameType::Data, FrameFlags::EndStream, 1);
+    server.pump();
+    EXPECT_EQ(response->body.size(), 512 * KiB);
+    EXPECT(response->finished);
+}
+
+TEST_CASE(initial_window_size_change_applies_to_open_streams)
+{
+    ScriptedServer server;
+    server.establish({ { settings_initial_window_size, 1000 } });
+
+    auto request = get_request();
+    request[0].value = "POST";
+    auto stream = server.connection->open_stream(move(request), ByteBuffer::create_zeroed(3000).release_value());
+    auto response = record_response(stream);
+    EXPECT_EQ(data_size(server.receive_frames(), 1), 1000u);
+
+    // Growing the initial window grows the windows of open streams by the difference...
+    server.send_settings({ { settings_initial_window_size, 2500 } });
+    EXPECT_EQ(data_size(server.receive_frames(), 1), 1500u);
+
+    // ...and shrinking it may leave them negative, so that a WINDOW_UPDATE has to make up for that first.
+    server.send_settings({ { settings_initial_window_size, 0 } });
+    (void)server.receive_frames();
+    server.send_frame(FrameType::WindowUpdate, 0, 1, u32_payload(2500));
+    EXPECT_EQ(data_size(server.receive_frames(), 1), 0u);
+
+    bool end_stream = false;
+    server.send_frame(FrameType::WindowUpdate, 0, 1, u32_payload(500));
+    EXPECT_EQ(data_size(server.receive_frames(), 1, &end_stream), 500u);
+    EXPECT(end_stream);
+    EXPECT(!response->error.has_value());
+
+    // A window can never be larger than 2^31-1 bytes.
+    server.send_settings({ { settings_initial_window_size, 0x80000000 } });
+    expect_go_away(server.receive_frames(), HTTP::Http2ErrorCode::FlowControlError);
+    EXPECT_EQ(response->error, HTTP::Http2ErrorCode::FlowControlError);
+}
+
+TEST_CASE(go_away_allows_retrying_unprocessed_streams)
+{
+    bool did_close = false;
+    ScriptedServer server;
+    server.connection->on_close = [&] { did_close = true; };
+    server.establish();
+
+    auto first_stream = server.connection->open_stream(get_request("/first"sv), {});
+    auto first_response = record_response(first_stream);
+    auto second_stream = server.connection->open_stream(get_request("/second"sv), {});
+    auto second_response = record_response(second_stream);
+    auto frames = server.receive_frames();
+    EXPECT(find_frame(frames, FrameType::Headers, 1).has_value());
+    EXPECT(find_frame(frames, FrameType::Headers, 3).has_value());
+
+    ByteBuffer go_away;
+    go_away.append(u32_payload(1));
+    go_away.append(u32_payload(to_underlying(HTTP::Http2ErrorCode::NoError)));
+    server.send_frame(FrameType::GoAway, 0, 0, go_away);
+    server.pump();
+
+    // The server never saw the second request, so it can safely be sent again elsewhere.
+    EXPECT_EQ(second_response->error, HTTP::Http2ErrorCode::RefusedStream);
+    EXPECT(second_response->can_retry);
+    EXPECT(!first_response->error.has_value());
+    EXPECT(!server.connection->is_usable());
+    EXPECT(!did_close);
+
+    // The first request still completes, after which the connection goes away.
+    server.send_headers(1, { { ":status", "200" } }, FrameFlags::EndStream);
+    server.pump();
+    EXPECT(first_response->finished);
+    EXPECT(did_close);
+}
+
+TEST_CASE(refused_stream_can_be_retried)
+{
+    ScriptedServer server;
+    server.establish();
+
+    auto first_stream = server.connection->open_stream(get_request("/first"sv), {});
+    auto first_response = record_response(first_stream);
+    auto second_stream = server.connection->open_stream(get_request("/second"sv), {});
+    auto second_response = record_response(second_stream);
+    (void)server.receive_frames();
+
+    server.send_frame(FrameType::ResetStream, 0, 1, u32_payload(to_underlying(HTTP::Http2ErrorCode::RefusedStream)));
+    server.send_frame(FrameType::ResetStream, 0, 3, u32_payload(to_underlying(HTTP::Http2ErrorCode::Cancel)));
+    server.pump();
+
+    EXPECT_EQ(first_response->error, HTTP::Http2ErrorCode::RefusedStream);
+    EXPECT(first_response->can_retry);
+    // Any other error means the server may already have acted on the request.
+    EXPECT_EQ(second_response->error, HTTP::Http2ErrorCode::Cancel);
+    EXPECT(!second_response->can_retry);
+
+    EXPECT(server.connection->is_usable());
+    EXPECT(server.connection->is_idle());
+}
@@ -52,6 +52,17 @@ TESTJS_GLOBAL_FUNCTION(get_weak_map_size, getWeakMapSize)
     return JS::Value(weak_map.values().size());
 }
 
+TESTJS_GLOBAL_FUNCTION(collect_young_garbage, collectYoungGarbage, 0)
+{
+    vm.heap().collect_garbage(JS::Heap::CollectionType::CollectYoungGarbage);
+    return JS::js_undefined();
+}
+
+TESTJS_GLOBAL_FUNCTION(completed_incremental_marking_count, completedIncrementalMarkingCount, 0)
+{
+    return JS::Value(vm.heap().completed_incremental_marking_count());
+}
+
 TESTJS_GLOBAL_FUNCTION(mark_as_garbage, markAsGarbage)
 {
     auto argument = vm.argument(0);
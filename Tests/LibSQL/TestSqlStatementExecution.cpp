@@ -12,6 +12,7 @@
 #include <LibSQL/AST/Parser.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Result.h>
+#include <LibSQL/ResultCursor.h>
 #include <LibSQL/ResultSet.h>
 #include <LibSQL/Row.h>
 #include <LibSQL/Value.h>
@@ -384,6 +385,51 @@ TEST_CASE(select_inner_join)
     EXPECT_EQ(result[0].row[2].to_byte_string(), "Test_12");
 }
 
+TEST_CASE(select_inner_join_with_filters)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_two_tables(database);
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable1 ( TextColumn1, IntColumn ) VALUES "
+        "( 'Test_1', 42 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 44 ), "
+        "( 'Test_4', 44 ), "
+        "( 'Test_5', 46 );");
+    EXPECT(result.size() == 5);
+    result = execute(database,
+        "INSERT INTO TestSchema.TestTable2 ( TextColumn2, IntColumn ) VALUES "
+        "( 'Test_10', 42 ), "
+        "( 'Test_11', 44 ), "
+        "( 'Test_12', 44 ), "
+        "( 'Test_13', 46 ), "
+        "( 'Test_14', 48 );");
+    EXPECT(result.size() == 5);
+    result = execute(database, "INSERT INTO TestSchema.TestTable2 ( TextColumn2 ) VALUES ( 'Test_15' );");
+    EXPECT(result.size() == 1);
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 "
+        "FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE (TestTable2.IntColumn = TestTable1.IntColumn) AND (TextColumn1 != 'Test_4') AND (TestTable2.IntColumn < 46) "
+        "ORDER BY TextColumn1, TextColumn2;");
+    EXPECT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0].row[0].to_byte_string(), "Test_1");
+    EXPECT_EQ(result[0].row[1].to_byte_string(), "Test_10");
+    EXPECT_EQ(result[1].row[0].to_byte_string(), "Test_3");
+    EXPECT_EQ(result[1].row[1].to_byte_string(), "Test_11");
+    EXPECT_EQ(result[2].row[0].to_byte_string(), "Test_3");
+    EXPECT_EQ(result[2].row[1].to_byte_string(), "Test_12");
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 "
+        "FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE (TestTable1.IntColumn = TestTable2.IntColumn) AND (TextColumn1 = 'Test_2');");
+    EXPECT(result.is_empty());
+}
+
 TEST_CASE(select_with_like)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -594,6 +640,89 @@ TEST_CASE(select_with_limit)
     EXPECT_EQ(rows.size(), 10u);
 }
 
+TEST_CASE(select_with_cursor)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    for (auto count = 0; count < 200; count++) {
+        auto result = execute(database,
+            ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer("SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 100 LIMIT 3 OFFSET 1;"sv));
+    auto statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+
+    auto cursor = MUST(statement->open_cursor(database));
+    EXPECT_EQ(cursor->command(), SQL::SQLCommand::Select);
+    EXPECT_EQ(cursor->column_names().size(), 2u);
+
+    for (auto i = 0; i < 3; ++i) {
+        auto row = MUST(cursor->next());
+        EXPECT(row.has_value());
+        EXPECT((*row)[1].to_int<i32>().value() >= 100);
+    }
+    EXPECT(!MUST(cursor->next()).has_value());
+    EXPECT(!MUST(cursor->next()).has_value());
+}
+
+TEST_CASE(select_with_cursor_interleaved_with_delete)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    for (auto count = 0; count < 200; count++) {
+        auto result = execute(database,
+            ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer("SELECT TextColumn, IntColumn FROM TestSchema.TestTable;"sv));
+    auto statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+    auto cursor = MUST(statement->open_cursor(database));
+
+    Vector<i32> seen_values;
+    auto pull_rows = [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            auto row = MUST(cursor->next());
+            if (!row.has_value())
+                return;
+            auto value = (*row)[1].to_int<i32>().value();
+            EXPECT_EQ((*row)[0].to_byte_string(), ByteString::formatted("Test_{}", value));
+            EXPECT(!seen_values.contains_slow(value));
+            seen_values.append(value);
+        }
+    };
+
+    // Rows are scanned newest first, so the cursor has read the rows down to 72 after the first 70 rows, and it will
+    // continue with row 129. Delete rows on both sides of that, and insert new rows ahead of the scan.
+    pull_rows(70);
+    for (auto count = 50; count < 80; count++) {
+        auto result = execute(database, ByteString::formatted("DELETE FROM TestSchema.TestTable WHERE IntColumn = {};", count));
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Delete);
+    }
+    for (auto count = 1000; count < 1030; count++)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+    pull_rows(NumericLimits<size_t>::max());
+    EXPECT(!MUST(cursor->next()).has_value());
+
+    // Deleted rows are skipped, whether the cursor had already read them or not, and new rows are never reached.
+    Vector<i32> expected_values;
+    for (auto value = 199; value >= 0; --value) {
+        if (value < 50 || value >= 80)
+            expected_values.append(value);
+    }
+    EXPECT_EQ(seen_values, expected_values);
+
+    auto result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+    EXPECT_EQ(result.size(), 200u);
+}
+
 TEST_CASE(select_with_limit_and_offset)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Socket.h>
+#include <LibCrypto/Authentication/HMAC.h>
+#include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTLS/SessionCache.h>
+#include <LibTLS/TLSv12.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static TLS::Session make_session(u8 id, Duration lifetime = TLS::SessionCache::default_session_lifetime)
+{
+    return TLS::Session {
+        .session_id = MUST(ByteBuffer::copy(Array<u8, 4> { id, id, id, id }.span())),
+        .ticket = {},
+        .master_key = MUST(ByteBuffer::create_zeroed(48)),
+        .cipher = TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+        .extended_master_secret = true,
+        .expires_at = MonotonicTime::now_coarse() + lifetime,
+    };
+}
+
+TEST_CASE(store_and_find)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("example.com", 443, make_session(1));
+
+    auto session = cache->find("example.com", 443);
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id.size(), 4u);
+    EXPECT_EQ(session->session_id[0], 1);
+    EXPECT_EQ(session->cipher, TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256);
+    EXPECT(session->extended_master_secret);
+
+    EXPECT(!cache->find("example.com", 8443).has_value());
+    EXPECT(!cache->find("example.org", 443).has_value());
+}
+
+TEST_CASE(store_replaces_and_remove_forgets)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("example.com", 443, make_session(1));
+    cache->store("example.com", 443, make_session(2));
+    EXPECT_EQ(cache->size(), 1u);
+    EXPECT_EQ(cache->find("example.com", 443)->session_id[0], 2);
+
+    cache->remove("example.com", 443);
+    EXPECT(!cache->find("example.com", 443).has_value());
+    EXPECT_EQ(cache->size(), 0u);
+}
+
+TEST_CASE(unresumable_sessions_are_not_cached)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("example.com", 443, make_session(1));
+
+    auto session = make_session(2);
+    session.session_id.clear();
+    cache->store("example.com", 443, move(session));
+    EXPECT(!cache->find("example.com", 443).has_value());
+}
+
+TEST_CASE(expired_sessions_are_dropped)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("example.com", 443, make_session(1, Duration::from_seconds(-1)));
+    EXPECT(!cache->find("example.com", 443).has_value());
+    EXPECT_EQ(cache->size(), 0u);
+}
+
+TEST_CASE(full_cache_evicts_soonest_to_expire)
+{
+    auto cache = TLS::SessionCache::create(2);
+    cache->store("a.example.com", 443, make_session(1, Duration::from_seconds(60)));
+    cache->store("b.example.com", 443, make_session(2, Duration::from_seconds(30)));
+    cache->store("c.example.com", 443, make_session(3, Duration::from_seconds(90)));
+
+    EXPECT_EQ(cache->size(), 2u);
+    EXPECT(cache->find("a.example.com", 443).has_value());
+    EXPECT(!cache->find("b.example.com", 443).has_value());
+    EXPECT(cache->find("c.example.com", 443).has_value());
+}
+
+static constexpr auto test_host = "example.com"sv;
+static constexpr auto test_cipher = TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256;
+
+static void append_u16(ByteBuffer& buffer, u16 value)
+{
+    buffer.append(static_cast<u8>(value >> 8));
+    buffer.append(static_cast<u8>(value));
+}
+
+static void append_u24(ByteBuffer& buffer, u32 value)
+{
+    buffer.append(static_cast<u8>(value >> 16));
+    append_u16(buffer, static_cast<u16>(value));
+}
+
+static ByteBuffer handshake_message(TLS::HandshakeType type, ReadonlyBytes body)
+{
+    ByteBuffer message;
+    message.append(to_underlying(type));
+    append_u24(message, body.size());
+    message.append(body);
+    return message;
+}
+
+static ByteBuffer new_session_ticket(u32 lifetime_hint, ReadonlyBytes ticket, u16 ticket_length)
+{
+    ByteBuffer body;
+    append_u16(body, lifetime_hint >> 16);
+    append_u16(body, lifetime_hint);
+    append_u16(body, ticket_length);
+    body.append(ticket);
+    return handshake_message(TLS::HandshakeType::NEW_SESSION_TICKET, body);
+}
+
+// RFC 5246 section 5: PRF(secret, label, seed) = P_SHA256(secret, label + seed)
+static ByteBuffer pseudorandom_function(ReadonlyBytes secret, StringView label, ReadonlyBytes seed, size_t length)
+{
+    auto label_and_seed = MUST(ByteBuffer::copy(label.bytes()));
+    label_and_seed.append(seed);
+
+    Crypto::Authentication::HMAC<Crypto::Hash::SHA256> hmac(secret);
+    auto a = MUST(ByteBuffer::copy(label_and_seed));
+    ByteBuffer output;
+    while (output.size() < length) {
+        a = MUST(ByteBuffer::copy(hmac.process(a.bytes()).bytes()));
+        hmac.update(a.bytes());
+        hmac.update(label_and_seed.bytes());
+        output.append(hmac.digest().bytes());
+    }
+    output.trim(length, false);
+    return output;
+}
+
+struct Record {
+    TLS::ContentType type;
+    ByteBuffer payload;
+};
+
+// Plays the server side of an abbreviated TLS 1.2 handshake over a local socket pair, with canned records.
+// Every session it resumes uses test_cipher, so the records after the ChangeCipherSpec are AES-128-GCM.
+class ScriptedServer {
+public:
+    explicit ScriptedServer(NonnullRefPtr<TLS::SessionCache> cache)
+    {
+        int fds[2];
+        VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+        m_fd = fds[1];
+        VERIFY(fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK) == 0);
+
+        auto socket = MUST(Core::LocalSocket::adopt_fd(fds[0]));
+        MUST(socket->set_blocking(false));
+
+        TLS::Options options;
+        options.set_root_certificates(Vector<TLS::Certificate> {});
+        options.set_session_cache(move(cache));
+        client = make<TLS::TLSv12>(OwnPtr<Core::Socket> { move(socket) }, move(options));
+        client->set_sni(test_host);
+        client->on_connected = [this] { connected = true; };
+        client->on_tls_error = [this](TLS::AlertDescription alert) { error = alert; };
+
+        pump();
+        auto records = receive_records();
+        VERIFY(records.size() == 1 && records[0].type == TLS::ContentType::HANDSHAKE);
+        parse_client_hello(records[0].payload);
+    }
+
+    ~ScriptedServer()
+    {
+        client = nullptr;
+        close(m_fd);
+    }
+
+    void pump()
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    }
+
+    void send_record(TLS::ContentType type, ReadonlyBytes payload)
+    {
+        ByteBuffer record;
+        record.append(to_underlying(type));
+        append_u16(record, to_underlying(TLS::ProtocolVersion::VERSION_1_2));
+        append_u16(record, payload.size());
+        record.append(payload);
+        VERIFY(write(m_fd, record.data(), record.size()) == static_cast<ssize_t>(record.size()));
+    }
+
+    void send_server_hello(ReadonlyBytes session_id, TLS::CipherSuite cipher, bool extended_master_secret, bool session_ticket)
+    {
+        ByteBuffer body;
+        append_u16(body, to_underlying(TLS::ProtocolVersion::VERSION_1_2));
+        body.append(server_random);
+        body.append(static_cast<u8>(session_id.size()));
+        body.append(session_id);
+        append_u16(body, to_underlying(cipher));
+        body.append(static_cast<u8>(0)); // compression_method: null
+
+        ByteBuffer extensions;
+        if (extended_master_secret) {
+            append_u16(extensions, to_underlying(TLS::ExtensionType::EXTENDED_MASTER_SECRET));
+            append_u16(extensions, 0);
+        }
+        if (session_ticket) {
+            append_u16(extensions, to_underlying(TLS::ExtensionType::SESSION_TICKET));
+            append_u16(extensions, 0);
+        }
+        append_u16(body, extensions.size());
+        body.append(extensions);
+
+        send_record(TLS::ContentType::HANDSHAKE, handshake_message(TLS::HandshakeType::SERVER_HELLO, body));
+    }
+
+    // Switches to the keys of `master_key`, and sends the server's Finished, which ends an abbreviated handshake.
+    void send_change_cipher_spec_and_finished(ReadonlyBytes master_key)
+    {
+        // RFC 5246 section 6.3: key_block = PRF(master_secret, "key expansion", server_random + client_random)
+        ByteBuffer randoms;
+        randoms.append(server_random);
+        randoms.append(client_random);
+        m_key_block = pseudorandom_function(master_key, "key expansion"sv, randoms, 40);
+
+        send_record(TLS::ContentType::CHANGE_CIPHER_SPEC, Array<u8, 1> { 1 });
+
+        // The client doesn't check the verify_data (yet), so any 12 bytes will do.
+        Array<u8, 12> verify_data {};
+        auto finished = handshake_message(TLS::HandshakeType::FINISHED, verify_data);
+
+        Array<u8, 8> nonce {};
+        auto iv = gcm_iv(server_write_iv(), nonce);
+        auto aad = additional_data(TLS::ContentType::HANDSHAKE, finished.size());
+        ByteBuffer payload;
+        payload.append(nonce);
+        auto ciphertext = MUST(ByteBuffer::create_uninitialized(finished.size()));
+        Array<u8, 16> tag {};
+        Crypto::Cipher::AESCipher::GCMMode gcm(server_write_key(), 128, Crypto::Cipher::Intent::Encryption);
+        gcm.encrypt(finished, ciphertext, iv, aad, tag.span());
+        payload.append(ciphertext);
+        payload.append(tag);
+        send_record(TLS::ContentType::HANDSHAKE, payload);
+    }
+
+    // Decrypts the first record the client protected with the keys from send_change_cipher_spec_and_finished().
+    Optional<ByteBuffer> decrypt_from_client(Record const& record)
+    {
+        if (record.payload.size() < 8 + 16)
+            return {};
+        auto nonce = record.payload.bytes().slice(0, 8);
+        auto ciphertext = record.payload.bytes().slice(8, record.payload.size() - 8 - 16);
+        auto tag = record.payload.bytes().slice(record.payload.size() - 16);
+
+        auto iv = gcm_iv(client_write_iv(), nonce);
+        auto aad = additional_data(record.type, ciphertext.size());
+        auto plaintext = MUST(ByteBuffer::create_uninitialized(ciphertext.size()));
+        Crypto::Cipher::AESCipher::GCMMode gcm(client_write_key(), 128, Crypto::Cipher::Intent::Decryption);
+        if (gcm.decrypt(ciphertext, plaintext, iv, aad, tag) != Crypto::VerificationConsistency::Consistent)
+            return {};
+        return plaintext;
+    }
+
+    Vector<Record> receive_records()
+    {
+        u8 buffer[4096];
+        for (;;) {
+            auto nread = read(m_fd, buffer, sizeof(buffer));
+            if (nread <= 0)
+                break;
+            m_received.append(buffer, nread);
+        }
+
+        Vector<Record> records;
+        while (m_received.size() >= 5) {
+            size_t length = (m_received[3] << 8) | m_received[4];
+            if (m_received.size() < 5 + length)
+                break;
+            records.append({ static_cast<TLS::ContentType>(m_received[0]), MUST(ByteBuffer::copy(m_received.bytes().slice(5, length))) });
+            m_received = MUST(ByteBuffer::copy(m_received.bytes().slice(5 + length)));
+        }
+        return records;
+    }
+
+    OwnPtr<TLS::TLSv12> client;
+    bool connected { false };
+    Optional<TLS::AlertDescription> error;
+
+    Array<u8, 32> client_random {};
+    Array<u8, 32> server_random {};
+    ByteBuffer offered_session_id;
+    Optional<ByteBuffer> offered_ticket;
+
+private:
+    void parse_client_hello(ReadonlyBytes message)
+    {
+        VERIFY(message[0] == to_underlying(TLS::HandshakeType::CLIENT_HELLO));
+        size_t offset = 4 + 2;
+        message.slice(offset, 32).copy_to(client_random.span());
+        offset += 32;
+
+        size_t session_id_length = message[offset++];
+        offered_session_id = MUST(ByteBuffer::copy(message.slice(offset, session_id_length)));
+        offset += session_id_length;
+
+        offset += 2 + ((message[offset] << 8) | message[offset + 1]); // cipher_suites
+        offset += 1 + message[offset];                                 // compression_methods
+        size_t extensions_end = offset + 2 + ((message[offset] << 8) | message[offset + 1]);
+        offset += 2;
+        while (offset + 4 <= extensions_end) {
+            u16 type = (message[offset] << 8) | message[offset + 1];
+            size_t length = (message[offset + 2] << 8) | message[offset + 3];
+            offset += 4;
+            if (type == to_underlying(TLS::ExtensionType::SESSION_TICKET))
+                offered_ticket = MUST(ByteBuffer::copy(message.slice(offset, length)));
+            offset += length;
+        }
+    }
+
+    // RFC 5288 section 3: The nonce is the 4 byte implicit IV from the key block, followed by the 8 byte explicit one.
+    //                     Our GCM implementation wants it padded to 16 bytes.
+    static Array<u8, 16> gcm_iv(ReadonlyBytes implicit_iv, ReadonlyBytes explicit_nonce)
+    {
+        Array<u8, 16> iv {};
+        implicit_iv.copy_to(iv.span().slice(0, 4));
+        explicit_nonce.copy_to(iv.span().slice(4, 8));
+        return iv;
+    }
+
+    // RFC 5246 section 6.2.3.3: additional_data = seq_num + TLSCompressed.type + TLSCompressed.version + TLSCompressed.length
+    //                           Both sides only ever protect a single record here, so the sequence number is always 0.
+    static ByteBuffer additional_data(TLS::ContentType type, size_t length)
+    {
+        auto aad = MUST(ByteBuffer::create_zeroed(8));
+        aad.append(to_underlying(type));
+        append_u16(aad, to_underlying(TLS::ProtocolVersion::VERSION_1_2));
+        append_u16(aad, length);
+        return aad;
+    }
+
+    ReadonlyBytes client_write_key() const { return m_key_block.bytes().slice(0, 16); }
+    ReadonlyBytes server_write_key() const { return m_key_block.bytes().slice(16, 16); }
+    ReadonlyBytes client_write_iv() const { return m_key_block.bytes().slice(32, 4); }
+    ReadonlyBytes server_write_iv() const { return m_key_block.bytes().slice(36, 4); }
+
+    Core::EventLoop m_event_loop;
+    int m_fd { -1 };
+    ByteBuffer m_received;
+    ByteBuffer m_key_block;
+};
+
+static TLS::Session make_resumable_session(ReadonlyBytes session_id, StringView ticket)
+{
+    return TLS::Session {
+        .session_id = MUST(ByteBuffer::copy(session_id)),
+        .ticket = MUST(ByteBuffer::copy(ticket.bytes())),
+        .master_key = MUST(ByteBuffer::copy(Array<u8, 48> { 0x42 }.span())),
+        .cipher = test_cipher,
+        .extended_master_secret = true,
+        .expires_at = MonotonicTime::now_coarse() + TLS::SessionCache::default_session_lifetime,
+    };
+}
+
+static Array<u8, 32> const cached_session_id { 0x11, 0x22, 0x33, 0x44 };
+
+TEST_CASE(abbreviated_handshake)
+{
+    auto cache = TLS::SessionCache::create();
+    auto cached = make_resumable_session(cached_session_id, "old ticket"sv);
+    auto master_key = MUST(ByteBuffer::copy(cached.master_key));
+    cache->store(test_host, 0, move(cached));
+
+    ScriptedServer server(cache);
+    EXPECT_EQ(server.offered_session_id.bytes(), cached_session_id.span());
+    EXPECT(server.offered_ticket.has_value());
+    EXPECT_EQ(StringView { server.offered_ticket->bytes() }, "old ticket"sv);
+
+    server.send_server_hello(server.offered_session_id, test_cipher, true, true);
+    server.send_record(TLS::ContentType::HANDSHAKE, new_session_ticket(3600, "new ticket"sv.bytes(), 10));
+    server.send_change_cipher_spec_and_finished(master_key);
+    server.pump();
+
+    EXPECT(!server.error.has_value());
+    EXPECT(server.connected);
+    EXPECT(server.client->is_established());
+
+    // The server spoke first, so the client has to answer with its own ChangeCipherSpec and Finished.
+    auto records = server.receive_records();
+    EXPECT_EQ(records.size(), 2u);
+    if (records.size() == 2) {
+        EXPECT_EQ(records[0].type, TLS::ContentType::CHANGE_CIPHER_SPEC);
+        EXPECT_EQ(records[1].type, TLS::ContentType::HANDSHAKE);
+        auto finished = server.decrypt_from_client(records[1]);
+        EXPECT(finished.has_value());
+        if (finished.has_value()) {
+            EXPECT_EQ(finished->size(), 4u + 12u);
+            EXPECT_EQ((*finished)[0], to_underlying(TLS::HandshakeType::FINISHED));
+        }
+    }
+
+    auto session = cache->find(test_host, 0);
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id.bytes(), cached_session_id.span());
+    EXPECT_EQ(StringView { session->ticket.bytes() }, "new ticket"sv);
+    EXPECT_EQ(session->master_key.bytes(), master_key.bytes());
+}
+
+TEST_CASE(ticket_only_session_is_offered_with_a_random_session_id)
+{
+    auto cache = TLS::SessionCache::create();
+    auto cached = make_resumable_session({}, "ticket"sv);
+    auto master_key = MUST(ByteBuffer::copy(cached.master_key));
+    cache->store(test_host, 0, move(cached));
+
+    ScriptedServer server(cache);
+    EXPECT_EQ(server.offered_session_id.size(), 32u);
+    EXPECT(server.offered_ticket.has_value());
+
+    // RFC 5077 section 3.4: The server accepts the ticket by echoing our session ID, and doesn't issue a new ticket.
+    server.send_server_hello(server.offered_session_id, test_cipher, true, false);
+    server.send_change_cipher_spec_and_finished(master_key);
+    server.pump();
+
+    EXPECT(server.connected);
+    auto session = cache->find(test_host, 0);
+    EXPECT(session.has_value());
+    EXPECT(session->session_id.is_empty());
+    EXPECT_EQ(StringView { session->ticket.bytes() }, "ticket"sv);
+}
+
+TEST_CASE(empty_new_session_ticket)
+{
+    auto cache = TLS::SessionCache::create();
+    auto cached = make_resumable_session(cached_session_id, "old ticket"sv);
+    auto master_key = MUST(ByteBuffer::copy(cached.master_key));
+    cache->store(test_host, 0, move(cached));
+
+    ScriptedServer server(cache);
+    server.send_server_hello(server.offered_session_id, test_cipher, true, true);
+    server.send_record(TLS::ContentType::HANDSHAKE, new_session_ticket(0, {}, 0));
+    server.send_change_cipher_spec_and_finished(master_key);
+    server.pump();
+
+    EXPECT(server.connected);
+
+    // The server took back its ticket, so only the session ID is left to resume with.
+    auto session = cache->find(test_host, 0);
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id.bytes(), cached_session_id.span());
+    EXPECT(session->ticket.is_empty());
+}
+
+TEST_CASE(new_session_ticket_length_mismatch)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store(test_host, 0, make_resumable_session(cached_session_id, "old ticket"sv));
+
+    ScriptedServer server(cache);
+    server.send_server_hello(server.offered_session_id, test_cipher, true, true);
+    server.send_record(TLS::ContentType::HANDSHAKE, new_session_ticket(3600, "new ticket"sv.bytes(), 11));
+    server.pump();
+
+    EXPECT(!server.connected);
+    EXPECT(server.error == TLS::AlertDescription::DECODE_ERROR);
+    EXPECT(!cache->find(test_host, 0).has_value());
+}
+
+TEST_CASE(resumption_with_a_different_cipher_suite_is_aborted)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store(test_host, 0, make_resumable_session(cached_session_id, "old ticket"sv));
+
+    ScriptedServer server(cache);
+    server.send_server_hello(server.offered_session_id, TLS::CipherSuite::TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384, true, false);
+    server.pump();
+
+    EXPECT(!server.connected);
+    EXPECT(server.error == TLS::AlertDescription::DECRYPT_ERROR);
+    EXPECT(!cache->find(test_host, 0).has_value());
+}
+
+TEST_CASE(resumption_with_mismatched_extended_master_secret_is_aborted)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store(test_host, 0, make_resumable_session(cached_session_id, "old ticket"sv));
+
+    ScriptedServer server(cache);
+    server.send_server_hello(server.offered_session_id, test_cipher, false, false);
+    server.pump();
+
+    EXPECT(!server.connected);
+    EXPECT(server.error == TLS::AlertDescription::DECRYPT_ERROR);
+    EXPECT(!cache->find(test_host, 0).has_value());
+}
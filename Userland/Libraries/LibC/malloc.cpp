@@ -49,6 +49,17 @@ constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+constexpr size_t default_alignment = 16;
+
+#ifndef NO_TLS
+#    define USE_THREAD_CACHE
+// Only the size classes up to 1008 bytes are cached per thread, to keep the TLS footprint small.
+constexpr size_t number_of_thread_cached_size_classes = 7;
+constexpr size_t thread_cache_capacity_per_size_class = 16;
+constexpr size_t thread_cache_batch_size = thread_cache_capacity_per_size_class / 2;
+static_assert(number_of_thread_cached_size_classes <= num_size_classes);
+#endif
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
@@ -57,6 +68,9 @@ static bool s_profiling = false;
 struct MallocStats {
     size_t number_of_malloc_calls;
 
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_refills;
+
     size_t number_of_big_allocator_hits;
     size_t number_of_big_allocator_purge_hits;
     size_t number_of_big_allocs;
@@ -69,6 +83,9 @@ struct MallocStats {
 
     size_t number_of_free_calls;
 
+    size_t number_of_thread_cache_keeps;
+    size_t number_of_thread_cache_drains;
+
     size_t number_of_big_allocator_keeps;
     size_t number_of_big_allocator_frees;
 
@@ -252,6 +269,97 @@ enum class CallerWillInitializeMemory {
 __thread bool __allocation_enabled = true;
 #endif
 
+static ErrorOr<void*> allocate_chunk_locked(Allocator&, size_t good_size, size_t align);
+static void free_chunk_locked(ChunkedBlock&, void* ptr);
+
+#ifdef USE_THREAD_CACHE
+// NOTE: Every thread keeps a small cache of free chunks for each of the smaller size classes,
+//       so that most allocations and frees don't need to take s_malloc_mutex at all.
+//       Chunks move between the thread cache and the shared allocators in batches.
+struct ThreadCacheBin {
+    size_t count { 0 };
+    void* chunks[thread_cache_capacity_per_size_class] {};
+};
+
+struct ThreadCache {
+    ThreadCacheBin bins[number_of_thread_cached_size_classes];
+
+    // NOTE: These are counted per thread, and only added to g_malloc_stats while holding s_malloc_mutex.
+    size_t number_of_hits { 0 };
+    size_t number_of_refills { 0 };
+    size_t number_of_keeps { 0 };
+    size_t number_of_drains { 0 };
+};
+
+static __thread ThreadCache s_thread_cache;
+
+static void flush_thread_cache_stats_locked()
+{
+    g_malloc_stats.number_of_thread_cache_hits += exchange(s_thread_cache.number_of_hits, 0);
+    g_malloc_stats.number_of_thread_cache_refills += exchange(s_thread_cache.number_of_refills, 0);
+    g_malloc_stats.number_of_thread_cache_keeps += exchange(s_thread_cache.number_of_keeps, 0);
+    g_malloc_stats.number_of_thread_cache_drains += exchange(s_thread_cache.number_of_drains, 0);
+}
+
+static ErrorOr<void*> allocate_from_thread_cache(Allocator& allocator, size_t size_class, size_t good_size)
+{
+    auto& bin = s_thread_cache.bins[size_class];
+    if (bin.count == 0) {
+        s_thread_cache.number_of_refills++;
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_stats_locked();
+        while (bin.count < thread_cache_batch_size) {
+            auto ptr_or_error = allocate_chunk_locked(allocator, good_size, default_alignment);
+            if (ptr_or_error.is_error()) {
+                if (bin.count == 0)
+                    return ptr_or_error.release_error();
+                break;
+            }
+            bin.chunks[bin.count++] = ptr_or_error.release_value();
+        }
+    } else {
+        s_thread_cache.number_of_hits++;
+    }
+    return bin.chunks[--bin.count];
+}
+
+static void free_to_thread_cache(size_t size_class, void* ptr)
+{
+    auto& bin = s_thread_cache.bins[size_class];
+    if (bin.count == thread_cache_capacity_per_size_class) {
+        // Give the least recently freed chunks back to the shared allocator, and keep the hot ones around.
+        s_thread_cache.number_of_drains++;
+        {
+            PthreadMutexLocker locker(s_malloc_mutex);
+            flush_thread_cache_stats_locked();
+            for (size_t i = 0; i < thread_cache_batch_size; ++i) {
+                auto* chunk = bin.chunks[i];
+                free_chunk_locked(*(ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+            }
+        }
+        memmove(&bin.chunks[0], &bin.chunks[thread_cache_batch_size], (bin.count - thread_cache_batch_size) * sizeof(void*));
+        bin.count -= thread_cache_batch_size;
+    } else {
+        s_thread_cache.number_of_keeps++;
+    }
+    bin.chunks[bin.count++] = ptr;
+}
+#endif
+
+void __malloc_destroy_thread_cache()
+{
+#ifdef USE_THREAD_CACHE
+    PthreadMutexLocker locker(s_malloc_mutex);
+    flush_thread_cache_stats_locked();
+    for (auto& bin : s_thread_cache.bins) {
+        while (bin.count > 0) {
+            auto* chunk = bin.chunks[--bin.count];
+            free_chunk_locked(*(ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+        }
+    }
+#endif
+}
+
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
 {
 #ifndef NO_TLS
@@ -280,6 +388,18 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifdef USE_THREAD_CACHE
+    if (allocator && align <= default_alignment) {
+        auto size_class = static_cast<size_t>(allocator - allocators());
+        if (size_class < number_of_thread_cached_size_classes) {
+            auto* ptr = TRY(allocate_from_thread_cache(*allocator, size_class, good_size));
+            if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+            return ptr;
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -319,9 +439,20 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
     }
 
+    auto* ptr = TRY(allocate_chunk_locked(*allocator, good_size, align));
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (size {})", ptr, good_size);
+
+    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+
+    return ptr;
+}
+
+static ErrorOr<void*> allocate_chunk_locked(Allocator& allocator, size_t good_size, size_t align)
+{
     ChunkedBlock* block = nullptr;
     void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
+    for (auto& current : allocator.usable_blocks) {
         if (current.free_chunks()) {
             ptr = try_allocate_chunk_aligned(align, current);
             if (ptr) {
@@ -340,7 +471,7 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
             snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
             set_mmap_name(block, ChunkedBlock::block_size, buffer);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block && s_cold_empty_block_count) {
@@ -362,7 +493,7 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
                 g_malloc_stats.number_of_cold_empty_block_purge_hits++;
             new (block) ChunkedBlock(good_size);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block) {
@@ -371,8 +502,8 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
         block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
     }
 
     if (!ptr) {
@@ -383,13 +514,10 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
         dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
     }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
-
-    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated chunk {:p} in block {:p}, size {}", ptr, block, block->bytes_per_chunk());
 
     return ptr;
 }
@@ -410,6 +538,20 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+#ifdef USE_THREAD_CACHE
+    if (magic == MAGIC_PAGE_HEADER) {
+        auto& block = *(ChunkedBlock*)block_base;
+        size_t good_size;
+        auto size_class = static_cast<size_t>(allocator_for_size(block.m_size, good_size) - allocators());
+        if (size_class < number_of_thread_cached_size_classes) {
+            if (s_scrub_free)
+                memset(ptr, FREE_SCRUB_BYTE, block.bytes_per_chunk());
+            free_to_thread_cache(size_class, ptr);
+            return;
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -440,11 +582,17 @@ static void free_impl(void* ptr)
     VERIFY(magic == MAGIC_PAGE_HEADER);
     auto* block = (ChunkedBlock*)block_base;
 
-    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
-
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
+    free_chunk_locked(*block, ptr);
+}
+
+static void free_chunk_locked(ChunkedBlock& chunked_block, void* ptr)
+{
+    auto* block = &chunked_block;
+    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+
     auto* entry = (FreelistEntry*)ptr;
     entry->next = block->m_freelist;
     block->m_freelist = entry;
@@ -490,7 +638,7 @@ static void free_impl(void* ptr)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
 void* malloc(size_t size)
 {
-    auto ptr_or_error = malloc_impl(size, 16, CallerWillInitializeMemory::No);
+    auto ptr_or_error = malloc_impl(size, default_alignment, CallerWillInitializeMemory::No);
 
     if (ptr_or_error.is_error()) {
         errno = ptr_or_error.error().code();
@@ -519,7 +667,7 @@ void* calloc(size_t count, size_t size)
         return nullptr;
     }
     size_t new_size = count * size;
-    auto ptr_or_error = malloc_impl(new_size, 16, CallerWillInitializeMemory::Yes);
+    auto ptr_or_error = malloc_impl(new_size, default_alignment, CallerWillInitializeMemory::Yes);
 
     if (ptr_or_error.is_error()) {
         errno = ptr_or_error.error().code();
@@ -618,8 +766,19 @@ void __malloc_init()
 
 void serenity_dump_malloc_stats()
 {
+#ifdef USE_THREAD_CACHE
+    // NOTE: Other threads' counts show up once they next take the lock (or exit).
+    {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_stats_locked();
+    }
+#endif
+
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
     dbgln();
+    dbgln("thread cache hits: {}", g_malloc_stats.number_of_thread_cache_hits);
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln();
     dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
     dbgln("big alloc hits that were purged: {}", g_malloc_stats.number_of_big_allocator_purge_hits);
     dbgln("big allocs: {}", g_malloc_stats.number_of_big_allocs);
@@ -632,6 +791,9 @@ void serenity_dump_malloc_stats()
     dbgln();
     dbgln("# free() calls: {}", g_malloc_stats.number_of_free_calls);
     dbgln();
+    dbgln("thread cache keeps: {}", g_malloc_stats.number_of_thread_cache_keeps);
+    dbgln("thread cache drains: {}", g_malloc_stats.number_of_thread_cache_drains);
+    dbgln();
     dbgln("big alloc keeps: {}", g_malloc_stats.number_of_big_allocator_keeps);
     dbgln("big alloc frees: {}", g_malloc_stats.number_of_big_allocator_frees);
     dbgln();
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <signal.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+int epoll_create(int size);
+int epoll_create1(int flags);
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event*);
+int epoll_wait(int epfd, struct epoll_event*, int maxevents, int timeout);
+int epoll_pwait(int epfd, struct epoll_event*, int maxevents, int timeout, sigset_t const* sigmask);
+int epoll_pwait2(int epfd, struct epoll_event*, int maxevents, const struct timespec* timeout, sigset_t const* sigmask);
+
+__END_DECLS
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/BinaryHeap.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
@@ -48,6 +49,28 @@ bool has_flag(int value, int flag)
     return (value & flag) == flag;
 }
 
+// NOTE: The epoll event bits have the same values as the poll ones, so this handles both.
+NotificationType notification_type_from_poll_events(int revents)
+{
+    NotificationType type = NotificationType::None;
+    if (has_flag(revents, POLLIN))
+        type |= NotificationType::Read;
+    if (has_flag(revents, POLLOUT))
+        type |= NotificationType::Write;
+    if (has_flag(revents, POLLHUP))
+        type |= NotificationType::Read | NotificationType::HangUp;
+    if (has_flag(revents, POLLERR))
+        type |= NotificationType::Error;
+    return type;
+}
+
+void post_notifier_activation_if_needed(Notifier& notifier, NotificationType type)
+{
+    type &= notifier.type();
+    if (type != NotificationType::None)
+        ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
+}
+
 class EventLoopTimeout {
 public:
     static constexpr ssize_t INVALID_INDEX = NumericLimits<ssize_t>::max();
@@ -281,17 +304,61 @@ struct ThreadData {
         wake_pipe_fds = result.release_value();
 
         // The wake pipe informs us of POSIX signals as well as manual calls to wake()
+#ifdef AK_OS_SERENITY
+        if (epoll_fd != -1)
+            close(epoll_fd);
+
+        auto epoll_fd_or_error = Core::System::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_or_error.is_error()) {
+            warnln("\033[31;1mFailed to create event loop epoll:\033[0m {}", epoll_fd_or_error.error());
+            VERIFY_NOT_REACHED();
+        }
+        epoll_fd = epoll_fd_or_error.release_value();
+
+        VERIFY(notifiers_by_fd.is_empty());
+        epoll_event event { .events = EPOLLIN, .data = { .fd = wake_pipe_fds[0] } };
+        MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event));
+        ready_events.resize(max_ready_events_per_wait);
+#else
         VERIFY(poll_fds.size() == 0);
         poll_fds.append({ .fd = wake_pipe_fds[0], .events = POLLIN, .revents = 0 });
         notifier_by_index.append(nullptr);
+#endif
     }
 
+#ifdef AK_OS_SERENITY
+    void update_epoll_interest(int fd, int op)
+    {
+        epoll_event event { .events = 0, .data = { .fd = fd } };
+        if (auto notifiers = notifiers_by_fd.get(fd); notifiers.has_value()) {
+            for (auto* notifier : notifiers.value())
+                event.events |= notification_type_to_poll_events(notifier->type());
+        }
+        auto result = Core::System::epoll_ctl(epoll_fd, op, fd, &event);
+        // The fd may already have been closed, in which case the kernel drops the interest by itself.
+        // If the fd number has been reused since, we still want to hear about it, so add it back.
+        if (result.is_error() && op == EPOLL_CTL_MOD && result.error().code() == ENOENT)
+            result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (result.is_error() && op != EPOLL_CTL_DEL)
+            dbgln("EventLoopImplementationUnix: Failed to update interest in fd {}: {}", fd, result.error());
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
+#ifdef AK_OS_SERENITY
+    // The kernel keeps the set of fds we're interested in, so we only tell it about changes
+    // instead of handing it every fd on each iteration.
+    static constexpr size_t max_ready_events_per_wait = 64;
+    int epoll_fd { -1 };
+    Vector<epoll_event> ready_events;
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+#else
     Vector<pollfd> poll_fds;
     HashMap<Notifier*, size_t> notifier_by_ptr;
     Vector<Notifier*> notifier_by_index;
+#endif
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -383,7 +450,11 @@ retry:
 
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+#ifdef AK_OS_SERENITY
+    ErrorOr<int> error_or_marked_fd_count = System::epoll_wait(thread_data.epoll_fd, thread_data.ready_events, should_wait_forever ? -1 : timeout);
+#else
     ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+#endif
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -393,9 +464,16 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+#ifdef AK_OS_SERENITY
+    auto ready_events = thread_data.ready_events.span().trim(error_or_marked_fd_count.value());
+    bool wake_pipe_is_readable = any_of(ready_events, [&](auto& event) { return event.data.fd == thread_data.wake_pipe_fds[0]; });
+#else
+    bool wake_pipe_is_readable = has_flag(thread_data.poll_fds[0].revents, POLLIN);
+#endif
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -426,25 +504,24 @@ try_select_again:
 
     if (error_or_marked_fd_count.value() != 0) {
         // Handle file system notifiers by making them normal events.
+#ifdef AK_OS_SERENITY
+        for (auto& event : ready_events) {
+            if (event.data.fd == thread_data.wake_pipe_fds[0])
+                continue;
+            // A signal handler may have unregistered the notifiers in the meantime.
+            auto notifiers = thread_data.notifiers_by_fd.get(event.data.fd);
+            if (!notifiers.has_value())
+                continue;
+            auto type = notification_type_from_poll_events(event.events);
+            for (auto* notifier : notifiers.value())
+                post_notifier_activation_if_needed(*notifier, type);
+        }
+#else
         for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
-            auto& revents = thread_data.poll_fds[i].revents;
             auto& notifier = *thread_data.notifier_by_index[i];
-
-            NotificationType type = NotificationType::None;
-            if (has_flag(revents, POLLIN))
-                type |= NotificationType::Read;
-            if (has_flag(revents, POLLOUT))
-                type |= NotificationType::Write;
-            if (has_flag(revents, POLLHUP))
-                type |= NotificationType::Read | NotificationType::HangUp;
-            if (has_flag(revents, POLLERR))
-                type |= NotificationType::Error;
-
-            type &= notifier.type();
-
-            if (type != NotificationType::None)
-                ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
+            post_notifier_activation_if_needed(notifier, notification_type_from_poll_events(thread_data.poll_fds[i].revents));
         }
+#endif
     }
 
     // Handle expired timers.
@@ -522,9 +599,13 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
     thread_data.timeouts.clear();
+#ifdef AK_OS_SERENITY
+    thread_data.notifiers_by_fd.clear();
+#else
     thread_data.poll_fds.clear();
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
+#endif
     thread_data.initialize_wake_pipe();
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
@@ -680,6 +761,11 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef AK_OS_SERENITY
+    auto& notifiers = thread_data.notifiers_by_fd.ensure(notifier.fd());
+    notifiers.append(&notifier);
+    thread_data.update_epoll_interest(notifier.fd(), notifiers.size() == 1 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+#else
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -687,6 +773,7 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
         .events = notification_type_to_poll_events(notifier.type()),
         .revents = 0,
     });
+#endif
 
     notifier.set_owner_thread(s_thread_id);
 }
@@ -698,6 +785,19 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
         return;
 
     auto& thread_data = *thread_data_ptr;
+#ifdef AK_OS_SERENITY
+    auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+    VERIFY(it != thread_data.notifiers_by_fd.end());
+
+    auto& notifiers = it->value;
+    notifiers.remove_first_matching([&](auto* other) { return other == &notifier; });
+    if (notifiers.is_empty()) {
+        thread_data.notifiers_by_fd.remove(it);
+        thread_data.update_epoll_interest(notifier.fd(), EPOLL_CTL_DEL);
+    } else {
+        thread_data.update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD);
+    }
+#else
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
@@ -711,6 +811,7 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
     }
     thread_data.poll_fds.take_last();
     thread_data.notifier_by_index.take_last();
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
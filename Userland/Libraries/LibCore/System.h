@@ -47,6 +47,8 @@
 
 #ifdef AK_OS_SERENITY
 #    include <Kernel/API/Unshare.h>
+#    include <sys/epoll.h>
+#    include <sys/sendfile.h>
 #endif
 
 namespace Core::System {
@@ -243,6 +245,13 @@ ErrorOr<void> access(StringView pathname, int mode, int flags = 0);
 ErrorOr<ByteString> readlink(StringView pathname);
 ErrorOr<int> poll(Span<struct pollfd>, int timeout);
 
+#ifdef AK_OS_SERENITY
+ErrorOr<int> epoll_create1(int flags);
+ErrorOr<void> epoll_ctl(int epoll_fd, int op, int fd, struct epoll_event*);
+ErrorOr<int> epoll_wait(int epoll_fd, Span<struct epoll_event>, int timeout);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> create_block_device(StringView name, mode_t mode, unsigned major, unsigned minor);
 ErrorOr<void> create_char_device(StringView name, mode_t mode, unsigned major, unsigned minor);
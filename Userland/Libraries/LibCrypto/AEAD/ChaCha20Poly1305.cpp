@@ -39,42 +39,7 @@ ErrorOr<ByteBuffer> ChaCha20Poly1305::encrypt(ReadonlyBytes aad, ReadonlyBytes i
     // Finally, the Poly1305 function is called with the Poly1305 key
     // calculated above, and a message constructed as a concatenation of
     // the following:
-    auto mac_data = TRY(ByteBuffer::create_zeroed(0));
-    auto buffer_size = aad.size() + pad_to_16(aad) + ciphertext_buffer.size() + pad_to_16(ciphertext_buffer) + sizeof(u64) + sizeof(u64);
-    mac_data.ensure_capacity(buffer_size);
-
-    // The AAD
-    mac_data.append(aad);
-
-    // padding1 -- the padding is up to 15 zero bytes, and it brings
-    // the total length so far to an integral multiple of 16.  If the
-    // length of the AAD was already an integral multiple of 16 bytes,
-    // this field is zero-length.
-    for (size_t i = 0; i < pad_to_16(aad); ++i)
-        mac_data.append(0);
-
-    // The ciphertext
-    mac_data.append(ciphertext);
-
-    // padding2 -- the padding is up to 15 zero bytes, and it brings
-    // the total length so far to an integral multiple of 16.  If the
-    // length of the ciphertext was already an integral multiple of 16
-    // bytes, this field is zero-length.
-    for (size_t i = 0; i < pad_to_16(ciphertext); ++i)
-        mac_data.append(0);
-
-    u8 placeholder[8] = { 0 };
-    // The length of the additional data in octets (as a 64-bit little-endian integer).
-    mac_data.append(ReadonlyBytes { placeholder, 8 });
-    ByteReader::store(static_cast<u8*>(mac_data.end_pointer()) - sizeof(u64), AK::convert_between_host_and_little_endian(static_cast<u64>(aad.size())));
-
-    // The length of the ciphertext in octets (as a 64-bit little-endian integer).
-    mac_data.append(ReadonlyBytes { placeholder, 8 });
-    ByteReader::store(static_cast<u8*>(mac_data.end_pointer()) - sizeof(u64), AK::convert_between_host_and_little_endian(static_cast<u64>(ciphertext.size())));
-
-    Crypto::Authentication::Poly1305 mac_function(otk);
-    mac_function.update(mac_data.bytes());
-    auto tag = TRY(mac_function.digest());
+    auto tag = TRY(compute_tag(otk, aad, ciphertext));
 
     // The output from the AEAD is the concatenation of:
     auto result = TRY(ByteBuffer::create_zeroed(0));
@@ -113,53 +78,55 @@ ErrorOr<ByteBuffer> ChaCha20Poly1305::decrypt(ReadonlyBytes aad, ReadonlyBytes c
     // Finally, the Poly1305 function is called with the Poly1305 key
     // calculated above, and a message constructed as a concatenation of
     // the following:
-    auto mac_data = TRY(ByteBuffer::create_zeroed(0));
-    auto buffer_size = aad.size() + pad_to_16(aad) + ciphertext.size() + pad_to_16(ciphertext) + sizeof(u64) + sizeof(u64);
-    mac_data.ensure_capacity(buffer_size);
+    auto tag = TRY(compute_tag(otk, aad, ciphertext));
+
+    // The output from the AEAD is the concatenation of:
+    auto result = TRY(ByteBuffer::create_zeroed(0));
+    result.ensure_capacity(plaintext.size() + tag.size());
+
+    // A plaintext of the same length as the ciphertext.
+    result.append(plaintext);
+
+    // A 128-bit tag, which is the output of the Poly1305 function.
+    result.append(tag);
+    return result;
+}
+
+// https://datatracker.ietf.org/doc/html/rfc8439#section-2.8
+ErrorOr<ByteBuffer> ChaCha20Poly1305::compute_tag(ReadonlyBytes otk, ReadonlyBytes aad, ReadonlyBytes ciphertext)
+{
+    static constexpr u8 zeros[16] {};
+
+    // NOTE: The message is fed to Poly1305 piece by piece instead of being concatenated into a buffer first.
+    Crypto::Authentication::Poly1305 mac_function(otk);
 
     // The AAD
-    mac_data.append(aad);
+    mac_function.update(aad);
 
     // padding1 -- the padding is up to 15 zero bytes, and it brings
     // the total length so far to an integral multiple of 16.  If the
     // length of the AAD was already an integral multiple of 16 bytes,
     // this field is zero-length.
-    for (size_t i = 0; i < pad_to_16(aad); ++i)
-        mac_data.append(0);
+    mac_function.update({ zeros, pad_to_16(aad) });
 
     // The ciphertext
-    mac_data.append(ciphertext);
+    mac_function.update(ciphertext);
 
     // padding2 -- the padding is up to 15 zero bytes, and it brings
     // the total length so far to an integral multiple of 16.  If the
     // length of the ciphertext was already an integral multiple of 16
     // bytes, this field is zero-length.
-    for (size_t i = 0; i < pad_to_16(ciphertext); ++i)
-        mac_data.append(0);
+    mac_function.update({ zeros, pad_to_16(ciphertext) });
 
-    u8 placeholder[8] = { 0 };
+    u8 lengths[16];
     // The length of the additional data in octets (as a 64-bit little-endian integer).
-    mac_data.append(ReadonlyBytes { placeholder, 8 });
-    ByteReader::store(static_cast<u8*>(mac_data.end_pointer()) - sizeof(u64), AK::convert_between_host_and_little_endian(static_cast<u64>(aad.size())));
+    ByteReader::store(lengths, AK::convert_between_host_and_little_endian(static_cast<u64>(aad.size())));
 
     // The length of the ciphertext in octets (as a 64-bit little-endian integer).
-    mac_data.append(ReadonlyBytes { placeholder, 8 });
-    ByteReader::store(static_cast<u8*>(mac_data.end_pointer()) - sizeof(u64), AK::convert_between_host_and_little_endian(static_cast<u64>(ciphertext.size())));
+    ByteReader::store(lengths + sizeof(u64), AK::convert_between_host_and_little_endian(static_cast<u64>(ciphertext.size())));
+    mac_function.update({ lengths, sizeof(lengths) });
 
-    Crypto::Authentication::Poly1305 mac_function(otk);
-    mac_function.update(mac_data.bytes());
-    auto tag = TRY(mac_function.digest());
-
-    // The output from the AEAD is the concatenation of:
-    auto result = TRY(ByteBuffer::create_zeroed(0));
-    result.ensure_capacity(plaintext.size() + tag.size());
-
-    // A plaintext of the same length as the ciphertext.
-    result.append(plaintext);
-
-    // A 128-bit tag, which is the output of the Poly1305 function.
-    result.append(tag);
-    return result;
+    return mac_function.digest();
 }
 
 // https://datatracker.ietf.org/doc/html/rfc8439#section-4
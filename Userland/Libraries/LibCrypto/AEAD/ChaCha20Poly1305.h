@@ -24,9 +24,11 @@ public:
     static bool verify_tag(ReadonlyBytes encrypted, ReadonlyBytes decrypted);
 
 private:
+    ErrorOr<ByteBuffer> compute_tag(ReadonlyBytes otk, ReadonlyBytes aad, ReadonlyBytes ciphertext);
+
     u8 pad_to_16(ReadonlyBytes data)
     {
-        return 16 - (data.size() % 16);
+        return (16 - (data.size() % 16)) % 16;
     }
 
     ByteBuffer m_key;
@@ -5,7 +5,10 @@
  */
 
 #include <AK/ByteReader.h>
+#include <AK/CPUFeatures.h>
 #include <AK/Debug.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Types.h>
 #include <LibCrypto/Authentication/GHash.h>
 
@@ -27,38 +30,60 @@ static void to_u8s(u8* b, u32 const* w)
 
 namespace Crypto::Authentication {
 
+GHash::GHash(ReadonlyBytes key)
+{
+    VERIFY(key.size() >= 16);
+    for (size_t i = 0; i < 16; i += 4) {
+        m_key_powers[0][i / 4] = to_u32(key.offset(i));
+    }
+    for (size_t i = 1; i < AggregatedBlocks; ++i)
+        galois_multiply(m_key_powers[i], m_key_powers[i - 1], m_key_powers[0]);
+}
+
 GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 {
-    u32 tag[4] { 0, 0, 0, 0 };
-
-    auto transform_one = [&](auto& buf) {
-        size_t i = 0;
-        for (; i < buf.size(); i += 16) {
-            if (i + 16 <= buf.size()) {
-                for (auto j = 0; j < 4; ++j) {
-                    tag[j] ^= to_u32(buf.offset(i + j * 4));
-                }
-                galois_multiply(tag, m_key, tag);
-            }
-        }
+    begin(aad);
+    update(cipher);
+    return finish();
+}
 
-        if (i > buf.size()) {
-            u8 buffer[16] = {};
-            Bytes buffer_bytes { buffer, 16 };
-            buf.slice(i - 16).copy_to(buffer_bytes);
+void GHash::begin(ReadonlyBytes aad)
+{
+    __builtin_memset(m_tag, 0, sizeof(m_tag));
+    m_aad_size = aad.size();
+    m_cipher_size = 0;
+    m_saw_partial_block = false;
 
-            for (auto j = 0; j < 4; ++j) {
-                tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
-            }
-            galois_multiply(tag, m_key, tag);
-        }
-    };
+    transform(aad);
+}
+
+void GHash::update(ReadonlyBytes cipher)
+{
+    VERIFY(!m_saw_partial_block);
+    m_cipher_size += cipher.size();
+    m_saw_partial_block = cipher.size() % 16 != 0;
+
+    transform(cipher);
+}
 
-    transform_one(aad);
-    transform_one(cipher);
+void GHash::transform(ReadonlyBytes buf)
+{
+    auto full_blocks_size = buf.size() - buf.size() % 16;
+    if (full_blocks_size != 0)
+        (this->*transform_blocks_dispatched)(buf.trim(full_blocks_size));
+
+    if (full_blocks_size != buf.size()) {
+        u8 buffer[16] = {};
+        Bytes buffer_bytes { buffer, 16 };
+        buf.slice(full_blocks_size).copy_to(buffer_bytes);
+        (this->*transform_blocks_dispatched)(buffer_bytes);
+    }
+}
 
-    auto aad_bits = 8 * (u64)aad.size();
-    auto cipher_bits = 8 * (u64)cipher.size();
+GHash::TagType GHash::finish()
+{
+    auto aad_bits = 8 * m_aad_size;
+    auto cipher_bits = 8 * m_cipher_size;
 
     auto high = [](u64 value) -> u32 { return value >> 32; };
     auto low = [](u64 value) -> u32 { return value & 0xffffffff; };
@@ -66,24 +91,128 @@ GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
     if constexpr (GHASH_PROCESS_DEBUG) {
         dbgln("AAD bits: {} : {}", high(aad_bits), low(aad_bits));
         dbgln("Cipher bits: {} : {}", high(cipher_bits), low(cipher_bits));
-        dbgln("Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+        dbgln("Tag bits: {} : {} : {} : {}", m_tag[0], m_tag[1], m_tag[2], m_tag[3]);
     }
 
-    tag[0] ^= high(aad_bits);
-    tag[1] ^= low(aad_bits);
-    tag[2] ^= high(cipher_bits);
-    tag[3] ^= low(cipher_bits);
+    m_tag[0] ^= high(aad_bits);
+    m_tag[1] ^= low(aad_bits);
+    m_tag[2] ^= high(cipher_bits);
+    m_tag[3] ^= low(cipher_bits);
 
-    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", m_tag[0], m_tag[1], m_tag[2], m_tag[3]);
 
-    galois_multiply(tag, m_key, tag);
+    galois_multiply(m_tag, m_key_powers[0], m_tag);
 
     TagType digest;
-    to_u8s(digest.data, tag);
+    to_u8s(digest.data, m_tag);
 
     return digest;
 }
 
+template<>
+void GHash::transform_blocks_impl<CPUFeatures::None>(ReadonlyBytes blocks)
+{
+    for (size_t i = 0; i < blocks.size(); i += 16) {
+        for (auto j = 0; j < 4; ++j) {
+            m_tag[j] ^= to_u32(blocks.offset(i + j * 4));
+        }
+        galois_multiply(m_tag, m_key_powers[0], m_tag);
+    }
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_PCLMUL
+// The PCLMULQDQ path operates on byte-reversed blocks, which turns GHASH's reflected bit order into
+// "bit i is the coefficient of x^(127 - i)". The product of two such values then comes out shifted right
+// by one bit, which is corrected before reducing (see Intel's "Carry-Less Multiplication and Its Usage
+// for Computing the GCM Mode").
+using illx2 = signed long long int __attribute__((vector_size(16)));
+
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE static AK::SIMD::u64x2 ghash_load_words(u32 const (&words)[4])
+{
+    return bit_cast<AK::SIMD::u64x2>(AK::SIMD::u32x4 { words[3], words[2], words[1], words[0] });
+}
+
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE static void ghash_store_words(u32 (&words)[4], AK::SIMD::u64x2 value)
+{
+    auto value_words = bit_cast<AK::SIMD::u32x4>(value);
+    for (size_t i = 0; i < 4; ++i)
+        words[i] = value_words[3 - i];
+}
+
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE static AK::SIMD::u64x2 ghash_load_block(u8 const* data)
+{
+    return bit_cast<AK::SIMD::u64x2>(AK::SIMD::byte_reverse(AK::SIMD::load_unaligned<AK::SIMD::u8x16>(data)));
+}
+
+// Accumulates the unreduced 256-bit product a * b into low, middle and high.
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE static void ghash_multiply_accumulate(AK::SIMD::u64x2& low, AK::SIMD::u64x2& middle, AK::SIMD::u64x2& high, AK::SIMD::u64x2 a, AK::SIMD::u64x2 b)
+{
+    low ^= bit_cast<AK::SIMD::u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), 0x00));
+    middle ^= bit_cast<AK::SIMD::u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), 0x01));
+    middle ^= bit_cast<AK::SIMD::u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), 0x10));
+    high ^= bit_cast<AK::SIMD::u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), 0x11));
+}
+
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE static AK::SIMD::u64x2 ghash_reduce(AK::SIMD::u64x2 low, AK::SIMD::u64x2 middle, AK::SIMD::u64x2 high)
+{
+    AK::SIMD::u64x2 const zero {};
+
+    low ^= __builtin_shufflevector(middle, zero, 2, 0);
+    high ^= __builtin_shufflevector(middle, zero, 1, 2);
+
+    // Shift the 256-bit product left by one.
+    high = (high << 1) | __builtin_shufflevector(high >> 63, low >> 63, 3, 0);
+    low = (low << 1) | __builtin_shufflevector(low >> 63, zero, 2, 0);
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    auto folded = (low << 63) ^ (low << 62) ^ (low << 57);
+    low ^= __builtin_shufflevector(folded, zero, 2, 0);
+    folded = (low << 63) ^ (low << 62) ^ (low << 57);
+    auto result = (low >> 1) ^ (low >> 2) ^ (low >> 7) ^ __builtin_shufflevector(folded, zero, 1, 2);
+    return result ^ low ^ high;
+}
+
+template<>
+[[gnu::target("pclmul,ssse3")]] void GHash::transform_blocks_impl<CPUFeatures::X86_PCLMUL>(ReadonlyBytes blocks)
+{
+    AK::SIMD::u64x2 key_powers[AggregatedBlocks];
+    for (size_t i = 0; i < AggregatedBlocks; ++i)
+        key_powers[i] = ghash_load_words(m_key_powers[i]);
+
+    auto tag = ghash_load_words(m_tag);
+    auto const* data = blocks.data();
+    auto block_count = blocks.size() / 16;
+
+    // Y_(i + n) = (Y_i + X_1) * H^n + X_2 * H^(n - 1) + ... + X_n * H, with a single reduction at the end.
+    for (; block_count >= AggregatedBlocks; block_count -= AggregatedBlocks, data += AggregatedBlocks * 16) {
+        AK::SIMD::u64x2 low {}, middle {}, high {};
+        ghash_multiply_accumulate(low, middle, high, tag ^ ghash_load_block(data), key_powers[AggregatedBlocks - 1]);
+        for (size_t i = 1; i < AggregatedBlocks; ++i)
+            ghash_multiply_accumulate(low, middle, high, ghash_load_block(data + i * 16), key_powers[AggregatedBlocks - 1 - i]);
+        tag = ghash_reduce(low, middle, high);
+    }
+
+    for (; block_count > 0; --block_count, data += 16) {
+        AK::SIMD::u64x2 low {}, middle {}, high {};
+        ghash_multiply_accumulate(low, middle, high, tag ^ ghash_load_block(data), key_powers[0]);
+        tag = ghash_reduce(low, middle, high);
+    }
+
+    ghash_store_words(m_tag, tag);
+}
+#endif
+
+decltype(GHash::transform_blocks_dispatched) GHash::transform_blocks_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_PCLMUL)) {
+        if (has_flag(features, CPUFeatures::X86_PCLMUL))
+            return &GHash::transform_blocks_impl<CPUFeatures::X86_PCLMUL>;
+    }
+
+    return &GHash::transform_blocks_impl<CPUFeatures::None>;
+}();
+
 /// Galois Field multiplication using <x^127 + x^7 + x^2 + x + 1>.
 /// Note that x, y, and z are strictly BE.
 void galois_multiply(u32 (&_z)[4], u32 const (&_x)[4], u32 const (&_y)[4])
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteReader.h>
+#include <AK/CPUFeatures.h>
 #include <AK/Endian.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/HashFunction.h>
@@ -37,13 +38,7 @@ public:
     {
     }
 
-    explicit GHash(ReadonlyBytes key)
-    {
-        VERIFY(key.size() >= 16);
-        for (size_t i = 0; i < 16; i += 4) {
-            m_key[i / 4] = AK::convert_between_host_and_big_endian(ByteReader::load32(key.offset(i)));
-        }
-    }
+    explicit GHash(ReadonlyBytes key);
 
     constexpr static size_t digest_size() { return TagType::Size; }
 
@@ -56,8 +51,29 @@ public:
 
     TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
 
+    // Incremental version of process(): begin(aad), followed by any number of update() calls and a finish().
+    // Every update() except for the last one must be a multiple of the block size.
+    void begin(ReadonlyBytes aad);
+    void update(ReadonlyBytes cipher);
+    TagType finish();
+
 private:
-    u32 m_key[4];
+    // Number of blocks that are multiplied by successive powers of the key before a single reduction.
+    static constexpr size_t AggregatedBlocks = 8;
+
+    void transform(ReadonlyBytes);
+
+    template<CPUFeatures>
+    void transform_blocks_impl(ReadonlyBytes);
+
+    static void (GHash::*const transform_blocks_dispatched)(ReadonlyBytes);
+
+    // m_key_powers[i] is H^(i + 1).
+    u32 m_key_powers[AggregatedBlocks][4];
+    u32 m_tag[4] { 0, 0, 0, 0 };
+    u64 m_aad_size { 0 };
+    u64 m_cipher_size { 0 };
+    bool m_saw_partial_block { false };
 };
 
 }
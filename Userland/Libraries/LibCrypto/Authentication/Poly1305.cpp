@@ -6,10 +6,38 @@
 
 #include <AK/ByteReader.h>
 #include <AK/Endian.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <LibCrypto/Authentication/Poly1305.h>
 
 namespace Crypto::Authentication {
 
+static constexpr u32 limb_mask = 0x3FFFFFF;
+
+// Multiplies h by r modulo 2^130 - 5, with both numbers in radix 2^26.
+static void multiply_modulo_p(u32 (&h)[5], u32 const (&r)[5])
+{
+    u64 s1 = r[1] * 5, s2 = r[2] * 5, s3 = r[3] * 5, s4 = r[4] * 5;
+
+    u64 d0 = (u64)h[0] * r[0] + h[1] * s4 + h[2] * s3 + h[3] * s2 + h[4] * s1;
+    u64 d1 = (u64)h[0] * r[1] + (u64)h[1] * r[0] + h[2] * s4 + h[3] * s3 + h[4] * s2;
+    u64 d2 = (u64)h[0] * r[2] + (u64)h[1] * r[1] + (u64)h[2] * r[0] + h[3] * s4 + h[4] * s3;
+    u64 d3 = (u64)h[0] * r[3] + (u64)h[1] * r[2] + (u64)h[2] * r[1] + (u64)h[3] * r[0] + h[4] * s4;
+    u64 d4 = (u64)h[0] * r[4] + (u64)h[1] * r[3] + (u64)h[2] * r[2] + (u64)h[3] * r[1] + (u64)h[4] * r[0];
+
+    d1 += d0 >> 26;
+    d2 += d1 >> 26;
+    d3 += d2 >> 26;
+    d4 += d3 >> 26;
+    u64 h0 = (d0 & limb_mask) + (d4 >> 26) * 5;
+
+    h[0] = h0 & limb_mask;
+    h[1] = (d1 & limb_mask) + (h0 >> 26);
+    h[2] = d2 & limb_mask;
+    h[3] = d3 & limb_mask;
+    h[4] = d4 & limb_mask;
+}
+
 Poly1305::Poly1305(ReadonlyBytes key)
 {
     for (size_t i = 0; i < 16; i += 4) {
@@ -26,12 +54,30 @@ Poly1305::Poly1305(ReadonlyBytes key)
     for (size_t i = 16; i < 32; i += 4) {
         m_state.s[(i - 16) / 4] = AK::convert_between_host_and_little_endian(ByteReader::load32(key.offset(i)));
     }
+
+    auto& r = m_state.r;
+    m_r_powers[0][0] = r[0] & limb_mask;
+    m_r_powers[0][1] = ((r[0] >> 26) | (r[1] << 6)) & limb_mask;
+    m_r_powers[0][2] = ((r[1] >> 20) | (r[2] << 12)) & limb_mask;
+    m_r_powers[0][3] = ((r[2] >> 14) | (r[3] << 18)) & limb_mask;
+    m_r_powers[0][4] = r[3] >> 8;
+    for (size_t i = 1; i < 4; ++i) {
+        memcpy(m_r_powers[i], m_r_powers[i - 1], sizeof(m_r_powers[i]));
+        multiply_modulo_p(m_r_powers[i], m_r_powers[0]);
+    }
 }
 
 void Poly1305::update(ReadonlyBytes message)
 {
     size_t offset = 0;
     while (offset < message.size()) {
+        // Whole blocks can be processed right from the message.
+        if (m_state.block_count == 0) {
+            offset += (this->*process_blocks_dispatched)(message.offset_pointer(offset), (message.size() - offset) / 16) * 16;
+            if (offset == message.size())
+                break;
+        }
+
         u32 n = min(message.size() - offset, 16 - m_state.block_count);
         memcpy(m_state.blocks + m_state.block_count, message.offset_pointer(offset), n);
         m_state.block_count += n;
@@ -163,6 +209,142 @@ void Poly1305::process_block()
     m_state.a[4] &= 0x00000003;
 }
 
+template<>
+size_t Poly1305::process_blocks_impl<CPUFeatures::None>(u8 const* blocks, size_t block_count)
+{
+    for (size_t i = 0; i < block_count; ++i) {
+        memcpy(m_state.blocks, blocks + i * 16, 16);
+        m_state.block_count = 16;
+        process_block();
+    }
+    m_state.block_count = 0;
+    return block_count;
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+using AK::SIMD::u64x4;
+
+[[gnu::target("avx2")]] ALWAYS_INLINE static u64x4 multiply_low_halves(u64x4 a, u64x4 b)
+{
+    return (u64x4)__builtin_ia32_pmuludq256((AK::SIMD::i32x8)a, (AK::SIMD::i32x8)b);
+}
+
+// Lane-wise h * r modulo 2^130 - 5 in radix 2^26, where s is 5 * r. The result is only partially reduced.
+[[gnu::target("avx2")]] ALWAYS_INLINE static void multiply_modulo_p(u64x4 (&h)[5], u64x4 const (&r)[5], u64x4 const (&s)[5])
+{
+    auto d0 = multiply_low_halves(h[0], r[0]) + multiply_low_halves(h[1], s[4]) + multiply_low_halves(h[2], s[3]) + multiply_low_halves(h[3], s[2]) + multiply_low_halves(h[4], s[1]);
+    auto d1 = multiply_low_halves(h[0], r[1]) + multiply_low_halves(h[1], r[0]) + multiply_low_halves(h[2], s[4]) + multiply_low_halves(h[3], s[3]) + multiply_low_halves(h[4], s[2]);
+    auto d2 = multiply_low_halves(h[0], r[2]) + multiply_low_halves(h[1], r[1]) + multiply_low_halves(h[2], r[0]) + multiply_low_halves(h[3], s[4]) + multiply_low_halves(h[4], s[3]);
+    auto d3 = multiply_low_halves(h[0], r[3]) + multiply_low_halves(h[1], r[2]) + multiply_low_halves(h[2], r[1]) + multiply_low_halves(h[3], r[0]) + multiply_low_halves(h[4], s[4]);
+    auto d4 = multiply_low_halves(h[0], r[4]) + multiply_low_halves(h[1], r[3]) + multiply_low_halves(h[2], r[2]) + multiply_low_halves(h[3], r[1]) + multiply_low_halves(h[4], r[0]);
+
+    d1 += d0 >> 26;
+    d2 += d1 >> 26;
+    d3 += d2 >> 26;
+    d4 += d3 >> 26;
+    auto h0 = (d0 & limb_mask) + (d4 >> 26) * 5;
+
+    h[0] = h0 & limb_mask;
+    h[1] = (d1 & limb_mask) + (h0 >> 26);
+    h[2] = d2 & limb_mask;
+    h[3] = d3 & limb_mask;
+    h[4] = d4 & limb_mask;
+}
+
+// Adds four consecutive blocks (one per lane) to h.
+[[gnu::target("avx2")]] ALWAYS_INLINE static void add_blocks(u64x4 (&h)[5], u8 const* blocks)
+{
+    auto first_half = AK::SIMD::load_unaligned<u64x4>(blocks);
+    auto second_half = AK::SIMD::load_unaligned<u64x4>(blocks + 32);
+    u64x4 low = __builtin_shufflevector(first_half, second_half, 0, 2, 4, 6);
+    u64x4 high = __builtin_shufflevector(first_half, second_half, 1, 3, 5, 7);
+
+    h[0] += low & limb_mask;
+    h[1] += (low >> 26) & limb_mask;
+    h[2] += ((low >> 52) | (high << 12)) & limb_mask;
+    h[3] += (high >> 14) & limb_mask;
+    // Every whole block has 2^128 added to it.
+    h[4] += (high >> 40) | (1 << 24);
+}
+
+template<>
+[[gnu::target("avx2")]] size_t Poly1305::process_blocks_impl<CPUFeatures::X86_AVX2>(u8 const* blocks, size_t block_count)
+{
+    // Below this, converting the accumulator back and forth isn't worth it.
+    if (block_count < 8 || !AK::HostIsLittleEndian)
+        return process_blocks_impl<CPUFeatures::None>(blocks, block_count);
+
+    // Lane i accumulates blocks i, i + 4, i + 8, ..., multiplying by r^4 in between:
+    //   h' = (h + m_0) * r^n + m_1 * r^(n - 1) + ... + m_(n - 1) * r
+    //      = sum over lanes i of (m_i * r^(n - 4) + m_(i + 4) * r^(n - 8) + ... + m_(n - 4 + i)) * r^(4 - i)
+    auto& a = m_state.a;
+    u64x4 h[5] {};
+    h[0][0] = a[0] & limb_mask;
+    h[1][0] = ((a[0] >> 26) | (a[1] << 6)) & limb_mask;
+    h[2][0] = ((a[1] >> 20) | (a[2] << 12)) & limb_mask;
+    h[3][0] = ((a[2] >> 14) | (a[3] << 18)) & limb_mask;
+    h[4][0] = (a[3] >> 8) | (a[4] << 24);
+
+    u64x4 r[5], s[5];
+    for (size_t i = 0; i < 5; ++i) {
+        r[i] = u64x4 {} + m_r_powers[3][i];
+        s[i] = r[i] * 5;
+    }
+
+    auto vector_block_count = block_count - block_count % 4;
+    add_blocks(h, blocks);
+    for (size_t i = 4; i < vector_block_count; i += 4) {
+        multiply_modulo_p(h, r, s);
+        add_blocks(h, blocks + i * 16);
+    }
+
+    for (size_t i = 0; i < 5; ++i) {
+        r[i] = u64x4 { m_r_powers[3][i], m_r_powers[2][i], m_r_powers[1][i], m_r_powers[0][i] };
+        s[i] = r[i] * 5;
+    }
+    multiply_modulo_p(h, r, s);
+
+    u64 sum[5];
+    for (size_t i = 0; i < 5; ++i)
+        sum[i] = h[i][0] + h[i][1] + h[i][2] + h[i][3];
+
+    // Carry twice, so that the result is below 2^130 like the one from process_block().
+    for (size_t pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < 4; ++i) {
+            sum[i + 1] += sum[i] >> 26;
+            sum[i] &= limb_mask;
+        }
+        sum[0] += (sum[4] >> 26) * 5;
+        sum[4] &= limb_mask;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        sum[i + 1] += sum[i] >> 26;
+        sum[i] &= limb_mask;
+    }
+
+    u64 low = sum[0] | (sum[1] << 26) | ((sum[2] & 0xFFF) << 52);
+    u64 high = (sum[2] >> 12) | (sum[3] << 14) | ((sum[4] & 0xFFFFFF) << 40);
+    a[0] = low & 0xFFFFFFFF;
+    a[1] = low >> 32;
+    a[2] = high & 0xFFFFFFFF;
+    a[3] = high >> 32;
+    a[4] = sum[4] >> 24;
+
+    return vector_block_count + process_blocks_impl<CPUFeatures::None>(blocks + vector_block_count * 16, block_count - vector_block_count);
+}
+#endif
+
+decltype(Poly1305::process_blocks_dispatched) Poly1305::process_blocks_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &Poly1305::process_blocks_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &Poly1305::process_blocks_impl<CPUFeatures::None>;
+}();
+
 ErrorOr<ByteBuffer> Poly1305::digest()
 {
     if (m_state.block_count != 0)
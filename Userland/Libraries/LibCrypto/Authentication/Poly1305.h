@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/CPUFeatures.h>
 
 namespace Crypto::Authentication {
 
@@ -28,7 +29,16 @@ public:
 private:
     void process_block();
 
+    // Processes as many of the given whole blocks as possible and returns how many it processed.
+    template<CPUFeatures>
+    size_t process_blocks_impl(u8 const* blocks, size_t block_count);
+
+    static size_t (Poly1305::*const process_blocks_dispatched)(u8 const* blocks, size_t block_count);
+
     State m_state;
+
+    // r, r^2, r^3 and r^4 in radix 2^26, for processing several blocks in parallel.
+    u32 m_r_powers[4][5] {};
 };
 
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/InternetChecksum.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/ChecksumFunction.h>
@@ -24,10 +25,7 @@ public:
     virtual u16 digest() override;
 
 private:
-    // NOTE: This is intentionally 32-bit rather than 16-bit.
-    // When we're in the process of summing up, we need to avoid
-    // overflowing or otherwise losing the carries in the process.
-    u32 m_state { 0 };
+    InternetChecksum m_checksum;
 };
 
 }
@@ -724,6 +724,85 @@ template<>
 }
 #endif
 
+template<>
+void AESCipher::ctr_encrypt_impl<CPUFeatures::None>(ReadonlyBytes in, Bytes out, Bytes counter)
+{
+    VERIFY(in.size() <= out.size());
+    VERIFY(counter.size() == AESCipherBlock::block_size());
+
+    IncrementInplace increment;
+    AESCipherBlock block;
+
+    for (size_t offset = 0; offset < in.size(); offset += AESCipherBlock::block_size()) {
+        block.overwrite(counter);
+        encrypt_block_impl<CPUFeatures::None>(block, block);
+        block.apply_initialization_vector(in.slice(offset));
+
+        auto write_size = min(AESCipherBlock::block_size(), in.size() - offset);
+        __builtin_memcpy(out.offset(offset), block.bytes().data(), write_size);
+
+        increment(counter);
+    }
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AES
+template<>
+[[gnu::target("aes")]] void AESCipher::ctr_encrypt_impl<CPUFeatures::X86_AES>(ReadonlyBytes in, Bytes out, Bytes counter)
+{
+    using illx2 = signed long long int __attribute__((vector_size(16)));
+
+    // AESENC has a latency of several cycles but a throughput of (at least) one per cycle,
+    // so interleaving independent blocks keeps the unit busy.
+    static constexpr size_t blocks_in_parallel = 8;
+    static constexpr size_t block_size = AESCipherBlock::block_size();
+
+    VERIFY(in.size() <= out.size());
+    VERIFY(counter.size() == block_size);
+
+    AESCipherKey const& key = m_key;
+    auto round_keys = key.round_keys();
+    auto n_rounds = static_cast<int>(key.rounds());
+    IncrementInplace increment;
+
+    for (size_t offset = 0; offset < in.size(); offset += blocks_in_parallel * block_size) {
+        auto block_count = min(blocks_in_parallel, ceil_div(in.size() - offset, block_size));
+
+        illx2 values[blocks_in_parallel];
+        for (size_t i = 0; i < blocks_in_parallel; ++i) {
+            values[i] = AK::SIMD::load_unaligned<illx2>(counter.data());
+            if (i < block_count)
+                increment(counter);
+        }
+
+        auto round_key = AK::SIMD::load_unaligned<illx2>(&round_keys[0]);
+        for (auto& value : values)
+            value ^= round_key;
+        for (int i_round = 1; i_round != n_rounds; ++i_round) {
+            round_key = AK::SIMD::load_unaligned<illx2>(&round_keys[i_round * 4]);
+            for (auto& value : values)
+                value = __builtin_ia32_aesenc128(value, round_key);
+        }
+        round_key = AK::SIMD::load_unaligned<illx2>(&round_keys[n_rounds * 4]);
+        for (auto& value : values)
+            value = __builtin_ia32_aesenclast128(value, round_key);
+
+        for (size_t i = 0; i < block_count; ++i) {
+            auto block_offset = offset + i * block_size;
+            if (block_offset + block_size <= in.size()) {
+                auto input = AK::SIMD::load_unaligned<illx2>(in.offset_pointer(block_offset));
+                AK::SIMD::store_unaligned(out.offset_pointer(block_offset), values[i] ^ input);
+                continue;
+            }
+
+            u8 key_stream[block_size];
+            AK::SIMD::store_unaligned(key_stream, values[i]);
+            for (size_t j = block_offset; j < in.size(); ++j)
+                out[j] = in[j] ^ key_stream[j - block_offset];
+        }
+    }
+}
+#endif
+
 decltype(AESCipher::encrypt_block_dispatched) AESCipher::encrypt_block_dispatched = [] {
     CPUFeatures features = detect_cpu_features();
 
@@ -746,6 +825,17 @@ decltype(AESCipher::decrypt_block_dispatched) AESCipher::decrypt_block_dispatche
     return &AESCipher::decrypt_block_impl<CPUFeatures::None>;
 }();
 
+decltype(AESCipher::ctr_encrypt_dispatched) AESCipher::ctr_encrypt_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AES)) {
+        if (has_flag(features, CPUFeatures::X86_AES))
+            return &AESCipher::ctr_encrypt_impl<CPUFeatures::X86_AES>;
+    }
+
+    return &AESCipher::ctr_encrypt_impl<CPUFeatures::None>;
+}();
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
@@ -128,6 +128,10 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override { return (this->*encrypt_block_dispatched)(in, out); }
     virtual void decrypt_block(BlockType const& in, BlockType& out) override { return (this->*decrypt_block_dispatched)(in, out); }
 
+    // Equivalent to CTRMode::encrypt() with `counter` as the IV, except that `counter` is advanced past the blocks used.
+    // This lets us keep several blocks in flight instead of going through encrypt_block() for each of them.
+    void ctr_encrypt(ReadonlyBytes in, Bytes out, Bytes counter) { return (this->*ctr_encrypt_dispatched)(in, out, counter); }
+
 #ifndef KERNEL
     virtual ByteString class_name() const override
     {
@@ -144,8 +148,12 @@ private:
     template<CPUFeatures>
     void decrypt_block_impl(BlockType const& in, BlockType& out);
 
+    template<CPUFeatures>
+    void ctr_encrypt_impl(ReadonlyBytes in, Bytes out, Bytes counter);
+
     static void (AESCipher::*const encrypt_block_dispatched)(BlockType const& in, BlockType& out);
     static void (AESCipher::*const decrypt_block_dispatched)(BlockType const& in, BlockType& out);
+    static void (AESCipher::*const ctr_encrypt_dispatched)(ReadonlyBytes in, Bytes out, Bytes counter);
 };
 
 }
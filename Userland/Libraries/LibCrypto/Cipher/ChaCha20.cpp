@@ -6,6 +6,8 @@
 
 #include <AK/ByteReader.h>
 #include <AK/Endian.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
 
 namespace Crypto::Cipher {
@@ -111,9 +113,153 @@ void ChaCha20::do_quarter_round(u32& a, u32& b, u32& c, u32& d)
     rotl(b, 7);
 }
 
+template<typename VectorType>
+ALWAYS_INLINE static void do_quarter_round(VectorType& a, VectorType& b, VectorType& c, VectorType& d)
+{
+    a += b;
+    d ^= a;
+    d = (d << 16) | (d >> 16);
+
+    c += d;
+    b ^= c;
+    b = (b << 12) | (b >> 20);
+
+    a += b;
+    d ^= a;
+    d = (d << 8) | (d >> 24);
+
+    c += d;
+    b ^= c;
+    b = (b << 7) | (b >> 25);
+}
+
+template<size_t FirstLane, typename VectorType>
+ALWAYS_INLINE static AK::SIMD::u32x4 four_lanes(VectorType const& vector)
+{
+    if constexpr (AK::SIMD::vector_length<VectorType> == 4)
+        return vector;
+    else
+        return __builtin_shufflevector(vector, vector, FirstLane, FirstLane + 1, FirstLane + 2, FirstLane + 3);
+}
+
+// Transposes the words of blocks FirstBlock to FirstBlock + 3 back into block order and XORs them into the output.
+template<size_t FirstBlock, typename VectorType>
+ALWAYS_INLINE static void xor_key_stream_blocks(VectorType const (&x)[16], u8 const* input, u8* output)
+{
+    for (size_t word = 0; word < 16; word += 4) {
+        auto a = four_lanes<FirstBlock>(x[word + 0]);
+        auto b = four_lanes<FirstBlock>(x[word + 1]);
+        auto c = four_lanes<FirstBlock>(x[word + 2]);
+        auto d = four_lanes<FirstBlock>(x[word + 3]);
+
+        auto ab_low = __builtin_shufflevector(a, b, 0, 4, 1, 5);
+        auto ab_high = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+        auto cd_low = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+        auto cd_high = __builtin_shufflevector(c, d, 2, 6, 3, 7);
+
+        AK::SIMD::u32x4 const rows[4] {
+            __builtin_shufflevector(ab_low, cd_low, 0, 1, 4, 5),
+            __builtin_shufflevector(ab_low, cd_low, 2, 3, 6, 7),
+            __builtin_shufflevector(ab_high, cd_high, 0, 1, 4, 5),
+            __builtin_shufflevector(ab_high, cd_high, 2, 3, 6, 7),
+        };
+
+        for (size_t i = 0; i < 4; ++i) {
+            auto offset = (FirstBlock + i) * 64 + word * 4;
+            auto value = AK::SIMD::load_unaligned<AK::SIMD::u32x4>(input + offset) ^ rows[i];
+            AK::SIMD::store_unaligned(output + offset, value);
+        }
+    }
+}
+
+// Runs one block per vector lane, with the words of all blocks interleaved ("vertical" vectorization).
+template<typename VectorType>
+ALWAYS_INLINE static void run_cipher_on_vector_of_blocks(u32 (&state)[16], u8 const* input, u8* output)
+{
+    constexpr size_t lanes = AK::SIMD::vector_length<VectorType>;
+
+    VectorType initial[16];
+    for (size_t i = 0; i < 16; ++i)
+        initial[i] = VectorType {} + state[i];
+
+    // Every lane gets its own block counter, which carries over into word 13 like in run_cipher().
+    VectorType lane_index;
+    for (size_t i = 0; i < lanes; ++i)
+        lane_index[i] = i;
+    initial[12] += lane_index;
+    initial[13] -= (VectorType)(initial[12] < state[12]);
+
+    VectorType x[16];
+    for (size_t i = 0; i < 16; ++i)
+        x[i] = initial[i];
+
+    for (u32 i = 0; i < 20; i += 2) {
+        // Column rounds
+        do_quarter_round(x[0], x[4], x[8], x[12]);
+        do_quarter_round(x[1], x[5], x[9], x[13]);
+        do_quarter_round(x[2], x[6], x[10], x[14]);
+        do_quarter_round(x[3], x[7], x[11], x[15]);
+
+        // Diagonal rounds
+        do_quarter_round(x[0], x[5], x[10], x[15]);
+        do_quarter_round(x[1], x[6], x[11], x[12]);
+        do_quarter_round(x[2], x[7], x[8], x[13]);
+        do_quarter_round(x[3], x[4], x[9], x[14]);
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+        x[i] += initial[i];
+
+    xor_key_stream_blocks<0>(x, input, output);
+    if constexpr (lanes == 8)
+        xor_key_stream_blocks<4>(x, input, output);
+
+    auto counter = state[12];
+    state[12] += lanes;
+    if (state[12] < counter)
+        state[13]++;
+}
+
+template<>
+size_t ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::None>(u8 const* input, u8* output, size_t block_count)
+{
+    // The key stream is serialized by storing the words as they are.
+    if constexpr (!AK::HostIsLittleEndian)
+        return 0;
+
+    size_t processed = 0;
+    for (; block_count - processed >= 4; processed += 4)
+        run_cipher_on_vector_of_blocks<AK::SIMD::u32x4>(m_state, input + processed * 64, output + processed * 64);
+    return processed;
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] size_t ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::X86_AVX2>(u8 const* input, u8* output, size_t block_count)
+{
+    size_t processed = 0;
+    for (; block_count - processed >= 8; processed += 8)
+        run_cipher_on_vector_of_blocks<AK::SIMD::u32x8>(m_state, input + processed * 64, output + processed * 64);
+    for (; block_count - processed >= 4; processed += 4)
+        run_cipher_on_vector_of_blocks<AK::SIMD::u32x4>(m_state, input + processed * 64, output + processed * 64);
+    return processed;
+}
+#endif
+
+decltype(ChaCha20::run_cipher_on_blocks_dispatched) ChaCha20::run_cipher_on_blocks_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::None>;
+}();
+
 void ChaCha20::run_cipher(ReadonlyBytes input, Bytes& output)
 {
-    size_t offset = 0;
+    size_t offset = (this->*run_cipher_on_blocks_dispatched)(input.data(), output.data(), input.size() / 64) * 64;
     size_t block_offset = 0;
     while (offset < input.size()) {
         if (block_offset == 0 || block_offset >= 64) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/CPUFeatures.h>
 
 namespace Crypto::Cipher {
 
@@ -26,6 +27,12 @@ private:
     void run_cipher(ReadonlyBytes input, Bytes& output);
     ALWAYS_INLINE void do_quarter_round(u32& a, u32& b, u32& c, u32& d);
 
+    // Encrypts as many of the given whole blocks as possible several blocks at a time, and returns how many it processed.
+    template<CPUFeatures>
+    size_t run_cipher_on_blocks_impl(u8 const* input, u8* output, size_t block_count);
+
+    static size_t (ChaCha20::*const run_cipher_on_blocks_dispatched)(u8 const* input, u8* output, size_t block_count);
+
     u32 m_state[16] {};
     u32 m_block[16] {};
 };
@@ -95,12 +95,19 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        if (in.is_empty())
+        Authentication::GHashDigest auth_tag;
+        if (in.is_empty()) {
             CTR<T>::key_stream(out, iv);
-        else
+            auth_tag = m_ghash->process(aad, out);
+        } else if (in.size() == out.size()) {
+            m_ghash->begin(aad);
+            crypt_and_authenticate(in, out, iv, AuthenticatedText::Output);
+            auth_tag = m_ghash->finish();
+        } else {
             CTR<T>::encrypt(in, out, iv);
+            auth_tag = m_ghash->process(aad, out);
+        }
 
-        auto auth_tag = m_ghash->process(aad, out);
         block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
         block0.bytes().copy_to(tag);
     }
@@ -123,26 +130,55 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        auto auth_tag = m_ghash->process(aad, in);
-        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
-
-        auto test_consistency = [&] {
-            if (block0.block_size() != tag.size() || !timing_safe_compare(block0.bytes().data(), tag.data(), tag.size()))
-                return VerificationConsistency::Inconsistent;
-
-            return VerificationConsistency::Consistent;
-        };
-
+        Authentication::GHashDigest auth_tag;
         if (in.is_empty()) {
             out = {};
-            return test_consistency();
+            auth_tag = m_ghash->process(aad, in);
+        } else {
+            m_ghash->begin(aad);
+            crypt_and_authenticate(in, out, iv, AuthenticatedText::Input);
+            auth_tag = m_ghash->finish();
         }
 
-        CTR<T>::encrypt(in, out, iv);
-        return test_consistency();
+        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
+        if (block0.block_size() != tag.size() || !timing_safe_compare(block0.bytes().data(), tag.data(), tag.size()))
+            return VerificationConsistency::Inconsistent;
+
+        return VerificationConsistency::Consistent;
     }
 
 private:
+    enum class AuthenticatedText {
+        Input,
+        Output,
+    };
+
+    // Runs CTR and GHASH over the data in chunks, so each chunk gets authenticated while it's still in the cache.
+    void crypt_and_authenticate(ReadonlyBytes in, Bytes out, Bytes iv, AuthenticatedText authenticated_text)
+    {
+        auto counter = iv.trim(IVSizeInBits / 8);
+
+        for (size_t offset = 0; offset < in.size(); offset += interleave_chunk_size) {
+            auto chunk_size = min(interleave_chunk_size, in.size() - offset);
+            auto in_chunk = in.slice(offset, chunk_size);
+            auto out_chunk = out.slice(offset, chunk_size);
+
+            if (authenticated_text == AuthenticatedText::Input)
+                m_ghash->update(in_chunk);
+
+            if constexpr (requires { this->cipher().ctr_encrypt(in_chunk, out_chunk, counter); })
+                this->cipher().ctr_encrypt(in_chunk, out_chunk, counter);
+            else
+                CTR<T>::encrypt(in_chunk, out_chunk, counter, &counter);
+
+            if (authenticated_text == AuthenticatedText::Output)
+                m_ghash->update(out_chunk);
+        }
+    }
+
+    // Small enough for a chunk of plaintext and ciphertext to stay in L1, and a multiple of GHASH's aggregation width.
+    static constexpr size_t interleave_chunk_size = 1 * KiB;
+
     static constexpr auto block_size = T::BlockType::BlockSizeInBits / 8;
     u8 m_auth_key_storage[block_size];
     Bytes m_auth_key { m_auth_key_storage, block_size };
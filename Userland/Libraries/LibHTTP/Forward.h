@@ -8,6 +8,8 @@
 
 namespace HTTP {
 
+class Http2Connection;
+class Http2Stream;
 class HttpRequest;
 class HttpResponse;
 class HttpsJob;
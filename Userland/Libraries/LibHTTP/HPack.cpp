@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/NumericLimits.h>
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/HPackTables.h>
+
+namespace HTTP::HPack {
+
+namespace {
+
+// The Huffman code is canonical, so a symbol can be decoded by comparing the leading bits of the input
+// against the range of codes of each length in turn, shortest first.
+struct HuffmanDecodeTable {
+    static constexpr size_t max_bit_length = 30;
+
+    Array<u32, max_bit_length + 1> first_code {};
+    Array<u32, max_bit_length + 1> code_count {};
+    Array<u16, max_bit_length + 1> first_symbol_index {};
+    Array<u16, 257> symbols_by_code {};
+};
+
+constexpr HuffmanDecodeTable huffman_decode_table = [] {
+    HuffmanDecodeTable table;
+    u16 index = 0;
+    for (size_t length = 1; length <= HuffmanDecodeTable::max_bit_length; ++length) {
+        table.first_symbol_index[length] = index;
+        for (u16 symbol = 0; symbol < 257; ++symbol) {
+            if (huffman_codes[symbol].bit_length != length)
+                continue;
+            if (table.code_count[length] == 0)
+                table.first_code[length] = huffman_codes[symbol].code;
+            ++table.code_count[length];
+            table.symbols_by_code[index++] = symbol;
+        }
+    }
+    return table;
+}();
+
+constexpr size_t shortest_huffman_code_length = 5;
+
+// RFC 7541 section 5.1: Integer Representation
+ErrorOr<u32> decode_integer(ReadonlyBytes data, size_t& offset, u8 prefix_bits)
+{
+    VERIFY(offset < data.size());
+    u32 const max_prefix_value = (1u << prefix_bits) - 1;
+
+    u64 value = data[offset++] & max_prefix_value;
+    if (value < max_prefix_value)
+        return value;
+
+    for (size_t shift = 0;; shift += 7) {
+        if (offset >= data.size())
+            return Error::from_string_literal("HPACK: Truncated integer");
+        if (shift > 28)
+            return Error::from_string_literal("HPACK: Integer is too large");
+
+        u8 byte = data[offset++];
+        value += static_cast<u64>(byte & 0x7f) << shift;
+        if (value > NumericLimits<u32>::max())
+            return Error::from_string_literal("HPACK: Integer is too large");
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+}
+
+ErrorOr<void> encode_integer(ByteBuffer& output, u8 flags, u8 prefix_bits, size_t value)
+{
+    size_t const max_prefix_value = (1u << prefix_bits) - 1;
+    if (value < max_prefix_value)
+        return output.try_append(flags | value);
+
+    TRY(output.try_append(flags | max_prefix_value));
+    value -= max_prefix_value;
+    while (value >= 0x80) {
+        TRY(output.try_append((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    return output.try_append(value);
+}
+
+// RFC 7541 section 5.2: String Literal Representation
+ErrorOr<ByteString> decode_string(ReadonlyBytes data, size_t& offset)
+{
+    if (offset >= data.size())
+        return Error::from_string_literal("HPACK: Truncated string literal");
+
+    bool is_huffman_encoded = data[offset] & 0x80;
+    auto length = TRY(decode_integer(data, offset, 7));
+    if (length > data.size() - offset)
+        return Error::from_string_literal("HPACK: Truncated string literal");
+
+    auto bytes = data.slice(offset, length);
+    offset += length;
+
+    if (is_huffman_encoded)
+        return ByteString { TRY(huffman_decode(bytes)).bytes() };
+    return ByteString { bytes };
+}
+
+ErrorOr<void> encode_string(ByteBuffer& output, StringView string)
+{
+    auto huffman_length = huffman_encoded_length(string.bytes());
+    if (huffman_length < string.length()) {
+        TRY(encode_integer(output, 0x80, 7, huffman_length));
+        return huffman_encode(string.bytes(), output);
+    }
+
+    TRY(encode_integer(output, 0x00, 7, string.length()));
+    return output.try_append(string.bytes());
+}
+
+size_t entry_size(Header const& header)
+{
+    return header.name.length() + header.value.length() + entry_size_overhead;
+}
+
+}
+
+ErrorOr<ByteBuffer> huffman_decode(ReadonlyBytes input)
+{
+    ByteBuffer output;
+    TRY(output.try_ensure_capacity(input.size() * 8 / shortest_huffman_code_length));
+
+    u64 bits = 0;
+    size_t bit_count = 0;
+    size_t input_offset = 0;
+
+    while (true) {
+        while (bit_count <= 56 && input_offset < input.size()) {
+            bits = (bits << 8) | input[input_offset++];
+            bit_count += 8;
+        }
+        if (bit_count == 0)
+            break;
+
+        Optional<u16> symbol;
+        size_t length = shortest_huffman_code_length;
+        for (; length <= min(bit_count, HuffmanDecodeTable::max_bit_length); ++length) {
+            u32 code = (bits >> (bit_count - length)) & ((1u << length) - 1);
+            u32 offset_in_length = code - huffman_decode_table.first_code[length];
+            if (code >= huffman_decode_table.first_code[length] && offset_in_length < huffman_decode_table.code_count[length]) {
+                symbol = huffman_decode_table.symbols_by_code[huffman_decode_table.first_symbol_index[length] + offset_in_length];
+                break;
+            }
+        }
+
+        if (!symbol.has_value()) {
+            // RFC 7541 section 5.2: "A padding strictly longer than 7 bits MUST be treated as a decoding error.
+            //                        A padding not corresponding to the most significant bits of the code for the
+            //                        EOS symbol MUST be treated as a decoding error."
+            if (bit_count > 7)
+                return Error::from_string_literal("HPACK: Invalid Huffman padding");
+            u64 padding_mask = (1ull << bit_count) - 1;
+            if ((bits & padding_mask) != padding_mask)
+                return Error::from_string_literal("HPACK: Invalid Huffman padding");
+            break;
+        }
+
+        // "A Huffman-encoded string literal containing the EOS symbol MUST be treated as a decoding error."
+        if (*symbol == huffman_end_of_string_symbol)
+            return Error::from_string_literal("HPACK: EOS symbol in Huffman-encoded string");
+
+        output.append(static_cast<u8>(*symbol));
+        bit_count -= length;
+    }
+
+    return output;
+}
+
+size_t huffman_encoded_length(ReadonlyBytes input)
+{
+    size_t bit_count = 0;
+    for (auto byte : input)
+        bit_count += huffman_codes[byte].bit_length;
+    return (bit_count + 7) / 8;
+}
+
+ErrorOr<void> huffman_encode(ReadonlyBytes input, ByteBuffer& output)
+{
+    TRY(output.try_ensure_capacity(output.size() + huffman_encoded_length(input)));
+
+    u64 bits = 0;
+    size_t bit_count = 0;
+    for (auto byte : input) {
+        auto [code, length] = huffman_codes[byte];
+        bits = (bits << length) | code;
+        bit_count += length;
+        while (bit_count >= 8) {
+            bit_count -= 8;
+            output.append(static_cast<u8>(bits >> bit_count));
+        }
+    }
+
+    // Pad with the most significant bits of EOS, which are all ones.
+    if (bit_count > 0)
+        output.append(static_cast<u8>((bits << (8 - bit_count)) | (0xff >> bit_count)));
+
+    return {};
+}
+
+void DynamicTable::set_max_size(size_t max_size)
+{
+    m_max_size = max_size;
+    evict_until_size_is_at_most(m_max_size);
+}
+
+ErrorOr<void> DynamicTable::insert(Header header)
+{
+    // RFC 7541 section 4.4: "It is not an error to attempt to add an entry that is larger than the maximum size;
+    //                        an attempt to add an entry larger than the maximum size causes the table to be
+    //                        emptied of all existing entries and results in an empty table."
+    auto size = entry_size(header);
+    if (size > m_max_size) {
+        evict_until_size_is_at_most(0);
+        return {};
+    }
+
+    evict_until_size_is_at_most(m_max_size - size);
+    TRY(m_entries.try_append(move(header)));
+    m_size += size;
+    return {};
+}
+
+void DynamicTable::evict_until_size_is_at_most(size_t size)
+{
+    size_t evicted_count = 0;
+    while (m_size > size) {
+        m_size -= entry_size(m_entries[evicted_count]);
+        ++evicted_count;
+    }
+    m_entries.remove(0, evicted_count);
+}
+
+ErrorOr<Header> Decoder::header_at(u32 index) const
+{
+    // RFC 7541 section 2.3.3: Index Address Space
+    if (index == 0)
+        return Error::from_string_literal("HPACK: Index 0 is not valid");
+
+    if (index <= array_size(static_table)) {
+        auto const& entry = static_table[index - 1];
+        return Header { entry.name, entry.value };
+    }
+
+    index -= array_size(static_table) + 1;
+    if (index >= m_table.entry_count())
+        return Error::from_string_literal("HPACK: Index is out of range");
+    return m_table.at(index);
+}
+
+ErrorOr<Header> Decoder::decode_literal(ReadonlyBytes header_block, size_t& offset, u8 prefix_bits) const
+{
+    auto name_index = TRY(decode_integer(header_block, offset, prefix_bits));
+
+    ByteString name;
+    if (name_index == 0)
+        name = TRY(decode_string(header_block, offset));
+    else
+        name = TRY(header_at(name_index)).name;
+
+    auto value = TRY(decode_string(header_block, offset));
+    return Header { move(name), move(value) };
+}
+
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes header_block)
+{
+    Vector<Header> headers;
+    size_t header_list_size = 0;
+    bool may_update_table_size = true;
+
+    size_t offset = 0;
+    while (offset < header_block.size()) {
+        u8 representation = header_block[offset];
+
+        Header header;
+        if (representation & 0x80) {
+            // RFC 7541 section 6.1: Indexed Header Field Representation
+            header = TRY(header_at(TRY(decode_integer(header_block, offset, 7))));
+        } else if (representation & 0x40) {
+            // RFC 7541 section 6.2.1: Literal Header Field with Incremental Indexing
+            header = TRY(decode_literal(header_block, offset, 6));
+            TRY(m_table.insert(header));
+        } else if (representation & 0x20) {
+            // RFC 7541 section 6.3: Dynamic Table Size Update
+            // "This dynamic table size update MUST occur at the beginning of the first header block following the
+            //  change to the dynamic table size."
+            if (!may_update_table_size)
+                return Error::from_string_literal("HPACK: Dynamic table size update after the start of a header block");
+            auto max_size = TRY(decode_integer(header_block, offset, 5));
+            if (max_size > m_max_table_size)
+                return Error::from_string_literal("HPACK: Dynamic table size update exceeds the limit");
+            m_table.set_max_size(max_size);
+            continue;
+        } else {
+            // RFC 7541 section 6.2.2: Literal Header Field without Indexing
+            // RFC 7541 section 6.2.3: Literal Header Field Never Indexed
+            header = TRY(decode_literal(header_block, offset, 4));
+        }
+        may_update_table_size = false;
+
+        // Guard against small blocks that expand into huge header lists through repeated references to the tables.
+        header_list_size += entry_size(header);
+        if (header_list_size > m_max_header_list_size)
+            return Error::from_string_literal("HPACK: Header list is too large");
+
+        TRY(headers.try_append(move(header)));
+    }
+
+    return headers;
+}
+
+void Encoder::set_max_table_size_limit(size_t limit)
+{
+    auto max_size = min(limit, default_max_table_size);
+    if (!m_pending_max_table_size.has_value() && max_size == m_table.max_size())
+        return;
+
+    m_pending_max_table_size = max_size;
+    m_smallest_pending_max_table_size = min(m_smallest_pending_max_table_size.value_or(max_size), max_size);
+}
+
+Encoder::Indexing Encoder::indexing_for(Header const& header) const
+{
+    // RFC 7541 section 7.1.3: Credentials and short cookies could be recovered by probing the compression state,
+    //                         so they are never indexed.
+    if (header.name == "authorization"sv || header.name == "proxy-authorization"sv)
+        return Indexing::Never;
+    if (header.name == "cookie"sv && header.value.length() < 20)
+        return Indexing::Never;
+
+    // These are almost always unique to a request, so indexing them would only evict entries that would have been reused.
+    if (header.name == ":path"sv || header.name == "content-length"sv)
+        return Indexing::None;
+    if (entry_size(header) > m_table.max_size() / 2)
+        return Indexing::None;
+
+    return Indexing::Incremental;
+}
+
+ErrorOr<void> Encoder::encode_header(ByteBuffer& output, Header const& header)
+{
+    auto indexing = indexing_for(header);
+
+    Optional<size_t> name_index;
+    for (size_t i = 0; i < array_size(static_table); ++i) {
+        if (static_table[i].name != header.name)
+            continue;
+        if (static_table[i].value == header.value && indexing != Indexing::Never) {
+            // RFC 7541 section 6.1: Indexed Header Field Representation
+            return encode_integer(output, 0x80, 7, i + 1);
+        }
+        if (!name_index.has_value())
+            name_index = i + 1;
+    }
+
+    for (size_t i = 0; i < m_table.entry_count(); ++i) {
+        auto const& entry = m_table.at(i);
+        if (entry.name != header.name)
+            continue;
+        if (entry.value == header.value && indexing != Indexing::Never)
+            return encode_integer(output, 0x80, 7, array_size(static_table) + i + 1);
+        if (!name_index.has_value())
+            name_index = array_size(static_table) + i + 1;
+    }
+
+    switch (indexing) {
+    case Indexing::Incremental:
+        // RFC 7541 section 6.2.1: Literal Header Field with Incremental Indexing
+        TRY(encode_integer(output, 0x40, 6, name_index.value_or(0)));
+        break;
+    case Indexing::None:
+        // RFC 7541 section 6.2.2: Literal Header Field without Indexing
+        TRY(encode_integer(output, 0x00, 4, name_index.value_or(0)));
+        break;
+    case Indexing::Never:
+        // RFC 7541 section 6.2.3: Literal Header Field Never Indexed
+        TRY(encode_integer(output, 0x10, 4, name_index.value_or(0)));
+        break;
+    }
+
+    if (!name_index.has_value())
+        TRY(encode_string(output, header.name));
+    TRY(encode_string(output, header.value));
+
+    if (indexing == Indexing::Incremental)
+        TRY(m_table.insert(header));
+    return {};
+}
+
+ErrorOr<ByteBuffer> Encoder::encode(ReadonlySpan<Header> headers)
+{
+    ByteBuffer output;
+
+    if (m_pending_max_table_size.has_value()) {
+        // RFC 7541 section 4.2: "If the maximum size is reduced and then increased between two header blocks,
+        //                        the encoder MUST signal the smallest value, followed by the final value."
+        if (*m_smallest_pending_max_table_size < *m_pending_max_table_size) {
+            m_table.set_max_size(*m_smallest_pending_max_table_size);
+            TRY(encode_integer(output, 0x20, 5, *m_smallest_pending_max_table_size));
+        }
+        m_table.set_max_size(*m_pending_max_table_size);
+        TRY(encode_integer(output, 0x20, 5, *m_pending_max_table_size));
+
+        m_pending_max_table_size.clear();
+        m_smallest_pending_max_table_size.clear();
+    }
+
+    for (auto const& header : headers)
+        TRY(encode_header(output, header));
+
+    return output;
+}
+
+}
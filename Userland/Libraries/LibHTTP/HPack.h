@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibHTTP/Header.h>
+
+// HPACK: Header Compression for HTTP/2 (RFC 7541)
+namespace HTTP::HPack {
+
+// RFC 7541 section 4.1: "The size of an entry is the sum of its name's length in octets, its value's length in octets, and 32."
+constexpr size_t entry_size_overhead = 32;
+
+// RFC 9113 section 6.5.2: The initial value of SETTINGS_HEADER_TABLE_SIZE.
+constexpr size_t default_max_table_size = 4096;
+
+ErrorOr<ByteBuffer> huffman_decode(ReadonlyBytes);
+ErrorOr<void> huffman_encode(ReadonlyBytes, ByteBuffer&);
+size_t huffman_encoded_length(ReadonlyBytes);
+
+// RFC 7541 section 2.3.2: Dynamic Table
+class DynamicTable {
+public:
+    explicit DynamicTable(size_t max_size)
+        : m_max_size(max_size)
+    {
+    }
+
+    size_t size() const { return m_size; }
+    size_t max_size() const { return m_max_size; }
+    size_t entry_count() const { return m_entries.size(); }
+
+    // Index 0 is the most recently inserted entry.
+    Header const& at(size_t index) const { return m_entries[m_entries.size() - index - 1]; }
+
+    void set_max_size(size_t);
+    ErrorOr<void> insert(Header);
+
+private:
+    void evict_until_size_is_at_most(size_t);
+
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_max_size { 0 };
+};
+
+class Decoder {
+public:
+    explicit Decoder(size_t max_header_list_size, size_t max_table_size = default_max_table_size)
+        : m_table(max_table_size)
+        , m_max_table_size(max_table_size)
+        , m_max_header_list_size(max_header_list_size)
+    {
+    }
+
+    // Decodes one complete header block. Errors are fatal for the whole connection, as the
+    // dynamic table is then out of sync with the peer (RFC 9113 section 4.3).
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes header_block);
+
+private:
+    ErrorOr<Header> header_at(u32 index) const;
+    ErrorOr<Header> decode_literal(ReadonlyBytes header_block, size_t& offset, u8 prefix_bits) const;
+
+    DynamicTable m_table;
+    size_t m_max_table_size { 0 };
+    size_t m_max_header_list_size { 0 };
+};
+
+class Encoder {
+public:
+    // Follows a change of the peer's SETTINGS_HEADER_TABLE_SIZE, announcing it at the start of the next header block.
+    // We never use more than the default size, even if the peer would allow it.
+    void set_max_table_size_limit(size_t);
+
+    // Header names must already be lowercase, as required by RFC 9113 section 8.2.1.
+    ErrorOr<ByteBuffer> encode(ReadonlySpan<Header>);
+
+private:
+    enum class Indexing {
+        Incremental,
+        None,
+        Never,
+    };
+
+    ErrorOr<void> encode_header(ByteBuffer&, Header const&);
+    Indexing indexing_for(Header const&) const;
+
+    DynamicTable m_table { default_max_table_size };
+    Optional<size_t> m_pending_max_table_size;
+    Optional<size_t> m_smallest_pending_max_table_size;
+};
+
+}
@@ -0,0 +1,868 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
+#include <LibCore/EventLoop.h>
+#include <LibHTTP/Http2Connection.h>
+#include <errno.h>
+
+namespace HTTP {
+
+StringView to_string_view(Http2ErrorCode code)
+{
+    switch (code) {
+#define ENUMERATE_ERROR_CODE(name, value) \
+    case Http2ErrorCode::name:            \
+        return #name##sv;
+        ENUMERATE_HTTP2_ERROR_CODES(ENUMERATE_ERROR_CODE)
+#undef ENUMERATE_ERROR_CODE
+    }
+    return "Unknown"sv;
+}
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return (static_cast<u32>(bytes[0]) << 24) | (static_cast<u32>(bytes[1]) << 16) | (static_cast<u32>(bytes[2]) << 8) | bytes[3];
+}
+
+static void append_u32(ByteBuffer& buffer, u32 value)
+{
+    buffer.append(static_cast<u8>(value >> 24));
+    buffer.append(static_cast<u8>(value >> 16));
+    buffer.append(static_cast<u8>(value >> 8));
+    buffer.append(static_cast<u8>(value));
+}
+
+Http2Stream::Http2Stream(Http2Connection& connection, Vector<Header> request_headers, ByteBuffer request_body)
+    : m_connection(connection)
+    , m_request_headers(move(request_headers))
+    , m_request_body(move(request_body))
+{
+}
+
+void Http2Stream::did_consume(size_t size)
+{
+    size = min(size, m_unconsumed_size);
+    m_unconsumed_size -= size;
+    if (m_connection && size > 0)
+        m_connection->consume(*this, size);
+}
+
+void Http2Stream::cancel()
+{
+    on_headers_received = nullptr;
+    on_trailers_received = nullptr;
+    on_data_received = nullptr;
+    on_finish = nullptr;
+    on_error = nullptr;
+
+    if (!m_connection)
+        return;
+    NonnullRefPtr connection = *m_connection;
+    connection->reset_stream(*this, Http2ErrorCode::Cancel);
+}
+
+ErrorOr<NonnullRefPtr<Http2Connection>> Http2Connection::try_create(NonnullOwnPtr<Core::Socket> socket)
+{
+    auto connection = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Http2Connection(move(socket))));
+
+    // RFC 9113 section 3.4: "[The client connection preface] MUST be followed by a SETTINGS frame."
+    connection->m_output_buffer.append(connection_preface.bytes());
+
+    ByteBuffer settings;
+    auto append_setting = [&](Setting setting, u32 value) {
+        settings.append(static_cast<u8>(to_underlying(setting) >> 8));
+        settings.append(static_cast<u8>(to_underlying(setting)));
+        append_u32(settings, value);
+    };
+    append_setting(Setting::EnablePush, 0);
+    append_setting(Setting::InitialWindowSize, stream_receive_window_size);
+    append_setting(Setting::MaxHeaderListSize, max_header_list_size);
+    connection->queue_frame(FrameType::Settings, 0, 0, settings);
+
+    // The connection window can only be changed with WINDOW_UPDATE, not through SETTINGS.
+    connection->queue_window_update(0, connection_receive_window_size - default_initial_window_size);
+
+    connection->m_socket->on_ready_to_read = [&connection = *connection] {
+        connection.read_from_socket();
+    };
+
+    // The server may have sent its SETTINGS along with the end of the TLS handshake, before we were listening.
+    Core::deferred_invoke([connection] {
+        connection->read_from_socket();
+    });
+
+    return connection;
+}
+
+Http2Connection::Http2Connection(NonnullOwnPtr<Core::Socket> socket)
+    : m_socket(move(socket))
+{
+}
+
+Http2Connection::~Http2Connection()
+{
+    m_socket->on_ready_to_read = nullptr;
+}
+
+bool Http2Connection::is_usable() const
+{
+    return !m_is_closed && !m_last_stream_id_processed_by_server.has_value() && m_next_stream_id <= max_stream_id;
+}
+
+NonnullRefPtr<Http2Stream> Http2Connection::open_stream(Vector<Header> request_headers, ByteBuffer request_body)
+{
+    VERIFY(is_usable());
+
+    auto stream = adopt_ref(*new Http2Stream(*this, move(request_headers), move(request_body)));
+    m_pending_streams.append(stream);
+    start_pending_streams();
+    return stream;
+}
+
+void Http2Connection::close()
+{
+    if (m_is_closed)
+        return;
+
+    // RFC 9113 section 6.8: "The last stream identifier in the GOAWAY frame contains the highest-numbered stream
+    // identifier for which the sender of the GOAWAY frame might have taken some action on". We never accept any.
+    ByteBuffer payload;
+    append_u32(payload, 0);
+    append_u32(payload, to_underlying(Http2ErrorCode::NoError));
+    queue_frame(FrameType::GoAway, 0, 0, payload);
+    flush();
+
+    tear_down(Http2ErrorCode::Cancel);
+}
+
+void Http2Connection::read_from_socket()
+{
+    if (m_is_closed)
+        return;
+
+    NonnullRefPtr protector(*this);
+
+    while (true) {
+        u8 buffer[16 * KiB];
+        auto result = m_socket->read_some({ buffer, sizeof(buffer) });
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EAGAIN)
+                break;
+            dbgln("Http2Connection: Failed to read from the socket: {}", result.error());
+            tear_down(Http2ErrorCode::ConnectError);
+            return;
+        }
+        if (result.value().is_empty())
+            break;
+        m_input_buffer.append(result.value());
+    }
+
+    while (!m_is_closed && m_input_buffer.data().size() >= frame_header_size) {
+        auto data = m_input_buffer.data();
+
+        // RFC 9113 section 4.1: Frame Format
+        FrameHeader header {
+            .length = (static_cast<u32>(data[0]) << 16) | (static_cast<u32>(data[1]) << 8) | data[2],
+            .type = static_cast<FrameType>(data[3]),
+            .flags = data[4],
+            .stream_id = read_u32(data.slice(5)) & max_stream_id,
+        };
+
+        // We never announce a larger SETTINGS_MAX_FRAME_SIZE than the default.
+        if (header.length > default_max_frame_size) {
+            fail_connection({ Http2ErrorCode::FrameSizeError, "Frame exceeds the maximum frame size"sv });
+            return;
+        }
+        if (data.size() < frame_header_size + header.length)
+            break;
+
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Received frame type={} flags={:#x} stream={} length={}", to_underlying(header.type), header.flags, header.stream_id, header.length);
+
+        auto result = process_frame(header, data.slice(frame_header_size, header.length));
+        m_input_buffer.dequeue(frame_header_size + header.length);
+        if (result.is_error()) {
+            fail_connection(result.release_error());
+            return;
+        }
+    }
+
+    if (!m_is_closed && m_socket->is_eof()) {
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Server closed the connection");
+        tear_down(Http2ErrorCode::ConnectError);
+    }
+}
+
+Http2Connection::ProcessResult Http2Connection::process_frame(FrameHeader const& header, ReadonlyBytes payload)
+{
+    // RFC 9113 section 6.10: "A receiver MUST treat the receipt of any other type of frame or a frame on a different
+    // stream as a connection error of type PROTOCOL_ERROR."
+    if (m_incomplete_header_block.stream_id != 0 && (header.type != FrameType::Continuation || header.stream_id != m_incomplete_header_block.stream_id))
+        return ConnectionError { Http2ErrorCode::ProtocolError, "Expected a CONTINUATION frame"sv };
+
+    switch (header.type) {
+    case FrameType::Data:
+        return process_data(header, payload);
+    case FrameType::Headers:
+        return process_headers(header, payload);
+    case FrameType::Priority:
+        // The priority signaling scheme from RFC 7540 is deprecated, and we wouldn't act on it anyway.
+        if (header.stream_id == 0)
+            return ConnectionError { Http2ErrorCode::ProtocolError, "PRIORITY frame on stream 0"sv };
+        return {};
+    case FrameType::ResetStream:
+        return process_reset_stream(header, payload);
+    case FrameType::Settings:
+        return process_settings(header, payload);
+    case FrameType::PushPromise:
+        return ConnectionError { Http2ErrorCode::ProtocolError, "PUSH_PROMISE received with server push disabled"sv };
+    case FrameType::Ping:
+        return process_ping(header, payload);
+    case FrameType::GoAway:
+        return process_go_away(header, payload);
+    case FrameType::WindowUpdate:
+        return process_window_update(header, payload);
+    case FrameType::Continuation:
+        return process_continuation(header, payload);
+    }
+
+    // RFC 9113 section 5.5: "Implementations MUST ignore and discard frames of unknown types."
+    return {};
+}
+
+ErrorOr<ReadonlyBytes, Http2Connection::ConnectionError> Http2Connection::strip_padding(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (!(header.flags & FrameFlags::Padded))
+        return payload;
+
+    if (payload.is_empty())
+        return ConnectionError { Http2ErrorCode::FrameSizeError, "Padded frame without a padding length"sv };
+
+    // RFC 9113 section 6.1: "If the length of the padding is the length of the frame payload or greater,
+    // the recipient MUST treat this as a connection error of type PROTOCOL_ERROR."
+    size_t padding_length = payload[0];
+    if (padding_length >= payload.size())
+        return ConnectionError { Http2ErrorCode::ProtocolError, "Padding exceeds the frame payload"sv };
+
+    return payload.slice(1, payload.size() - 1 - padding_length);
+}
+
+Http2Connection::ProcessResult Http2Connection::process_data(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id == 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "DATA frame on stream 0"sv };
+    if (is_idle_stream_id(header.stream_id))
+        return ConnectionError { Http2ErrorCode::ProtocolError, "DATA frame on an idle stream"sv };
+
+    // RFC 9113 section 6.9.1: "The entire DATA frame payload is included in flow control, including the Pad Length
+    // and Padding fields if present."
+    if (header.length > m_connection_receive_window)
+        return ConnectionError { Http2ErrorCode::FlowControlError, "DATA frame exceeds the connection window"sv };
+    m_connection_receive_window -= header.length;
+
+    auto data = TRY(strip_padding(header, payload));
+
+    auto stream = find_stream(header.stream_id);
+    if (!stream) {
+        // Most likely a stream we reset ourselves, with frames that were already in flight.
+        acknowledge_connection_data(header.length);
+        return {};
+    }
+
+    if (header.length > stream->m_receive_window) {
+        acknowledge_connection_data(header.length);
+        stream_error(*stream, Http2ErrorCode::FlowControlError);
+        return {};
+    }
+    stream->m_receive_window -= header.length;
+
+    if (!stream->m_has_received_response) {
+        acknowledge_connection_data(header.length);
+        stream_error(*stream, Http2ErrorCode::ProtocolError);
+        return {};
+    }
+
+    // Padding is never handed out, so it is consumed right away.
+    if (auto padding_length = header.length - data.size(); padding_length > 0)
+        consume(*stream, padding_length);
+
+    if (!data.is_empty()) {
+        stream->m_unconsumed_size += data.size();
+        if (stream->on_data_received)
+            stream->on_data_received(data);
+    }
+
+    if ((header.flags & FrameFlags::EndStream) && stream->can_receive())
+        finish_stream(*stream);
+
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_headers(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id == 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "HEADERS frame on stream 0"sv };
+    // Even-numbered streams are server-initiated, which requires server push.
+    if (header.stream_id % 2 == 0 || is_idle_stream_id(header.stream_id))
+        return ConnectionError { Http2ErrorCode::ProtocolError, "HEADERS frame on an idle stream"sv };
+
+    auto fragment = TRY(strip_padding(header, payload));
+    if (header.flags & FrameFlags::Priority) {
+        if (fragment.size() < 5)
+            return ConnectionError { Http2ErrorCode::FrameSizeError, "HEADERS frame too short for its priority fields"sv };
+        fragment = fragment.slice(5);
+    }
+
+    m_incomplete_header_block.stream_id = header.stream_id;
+    m_incomplete_header_block.end_stream = header.flags & FrameFlags::EndStream;
+    if (m_incomplete_header_block.fragments.try_append(fragment).is_error())
+        return ConnectionError { Http2ErrorCode::InternalError, "Failed to allocate the header block"sv };
+
+    if (header.flags & FrameFlags::EndHeaders)
+        return process_header_block();
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_continuation(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (m_incomplete_header_block.stream_id == 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "Unexpected CONTINUATION frame"sv };
+
+    // The compressed block is never larger than the header list it decodes to by any reasonable measure,
+    // so don't let a server make us buffer an endless stream of CONTINUATION frames.
+    if (m_incomplete_header_block.fragments.size() + payload.size() > max_header_list_size)
+        return ConnectionError { Http2ErrorCode::EnhanceYourCalm, "Header block is too large"sv };
+    if (m_incomplete_header_block.fragments.try_append(payload).is_error())
+        return ConnectionError { Http2ErrorCode::InternalError, "Failed to allocate the header block"sv };
+
+    if (header.flags & FrameFlags::EndHeaders)
+        return process_header_block();
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_header_block()
+{
+    auto block = exchange(m_incomplete_header_block, {});
+
+    // RFC 9113 section 4.3: "A decoding error in a field block MUST be treated as a connection error of type
+    // COMPRESSION_ERROR." The block is decoded even if the stream is gone, to keep the dynamic table in sync.
+    auto headers_or_error = m_decoder.decode(block.fragments);
+    if (headers_or_error.is_error()) {
+        dbgln("Http2Connection: Failed to decode header block: {}", headers_or_error.error());
+        return ConnectionError { Http2ErrorCode::CompressionError, "Failed to decode header block"sv };
+    }
+    auto headers = headers_or_error.release_value();
+
+    auto stream = find_stream(block.stream_id);
+    if (!stream || !stream->can_receive())
+        return {};
+
+    // RFC 9113 section 8.1.1: Malformed Messages
+    Optional<u32> status_code;
+    HeaderMap header_map;
+    for (auto& header : headers) {
+        if (header.name.starts_with(':')) {
+            // Responses only have the :status pseudo-header, and pseudo-headers come before any other headers.
+            if (header.name != ":status"sv || status_code.has_value() || !header_map.headers().is_empty()) {
+                stream_error(*stream, Http2ErrorCode::ProtocolError);
+                return {};
+            }
+            status_code = header.value.to_number<u32>();
+            if (!status_code.has_value()) {
+                stream_error(*stream, Http2ErrorCode::ProtocolError);
+                return {};
+            }
+            continue;
+        }
+
+        if (any_of(header.name, is_ascii_upper_alpha)) {
+            stream_error(*stream, Http2ErrorCode::ProtocolError);
+            return {};
+        }
+        header_map.set(move(header.name), move(header.value));
+    }
+
+    if (!stream->m_has_received_response) {
+        if (!status_code.has_value()) {
+            stream_error(*stream, Http2ErrorCode::ProtocolError);
+            return {};
+        }
+
+        // RFC 9113 section 8.1: Any number of interim responses may precede the final response.
+        if (*status_code >= 100 && *status_code < 200) {
+            if (block.end_stream)
+                stream_error(*stream, Http2ErrorCode::ProtocolError);
+            return {};
+        }
+
+        stream->m_has_received_response = true;
+        if (stream->on_headers_received)
+            stream->on_headers_received(*status_code, header_map);
+    } else {
+        // RFC 9113 section 8.1: Trailers must end the stream, and carry no pseudo-headers.
+        if (status_code.has_value() || !block.end_stream) {
+            stream_error(*stream, Http2ErrorCode::ProtocolError);
+            return {};
+        }
+        if (stream->on_trailers_received)
+            stream->on_trailers_received(header_map);
+    }
+
+    if (block.end_stream && stream->can_receive())
+        finish_stream(*stream);
+
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_reset_stream(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id == 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "RST_STREAM frame on stream 0"sv };
+    if (payload.size() != 4)
+        return ConnectionError { Http2ErrorCode::FrameSizeError, "RST_STREAM frame with an invalid length"sv };
+    if (is_idle_stream_id(header.stream_id))
+        return ConnectionError { Http2ErrorCode::ProtocolError, "RST_STREAM frame on an idle stream"sv };
+
+    auto code = static_cast<Http2ErrorCode>(read_u32(payload));
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Stream {} was reset: {}", header.stream_id, to_string_view(code));
+
+    // RFC 9113 section 8.7: REFUSED_STREAM means that the server didn't do any processing of the request.
+    if (auto stream = find_stream(header.stream_id))
+        fail_stream(*stream, code, code == Http2ErrorCode::RefusedStream);
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_settings(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id != 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "SETTINGS frame on a stream"sv };
+
+    if (header.flags & FrameFlags::Ack) {
+        if (!payload.is_empty())
+            return ConnectionError { Http2ErrorCode::FrameSizeError, "SETTINGS acknowledgement with a payload"sv };
+        return {};
+    }
+
+    if (payload.size() % 6 != 0)
+        return ConnectionError { Http2ErrorCode::FrameSizeError, "SETTINGS frame with an invalid length"sv };
+
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        auto setting = static_cast<Setting>((static_cast<u16>(payload[offset]) << 8) | payload[offset + 1]);
+        auto value = read_u32(payload.slice(offset + 2));
+
+        switch (setting) {
+        case Setting::HeaderTableSize:
+            m_encoder.set_max_table_size_limit(value);
+            break;
+        case Setting::EnablePush:
+            // "A client MUST treat receipt of a SETTINGS frame with SETTINGS_ENABLE_PUSH set to 1 as a connection error"
+            if (value != 0)
+                return ConnectionError { Http2ErrorCode::ProtocolError, "Server sent SETTINGS_ENABLE_PUSH"sv };
+            break;
+        case Setting::MaxConcurrentStreams:
+            m_max_concurrent_streams = value;
+            break;
+        case Setting::InitialWindowSize: {
+            if (value > max_window_size)
+                return ConnectionError { Http2ErrorCode::FlowControlError, "SETTINGS_INITIAL_WINDOW_SIZE is too large"sv };
+
+            // RFC 9113 section 6.9.2: The change applies to the windows of all open streams, which may become negative.
+            auto delta = static_cast<i64>(value) - m_initial_send_window;
+            for (auto& it : m_streams) {
+                it.value->m_send_window += delta;
+                if (it.value->m_send_window > max_window_size)
+                    return ConnectionError { Http2ErrorCode::FlowControlError, "SETTINGS_INITIAL_WINDOW_SIZE overflows a stream window"sv };
+            }
+            m_initial_send_window = value;
+            break;
+        }
+        case Setting::MaxFrameSize:
+            if (value < default_max_frame_size || value > 0xffffff)
+                return ConnectionError { Http2ErrorCode::ProtocolError, "SETTINGS_MAX_FRAME_SIZE out of range"sv };
+            m_max_frame_size = value;
+            break;
+        case Setting::MaxHeaderListSize:
+            // Advisory only, and our requests are nowhere near any reasonable limit.
+            break;
+        }
+    }
+
+    queue_frame(FrameType::Settings, FrameFlags::Ack, 0);
+
+    start_pending_streams();
+    send_pending_request_data();
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_ping(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id != 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "PING frame on a stream"sv };
+    if (payload.size() != 8)
+        return ConnectionError { Http2ErrorCode::FrameSizeError, "PING frame with an invalid length"sv };
+
+    if (!(header.flags & FrameFlags::Ack))
+        queue_frame(FrameType::Ping, FrameFlags::Ack, 0, payload);
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_go_away(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id != 0)
+        return ConnectionError { Http2ErrorCode::ProtocolError, "GOAWAY frame on a stream"sv };
+    if (payload.size() < 8)
+        return ConnectionError { Http2ErrorCode::FrameSizeError, "GOAWAY frame with an invalid length"sv };
+
+    auto last_stream_id = read_u32(payload) & max_stream_id;
+    auto code = static_cast<Http2ErrorCode>(read_u32(payload.slice(4)));
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Server is going away after stream {}: {}", last_stream_id, to_string_view(code));
+
+    // The server may send several GOAWAY frames, with decreasing stream IDs.
+    if (m_last_stream_id_processed_by_server.has_value())
+        last_stream_id = min(last_stream_id, *m_last_stream_id_processed_by_server);
+    m_last_stream_id_processed_by_server = last_stream_id;
+
+    // RFC 9113 section 6.8: Streams above the last stream ID were never processed, and can be retried on another connection.
+    Vector<NonnullRefPtr<Http2Stream>> unprocessed_streams;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            unprocessed_streams.append(it.value);
+    }
+    unprocessed_streams.extend(move(m_pending_streams));
+
+    for (auto& stream : unprocessed_streams)
+        fail_stream(*stream, Http2ErrorCode::RefusedStream, true);
+
+    if (!m_is_closed && is_idle())
+        tear_down(code);
+    return {};
+}
+
+Http2Connection::ProcessResult Http2Connection::process_window_update(FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (payload.size() != 4)
+        return ConnectionError { Http2ErrorCode::FrameSizeError, "WINDOW_UPDATE frame with an invalid length"sv };
+
+    i64 increment = read_u32(payload) & 0x7fffffff;
+
+    if (header.stream_id == 0) {
+        if (increment == 0)
+            return ConnectionError { Http2ErrorCode::ProtocolError, "WINDOW_UPDATE with a zero increment"sv };
+        m_connection_send_window += increment;
+        if (m_connection_send_window > max_window_size)
+            return ConnectionError { Http2ErrorCode::FlowControlError, "WINDOW_UPDATE overflows the connection window"sv };
+    } else {
+        if (is_idle_stream_id(header.stream_id))
+            return ConnectionError { Http2ErrorCode::ProtocolError, "WINDOW_UPDATE frame on an idle stream"sv };
+
+        auto stream = find_stream(header.stream_id);
+        if (!stream)
+            return {};
+        if (increment == 0) {
+            stream_error(*stream, Http2ErrorCode::ProtocolError);
+            return {};
+        }
+        stream->m_send_window += increment;
+        if (stream->m_send_window > max_window_size) {
+            stream_error(*stream, Http2ErrorCode::FlowControlError);
+            return {};
+        }
+    }
+
+    send_pending_request_data();
+    return {};
+}
+
+void Http2Connection::queue_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_is_closed)
+        return;
+
+    VERIFY(payload.size() <= m_max_frame_size);
+    u8 header[frame_header_size] {
+        static_cast<u8>(payload.size() >> 16),
+        static_cast<u8>(payload.size() >> 8),
+        static_cast<u8>(payload.size()),
+        to_underlying(type),
+        flags,
+        static_cast<u8>(stream_id >> 24),
+        static_cast<u8>(stream_id >> 16),
+        static_cast<u8>(stream_id >> 8),
+        static_cast<u8>(stream_id),
+    };
+    m_output_buffer.append({ header, sizeof(header) });
+    m_output_buffer.append(payload);
+    schedule_flush();
+}
+
+void Http2Connection::queue_window_update(u32 stream_id, u32 increment)
+{
+    ByteBuffer payload;
+    append_u32(payload, increment);
+    queue_frame(FrameType::WindowUpdate, 0, stream_id, payload);
+}
+
+void Http2Connection::schedule_flush()
+{
+    if (m_has_scheduled_flush)
+        return;
+
+    // Frames queued while handling a single read (or by several requests starting at once) go out in one write.
+    m_has_scheduled_flush = true;
+    Core::deferred_invoke([self = NonnullRefPtr(*this)] {
+        self->flush();
+    });
+}
+
+void Http2Connection::flush()
+{
+    m_has_scheduled_flush = false;
+    if (m_is_closed || m_output_buffer.is_empty())
+        return;
+
+    auto data = m_output_buffer.data();
+    if (auto result = m_socket->write_until_depleted(data); result.is_error()) {
+        dbgln("Http2Connection: Failed to write to the socket: {}", result.error());
+        NonnullRefPtr protector(*this);
+        tear_down(Http2ErrorCode::ConnectError);
+        return;
+    }
+    m_output_buffer.dequeue(data.size());
+}
+
+void Http2Connection::start_pending_streams()
+{
+    while (!m_pending_streams.is_empty() && m_streams.size() < m_max_concurrent_streams) {
+        if (m_next_stream_id > max_stream_id) {
+            // Stream IDs can't be reused, so this connection has run its course.
+            for (auto& stream : exchange(m_pending_streams, {}))
+                fail_stream(*stream, Http2ErrorCode::RefusedStream, true);
+            break;
+        }
+
+        auto stream = m_pending_streams.take_first();
+        stream->m_id = m_next_stream_id;
+        stream->m_send_window = m_initial_send_window;
+        stream->m_receive_window = stream_receive_window_size;
+        m_next_stream_id += 2;
+
+        m_streams.set(stream->m_id, stream);
+        send_request_headers(*stream);
+    }
+
+    send_pending_request_data();
+}
+
+void Http2Connection::send_request_headers(Http2Stream& stream)
+{
+    auto block_or_error = m_encoder.encode(stream.m_request_headers);
+    if (block_or_error.is_error()) {
+        // The encoder's dynamic table may now be out of sync with the server's.
+        fail_connection({ Http2ErrorCode::InternalError, "Failed to encode request headers"sv });
+        return;
+    }
+    auto block = block_or_error.release_value();
+    stream.m_request_headers.clear();
+
+    bool end_stream = !stream.has_pending_request_data();
+
+    // RFC 9113 section 4.3: A header block is sent as a single HEADERS frame followed by any number of
+    // CONTINUATION frames, with no other frames in between.
+    auto remaining = block.bytes();
+    auto fragment = remaining.trim(m_max_frame_size);
+    remaining = remaining.slice(fragment.size());
+
+    u8 flags = end_stream ? FrameFlags::EndStream : 0;
+    if (remaining.is_empty())
+        flags |= FrameFlags::EndHeaders;
+    queue_frame(FrameType::Headers, flags, stream.m_id, fragment);
+
+    while (!remaining.is_empty()) {
+        fragment = remaining.trim(m_max_frame_size);
+        remaining = remaining.slice(fragment.size());
+        queue_frame(FrameType::Continuation, remaining.is_empty() ? FrameFlags::EndHeaders : 0, stream.m_id, fragment);
+    }
+
+    stream.m_state = end_stream ? Http2Stream::State::HalfClosedLocal : Http2Stream::State::Open;
+}
+
+void Http2Connection::send_pending_request_data()
+{
+    for (auto& it : m_streams) {
+        auto& stream = *it.value;
+        while (stream.m_state == Http2Stream::State::Open && stream.has_pending_request_data()) {
+            auto window = min(m_connection_send_window, stream.m_send_window);
+            if (window <= 0)
+                break;
+
+            auto size = min(stream.m_request_body.size() - stream.m_request_body_offset, static_cast<size_t>(min<i64>(window, m_max_frame_size)));
+            auto data = stream.m_request_body.bytes().slice(stream.m_request_body_offset, size);
+            stream.m_request_body_offset += size;
+            stream.m_send_window -= size;
+            m_connection_send_window -= size;
+
+            bool end_stream = !stream.has_pending_request_data();
+            queue_frame(FrameType::Data, end_stream ? FrameFlags::EndStream : 0, stream.m_id, data);
+
+            if (end_stream) {
+                stream.m_state = Http2Stream::State::HalfClosedLocal;
+                stream.m_request_body.clear();
+            }
+        }
+        if (m_connection_send_window <= 0)
+            break;
+    }
+}
+
+void Http2Connection::consume(Http2Stream& stream, size_t size)
+{
+    // Window updates are sent once at least half of a window is owed, rather than for every little read.
+    if (stream.can_receive()) {
+        stream.m_consumed_size_to_acknowledge += size;
+        if (stream.m_consumed_size_to_acknowledge >= stream_receive_window_size / 2) {
+            queue_window_update(stream.m_id, stream.m_consumed_size_to_acknowledge);
+            stream.m_receive_window += stream.m_consumed_size_to_acknowledge;
+            stream.m_consumed_size_to_acknowledge = 0;
+        }
+    }
+
+    acknowledge_connection_data(size);
+}
+
+void Http2Connection::acknowledge_connection_data(size_t size)
+{
+    m_connection_consumed_size_to_acknowledge += size;
+    if (m_connection_consumed_size_to_acknowledge >= connection_receive_window_size / 2) {
+        queue_window_update(0, m_connection_consumed_size_to_acknowledge);
+        m_connection_receive_window += m_connection_consumed_size_to_acknowledge;
+        m_connection_consumed_size_to_acknowledge = 0;
+    }
+}
+
+void Http2Connection::finish_stream(Http2Stream& stream)
+{
+    NonnullRefPtr protector(stream);
+
+    // RFC 9113 section 8.1: The server may respond before we're done sending the request, in which case
+    // we stop sending and tell it so with NO_ERROR.
+    if (stream.m_state == Http2Stream::State::Open)
+        queue_frame(FrameType::ResetStream, 0, stream.m_id, to_array<u8>({ 0, 0, 0, 0 }));
+
+    detach_stream(stream);
+    if (stream.on_finish)
+        stream.on_finish();
+}
+
+void Http2Connection::fail_stream(Http2Stream& stream, Http2ErrorCode code, bool can_retry)
+{
+    NonnullRefPtr protector(stream);
+
+    detach_stream(stream);
+    if (stream.on_error)
+        stream.on_error(code, can_retry);
+}
+
+void Http2Connection::stream_error(Http2Stream& stream, Http2ErrorCode code)
+{
+    NonnullRefPtr protector(stream);
+
+    dbgln("Http2Connection: Resetting stream {}: {}", stream.m_id, to_string_view(code));
+    reset_stream(stream, code);
+    if (stream.on_error)
+        stream.on_error(code, false);
+}
+
+void Http2Connection::reset_stream(Http2Stream& stream, Http2ErrorCode code)
+{
+    if (stream.can_receive()) {
+        ByteBuffer payload;
+        append_u32(payload, to_underlying(code));
+        queue_frame(FrameType::ResetStream, 0, stream.m_id, payload);
+    }
+    detach_stream(stream);
+}
+
+void Http2Connection::detach_stream(Http2Stream& stream)
+{
+    // Whatever the stream didn't consume would otherwise count against the connection window forever.
+    if (stream.m_unconsumed_size > 0)
+        acknowledge_connection_data(exchange(stream.m_unconsumed_size, 0));
+
+    stream.m_state = Http2Stream::State::Closed;
+    stream.m_request_body.clear();
+    if (stream.m_id != 0)
+        m_streams.remove(stream.m_id);
+    else
+        m_pending_streams.remove_first_matching([&](auto& pending_stream) { return pending_stream.ptr() == &stream; });
+
+    // NOTE: This may drop the last reference to us; our callers keep us alive until they're done.
+    stream.m_connection = nullptr;
+
+    if (m_is_closed)
+        return;
+
+    start_pending_streams();
+
+    if (is_idle()) {
+        if (m_last_stream_id_processed_by_server.has_value())
+            tear_down(Http2ErrorCode::NoError);
+        else if (on_idle)
+            on_idle();
+    }
+}
+
+void Http2Connection::fail_connection(ConnectionError error)
+{
+    dbgln("Http2Connection: Connection error: {} ({})", error.reason, to_string_view(error.code));
+
+    ByteBuffer payload;
+    append_u32(payload, 0);
+    append_u32(payload, to_underlying(error.code));
+    queue_frame(FrameType::GoAway, 0, 0, payload);
+    flush();
+
+    tear_down(error.code);
+}
+
+void Http2Connection::tear_down(Http2ErrorCode code)
+{
+    if (m_is_closed)
+        return;
+
+    NonnullRefPtr protector(*this);
+    m_is_closed = true;
+    m_socket->on_ready_to_read = nullptr;
+    m_socket->close();
+
+    // Requests that were never sent can safely go out on another connection, but there's no telling
+    // what the server did with the ones that were in flight.
+    for (auto& stream : exchange(m_pending_streams, {})) {
+        stream->m_state = Http2Stream::State::Closed;
+        stream->m_connection = nullptr;
+        if (stream->on_error)
+            stream->on_error(code, true);
+    }
+
+    for (auto& stream : exchange(m_streams, {})) {
+        stream.value->m_state = Http2Stream::State::Closed;
+        stream.value->m_connection = nullptr;
+        if (stream.value->on_error)
+            stream.value->on_error(code, false);
+    }
+
+    if (on_close)
+        on_close();
+}
+
+RefPtr<Http2Stream> Http2Connection::find_stream(u32 stream_id)
+{
+    if (auto stream = m_streams.get(stream_id); stream.has_value())
+        return *stream;
+    return nullptr;
+}
+
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/StreamBuffer.h>
+#include <AK/Vector.h>
+#include <LibCore/Socket.h>
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/HeaderMap.h>
+
+namespace HTTP {
+
+// RFC 9113 section 7: Error Codes
+#define ENUMERATE_HTTP2_ERROR_CODES(E) \
+    E(NoError, 0x0)                    \
+    E(ProtocolError, 0x1)              \
+    E(InternalError, 0x2)              \
+    E(FlowControlError, 0x3)           \
+    E(SettingsTimeout, 0x4)            \
+    E(StreamClosed, 0x5)               \
+    E(FrameSizeError, 0x6)             \
+    E(RefusedStream, 0x7)              \
+    E(Cancel, 0x8)                     \
+    E(CompressionError, 0x9)           \
+    E(ConnectError, 0xa)               \
+    E(EnhanceYourCalm, 0xb)            \
+    E(InadequateSecurity, 0xc)         \
+    E(Http11Required, 0xd)
+
+enum class Http2ErrorCode : u32 {
+#define ID(name, value) name = value,
+    ENUMERATE_HTTP2_ERROR_CODES(ID)
+#undef ID
+};
+
+StringView to_string_view(Http2ErrorCode);
+
+class Http2Connection;
+
+// A single request/response exchange on an Http2Connection.
+class Http2Stream : public RefCounted<Http2Stream> {
+public:
+    // Informational (1xx) responses are not reported.
+    Function<void(u32 status_code, HeaderMap const&)> on_headers_received;
+    Function<void(HeaderMap const&)> on_trailers_received;
+    Function<void(ReadonlyBytes)> on_data_received;
+    Function<void()> on_finish;
+    // `can_retry` is set if the server is known not to have processed the request (RFC 9113 section 8.7),
+    // so that it is safe to send it again on another connection.
+    Function<void(Http2ErrorCode, bool can_retry)> on_error;
+
+    // Data passed to on_data_received counts against the flow control windows until it has been consumed;
+    // the server will stop sending once a stream has an entire window's worth of unconsumed data.
+    void did_consume(size_t);
+
+    // Resets the stream if it is still open, and detaches it from the connection.
+    void cancel();
+
+private:
+    friend class Http2Connection;
+
+    enum class State {
+        Idle,
+        Open,
+        HalfClosedLocal,
+        Closed,
+    };
+
+    Http2Stream(Http2Connection&, Vector<Header> request_headers, ByteBuffer request_body);
+
+    bool has_pending_request_data() const { return m_request_body_offset < m_request_body.size(); }
+    bool can_receive() const { return m_state == State::Open || m_state == State::HalfClosedLocal; }
+
+    RefPtr<Http2Connection> m_connection;
+    u32 m_id { 0 };
+    State m_state { State::Idle };
+
+    Vector<Header> m_request_headers;
+    ByteBuffer m_request_body;
+    size_t m_request_body_offset { 0 };
+
+    bool m_has_received_response { false };
+    i64 m_send_window { 0 };
+    i64 m_receive_window { 0 };
+    size_t m_unconsumed_size { 0 };
+    size_t m_consumed_size_to_acknowledge { 0 };
+};
+
+// An HTTP/2 client connection (RFC 9113), multiplexing any number of concurrent requests over a single socket.
+class Http2Connection : public RefCounted<Http2Connection> {
+public:
+    // RFC 9113 section 3.4: HTTP/2 Connection Preface
+    static constexpr auto connection_preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv;
+
+    // The socket must have negotiated "h2" through ALPN (RFC 9113 section 3.2).
+    static ErrorOr<NonnullRefPtr<Http2Connection>> try_create(NonnullOwnPtr<Core::Socket>);
+    ~Http2Connection();
+
+    // Pseudo-header fields must come first, and all header names must be lowercase (RFC 9113 section 8.3).
+    // The request is queued if the server doesn't allow any more concurrent streams yet.
+    NonnullRefPtr<Http2Stream> open_stream(Vector<Header> request_headers, ByteBuffer request_body);
+
+    // Whether new streams may be opened on this connection.
+    bool is_usable() const;
+    bool is_idle() const { return m_streams.is_empty() && m_pending_streams.is_empty(); }
+
+    // Fails all streams that are still open, and tells the server we're going away.
+    void close();
+
+    Function<void()> on_idle;
+    Function<void()> on_close;
+
+private:
+    friend class Http2Stream;
+
+    // RFC 9113 section 6: Frame Definitions
+    enum class FrameType : u8 {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        ResetStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9,
+    };
+
+    enum FrameFlags : u8 {
+        EndStream = 0x1,
+        Ack = 0x1,
+        EndHeaders = 0x4,
+        Padded = 0x8,
+        Priority = 0x20,
+    };
+
+    // RFC 9113 section 6.5.2: Defined Settings
+    enum class Setting : u16 {
+        HeaderTableSize = 0x1,
+        EnablePush = 0x2,
+        MaxConcurrentStreams = 0x3,
+        InitialWindowSize = 0x4,
+        MaxFrameSize = 0x5,
+        MaxHeaderListSize = 0x6,
+    };
+
+    struct FrameHeader {
+        u32 length { 0 };
+        FrameType type { FrameType::Data };
+        u8 flags { 0 };
+        u32 stream_id { 0 };
+    };
+
+    struct ConnectionError {
+        Http2ErrorCode code;
+        StringView reason;
+    };
+    using ProcessResult = ErrorOr<void, ConnectionError>;
+
+    static constexpr size_t frame_header_size = 9;
+    static constexpr u32 default_max_frame_size = 16384;
+    static constexpr u32 default_initial_window_size = 65535;
+    static constexpr i64 max_window_size = 0x7fffffff;
+    static constexpr u32 max_stream_id = 0x7fffffff;
+
+    // What we let the server send before it has to wait for us to consume data.
+    static constexpr u32 stream_receive_window_size = 1 * MiB;
+    static constexpr u32 connection_receive_window_size = 16 * MiB;
+    static constexpr size_t max_header_list_size = 256 * KiB;
+    // RFC 9113 section 6.5.2: "It is recommended that this value be no smaller than 100". Servers usually
+    // announce their limit right away, but we might already be sending requests before we've seen it.
+    static constexpr u32 assumed_max_concurrent_streams = 100;
+
+    explicit Http2Connection(NonnullOwnPtr<Core::Socket>);
+
+    void read_from_socket();
+    ProcessResult process_frame(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_data(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_headers(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_continuation(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_header_block();
+    ProcessResult process_reset_stream(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_settings(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_ping(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_go_away(FrameHeader const&, ReadonlyBytes payload);
+    ProcessResult process_window_update(FrameHeader const&, ReadonlyBytes payload);
+    static ErrorOr<ReadonlyBytes, ConnectionError> strip_padding(FrameHeader const&, ReadonlyBytes payload);
+
+    void queue_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload = {});
+    void queue_window_update(u32 stream_id, u32 increment);
+    void schedule_flush();
+    void flush();
+
+    void start_pending_streams();
+    void send_request_headers(Http2Stream&);
+    void send_pending_request_data();
+
+    void consume(Http2Stream&, size_t);
+    void acknowledge_connection_data(size_t);
+
+    void finish_stream(Http2Stream&);
+    void fail_stream(Http2Stream&, Http2ErrorCode, bool can_retry);
+    void stream_error(Http2Stream&, Http2ErrorCode);
+    void reset_stream(Http2Stream&, Http2ErrorCode);
+    void detach_stream(Http2Stream&);
+
+    void fail_connection(ConnectionError);
+    void tear_down(Http2ErrorCode);
+
+    RefPtr<Http2Stream> find_stream(u32 stream_id);
+    bool is_idle_stream_id(u32 stream_id) const { return stream_id >= m_next_stream_id; }
+
+    NonnullOwnPtr<Core::Socket> m_socket;
+    StreamBuffer m_input_buffer;
+    StreamBuffer m_output_buffer;
+    bool m_has_scheduled_flush { false };
+    bool m_is_closed { false };
+
+    HPack::Encoder m_encoder;
+    HPack::Decoder m_decoder { max_header_list_size };
+
+    HashMap<u32, NonnullRefPtr<Http2Stream>> m_streams;
+    Vector<NonnullRefPtr<Http2Stream>> m_pending_streams;
+    u32 m_next_stream_id { 1 };
+
+    // A header block that is still being continued with CONTINUATION frames (RFC 9113 section 6.10).
+    struct IncompleteHeaderBlock {
+        u32 stream_id { 0 };
+        bool end_stream { false };
+        ByteBuffer fragments;
+    };
+    IncompleteHeaderBlock m_incomplete_header_block;
+
+    // The server's settings.
+    u32 m_max_concurrent_streams { assumed_max_concurrent_streams };
+    u32 m_max_frame_size { default_max_frame_size };
+    i64 m_initial_send_window { default_initial_window_size };
+
+    i64 m_connection_send_window { default_initial_window_size };
+    i64 m_connection_receive_window { connection_receive_window_size };
+    size_t m_connection_consumed_size_to_acknowledge { 0 };
+
+    // Set once we receive GOAWAY; streams above this ID were never processed by the server.
+    Optional<u32> m_last_stream_id_processed_by_server;
+};
+
+}
@@ -84,6 +84,41 @@ ErrorOr<ByteBuffer> HttpRequest::to_raw_request() const
     return builder.to_byte_buffer();
 }
 
+ErrorOr<Vector<Header>> HttpRequest::to_http2_headers() const
+{
+    // RFC 9113 section 8.3.1: Request Pseudo-Header Fields
+    auto authority = TRY(m_url.serialized_host()).to_byte_string();
+    if (m_url.port().has_value())
+        authority = ByteString::formatted("{}:{}", authority, *m_url.port());
+
+    StringBuilder path;
+    TRY(path.try_append(m_url.serialize_path()));
+    if (m_url.query().has_value()) {
+        TRY(path.try_append('?'));
+        TRY(path.try_append(*m_url.query()));
+    }
+
+    Vector<Header> headers;
+    TRY(headers.try_ensure_capacity(m_headers.headers().size() + 5));
+    headers.unchecked_append({ ":method", method_name() });
+    headers.unchecked_append({ ":scheme", m_url.scheme().to_byte_string() });
+    headers.unchecked_append({ ":authority", move(authority) });
+    headers.unchecked_append({ ":path", path.to_byte_string() });
+
+    bool has_content_length = m_headers.contains("Content-Length"sv);
+    for (auto const& [name, value] : m_headers.headers()) {
+        // RFC 9113 section 8.2.2: Connection-specific header fields are not allowed, and :authority replaces Host.
+        if (name.is_one_of_ignoring_ascii_case("Connection"sv, "Host"sv, "Keep-Alive"sv, "Proxy-Connection"sv, "Transfer-Encoding"sv, "Upgrade"sv))
+            continue;
+        // RFC 9113 section 8.2.1: "Field names MUST be converted to lowercase when constructing an HTTP/2 message."
+        headers.append({ name.to_lowercase(), value });
+    }
+    if ((!m_body.is_empty() || method() == Method::POST) && !has_content_length)
+        headers.append({ "content-length", ByteString::number(m_body.size()) });
+
+    return headers;
+}
+
 ErrorOr<HttpRequest, HttpRequest::ParseError> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
 {
     enum class State {
@@ -81,6 +81,7 @@ public:
 
     StringView method_name() const;
     ErrorOr<ByteBuffer> to_raw_request() const;
+    ErrorOr<Vector<Header>> to_http2_headers() const;
 
     void set_headers(HeaderMap);
 
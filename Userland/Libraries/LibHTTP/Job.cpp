@@ -162,6 +162,12 @@ Job::Job(HttpRequest&& request, Core::File& output_stream)
 {
 }
 
+Job::~Job()
+{
+    if (m_http2_stream)
+        m_http2_stream->cancel();
+}
+
 void Job::start(Core::BufferedSocketBase& socket)
 {
     VERIFY(!m_socket);
@@ -173,8 +179,83 @@ void Job::start(Core::BufferedSocketBase& socket)
     });
 }
 
+void Job::start(Http2Connection& connection)
+{
+    VERIFY(!m_socket && !m_http2_stream);
+    dbgln_if(HTTPJOB_DEBUG, "Starting HTTP/2 request for {}", url());
+    m_is_using_http2 = true;
+
+    auto headers = m_request.to_http2_headers();
+    auto body = ByteBuffer::copy(m_request.body());
+    if (headers.is_error() || body.is_error())
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+
+    m_http2_stream = connection.open_stream(headers.release_value(), body.release_value());
+
+    m_http2_stream->on_headers_received = [this](u32 status_code, HeaderMap const& headers) {
+        m_code = status_code;
+        for (auto const& [name, value] : headers.headers()) {
+            m_headers.set(name, value);
+            if (name == "content-encoding"sv) {
+                // Assume that any content-encoding means that we can't decode it as a stream :(
+                m_can_stream_response = false;
+            } else if (name == "content-length"sv) {
+                if (auto length = value.to_number<u64>(); length.has_value())
+                    m_content_length = length.value();
+            }
+        }
+        if (on_headers_received)
+            on_headers_received(m_headers, m_code);
+    };
+
+    m_http2_stream->on_data_received = [this](ReadonlyBytes data) {
+        auto payload = ByteBuffer::copy(data);
+        if (payload.is_error())
+            return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+
+        m_received_buffers.append(make<ReceivedBuffer>(payload.release_value()));
+        m_buffered_size += data.size();
+        m_received_size += data.size();
+
+        // Encoded responses are only flushed once complete, so don't make the server wait for that.
+        if (!m_can_stream_response)
+            m_http2_stream->did_consume(data.size());
+
+        Core::EventLoop::current().adopt_coroutine(flush_received_buffers());
+        deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+    };
+
+    m_http2_stream->on_trailers_received = [this](HeaderMap const& trailers) {
+        for (auto const& [name, value] : trailers.headers())
+            m_headers.set(name, value);
+    };
+
+    m_http2_stream->on_finish = [this] {
+        Core::EventLoop::current().adopt_coroutine(finish_up());
+    };
+
+    m_http2_stream->on_error = [this](Http2ErrorCode code, bool can_retry) {
+        dbgln("Job: HTTP/2 stream for {} failed: {}", url(), to_string_view(code));
+        m_http2_stream = nullptr;
+
+        if (can_retry && on_request_refused && m_refused_request_count < max_refused_request_retries) {
+            ++m_refused_request_count;
+            m_is_using_http2 = false;
+            deferred_invoke([this] { on_request_refused(); });
+            return;
+        }
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+    };
+}
+
 void Job::shutdown(ShutdownMode mode)
 {
+    if (m_http2_stream) {
+        // This resets the stream if the response is still incomplete.
+        m_http2_stream->cancel();
+        m_http2_stream = nullptr;
+        return;
+    }
     if (!m_socket)
         return;
     if (mode == ShutdownMode::CloseSocket) {
@@ -202,6 +283,8 @@ Coroutine<void> Job::flush_received_buffers()
                 break;
             auto written = result.release_value();
             m_buffered_size -= written;
+            if (m_http2_stream)
+                m_http2_stream->did_consume(written);
             if (written == payload.size()) {
                 // FIXME: Make this a take-first-friendly object?
                 (void)m_received_buffers.take_first();
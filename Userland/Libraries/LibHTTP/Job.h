@@ -10,6 +10,7 @@
 #include <AK/Optional.h>
 #include <LibCore/NetworkJob.h>
 #include <LibCore/Socket.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 
@@ -20,11 +21,17 @@ class Job : public Core::NetworkJob {
 
 public:
     explicit Job(HttpRequest&&, Core::File&);
-    virtual ~Job() override = default;
+    virtual ~Job() override;
 
     virtual void start(Core::BufferedSocketBase&) override;
+    void start(Http2Connection&);
     virtual void shutdown(ShutdownMode) override;
 
+    bool is_using_http2() const { return m_is_using_http2; }
+
+    // Called when an HTTP/2 server refused the request without processing it, so that it can be started again on another connection.
+    Function<void()> on_request_refused;
+
     Core::Socket const* socket() const { return m_socket; }
     URL::URL url() const { return m_request.url(); }
 
@@ -74,6 +81,11 @@ protected:
     bool m_has_scheduled_finish { false };
     bool m_has_scheduled_flush { false };
     bool m_request_done { false };
+
+    static constexpr size_t max_refused_request_retries = 3;
+    RefPtr<Http2Stream> m_http2_stream;
+    bool m_is_using_http2 { false };
+    size_t m_refused_request_count { 0 };
 };
 
 }
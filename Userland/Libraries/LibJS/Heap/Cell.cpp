@@ -15,6 +15,14 @@ void JS::Cell::initialize(JS::Realm&)
 {
 }
 
+void JS::Cell::remember()
+{
+    if (m_remembered)
+        return;
+    m_remembered = true;
+    heap().did_remember_cell({}, *this);
+}
+
 void JS::Cell::Visitor::visit(JS::Value value)
 {
     if (value.is_cell())
@@ -36,6 +36,15 @@ public:                                            \
     }                                              \
     friend class JS::Heap;
 
+// Opts a cell type into generational collection. Every store of a GC-allocated reference into an instance of
+// ClassName after construction must be followed by a write_barrier() call (cells that never store a reference
+// after construction trivially qualify). Cells without this declaration are conservatively re-traced on every
+// minor collection once they are old. NOTE: This is deliberately not inherited by subclasses.
+// NOTE: Object keeps its IndexedProperties behind put_indexed_direct() and append_indexed_direct(), which
+//       call write_barrier() for you.
+#define JS_DECLARE_WRITE_BARRIERS(ClassName) \
+    using WriteBarrieredCellType = ClassName
+
 class Cell : public Weakable<Cell> {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -55,6 +64,27 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    bool has_write_barriers() const { return m_has_write_barriers; }
+    void set_has_write_barriers(Badge<Heap>) { m_has_write_barriers = true; }
+
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(Badge<Heap>, bool b) { m_remembered = b; }
+
+    // A dead cell that has been finalized and had its state set to Dead, but has not been destroyed yet.
+    bool is_awaiting_sweep() const { return m_awaiting_sweep; }
+    void set_awaiting_sweep(Badge<Heap>) { m_awaiting_sweep = true; }
+
+    void revoke_weak_ptrs(Badge<Heap>) { Weakable::revoke_weak_ptrs(); }
+
+    // Must be called after storing a reference to `cell` into this cell.
+    // NOTE: In generational mode, cells that survive a collection keep their mark bit until the next major
+    //       collection, so a marked cell is old and an unmarked one is young.
+    ALWAYS_INLINE void write_barrier(Cell* cell)
+    {
+        if (m_has_write_barriers && m_mark && cell && !cell->m_mark) [[unlikely]]
+            remember();
+    }
+
     virtual StringView class_name() const = 0;
 
     class Visitor {
@@ -177,9 +207,14 @@ protected:
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
+    void remember();
+
     bool m_mark : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
     State m_state : 1 { State::Live };
+    bool m_has_write_barriers : 1 { false };
+    bool m_remembered : 1 { false };
+    bool m_awaiting_sweep : 1 { false };
 };
 
 }
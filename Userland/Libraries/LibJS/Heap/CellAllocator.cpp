@@ -23,6 +23,10 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     if (!m_list_node.is_in_list())
         heap.register_cell_allocator({}, *this);
 
+    // Reclaim the cells of lazily swept blocks before growing the heap.
+    while (m_usable_blocks.is_empty() && !m_blocks_pending_sweep.is_empty())
+        heap.sweep_block_lazily({}, *m_blocks_pending_sweep.take_last());
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, *this, m_cell_size, m_class_name);
         auto block_ptr = reinterpret_cast<FlatPtr>(block.ptr());
@@ -55,4 +59,12 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+void CellAllocator::block_needs_sweep(Badge<Heap>, HeapBlock& block)
+{
+    if (block.is_pending_sweep())
+        return;
+    block.set_pending_sweep(true);
+    m_blocks_pending_sweep.append(&block);
+}
+
 }
@@ -9,6 +9,7 @@
 #include <AK/IntrusiveList.h>
 #include <AK/NeverDestroyed.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/BlockAllocator.h>
 #include <LibJS/Heap/HeapBlock.h>
@@ -47,6 +48,9 @@ public:
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
 
+    void block_needs_sweep(Badge<Heap>, HeapBlock&);
+    HeapBlock* take_block_pending_sweep(Badge<Heap>) { return m_blocks_pending_sweep.is_empty() ? nullptr : m_blocks_pending_sweep.take_last(); }
+
     IntrusiveListNode<CellAllocator> m_list_node;
     using List = IntrusiveList<&CellAllocator::m_list_node>;
 
@@ -63,6 +67,9 @@ private:
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+
+    // Blocks with cells that are awaiting sweep. They stay in the lists above and can still be allocated from.
+    Vector<HeapBlock*> m_blocks_pending_sweep;
     FlatPtr m_min_block_address { explode_byte(0xff) };
     FlatPtr m_max_block_address { 0 };
 };
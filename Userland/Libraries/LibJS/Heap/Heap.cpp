@@ -12,6 +12,7 @@
 #include <AK/JsonObject.h>
 #include <AK/Platform.h>
 #include <AK/StackInfo.h>
+#include <AK/StringBuilder.h>
 #include <AK/TemporaryChange.h>
 #include <LibCore/ElapsedTimer.h>
 #include <LibJS/Bytecode/Interpreter.h>
@@ -42,44 +43,6 @@ static int gc_perf_string_id;
 static __thread HashMap<FlatPtr*, size_t>* s_custom_ranges_for_conservative_scan = nullptr;
 static __thread HashMap<FlatPtr*, SourceLocation*>* s_safe_function_locations = nullptr;
 
-Heap::Heap(VM& vm)
-    : HeapBase(vm)
-{
-#ifdef AK_OS_SERENITY
-    auto gc_signpost_string = "Garbage collection"sv;
-    gc_perf_string_id = perf_register_string(gc_signpost_string.characters_without_null_termination(), gc_signpost_string.length());
-#endif
-
-    static_assert(HeapBlock::min_possible_cell_size <= 32, "Heap Cell tracking uses too much data!");
-    m_size_based_cell_allocators.append(make<CellAllocator>(64));
-    m_size_based_cell_allocators.append(make<CellAllocator>(96));
-    m_size_based_cell_allocators.append(make<CellAllocator>(128));
-    m_size_based_cell_allocators.append(make<CellAllocator>(256));
-    m_size_based_cell_allocators.append(make<CellAllocator>(512));
-    m_size_based_cell_allocators.append(make<CellAllocator>(1024));
-    m_size_based_cell_allocators.append(make<CellAllocator>(3072));
-}
-
-Heap::~Heap()
-{
-    vm().string_cache().clear();
-    vm().byte_string_cache().clear();
-    collect_garbage(CollectionType::CollectEverything);
-}
-
-void Heap::will_allocate(size_t size)
-{
-    if (should_collect_on_every_allocation()) {
-        m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
-    } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
-        m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
-    }
-
-    m_allocated_bytes_since_last_gc += size;
-}
-
 static void add_possible_value(HashMap<FlatPtr, HeapRoot>& possible_pointers, FlatPtr data, HeapRoot origin, FlatPtr min_block_address, FlatPtr max_block_address)
 {
     if constexpr (sizeof(FlatPtr*) == sizeof(Value)) {
@@ -129,6 +92,162 @@ static void for_each_cell_among_possible_pointers(HashTable<HeapBlock*> const& a
     }
 }
 
+class MarkingVisitor final : public Cell::Visitor {
+public:
+    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+        : m_heap(heap)
+    {
+        m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
+        m_heap.for_each_block([&](auto& block) {
+            m_all_live_heap_blocks.set(&block);
+            return IterationDecision::Continue;
+        });
+
+        visit_roots(roots);
+    }
+
+    void visit_roots(HashMap<Cell*, HeapRoot> const& roots)
+    {
+        for (auto* root : roots.keys())
+            visit(root);
+    }
+
+    virtual void visit_impl(Cell& cell) override
+    {
+        if (cell.is_marked())
+            return;
+        dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
+
+        cell.set_marked(true);
+        m_work_queue.append(cell);
+    }
+
+    virtual void visit_possible_values(ReadonlyBytes bytes) override
+    {
+        HashMap<FlatPtr, HeapRoot> possible_pointers;
+
+        auto* raw_pointer_sized_values = reinterpret_cast<FlatPtr const*>(bytes.data());
+        for (size_t i = 0; i < (bytes.size() / sizeof(FlatPtr)); ++i)
+            add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
+
+        for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
+            if (cell->is_marked())
+                return;
+            if (cell->state() != Cell::State::Live)
+                return;
+            cell->set_marked(true);
+            m_work_queue.append(*cell);
+        });
+    }
+
+    void mark_all_live_cells()
+    {
+        while (!m_work_queue.is_empty()) {
+            m_work_queue.take_last()->visit_edges(*this);
+        }
+    }
+
+    // Returns true once there is nothing left to mark.
+    bool mark_live_cells_until(MonotonicTime deadline)
+    {
+        static constexpr size_t cells_between_deadline_checks = 64;
+        size_t cells_until_deadline_check = cells_between_deadline_checks;
+        while (!m_work_queue.is_empty()) {
+            m_work_queue.take_last()->visit_edges(*this);
+            if (--cells_until_deadline_check == 0) {
+                if (MonotonicTime::now() >= deadline)
+                    return m_work_queue.is_empty();
+                cells_until_deadline_check = cells_between_deadline_checks;
+            }
+        }
+        return true;
+    }
+
+private:
+    Heap& m_heap;
+    Vector<NonnullGCPtr<Cell>> m_work_queue;
+    HashTable<HeapBlock*> m_all_live_heap_blocks;
+    FlatPtr m_min_block_address;
+    FlatPtr m_max_block_address;
+};
+
+Heap::Heap(VM& vm)
+    : HeapBase(vm)
+{
+#ifdef AK_OS_SERENITY
+    auto gc_signpost_string = "Garbage collection"sv;
+    gc_perf_string_id = perf_register_string(gc_signpost_string.characters_without_null_termination(), gc_signpost_string.length());
+#endif
+
+    static_assert(HeapBlock::min_possible_cell_size <= 32, "Heap Cell tracking uses too much data!");
+    m_size_based_cell_allocators.append(make<CellAllocator>(64));
+    m_size_based_cell_allocators.append(make<CellAllocator>(96));
+    m_size_based_cell_allocators.append(make<CellAllocator>(128));
+    m_size_based_cell_allocators.append(make<CellAllocator>(256));
+    m_size_based_cell_allocators.append(make<CellAllocator>(512));
+    m_size_based_cell_allocators.append(make<CellAllocator>(1024));
+    m_size_based_cell_allocators.append(make<CellAllocator>(3072));
+}
+
+Heap::~Heap()
+{
+    vm().string_cache().clear();
+    vm().byte_string_cache().clear();
+    collect_garbage(CollectionType::CollectEverything);
+}
+
+void Heap::will_allocate(size_t size)
+{
+    if (should_collect_on_every_allocation()) {
+        m_allocated_bytes_since_last_gc = 0;
+        collect_garbage();
+    } else if (m_incremental_marking_visitor) {
+        m_allocated_bytes_since_incremental_marking_started += size;
+        if (!m_gc_deferrals && m_allocated_bytes_since_last_gc + size > INCREMENTAL_MARKING_SLICE_BYTES) {
+            m_allocated_bytes_since_last_gc = 0;
+            perform_incremental_marking_slice();
+        }
+    } else if (m_allocated_bytes_since_last_gc + size > (m_generational_collection_enabled ? m_gc_bytes_threshold / 4 : m_gc_bytes_threshold)) {
+        auto collection_type = collection_type_for_allocation_pressure();
+        if (collection_type == CollectionType::CollectGarbage && m_incremental_marking_enabled) {
+            // NOTE: If GC is deferred, we'll try again on the next allocation.
+            if (!m_gc_deferrals) {
+                m_allocated_bytes_since_last_gc = 0;
+                start_incremental_marking();
+            }
+        } else {
+            m_allocated_bytes_since_last_gc = 0;
+            collect_garbage_impl(collection_type, SweepMode::Lazy);
+        }
+    }
+
+    m_allocated_bytes_since_last_gc += size;
+}
+
+Heap::CollectionType Heap::collection_type_for_allocation_pressure() const
+{
+    if (!m_generational_collection_enabled)
+        return CollectionType::CollectGarbage;
+    if (m_live_cell_bytes > m_live_cell_bytes_after_last_major_gc + m_gc_bytes_threshold)
+        return CollectionType::CollectGarbage;
+    return CollectionType::CollectYoungGarbage;
+}
+
+void Heap::set_generational_collection_enabled(bool enabled)
+{
+    VERIFY(!m_collecting_garbage);
+    VERIFY(!m_incremental_marking_visitor);
+    if (m_generational_collection_enabled == enabled)
+        return;
+    m_generational_collection_enabled = enabled;
+
+    // Survivors keep their mark bit in generational mode, which regular collections don't expect.
+    if (!enabled) {
+        clear_all_marks();
+        forget_remembered_cells();
+    }
+}
+
 class GraphConstructorVisitor final : public Cell::Visitor {
 public:
     explicit GraphConstructorVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
@@ -261,6 +380,11 @@ AK::JsonObject Heap::dump_graph()
 }
 
 void Heap::collect_garbage(CollectionType collection_type, bool print_report)
+{
+    collect_garbage_impl(collection_type, SweepMode::Eager, print_report);
+}
+
+void Heap::collect_garbage_impl(CollectionType collection_type, SweepMode sweep_mode, bool print_report)
 {
     VERIFY(!m_collecting_garbage);
     TemporaryChange change(m_collecting_garbage, true);
@@ -270,21 +394,114 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    Core::ElapsedTimer collection_measurement_timer(Core::TimerType::Precise);
+    collection_measurement_timer.start();
 
-    if (collection_type == CollectionType::CollectGarbage) {
+    // A minor collection can't run while the old generation is being marked, so finish that instead.
+    if (collection_type == CollectionType::CollectYoungGarbage && (!m_generational_collection_enabled || m_incremental_marking_visitor))
+        collection_type = CollectionType::CollectGarbage;
+
+    auto pause_kind = collection_type == CollectionType::CollectYoungGarbage ? PauseKind::MinorCollection : PauseKind::MajorCollection;
+
+    if (collection_type == CollectionType::CollectEverything) {
+        // Cells marked by an abandoned incremental marking pass would otherwise survive, whatever the collector mode.
+        bool did_abandon_incremental_marking = m_incremental_marking_visitor;
+        m_incremental_marking_visitor = nullptr;
+        sweep_all_pending_blocks();
+        if (m_generational_collection_enabled || did_abandon_incremental_marking)
+            clear_all_marks();
+        forget_remembered_cells();
+    } else {
         if (m_gc_deferrals) {
+            if (!m_should_gc_when_deferral_ends || collection_type == CollectionType::CollectGarbage)
+                m_deferred_collection_type = collection_type;
             m_should_gc_when_deferral_ends = true;
             return;
         }
-        HashMap<Cell*, HeapRoot> roots;
-        gather_roots(roots);
-        mark_live_cells(roots);
+        if (m_incremental_marking_visitor) {
+            finish_incremental_marking();
+            pause_kind = PauseKind::IncrementalMarkingFinish;
+        } else {
+            sweep_all_pending_blocks();
+            if (collection_type == CollectionType::CollectGarbage && m_generational_collection_enabled)
+                clear_all_marks();
+            HashMap<Cell*, HeapRoot> roots;
+            gather_roots(roots);
+            mark_live_cells(roots, collection_type);
+        }
     }
     finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    sweep_dead_cells(collection_type, sweep_mode, pause_kind, print_report, collection_measurement_timer);
+}
+
+void Heap::start_incremental_marking()
+{
+    VERIFY(!m_collecting_garbage);
+    VERIFY(!m_incremental_marking_visitor);
+    VERIFY(!m_gc_deferrals);
+    TemporaryChange change(m_collecting_garbage, true);
+
+    Core::ElapsedTimer timer(Core::TimerType::Precise);
+    timer.start();
+
+    sweep_all_pending_blocks();
+    if (m_generational_collection_enabled)
+        clear_all_marks();
+
+    // From here on, write barriers remember every marked cell that gets a reference to an unmarked cell stored into it.
+    forget_remembered_cells();
+
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    m_incremental_marking_visitor = make<MarkingVisitor>(*this, roots);
+    m_allocated_bytes_since_incremental_marking_started = 0;
+
+    record_pause(PauseKind::IncrementalMarkingSlice, timer.elapsed_time());
+}
+
+void Heap::perform_incremental_marking_slice()
+{
+    VERIFY(m_incremental_marking_visitor);
+    VERIFY(!m_gc_deferrals);
+
+    bool marking_is_done = false;
+    {
+        VERIFY(!m_collecting_garbage);
+        TemporaryChange change(m_collecting_garbage, true);
+
+        Core::ElapsedTimer timer(Core::TimerType::Precise);
+        timer.start();
+        marking_is_done = m_incremental_marking_visitor->mark_live_cells_until(MonotonicTime::now() + INCREMENTAL_MARKING_SLICE_TIME_BUDGET);
+        record_pause(PauseKind::IncrementalMarkingSlice, timer.elapsed_time());
+    }
+
+    // If the mutator allocates faster than we can mark, stop stretching the cycle out and finish it now.
+    if (marking_is_done || m_allocated_bytes_since_incremental_marking_started > m_gc_bytes_threshold)
+        collect_garbage_impl(CollectionType::CollectGarbage, SweepMode::Lazy);
+}
+
+void Heap::finish_incremental_marking()
+{
+    auto visitor = m_incremental_marking_visitor.release_nonnull();
+
+    // The mutator has been running since marking started, so anything it did to the roots or to already marked cells
+    // has to be looked at again. Cells allocated in the meantime are already marked.
+    // NOTE: This makes the final pause O(heap) rather than O(changes): the roots are gathered from scratch (including
+    //       the conservative stack scan), and finding the marked cells without write barriers walks every live cell.
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    visitor->visit_roots(roots);
+    visit_old_cells_that_may_point_to_unmarked_cells(*visitor);
+    forget_remembered_cells();
+
+    visitor->mark_all_live_cells();
+    unmark_uprooted_cells();
+}
+
+void Heap::did_allocate_cell_during_incremental_marking(Cell& cell)
+{
+    // The new cell survives this cycle, but whatever its constructor stored into it still has to be marked.
+    m_incremental_marking_visitor->visit(cell);
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -388,79 +605,69 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
     });
 }
 
-class MarkingVisitor final : public Cell::Visitor {
-public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
-        : m_heap(heap)
-    {
-        m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
-        m_heap.for_each_block([&](auto& block) {
-            m_all_live_heap_blocks.set(&block);
-            return IterationDecision::Continue;
-        });
-
-        for (auto* root : roots.keys()) {
-            visit(root);
-        }
-    }
-
-    virtual void visit_impl(Cell& cell) override
-    {
-        if (cell.is_marked())
-            return;
-        dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
+void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots, CollectionType collection_type)
+{
+    dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-        cell.set_marked(true);
-        m_work_queue.append(cell);
-    }
+    MarkingVisitor visitor(*this, roots);
 
-    virtual void visit_possible_values(ReadonlyBytes bytes) override
-    {
-        HashMap<FlatPtr, HeapRoot> possible_pointers;
+    // A minor collection never traces through old (still marked) cells, except for the ones that may point to young ones.
+    // NOTE: Finding those still walks the whole heap, so a minor collection is O(heap) as well. What it saves is
+    //       marking the old generation and tracing through the old cells that have write barriers.
+    if (collection_type == CollectionType::CollectYoungGarbage)
+        visit_old_cells_that_may_point_to_unmarked_cells(visitor);
 
-        auto* raw_pointer_sized_values = reinterpret_cast<FlatPtr const*>(bytes.data());
-        for (size_t i = 0; i < (bytes.size() / sizeof(FlatPtr)); ++i)
-            add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
+    forget_remembered_cells();
 
-        for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
-            if (cell->is_marked())
-                return;
-            if (cell->state() != Cell::State::Live)
-                return;
-            cell->set_marked(true);
-            m_work_queue.append(*cell);
-        });
-    }
-
-    void mark_all_live_cells()
-    {
-        while (!m_work_queue.is_empty()) {
-            m_work_queue.take_last()->visit_edges(*this);
-        }
-    }
+    visitor.mark_all_live_cells();
 
-private:
-    Heap& m_heap;
-    Vector<NonnullGCPtr<Cell>> m_work_queue;
-    HashTable<HeapBlock*> m_all_live_heap_blocks;
-    FlatPtr m_min_block_address;
-    FlatPtr m_max_block_address;
-};
+    unmark_uprooted_cells();
+}
 
-void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
+void Heap::visit_old_cells_that_may_point_to_unmarked_cells(MarkingVisitor& visitor)
 {
-    dbgln_if(HEAP_DEBUG, "mark_live_cells:");
+    // Marked cells are not visited again by the marking visitor, so unmarked cells that are only reachable from them
+    // have to be found here: through the remembered set for cells with write barriers, and by visiting every other
+    // marked cell.
+    // NOTE: Finding those other marked cells walks every live cell in the heap, so this is O(heap) no matter how many
+    //       cells have write barriers. Only the tracing through their edges is limited to the cells without them.
+    for (auto& cell : m_remembered_cells)
+        cell->visit_edges(visitor);
 
-    MarkingVisitor visitor(*this, roots);
-
-    visitor.mark_all_live_cells();
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (cell->is_marked() && !cell->has_write_barriers())
+                cell->visit_edges(visitor);
+        });
+        return IterationDecision::Continue;
+    });
+}
 
+void Heap::unmark_uprooted_cells()
+{
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
 
     m_uprooted_cells.clear();
 }
 
+void Heap::clear_all_marks()
+{
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_marked(false);
+        });
+        return IterationDecision::Continue;
+    });
+}
+
+void Heap::forget_remembered_cells()
+{
+    for (auto& cell : m_remembered_cells)
+        cell->set_remembered({}, false);
+    m_remembered_cells.clear();
+}
+
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 {
     if (!cell.overrides_must_survive_garbage_collection({}))
@@ -479,11 +686,12 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::sweep_dead_cells(CollectionType collection_type, SweepMode sweep_mode, PauseKind pause_kind, bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
     Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+    Vector<HeapBlock*, 32> blocks_to_sweep_lazily;
 
     size_t collected_cells = 0;
     size_t live_cells = 0;
@@ -492,21 +700,34 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
     for_each_block([&](auto& block) {
         bool block_has_live_cells = false;
+        bool block_has_cells_awaiting_sweep = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                block.deallocate(cell);
+                if (sweep_mode == SweepMode::Lazy) {
+                    // Make the cell look exactly like a swept one to everything but its CellAllocator.
+                    cell->revoke_weak_ptrs({});
+                    cell->set_state(Cell::State::Dead);
+                    cell->set_awaiting_sweep({});
+                    block_has_cells_awaiting_sweep = true;
+                } else {
+                    block.deallocate(cell);
+                }
                 ++collected_cells;
                 collected_cell_bytes += block.cell_size();
             } else {
-                cell->set_marked(false);
+                // In generational mode, surviving cells stay marked: that's what makes them old.
+                if (!m_generational_collection_enabled)
+                    cell->set_marked(false);
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
             }
         });
-        if (!block_has_live_cells)
+        if (block_has_cells_awaiting_sweep)
+            blocks_to_sweep_lazily.append(&block);
+        else if (!block_has_live_cells)
             empty_blocks.append(&block);
         else if (block_was_full != block.is_full())
             full_blocks_that_became_usable.append(&block);
@@ -526,6 +747,9 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         block->cell_allocator().block_did_become_usable({}, *block);
     }
 
+    for (auto* block : blocks_to_sweep_lazily)
+        block->cell_allocator().block_needs_sweep({}, *block);
+
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -533,10 +757,16 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
-    m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    m_live_cell_bytes = live_cell_bytes;
+    if (collection_type != CollectionType::CollectYoungGarbage) {
+        m_live_cell_bytes_after_last_major_gc = live_cell_bytes;
+        m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    }
+
+    Duration const time_spent = measurement_timer.elapsed_time();
+    record_pause(pause_kind, time_spent);
 
     if (print_report) {
-        Duration const time_spent = measurement_timer.elapsed_time();
         size_t live_block_count = 0;
         for_each_block([&](auto&) {
             ++live_block_count;
@@ -545,13 +775,95 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
+        dbgln("           Type: {}", collection_type == CollectionType::CollectYoungGarbage ? "Minor"sv : "Major"sv);
         dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
         dbgln("=============================================");
+        dump_pause_time_histograms();
+    }
+}
+
+void Heap::sweep_block(HeapBlock& block)
+{
+    VERIFY(block.is_pending_sweep());
+    block.set_pending_sweep(false);
+
+    bool block_has_live_cells = false;
+    bool block_was_full = block.is_full();
+    block.for_each_cell([&](Cell* cell) {
+        if (cell->is_awaiting_sweep())
+            block.deallocate(cell);
+        else if (cell->state() == Cell::State::Live)
+            block_has_live_cells = true;
+    });
+
+    if (!block_has_live_cells)
+        block.cell_allocator().block_did_become_empty({}, block);
+    else if (block_was_full != block.is_full())
+        block.cell_allocator().block_did_become_usable({}, block);
+}
+
+void Heap::sweep_block_lazily(Badge<CellAllocator>, HeapBlock& block)
+{
+    Core::ElapsedTimer timer(Core::TimerType::Precise);
+    timer.start();
+    sweep_block(block);
+    record_pause(PauseKind::LazySweep, timer.elapsed_time());
+}
+
+void Heap::sweep_all_pending_blocks()
+{
+    for (auto& allocator : m_all_cell_allocators) {
+        while (auto* block = allocator.take_block_pending_sweep({}))
+            sweep_block(*block);
+    }
+}
+
+void Heap::PauseTimeHistogram::record(Duration pause)
+{
+    size_t bucket = 0;
+    for (auto limit = 1'000; bucket < bucket_count - 1 && pause.to_microseconds() >= limit; limit *= 2)
+        ++bucket;
+    ++buckets[bucket];
+    ++pause_count;
+    total_time += pause;
+    if (pause > longest_pause)
+        longest_pause = pause;
+}
+
+void Heap::record_pause(PauseKind kind, Duration pause)
+{
+    m_pause_time_histograms[to_underlying(kind)].record(pause);
+}
+
+void Heap::dump_pause_time_histograms() const
+{
+    static constexpr AK::Array pause_kind_names {
+        "Minor"sv,
+        "Major"sv,
+        "Marking slice"sv,
+        "Marking finish"sv,
+        "Lazy sweep"sv,
+    };
+    static_assert(pause_kind_names.size() == to_underlying(PauseKind::__Count));
+
+    dbgln("Pause time histogram (number of pauses shorter than N ms)");
+    dbgln("                    <1    <2    <4    <8   <16   <32   <64  >=64   Longest     Total");
+    for (size_t i = 0; i < m_pause_time_histograms.size(); ++i) {
+        auto const& histogram = m_pause_time_histograms[i];
+        if (!histogram.pause_count)
+            continue;
+        StringBuilder builder;
+        builder.appendff("{:>15}:", pause_kind_names[i]);
+        for (auto count : histogram.buckets)
+            builder.appendff(" {:>5}", count);
+        builder.appendff(" {:>6} us {:>6} ms", histogram.longest_pause.to_microseconds(), histogram.total_time.to_milliseconds());
+        dbgln("{}", builder.string_view());
     }
+    dbgln("=============================================");
 }
 
 void Heap::defer_gc()
@@ -566,7 +878,7 @@ void Heap::undefer_gc()
 
     if (!m_gc_deferrals) {
         if (m_should_gc_when_deferral_ends)
-            collect_garbage();
+            collect_garbage(m_deferred_collection_type);
         m_should_gc_when_deferral_ends = false;
     }
 }
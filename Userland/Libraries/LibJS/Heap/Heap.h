@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -28,6 +31,11 @@
 
 namespace JS {
 
+class MarkingVisitor;
+
+template<typename T>
+concept CellHasWriteBarriers = IsSame<typename T::WriteBarrieredCellType, T>;
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -43,6 +51,10 @@ public:
         defer_gc();
         new (memory) T(forward<Args>(args)...);
         undefer_gc();
+        if constexpr (CellHasWriteBarriers<T>)
+            memory->set_has_write_barriers({});
+        if (m_incremental_marking_visitor) [[unlikely]]
+            did_allocate_cell_during_incremental_marking(*memory);
         return *static_cast<T*>(memory);
     }
 
@@ -53,6 +65,10 @@ public:
         defer_gc();
         new (memory) T(forward<Args>(args)...);
         undefer_gc();
+        if constexpr (CellHasWriteBarriers<T>)
+            memory->set_has_write_barriers({});
+        if (m_incremental_marking_visitor) [[unlikely]]
+            did_allocate_cell_during_incremental_marking(*memory);
         auto* cell = static_cast<T*>(memory);
         memory->initialize(realm);
         return *cell;
@@ -60,6 +76,7 @@ public:
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGarbage,
         CollectEverything,
     };
 
@@ -69,6 +86,16 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    bool is_generational_collection_enabled() const { return m_generational_collection_enabled; }
+    void set_generational_collection_enabled(bool);
+
+    bool is_incremental_marking_enabled() const { return m_incremental_marking_enabled; }
+    void set_incremental_marking_enabled(bool b) { m_incremental_marking_enabled = b; }
+    bool is_incremental_marking_in_progress() const { return m_incremental_marking_visitor.ptr() != nullptr; }
+    size_t completed_incremental_marking_count() const { return m_pause_time_histograms[to_underlying(PauseKind::IncrementalMarkingFinish)].pause_count; }
+
+    void did_remember_cell(Badge<Cell>, Cell& cell) { m_remembered_cells.append(cell); }
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -85,6 +112,7 @@ public:
     void did_destroy_execution_context(Badge<ExecutionContext>, ExecutionContext&);
 
     void register_cell_allocator(Badge<CellAllocator>, CellAllocator&);
+    void sweep_block_lazily(Badge<CellAllocator>, HeapBlock&);
 
     void uproot_cell(Cell* cell);
 
@@ -96,6 +124,34 @@ private:
     void defer_gc();
     void undefer_gc();
 
+    enum class SweepMode {
+        Eager,
+        // Dead cells are finalized and made unreachable right away, but only destroyed once their CellAllocator
+        // runs out of usable blocks, or before the next collection starts.
+        Lazy,
+    };
+
+    enum class PauseKind : u8 {
+        MinorCollection,
+        MajorCollection,
+        IncrementalMarkingSlice,
+        IncrementalMarkingFinish,
+        LazySweep,
+        __Count,
+    };
+
+    struct PauseTimeHistogram {
+        // Bucket N counts pauses shorter than 2^N ms, the last bucket counts everything longer.
+        static constexpr size_t bucket_count = 8;
+
+        void record(Duration);
+
+        AK::Array<size_t, bucket_count> buckets {};
+        size_t pause_count { 0 };
+        Duration total_time;
+        Duration longest_pause;
+    };
+
     static bool cell_must_survive_garbage_collection(Cell const&);
 
     template<typename T>
@@ -111,14 +167,31 @@ private:
     }
 
     void will_allocate(size_t);
+    CollectionType collection_type_for_allocation_pressure() const;
+
+    void collect_garbage_impl(CollectionType, SweepMode, bool print_report = false);
+
+    void start_incremental_marking();
+    void perform_incremental_marking_slice();
+    void finish_incremental_marking();
+    void did_allocate_cell_during_incremental_marking(Cell&);
 
     void find_min_and_max_block_addresses(FlatPtr& min_address, FlatPtr& max_address);
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
-    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
+    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells, CollectionType);
+    void visit_old_cells_that_may_point_to_unmarked_cells(MarkingVisitor&);
+    void unmark_uprooted_cells();
+    void clear_all_marks();
+    void forget_remembered_cells();
     void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void sweep_dead_cells(CollectionType, SweepMode, PauseKind, bool print_report, Core::ElapsedTimer const&);
+    void sweep_block(HeapBlock&);
+    void sweep_all_pending_blocks();
+
+    void record_pause(PauseKind, Duration);
+    void dump_pause_time_histograms() const;
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -144,7 +217,23 @@ private:
     size_t m_gc_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
     size_t m_allocated_bytes_since_last_gc { 0 };
 
+    // In generational mode, a minor collection runs every time a quarter of m_gc_bytes_threshold has been allocated,
+    // and a major collection once the old generation has grown by m_gc_bytes_threshold since the last major one.
+    size_t m_live_cell_bytes { 0 };
+    size_t m_live_cell_bytes_after_last_major_gc { 0 };
+
+    // While incremental marking is in progress, a marking slice runs every time this many bytes have been allocated.
+    // If the old generation has grown by m_gc_bytes_threshold before marking is done, it is finished in one go.
+    static constexpr size_t INCREMENTAL_MARKING_SLICE_BYTES { 256 * 1024 };
+    static constexpr Duration INCREMENTAL_MARKING_SLICE_TIME_BUDGET = Duration::from_milliseconds(2);
+    size_t m_allocated_bytes_since_incremental_marking_started { 0 };
+    OwnPtr<MarkingVisitor> m_incremental_marking_visitor;
+
+    AK::Array<PauseTimeHistogram, to_underlying(PauseKind::__Count)> m_pause_time_histograms;
+
     bool m_should_collect_on_every_allocation { false };
+    bool m_generational_collection_enabled { true };
+    bool m_incremental_marking_enabled { true };
 
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
     CellAllocator::List m_all_cell_allocators;
@@ -156,8 +245,12 @@ private:
 
     Vector<GCPtr<Cell>> m_uprooted_cells;
 
+    // Old cells with write barriers that had a reference to a young cell stored into them since the last collection.
+    Vector<NonnullGCPtr<Cell>> m_remembered_cells;
+
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
+    CollectionType m_deferred_collection_type { CollectionType::CollectGarbage };
 
     bool m_collecting_garbage { false };
 };
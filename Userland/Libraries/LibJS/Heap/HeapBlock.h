@@ -92,6 +92,9 @@ public:
 
     CellAllocator& cell_allocator() { return m_cell_allocator; }
 
+    bool is_pending_sweep() const { return m_pending_sweep; }
+    void set_pending_sweep(bool b) { m_pending_sweep = b; }
+
 private:
     HeapBlock(Heap&, CellAllocator&, size_t cell_size);
 
@@ -111,6 +114,7 @@ private:
     CellAllocator& m_cell_allocator;
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
+    bool m_pending_sweep { false };
     GCPtr<FreelistEntry> m_freelist;
     alignas(__BIGGEST_ALIGNMENT__) u8 m_storage[];
 
@@ -157,7 +157,7 @@ ThrowCompletionOr<bool> Array::set_length(PropertyDescriptor const& property_des
     // a. Let deleteSucceeded be ! A.[[Delete]](P).
     // b. If deleteSucceeded is false, then
     // i. Set newLenDesc.[[Value]] to ! ToUint32(P) + 1𝔽.
-    bool success = indexed_properties().set_array_like_size(new_length);
+    bool success = mutable_indexed_properties().set_array_like_size(new_length);
 
     // ii. If newWritable is false, set newLenDesc.[[Writable]] to false.
     // iii. Perform ! OrdinaryDefineOwnProperty(A, "length", newLenDesc).
@@ -49,6 +49,10 @@ bool FinalizationRegistry::remove_by_token(Cell& unregister_token)
 
 void FinalizationRegistry::remove_dead_cells(Badge<Heap>)
 {
+    // NOTE: If we're dead ourselves and just waiting to be swept, there's nobody left to run the cleanup job for.
+    if (state() != Cell::State::Live)
+        return;
+
     auto any_cells_were_removed = false;
     for (auto& record : m_records) {
         if (!record.target || record.target->state() == Cell::State::Live)
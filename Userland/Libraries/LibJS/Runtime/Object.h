@@ -56,6 +56,7 @@ struct CacheablePropertyMetadata {
 class Object : public Cell {
     JS_CELL(Object, Cell);
     JS_DECLARE_ALLOCATOR(Object);
+    JS_DECLARE_WRITE_BARRIERS(Object);
 
 public:
     static NonnullGCPtr<Object> create_prototype(Realm&, Object* prototype);
@@ -208,12 +209,37 @@ public:
 
     virtual void visit_edges(Cell::Visitor&) override;
 
+    using Cell::write_barrier;
+    ALWAYS_INLINE void write_barrier(Value value)
+    {
+        if (value.is_cell())
+            write_barrier(&value.as_cell());
+    }
+
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        write_barrier(value);
+    }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
-    IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    void put_indexed_direct(u32 index, Value value, PropertyAttributes attributes = default_attributes)
+    {
+        m_indexed_properties.put(index, value, attributes);
+        write_barrier(value);
+    }
+    void append_indexed_direct(Value value, PropertyAttributes attributes = default_attributes)
+    {
+        m_indexed_properties.append(value, attributes);
+        write_barrier(value);
+    }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        for (auto value : values)
+            write_barrier(value);
+        m_indexed_properties = IndexedProperties(move(values));
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
@@ -253,8 +279,15 @@ protected:
 
     bool m_is_typed_array { false };
 
+    // NOTE: Storing a value through this must be followed by write_barrier(), so prefer put_indexed_direct() and append_indexed_direct().
+    IndexedProperties& mutable_indexed_properties() { return m_indexed_properties; }
+
 private:
-    void set_shape(Shape& shape) { m_shape = &shape; }
+    void set_shape(Shape& shape)
+    {
+        m_shape = &shape;
+        write_barrier(&shape);
+    }
 
     Object* prototype() { return shape().prototype(); }
 
@@ -15,6 +15,7 @@ namespace JS {
 class Symbol final : public Cell {
     JS_CELL(Symbol, Cell);
     JS_DECLARE_ALLOCATOR(Symbol);
+    JS_DECLARE_WRITE_BARRIERS(Symbol);
 
 public:
     [[nodiscard]] static NonnullGCPtr<Symbol> create(VM&, Optional<String> description, bool is_global);
@@ -0,0 +1,25 @@
+test("values stored into old objects while the heap is being marked survive", () => {
+    const old = [];
+    for (let i = 0; i < 1000; ++i) old.push({ index: i, payload: null });
+
+    gc();
+
+    // Keep everything we allocate alive, so that the old generation grows enough to start incremental marking,
+    // and keep storing fresh objects into old ones until a marking cycle has run to completion.
+    const retained = [];
+    const markingCountBefore = completedIncrementalMarkingCount();
+    let round = 0;
+    for (; round < 1000 && completedIncrementalMarkingCount() === markingCountBefore; ++round) {
+        for (let i = 0; i < 1000; ++i) {
+            old[i].payload = { round, text: "payload " + i };
+            retained.push(old[i].payload);
+        }
+    }
+    expect(completedIncrementalMarkingCount()).toBeGreaterThan(markingCountBefore);
+
+    for (let i = 0; i < 1000; ++i) {
+        expect(old[i].index).toBe(i);
+        expect(old[i].payload.round).toBe(round - 1);
+        expect(old[i].payload.text).toBe("payload " + i);
+    }
+});
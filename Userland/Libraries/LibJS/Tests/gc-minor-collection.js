@@ -0,0 +1,56 @@
+test("young values stored into old objects survive a minor collection", () => {
+    const old = { object: {}, array: [] };
+
+    // Promote everything allocated so far to the old generation.
+    gc();
+
+    for (let i = 0; i < 1000; ++i) {
+        old.object["property" + i] = { value: i };
+        old.array.push({ value: i });
+        old.array[i + 1000] = "string " + i;
+    }
+    old.replaced = { value: "young" };
+    Object.setPrototypeOf(old.object, { inherited: "young" });
+
+    collectYoungGarbage();
+
+    for (let i = 0; i < 1000; ++i) {
+        expect(old.object["property" + i].value).toBe(i);
+        expect(old.array[i].value).toBe(i);
+        expect(old.array[i + 1000]).toBe("string " + i);
+    }
+    expect(old.replaced.value).toBe("young");
+    expect(old.object.inherited).toBe("young");
+});
+
+test("young values stored into old private fields survive a minor collection", () => {
+    class C {
+        #field = null;
+
+        set(value) {
+            this.#field = value;
+        }
+
+        get() {
+            return this.#field;
+        }
+    }
+
+    const old = new C();
+    gc();
+
+    old.set({ value: "young" });
+    collectYoungGarbage();
+
+    expect(old.get().value).toBe("young");
+});
+
+test("old objects unreachable from young ones are kept alive by minor collections", () => {
+    const old = { value: "old" };
+    gc();
+
+    collectYoungGarbage();
+    collectYoungGarbage();
+
+    expect(old.value).toBe("old");
+});
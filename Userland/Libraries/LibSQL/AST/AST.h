@@ -9,6 +9,7 @@
 #pragma once
 
 #include <AK/ByteString.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -300,7 +301,7 @@ private:
 struct ExecutionContext {
     NonnullRefPtr<Database> database;
     Statement const* statement { nullptr };
-    ReadonlySpan<Value> placeholder_values {};
+    Vector<Value> placeholder_values {};
     Tuple* current_row { nullptr };
 };
 
@@ -760,11 +761,15 @@ private:
 class Statement : public ASTNode {
 public:
     ResultOr<ResultSet> execute(AK::NonnullRefPtr<Database> database, ReadonlySpan<Value> placeholder_values = {}) const;
+    ResultOr<NonnullOwnPtr<ResultCursor>> open_cursor(AK::NonnullRefPtr<Database> database, Vector<Value> placeholder_values = {}) const;
 
     virtual ResultOr<ResultSet> execute(ExecutionContext&) const
     {
         return Result { SQLCommand::Unknown, SQLErrorCode::NotYetImplemented };
     }
+
+    // Statements that cannot be pipelined are executed in full, and the cursor walks the materialized result.
+    virtual ResultOr<NonnullOwnPtr<ResultCursor>> open_cursor(ExecutionContext) const;
 };
 
 class ErrorStatement final : public Statement {
@@ -1081,6 +1086,7 @@ public:
     Vector<NonnullRefPtr<OrderingTerm>> const& ordering_term_list() const { return m_ordering_term_list; }
     RefPtr<LimitClause> const& limit_clause() const { return m_limit_clause; }
     ResultOr<ResultSet> execute(ExecutionContext&) const override;
+    ResultOr<NonnullOwnPtr<ResultCursor>> open_cursor(ExecutionContext) const override;
 
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
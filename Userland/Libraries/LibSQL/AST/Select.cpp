@@ -4,10 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashMap.h>
 #include <AK/NumericLimits.h>
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
+#include <LibSQL/ResultCursor.h>
 #include <LibSQL/Row.h>
 
 namespace SQL::AST {
@@ -37,7 +39,666 @@ static ByteString result_column_name(ResultColumn const& column, size_t column_i
     return fallback_column_name();
 }
 
+namespace {
+
+struct Condition {
+    enum class Scope {
+        SingleTable,
+        Join,
+        Deferred,
+    };
+
+    NonnullRefPtr<Expression const> expression;
+    Scope scope { Scope::Deferred };
+    size_t table_index { 0 };
+};
+
+struct HashJoin {
+    size_t left_table_index { 0 };
+    size_t left_column_index { 0 };
+    size_t right_column_index { 0 };
+    SQLType type { SQLType::Null };
+};
+
+struct PlannedTable {
+    NonnullRefPtr<TableDef> table_def;
+    Vector<Row> rows;
+    Optional<HashJoin> hash_join;
+    HashMap<u32, Vector<size_t>> buckets;
+    Vector<size_t> unhashable_rows;
+};
+
+}
+
+static void split_conjunction(NonnullRefPtr<Expression const> expression, Vector<NonnullRefPtr<Expression const>>& conjuncts)
+{
+    // The parser doesn't know about operator precedence, so conjuncts other than plain column references or literals
+    // have to be parenthesized. A parenthesized expression is parsed as a chain of one expression, which on its own
+    // would evaluate to a tuple.
+    if (is<ChainedExpression>(*expression)) {
+        auto const& chained_expression = static_cast<ChainedExpression const&>(*expression);
+        if (chained_expression.expressions().size() == 1) {
+            split_conjunction(chained_expression.expressions().first(), conjuncts);
+            return;
+        }
+    }
+
+    if (is<BinaryOperatorExpression>(*expression)) {
+        auto const& binary_expression = static_cast<BinaryOperatorExpression const&>(*expression);
+        if (binary_expression.type() == BinaryOperator::And) {
+            split_conjunction(binary_expression.lhs(), conjuncts);
+            split_conjunction(binary_expression.rhs(), conjuncts);
+            return;
+        }
+    }
+
+    conjuncts.append(move(expression));
+}
+
+static Optional<size_t> column_index_in_table(TableDef const& table_def, ByteString const& column_name)
+{
+    auto const& columns = table_def.columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i]->name() == column_name)
+            return i;
+    }
+    return {};
+}
+
+static Vector<size_t> tables_for_column(ColumnNameExpression const& column, ReadonlySpan<PlannedTable> tables)
+{
+    Vector<size_t> matching_tables;
+    for (size_t i = 0; i < tables.size(); ++i) {
+        auto const& table_def = *tables[i].table_def;
+        if (!column.table_name().is_empty() && table_def.name() != column.table_name())
+            continue;
+        if (column_index_in_table(table_def, column.column_name()).has_value())
+            matching_tables.append(i);
+    }
+    return matching_tables;
+}
+
+// Marks every table the expression reads from. Returns false if the expression contains anything the planner does
+// not understand, in which case it must only be evaluated against fully joined rows.
+static bool collect_referenced_tables(Expression const& expression, ReadonlySpan<PlannedTable> tables, Vector<bool>& referenced)
+{
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<BlobLiteral>(expression)
+        || is<BooleanLiteral>(expression) || is<NullLiteral>(expression) || is<Placeholder>(expression))
+        return true;
+
+    if (is<ColumnNameExpression>(expression)) {
+        auto matching_tables = tables_for_column(static_cast<ColumnNameExpression const&>(expression), tables);
+        if (matching_tables.is_empty())
+            return false;
+        for (auto table_index : matching_tables)
+            referenced[table_index] = true;
+        return true;
+    }
+
+    if (is<UnaryOperatorExpression>(expression) || is<CastExpression>(expression) || is<CollateExpression>(expression) || is<NullExpression>(expression))
+        return collect_referenced_tables(*static_cast<NestedExpression const&>(expression).expression(), tables, referenced);
+
+    if (is<BetweenExpression>(expression)) {
+        if (!collect_referenced_tables(*static_cast<BetweenExpression const&>(expression).expression(), tables, referenced))
+            return false;
+    } else if (is<MatchExpression>(expression)) {
+        auto const& escape = static_cast<MatchExpression const&>(expression).escape();
+        if (escape && !collect_referenced_tables(*escape, tables, referenced))
+            return false;
+    } else if (!is<BinaryOperatorExpression>(expression) && !is<IsExpression>(expression)) {
+        if (is<InChainedExpression>(expression)) {
+            auto const& in_expression = static_cast<InChainedExpression const&>(expression);
+            return collect_referenced_tables(*in_expression.expression(), tables, referenced)
+                && collect_referenced_tables(*in_expression.expression_chain(), tables, referenced);
+        }
+
+        if (is<ChainedExpression>(expression)) {
+            for (auto const& element : static_cast<ChainedExpression const&>(expression).expressions()) {
+                if (!collect_referenced_tables(*element, tables, referenced))
+                    return false;
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    auto const& nested = static_cast<NestedDoubleExpression const&>(expression);
+    return collect_referenced_tables(*nested.lhs(), tables, referenced)
+        && collect_referenced_tables(*nested.rhs(), tables, referenced);
+}
+
+static Condition classify_condition(NonnullRefPtr<Expression const> expression, ReadonlySpan<PlannedTable> tables)
+{
+    Condition condition { .expression = move(expression) };
+
+    Vector<bool> referenced;
+    referenced.resize(tables.size());
+    if (!collect_referenced_tables(*condition.expression, tables, referenced))
+        return condition;
+
+    auto first_table = referenced.find_first_index(true);
+    if (!first_table.has_value())
+        return condition;
+
+    auto last_table = *first_table;
+    for (size_t i = last_table; i < referenced.size(); ++i) {
+        if (referenced[i])
+            last_table = i;
+    }
+
+    condition.scope = (last_table == *first_table) ? Condition::Scope::SingleTable : Condition::Scope::Join;
+    condition.table_index = last_table;
+    return condition;
+}
+
+static Optional<HashJoin> find_hash_join(ReadonlySpan<Condition> conditions, ReadonlySpan<PlannedTable> tables, size_t table_index)
+{
+    struct ResolvedColumn {
+        size_t table_index { 0 };
+        size_t column_index { 0 };
+    };
+
+    auto resolve_column = [&](Expression const& expression) -> Optional<ResolvedColumn> {
+        if (!is<ColumnNameExpression>(expression))
+            return {};
+
+        auto const& column = static_cast<ColumnNameExpression const&>(expression);
+        auto matching_tables = tables_for_column(column, tables);
+        if (matching_tables.size() != 1)
+            return {};
+
+        auto column_index = column_index_in_table(*tables[matching_tables[0]].table_def, column.column_name());
+        return ResolvedColumn { matching_tables[0], *column_index };
+    };
+
+    for (auto const& condition : conditions) {
+        if (condition.scope != Condition::Scope::Join || condition.table_index != table_index)
+            continue;
+        if (!is<BinaryOperatorExpression>(*condition.expression))
+            continue;
+
+        auto const& equality = static_cast<BinaryOperatorExpression const&>(*condition.expression);
+        if (equality.type() != BinaryOperator::Equals)
+            continue;
+
+        auto lhs = resolve_column(*equality.lhs());
+        auto rhs = resolve_column(*equality.rhs());
+        if (!lhs.has_value() || !rhs.has_value())
+            continue;
+        if (lhs->table_index == table_index)
+            swap(lhs, rhs);
+        if (rhs->table_index != table_index || lhs->table_index >= table_index)
+            continue;
+
+        auto left_type = tables[lhs->table_index].table_def->columns()[lhs->column_index]->type();
+        auto right_type = tables[table_index].table_def->columns()[rhs->column_index]->type();
+
+        // Only types whose hashes agree with Value::compare() can be bucketed. Floats cannot be hashed at all.
+        if (left_type != right_type || (left_type != SQLType::Text && left_type != SQLType::Integer && left_type != SQLType::Boolean))
+            continue;
+
+        return HashJoin {
+            .left_table_index = lhs->table_index,
+            .left_column_index = lhs->column_index,
+            .right_column_index = rhs->column_index,
+            .type = left_type,
+        };
+    }
+
+    return {};
+}
+
+static size_t column_offset_of(ReadonlySpan<PlannedTable> tables, size_t table_index)
+{
+    // Joined rows start with the "__unity__" column.
+    size_t offset = 1;
+    for (size_t i = 0; i < table_index; ++i)
+        offset += tables[i].table_def->columns().size();
+    return offset;
+}
+
+static ResultOr<bool> row_matches_conditions(ExecutionContext& context, Tuple& row, ReadonlySpan<Condition> conditions, Optional<size_t> table_index, Condition::Scope scope)
+{
+    for (auto const& condition : conditions) {
+        if (condition.scope != scope)
+            continue;
+        if (table_index.has_value() && condition.table_index != *table_index)
+            continue;
+
+        context.current_row = &row;
+        auto result = TRY(condition.expression->evaluate(context)).to_bool();
+        if (!result.has_value() || !result.value())
+            return false;
+    }
+
+    return true;
+}
+
+// The driving table is read this many (matching) rows at a time.
+static constexpr size_t driving_rows_per_batch = 64;
+
+// Tuple's constructor fills in a default value for every element of the descriptor, which append() would then add to.
+static Tuple make_empty_tuple(NonnullRefPtr<TupleDescriptor> const& descriptor)
+{
+    Tuple tuple(descriptor);
+    tuple.clear();
+    return tuple;
+}
+
+static void append_values(Tuple& tuple, Tuple const& values)
+{
+    for (size_t i = 0; i < values.size(); ++i)
+        tuple.append(values[i]);
+}
+
+namespace {
+
+// The operators of a SELECT pipeline. Each one pulls rows from its input on demand, so rows flow through the pipeline
+// one at a time and nothing is read from the database before it is needed.
+class RowSource {
+public:
+    virtual ~RowSource() = default;
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) = 0;
+};
+
+// Scans the first table in the FROM clause and joins its rows against the remaining tables. Those are read and filtered
+// up front, with hash tables built for equi-joins. Tables are joined left-deep in FROM order: conditions that only
+// reference a single table are applied while scanning that table, and conditions spanning several tables are applied as
+// soon as the last of them has been joined.
+class JoinSource final : public RowSource {
+public:
+    static ResultOr<NonnullOwnPtr<RowSource>> create(ExecutionContext&, Vector<PlannedTable>, Vector<Condition>);
+    virtual ~JoinSource() override;
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    JoinSource(NonnullRefPtr<Database> database, Vector<PlannedTable> tables, Vector<Condition> conditions, Vector<NonnullRefPtr<TupleDescriptor>> stage_descriptors)
+        : m_database(move(database))
+        , m_tables(move(tables))
+        , m_conditions(move(conditions))
+        , m_stage_descriptors(move(stage_descriptors))
+        , m_next_block_index(m_tables.is_empty() ? 0 : m_tables.first().table_def->block_index())
+    {
+        // The scan of the driving table may be spread over several calls, with other statements executed in between.
+        if (m_next_block_index != 0) {
+            m_database->pin_storage();
+            m_has_pinned_storage = true;
+        }
+    }
+
+    ErrorOr<void> unpin_storage();
+    ResultOr<void> read_next_batch(ExecutionContext&);
+    ResultOr<void> join_next_row(ExecutionContext&);
+    ResultOr<Vector<Tuple>> join_with_table(ExecutionContext&, Vector<Tuple> const& rows, size_t table_index);
+
+    NonnullRefPtr<Database> m_database;
+    bool m_has_pinned_storage { false };
+
+    Vector<PlannedTable> m_tables;
+    Vector<Condition> m_conditions;
+
+    // Descriptors of the rows produced after joining each table. The first one only holds the "__unity__" column.
+    Vector<NonnullRefPtr<TupleDescriptor>> m_stage_descriptors;
+
+    Block::Index m_next_block_index { 0 };
+    bool m_exhausted { false };
+
+    // Rows of the driving table are only joined once they're needed, so that rows deleted in the meantime are skipped.
+    Vector<Row> m_driving_rows;
+    size_t m_next_driving_row { 0 };
+
+    // The joined rows for the last driving row.
+    Vector<Tuple> m_pending_rows;
+    size_t m_next_pending_row { 0 };
+};
+
+ResultOr<NonnullOwnPtr<RowSource>> JoinSource::create(ExecutionContext& context, Vector<PlannedTable> tables, Vector<Condition> conditions)
+{
+    for (size_t table_index = 1; table_index < tables.size(); ++table_index) {
+        auto& table = tables[table_index];
+
+        auto table_rows = TRY(context.database->select_all(*table.table_def));
+        for (auto& table_row : table_rows) {
+            if (TRY(row_matches_conditions(context, table_row, conditions, table_index, Condition::Scope::SingleTable)))
+                TRY(table.rows.try_append(move(table_row)));
+        }
+
+        table.hash_join = find_hash_join(conditions, tables, table_index);
+        if (!table.hash_join.has_value())
+            continue;
+
+        for (size_t row_index = 0; row_index < table.rows.size(); ++row_index) {
+            auto const& value = table.rows[row_index][table.hash_join->right_column_index];
+            if (value.is_null())
+                continue;
+
+            if (value.type() == table.hash_join->type)
+                TRY(table.buckets.ensure(value.hash()).try_append(row_index));
+            else
+                TRY(table.unhashable_rows.try_append(row_index));
+        }
+    }
+
+    Vector<NonnullRefPtr<TupleDescriptor>> stage_descriptors;
+    TRY(stage_descriptors.try_ensure_capacity(tables.size() + 1));
+    for (size_t stage = 0; stage <= tables.size(); ++stage) {
+        auto descriptor = adopt_ref(*new TupleDescriptor);
+        descriptor->empend("__unity__"sv);
+        for (size_t table_index = 0; table_index < stage; ++table_index)
+            descriptor->extend(tables[table_index].table_def->to_tuple_descriptor());
+        stage_descriptors.unchecked_append(move(descriptor));
+    }
+
+    return TRY(adopt_nonnull_own_or_enomem(new (nothrow) JoinSource(context.database, move(tables), move(conditions), move(stage_descriptors))));
+}
+
+JoinSource::~JoinSource()
+{
+    if (auto result = unpin_storage(); result.is_error())
+        warnln("~JoinSource: {}", result.error());
+}
+
+ErrorOr<void> JoinSource::unpin_storage()
+{
+    if (!m_has_pinned_storage)
+        return {};
+    m_has_pinned_storage = false;
+    return m_database->unpin_storage();
+}
+
+ResultOr<Optional<Tuple>> JoinSource::next(ExecutionContext& context)
+{
+    while (m_next_pending_row >= m_pending_rows.size()) {
+        if (m_exhausted)
+            return Optional<Tuple> {};
+        TRY(join_next_row(context));
+    }
+
+    return m_pending_rows[m_next_pending_row++];
+}
+
+ResultOr<void> JoinSource::read_next_batch(ExecutionContext& context)
+{
+    auto& driving_table = *m_tables.first().table_def;
+
+    m_driving_rows.clear();
+    m_next_driving_row = 0;
+    while (m_driving_rows.size() < driving_rows_per_batch && m_next_block_index != 0) {
+        auto row = context.database->read_row(driving_table, m_next_block_index);
+        m_next_block_index = row.next_block_index();
+
+        if (TRY(row_matches_conditions(context, row, m_conditions, 0, Condition::Scope::SingleTable)))
+            TRY(m_driving_rows.try_append(move(row)));
+    }
+    return {};
+}
+
+ResultOr<void> JoinSource::join_next_row(ExecutionContext& context)
+{
+    m_pending_rows.clear();
+    m_next_pending_row = 0;
+
+    if (m_tables.is_empty()) {
+        auto unity = make_empty_tuple(m_stage_descriptors[0]);
+        unity.append(Value { true });
+        m_pending_rows.append(move(unity));
+        m_exhausted = true;
+        return {};
+    }
+
+    if (m_next_driving_row >= m_driving_rows.size())
+        TRY(read_next_batch(context));
+
+    if (m_next_driving_row >= m_driving_rows.size()) {
+        // Storage stays pinned until the buffered rows are used up, as that's what lets us tell which ones were deleted.
+        m_exhausted = true;
+        TRY(unpin_storage());
+        return {};
+    }
+
+    auto const& row = m_driving_rows[m_next_driving_row++];
+
+    // The cursor sees the table as it is when each row is reached: rows deleted by statements executed in between
+    // are skipped, even if they were read already. Rows inserted since the scan started are never reached, as they
+    // are linked in ahead of it.
+    if (context.database->was_removed_while_pinned(row.block_index()))
+        return {};
+
+    Vector<Tuple> rows;
+    auto joined_row = make_empty_tuple(m_stage_descriptors[1]);
+    joined_row.append(Value { true });
+    append_values(joined_row, row);
+    TRY(rows.try_append(move(joined_row)));
+
+    for (size_t table_index = 1; table_index < m_tables.size() && !rows.is_empty(); ++table_index)
+        rows = TRY(join_with_table(context, rows, table_index));
+
+    m_pending_rows = move(rows);
+    return {};
+}
+
+ResultOr<Vector<Tuple>> JoinSource::join_with_table(ExecutionContext& context, Vector<Tuple> const& rows, size_t table_index)
+{
+    auto const& table = m_tables[table_index];
+    auto const& descriptor = m_stage_descriptors[table_index + 1];
+
+    Vector<Tuple> joined_rows;
+    auto append_joined_row = [&](Tuple const& left_row, Row const& table_row) -> ResultOr<void> {
+        auto joined_row = make_empty_tuple(descriptor);
+        append_values(joined_row, left_row);
+        append_values(joined_row, table_row);
+        if (TRY(row_matches_conditions(context, joined_row, m_conditions, table_index, Condition::Scope::Join)))
+            TRY(joined_rows.try_append(move(joined_row)));
+        return {};
+    };
+
+    if (!table.hash_join.has_value()) {
+        for (auto const& left_row : rows) {
+            for (auto const& table_row : table.rows)
+                TRY(append_joined_row(left_row, table_row));
+        }
+        return joined_rows;
+    }
+
+    auto const& hash_join = *table.hash_join;
+    auto left_column_index = column_offset_of(m_tables, hash_join.left_table_index) + hash_join.left_column_index;
+
+    for (auto const& left_row : rows) {
+        auto const& value = left_row[left_column_index];
+        if (value.is_null())
+            continue;
+
+        // Values of an unexpected type may still compare equal to any row, so they fall back to a plain nested loop.
+        // The join condition itself is always re-evaluated on the joined row.
+        if (value.type() != hash_join.type) {
+            for (auto const& table_row : table.rows)
+                TRY(append_joined_row(left_row, table_row));
+            continue;
+        }
+
+        if (auto bucket = table.buckets.get(value.hash()); bucket.has_value()) {
+            for (auto row_index : *bucket)
+                TRY(append_joined_row(left_row, table.rows[row_index]));
+        }
+        for (auto row_index : table.unhashable_rows)
+            TRY(append_joined_row(left_row, table.rows[row_index]));
+    }
+
+    return joined_rows;
+}
+
+class FilterSource final : public RowSource {
+public:
+    FilterSource(NonnullOwnPtr<RowSource> input, Vector<Condition> conditions)
+        : m_input(move(input))
+        , m_conditions(move(conditions))
+    {
+    }
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext& context) override
+    {
+        while (true) {
+            auto row = TRY(m_input->next(context));
+            if (!row.has_value() || TRY(row_matches_conditions(context, *row, m_conditions, {}, Condition::Scope::Deferred)))
+                return row;
+        }
+    }
+
+private:
+    NonnullOwnPtr<RowSource> m_input;
+    Vector<Condition> m_conditions;
+};
+
+// Evaluates the result columns for each row. With an ORDER BY clause nothing can be produced before every input row
+// has been seen, so the first pull projects the whole input into a sorted buffer.
+class ProjectSource final : public RowSource {
+public:
+    ProjectSource(NonnullOwnPtr<RowSource> input, Vector<NonnullRefPtr<ResultColumn const>> columns, Vector<NonnullRefPtr<OrderingTerm>> ordering_terms)
+        : m_input(move(input))
+        , m_columns(move(columns))
+        , m_ordering_terms(move(ordering_terms))
+        , m_descriptor(adopt_ref(*new TupleDescriptor))
+        , m_sorted_rows(SQLCommand::Select)
+    {
+    }
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext& context) override
+    {
+        if (m_ordering_terms.is_empty()) {
+            auto row = TRY(m_input->next(context));
+            if (!row.has_value())
+                return row;
+            return TRY(project(context, *row));
+        }
+
+        if (!m_did_sort) {
+            TRY(sort_input(context));
+            m_did_sort = true;
+        }
+
+        if (m_next_sorted_row >= m_sorted_rows.size())
+            return Optional<Tuple> {};
+        return m_sorted_rows[m_next_sorted_row++].row;
+    }
+
+private:
+    ResultOr<Tuple> project(ExecutionContext& context, Tuple& row)
+    {
+        context.current_row = &row;
+
+        auto projected_row = make_empty_tuple(m_descriptor);
+        for (auto& column : m_columns)
+            projected_row.append(TRY(column->expression()->evaluate(context)));
+        return projected_row;
+    }
+
+    ResultOr<void> sort_input(ExecutionContext& context)
+    {
+        auto sort_descriptor = adopt_ref(*new TupleDescriptor);
+        for (auto& term : m_ordering_terms)
+            sort_descriptor->append(TupleElementDescriptor { .order = term->order() });
+
+        while (true) {
+            auto row = TRY(m_input->next(context));
+            if (!row.has_value())
+                return {};
+
+            auto projected_row = TRY(project(context, *row));
+
+            auto sort_key = make_empty_tuple(sort_descriptor);
+            for (auto& term : m_ordering_terms)
+                sort_key.append(TRY(term->expression()->evaluate(context)));
+
+            m_sorted_rows.insert_row(projected_row, sort_key);
+        }
+    }
+
+    NonnullOwnPtr<RowSource> m_input;
+    Vector<NonnullRefPtr<ResultColumn const>> m_columns;
+    Vector<NonnullRefPtr<OrderingTerm>> m_ordering_terms;
+    NonnullRefPtr<TupleDescriptor> m_descriptor;
+
+    ResultSet m_sorted_rows;
+    size_t m_next_sorted_row { 0 };
+    bool m_did_sort { false };
+};
+
+// Stops pulling from its input as soon as the limit has been reached.
+class LimitSource final : public RowSource {
+public:
+    LimitSource(NonnullOwnPtr<RowSource> input, size_t offset, size_t limit)
+        : m_input(move(input))
+        , m_rows_to_skip(offset)
+        , m_rows_remaining(limit)
+    {
+    }
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext& context) override
+    {
+        for (; m_rows_to_skip > 0; --m_rows_to_skip) {
+            if (!TRY(m_input->next(context)).has_value())
+                return Optional<Tuple> {};
+        }
+
+        if (m_rows_remaining == 0)
+            return Optional<Tuple> {};
+
+        auto row = TRY(m_input->next(context));
+        if (row.has_value())
+            --m_rows_remaining;
+        return row;
+    }
+
+private:
+    NonnullOwnPtr<RowSource> m_input;
+    size_t m_rows_to_skip { 0 };
+    size_t m_rows_remaining { 0 };
+};
+
+class SelectCursor final : public ResultCursor {
+public:
+    SelectCursor(Vector<ByteString> column_names, NonnullRefPtr<Select const> select, ExecutionContext context, NonnullOwnPtr<RowSource> pipeline)
+        : ResultCursor(SQLCommand::Select, move(column_names))
+        , m_select(move(select))
+        , m_context(move(context))
+        , m_pipeline(move(pipeline))
+    {
+    }
+
+    virtual ResultOr<Optional<Tuple>> next() override
+    {
+        auto row = m_pipeline->next(m_context);
+        m_context.current_row = nullptr;
+        return row;
+    }
+
+private:
+    NonnullRefPtr<Select const> m_select;
+    ExecutionContext m_context;
+    NonnullOwnPtr<RowSource> m_pipeline;
+};
+
+}
+
 ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+{
+    auto cursor = TRY(open_cursor(context));
+    ResultSet result { SQLCommand::Select, cursor->column_names() };
+
+    while (true) {
+        auto row = TRY(cursor->next());
+        if (!row.has_value())
+            break;
+        result.insert_row(*row, {});
+    }
+
+    return result;
+}
+
+ResultOr<NonnullOwnPtr<ResultCursor>> Select::open_cursor(ExecutionContext context) const
 {
     Vector<NonnullRefPtr<ResultColumn const>> columns;
     Vector<ByteString> column_names;
@@ -83,15 +744,7 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         }
     }
 
-    ResultSet result { SQLCommand::Select, move(column_names) };
-
-    auto descriptor = adopt_ref(*new TupleDescriptor);
-    Tuple tuple(descriptor);
-    Vector<Tuple> rows;
-    descriptor->empend("__unity__"sv);
-    tuple.append(Value { true });
-    rows.append(tuple);
-
+    Vector<PlannedTable> tables;
     for (auto& table_descriptor : table_or_subquery_list()) {
         if (!table_descriptor->is_table())
             return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
@@ -100,60 +753,23 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         if (table_def->num_columns() == 0)
             continue;
 
-        auto old_descriptor_size = descriptor->size();
-        descriptor->extend(table_def->to_tuple_descriptor());
-
-        while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
-            auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
-
-            for (auto& table_row : table_rows) {
-                auto new_row = cartesian_row;
-                new_row.extend(table_row);
-                rows.append(new_row);
-            }
-        }
+        TRY(tables.try_append({ move(table_def), {} }));
     }
 
-    bool has_ordering { false };
-    auto sort_descriptor = adopt_ref(*new TupleDescriptor);
-    for (auto& term : m_ordering_term_list) {
-        sort_descriptor->append(TupleElementDescriptor { .order = term->order() });
-        has_ordering = true;
-    }
-    Tuple sort_key(sort_descriptor);
-
-    for (auto& row : rows) {
-        context.current_row = &row;
-
-        if (where_clause()) {
-            auto where_result = TRY(where_clause()->evaluate(context)).to_bool();
-            if (!where_result.has_value() || !where_result.value())
-                continue;
-        }
-
-        tuple.clear();
-
-        for (auto& col : columns) {
-            auto value = TRY(col->expression()->evaluate(context));
-            tuple.append(value);
-        }
-
-        if (has_ordering) {
-            sort_key.clear();
-            for (auto& term : m_ordering_term_list) {
-                auto value = TRY(term->expression()->evaluate(context));
-                sort_key.append(value);
-            }
-        }
+    Vector<Condition> conditions;
+    if (where_clause()) {
+        Vector<NonnullRefPtr<Expression const>> conjuncts;
+        split_conjunction(*where_clause(), conjuncts);
 
-        result.insert_row(tuple, sort_key);
+        TRY(conditions.try_ensure_capacity(conjuncts.size()));
+        for (auto& conjunct : conjuncts)
+            conditions.unchecked_append(classify_condition(move(conjunct), tables));
     }
 
-    if (m_limit_clause != nullptr) {
-        size_t limit_value = NumericLimits<size_t>::max();
-        size_t offset_value = 0;
+    size_t limit_value = NumericLimits<size_t>::max();
+    size_t offset_value = 0;
 
+    if (m_limit_clause != nullptr) {
         auto limit = TRY(m_limit_clause->limit_expression()->evaluate(context));
         if (!limit.is_null()) {
             auto limit_value_maybe = limit.to_int<size_t>();
@@ -173,11 +789,22 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
                 offset_value = offset_value_maybe.value();
             }
         }
+    }
 
-        result.limit(offset_value, limit_value);
+    Vector<Condition> deferred_conditions;
+    for (auto const& condition : conditions) {
+        if (condition.scope == Condition::Scope::Deferred)
+            TRY(deferred_conditions.try_append(condition));
     }
 
-    return result;
+    auto pipeline = TRY(JoinSource::create(context, move(tables), move(conditions)));
+    if (!deferred_conditions.is_empty())
+        pipeline = TRY(adopt_nonnull_own_or_enomem<RowSource>(new (nothrow) FilterSource(move(pipeline), move(deferred_conditions))));
+    pipeline = TRY(adopt_nonnull_own_or_enomem<RowSource>(new (nothrow) ProjectSource(move(pipeline), move(columns), m_ordering_term_list)));
+    if (m_limit_clause != nullptr)
+        pipeline = TRY(adopt_nonnull_own_or_enomem<RowSource>(new (nothrow) LimitSource(move(pipeline), offset_value, limit_value)));
+
+    return TRY(adopt_nonnull_own_or_enomem<ResultCursor>(new (nothrow) SelectCursor(move(column_names), *this, move(context), move(pipeline))));
 }
 
 }
@@ -7,13 +7,14 @@
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
+#include <LibSQL/ResultCursor.h>
 #include <LibSQL/Row.h>
 
 namespace SQL::AST {
 
 ResultOr<ResultSet> Statement::execute(AK::NonnullRefPtr<Database> database, ReadonlySpan<Value> placeholder_values) const
 {
-    ExecutionContext context { move(database), this, placeholder_values, nullptr };
+    ExecutionContext context { move(database), this, Vector<Value> { placeholder_values }, nullptr };
     auto result = TRY(execute(context));
 
     // FIXME: When transactional sessions are supported, don't auto-commit modifications.
@@ -22,4 +23,19 @@ ResultOr<ResultSet> Statement::execute(AK::NonnullRefPtr<Database> database, Rea
     return result;
 }
 
+ResultOr<NonnullOwnPtr<ResultCursor>> Statement::open_cursor(AK::NonnullRefPtr<Database> database, Vector<Value> placeholder_values) const
+{
+    return open_cursor(ExecutionContext { move(database), this, move(placeholder_values), nullptr });
+}
+
+ResultOr<NonnullOwnPtr<ResultCursor>> Statement::open_cursor(ExecutionContext context) const
+{
+    auto result = TRY(execute(context));
+
+    // FIXME: When transactional sessions are supported, don't auto-commit modifications.
+    TRY(context.database->commit());
+
+    return MaterializedResultCursor::create(move(result));
+}
+
 }
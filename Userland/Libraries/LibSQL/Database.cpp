@@ -180,10 +180,15 @@ ErrorOr<Vector<Row>> Database::select_all(TableDef& table)
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
     Vector<Row> ret;
     for (auto block_index = table.block_index(); block_index; block_index = ret.last().next_block_index())
-        ret.append(m_serializer.deserialize_block<Row>(block_index, table, block_index));
+        ret.append(read_row(table, block_index));
     return ret;
 }
 
+Row Database::read_row(TableDef& table, Block::Index block_index)
+{
+    return m_serializer.deserialize_block<Row>(block_index, table, block_index);
+}
+
 ErrorOr<Vector<Row>> Database::match(TableDef& table, Key const& key)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -223,7 +228,10 @@ ErrorOr<void> Database::remove(Row& row)
     auto& table = row.table();
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
 
-    TRY(m_heap->free_storage(row.block_index()));
+    if (m_storage_pin_count > 0)
+        TRY(m_blocks_to_free_when_unpinned.try_set(row.block_index()));
+    else
+        TRY(m_heap->free_storage(row.block_index()));
 
     if (table.block_index() == row.block_index()) {
         auto table_key = table.key();
@@ -249,6 +257,18 @@ ErrorOr<void> Database::remove(Row& row)
     return {};
 }
 
+ErrorOr<void> Database::unpin_storage()
+{
+    VERIFY(m_storage_pin_count > 0);
+    if (--m_storage_pin_count > 0)
+        return {};
+
+    auto blocks_to_free = move(m_blocks_to_free_when_unpinned);
+    for (auto block_index : blocks_to_free)
+        TRY(m_heap->free_storage(block_index));
+    return {};
+}
+
 ErrorOr<void> Database::update(Row& tuple)
 {
     VERIFY(m_table_cache.get(tuple.table().key().hash()).has_value());
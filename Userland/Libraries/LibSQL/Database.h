@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/ByteString.h>
+#include <AK/HashTable.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefPtr.h>
 #include <LibSQL/Forward.h>
@@ -42,11 +43,21 @@ public:
     ResultOr<NonnullRefPtr<TableDef>> get_table(ByteString const&, ByteString const&);
 
     ErrorOr<Vector<Row>> select_all(TableDef&);
+    Row read_row(TableDef&, Block::Index);
     ErrorOr<Vector<Row>> match(TableDef&, Key const&);
     ErrorOr<void> insert(Row&);
     ErrorOr<void> remove(Row&);
     ErrorOr<void> update(Row&);
 
+    // Cursors keep the block index of the next row they are going to read between calls. While storage is pinned,
+    // removed rows are still unlinked from their table, but their blocks are only freed once the last pin is released.
+    // This way, a cursor never reads a block that has been freed or reused in the meantime.
+    void pin_storage() { ++m_storage_pin_count; }
+    ErrorOr<void> unpin_storage();
+
+    // Lets cursors skip rows they had already read, but which have been removed since.
+    bool was_removed_while_pinned(Block::Index block_index) const { return m_blocks_to_free_when_unpinned.contains(block_index); }
+
 private:
     explicit Database(NonnullRefPtr<Heap>);
 
@@ -59,6 +70,9 @@ private:
 
     HashMap<u32, NonnullRefPtr<SchemaDef>> m_schema_cache;
     HashMap<u32, NonnullRefPtr<TableDef>> m_table_cache;
+
+    size_t m_storage_pin_count { 0 };
+    HashTable<Block::Index> m_blocks_to_free_when_unpinned;
 };
 
 }
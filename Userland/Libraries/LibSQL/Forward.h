@@ -19,6 +19,7 @@ class Key;
 class KeyPartDef;
 class Relation;
 class Result;
+class ResultCursor;
 class ResultSet;
 class Row;
 class SchemaDef;
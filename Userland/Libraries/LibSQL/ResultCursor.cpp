@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/ResultCursor.h>
+
+namespace SQL {
+
+ResultOr<NonnullOwnPtr<ResultCursor>> MaterializedResultCursor::create(ResultSet result)
+{
+    return TRY(adopt_nonnull_own_or_enomem(new (nothrow) MaterializedResultCursor(move(result))));
+}
+
+MaterializedResultCursor::MaterializedResultCursor(ResultSet result)
+    : ResultCursor(result.command(), result.column_names())
+    , m_result(move(result))
+{
+}
+
+ResultOr<Optional<Tuple>> MaterializedResultCursor::next()
+{
+    if (m_next_row >= m_result.size())
+        return Optional<Tuple> {};
+    return m_result[m_next_row++].row;
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/ResultSet.h>
+#include <LibSQL/Tuple.h>
+#include <LibSQL/Type.h>
+
+namespace SQL {
+
+/**
+ * A ResultCursor produces the rows of an executed statement one at a time.
+ * Statements that can be pipelined (like SELECT) only do as much work as is
+ * needed to produce the next row, so callers that stop pulling rows early
+ * never pay for the rest of the result.
+ */
+class ResultCursor {
+    AK_MAKE_NONCOPYABLE(ResultCursor);
+    AK_MAKE_NONMOVABLE(ResultCursor);
+
+public:
+    virtual ~ResultCursor() = default;
+
+    SQLCommand command() const { return m_command; }
+    Vector<ByteString> const& column_names() const { return m_column_names; }
+
+    // Returns an empty Optional once all rows have been produced.
+    virtual ResultOr<Optional<Tuple>> next() = 0;
+
+protected:
+    ResultCursor(SQLCommand command, Vector<ByteString> column_names)
+        : m_command(command)
+        , m_column_names(move(column_names))
+    {
+    }
+
+private:
+    SQLCommand m_command { SQLCommand::Unknown };
+    Vector<ByteString> m_column_names;
+};
+
+class MaterializedResultCursor final : public ResultCursor {
+public:
+    static ResultOr<NonnullOwnPtr<ResultCursor>> create(ResultSet);
+
+    virtual ResultOr<Optional<Tuple>> next() override;
+
+private:
+    explicit MaterializedResultCursor(ResultSet);
+
+    ResultSet m_result;
+    size_t m_next_row { 0 };
+};
+
+}
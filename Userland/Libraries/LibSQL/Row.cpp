@@ -20,6 +20,12 @@ void Row::deserialize(Serializer& serializer)
 {
     Tuple::deserialize(serializer);
     m_next_block_index = serializer.deserialize<Block::Index>();
+
+    // Only column names are stored, but expressions may qualify columns with their table name.
+    for (auto& element : *descriptor()) {
+        element.schema = m_table->parent()->name();
+        element.table = m_table->name();
+    }
 }
 
 void Row::serialize(Serializer& serializer) const
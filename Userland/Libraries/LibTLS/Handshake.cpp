@@ -34,6 +34,8 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    offer_cached_session();
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -49,7 +51,9 @@ ByteBuffer TLSv12::build_hello()
         extension_length += alpn_length + 6;
     } else if (m_context.alpn.size()) {
         for (auto& alpn : m_context.alpn) {
+            // RFC 7301 section 3.1: opaque ProtocolName<1..2^8-1>;
             size_t length = alpn.length();
+            VERIFY(length > 0 && length <= 255);
             alpn_length += length + 1;
         }
         if (alpn_length)
@@ -75,6 +79,8 @@ ByteBuffer TLSv12::build_hello()
     auto supported_ec_point_formats_length = m_context.options.supported_ec_point_formats.size();
     bool supports_elliptic_curves = elliptic_curves_length && supported_ec_point_formats_length;
     bool enable_extended_master_secret = m_context.options.enable_extended_master_secret;
+    bool enable_session_ticket = !m_context.options.session_cache.is_null();
+    auto session_ticket_length = m_context.resumption.offered.has_value() ? m_context.resumption.offered->ticket.size() : 0;
 
     // signature_algorithms: 2b extension ID, 2b extension length, 2b vector length, 2xN signatures and hashes
     extension_length += 2 + 2 + 2 + 2 * m_context.options.supported_signature_algorithms.size();
@@ -89,6 +95,9 @@ ByteBuffer TLSv12::build_hello()
     if (enable_extended_master_secret)
         extension_length += 4;
 
+    if (enable_session_ticket)
+        extension_length += 4 + session_ticket_length;
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -139,9 +148,29 @@ ByteBuffer TLSv12::build_hello()
         builder.append((u16)0);
     }
 
+    if (enable_session_ticket) {
+        // session_ticket extension, RFC 5077 section 3.2: empty unless we have a ticket to offer
+        builder.append((u16)ExtensionType::SESSION_TICKET);
+        builder.append((u16)session_ticket_length);
+        if (session_ticket_length)
+            builder.append(m_context.resumption.offered->ticket.bytes());
+    }
+
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension
+        builder.append((u16)ExtensionType::APPLICATION_LAYER_PROTOCOL_NEGOTIATION);
+        builder.append((u16)(alpn_length + 2));
+        // ProtocolNameList length
+        builder.append((u16)alpn_length);
+        if (alpn_negotiated_length) {
+            builder.append((u8)alpn_negotiated_length);
+            builder.append(m_context.negotiated_alpn.bytes());
+        } else {
+            for (auto& alpn : m_context.alpn) {
+                builder.append((u8)alpn.length());
+                builder.append(alpn.bytes());
+            }
+        }
     }
 
     // set the "length" field of the packet
@@ -229,6 +258,13 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
     dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
     m_context.connection_status = ConnectionStatus::Established;
 
+    // RFC 5246 section 7.3: In an abbreviated handshake the server sends its Finished first,
+    //                       so we still have to send our ChangeCipherSpec and Finished.
+    if (m_context.resumption.resumed)
+        write_packets = WritePacketStage::Finished;
+
+    update_session_cache();
+
     if (m_handshake_timeout_timer) {
         // Disable the handshake timeout timer as handshake has been established.
         m_handshake_timeout_timer->stop();
@@ -308,6 +344,24 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case HandshakeType::NEW_SESSION_TICKET:
+            if (m_context.handshake_messages[3] >= 1 || !m_context.extensions.session_ticket) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[3];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.is_server) {
+                dbgln("unsupported: server mode");
+                VERIFY_NOT_REACHED();
+            }
+            if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+                payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            } else {
+                payload_res = (i8)Error::UnexpectedMessage;
+            }
+            break;
         case HandshakeType::CERTIFICATE:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
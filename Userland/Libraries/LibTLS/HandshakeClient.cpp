@@ -164,6 +164,116 @@ bool TLSv12::compute_master_secret_from_pre_master_secret(size_t length)
     return true;
 }
 
+void TLSv12::offer_cached_session()
+{
+    m_context.resumption.offered = {};
+    m_context.resumption.resumed = false;
+
+    auto& cache = m_context.options.session_cache;
+    if (!cache || m_context.extensions.SNI.is_empty())
+        return;
+
+    auto session = cache->find(m_context.extensions.SNI, m_context.resumption.port);
+    if (!session.has_value() || !m_context.options.usable_cipher_suites.contains_slow(session->cipher))
+        return;
+
+    if (!session->session_id.is_empty()) {
+        VERIFY(session->session_id.size() <= sizeof(m_context.session_id));
+        memcpy(m_context.session_id, session->session_id.data(), session->session_id.size());
+        m_context.session_id_size = session->session_id.size();
+    } else {
+        // RFC 5077 section 3.4: "When presenting a ticket, the client MAY generate and include a Session ID in the
+        //                        TLS ClientHello. If the server accepts the ticket and the Session ID is not empty,
+        //                        then it MUST respond with the same Session ID present in the ClientHello."
+        fill_with_random(m_context.session_id);
+        m_context.session_id_size = sizeof(m_context.session_id);
+    }
+
+    dbgln_if(TLS_DEBUG, "Offering cached session for {}:{}", m_context.extensions.SNI, m_context.resumption.port);
+    m_context.resumption.offered = session.release_value();
+}
+
+bool TLSv12::resume_offered_session()
+{
+    auto& session = *m_context.resumption.offered;
+
+    // RFC 5246 section 7.4.1.3: "cipher_suite [...] For resumed sessions, this field is the value from the state of the session being resumed."
+    if (session.cipher != m_context.cipher) {
+        dbgln("Server resumed a session with a different cipher suite ({} != {})", enum_to_string(m_context.cipher), enum_to_string(session.cipher));
+        return false;
+    }
+
+    // RFC 7627 section 5.3: The client MUST abort the handshake if the server's use of the extended master secret
+    //                       does not match the original session.
+    if (session.extended_master_secret != m_context.extensions.extended_master_secret) {
+        dbgln("Server resumed a session with a mismatched extended_master_secret extension");
+        return false;
+    }
+
+    auto master_key = ByteBuffer::copy(session.master_key);
+    if (master_key.is_error()) {
+        dbgln("Couldn't allocate enough space for the master key :(");
+        return false;
+    }
+    m_context.master_key = master_key.release_value();
+
+    if (!expand_key())
+        return false;
+
+    dbgln_if(TLS_DEBUG, "Resuming session, skipping the key exchange");
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+    return true;
+}
+
+void TLSv12::update_session_cache()
+{
+    auto& cache = m_context.options.session_cache;
+    if (!cache || m_context.extensions.SNI.is_empty())
+        return;
+
+    auto& offered = m_context.resumption.offered;
+    bool resumed = m_context.resumption.resumed;
+    auto now = MonotonicTime::now_coarse();
+
+    Session session;
+    session.cipher = m_context.cipher;
+    session.extended_master_secret = m_context.extensions.extended_master_secret;
+    session.expires_at = resumed ? offered->expires_at : now + SessionCache::default_session_lifetime;
+
+    // When resuming with a ticket, the echoed session ID may just be the random one we made up.
+    auto session_id = resumed ? offered->session_id.bytes() : ReadonlyBytes { m_context.session_id, m_context.session_id_size };
+    auto master_key = ByteBuffer::copy(m_context.master_key);
+    auto session_id_copy = ByteBuffer::copy(session_id);
+    if (master_key.is_error() || session_id_copy.is_error())
+        return;
+    session.master_key = master_key.release_value();
+    session.session_id = session_id_copy.release_value();
+
+    if (m_context.resumption.new_ticket.has_value()) {
+        session.ticket = m_context.resumption.new_ticket.release_value();
+        if (m_context.resumption.new_ticket_lifetime_hint)
+            session.expires_at = now + Duration::from_seconds(m_context.resumption.new_ticket_lifetime_hint);
+        m_context.resumption.new_ticket.clear();
+    } else if (resumed) {
+        session.ticket = move(offered->ticket);
+    }
+
+    cache->store(m_context.extensions.SNI, m_context.resumption.port, move(session));
+    offered = {};
+}
+
+void TLSv12::forget_offered_session()
+{
+    // RFC 5246 section 7.2.2: Sessions of connections that failed during the handshake must not be resumed.
+    auto& cache = m_context.options.session_cache;
+    if (!cache || !m_context.resumption.offered.has_value())
+        return;
+
+    dbgln_if(TLS_DEBUG, "Forgetting cached session for {}:{}", m_context.extensions.SNI, m_context.resumption.port);
+    cache->remove(m_context.extensions.SNI, m_context.resumption.port);
+    m_context.resumption.offered = {};
+}
+
 void TLSv12::build_rsa_pre_master_secret(PacketBuilder& builder)
 {
     u8 random_bytes[48];
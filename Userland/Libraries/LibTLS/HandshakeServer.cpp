@@ -61,6 +61,13 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // RFC 5246 section 7.4.1.3: If the session_id matches the one we offered, the server agreed to resume that session.
+    // RFC 5077 section 3.4: This is also how a server signals that it accepted our session ticket.
+    m_context.resumption.resumed = m_context.resumption.offered.has_value()
+        && session_length != 0
+        && session_length == m_context.session_id_size
+        && memcmp(m_context.session_id, buffer.offset_pointer(res), session_length) == 0;
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -149,28 +156,25 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                 res += sni_name_length;
                 dbgln("SNI host_name: {}", m_context.extensions.SNI);
             }
-        } else if (extension_type == ExtensionType::APPLICATION_LAYER_PROTOCOL_NEGOTIATION && m_context.alpn.size()) {
-            if (buffer.size() - res > 2) {
-                auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
-                if (alpn_length && alpn_length <= extension_length - 2) {
-                    u8 const* alpn = buffer.offset_pointer(res + 2);
-                    size_t alpn_position = 0;
-                    while (alpn_position < alpn_length) {
-                        u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
-                            break;
-                        ByteString alpn_str { (char const*)alpn + alpn_position, alpn_length };
-                        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
-                            m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
-                            break;
-                        }
-                        alpn_position += alpn_length;
-                        if (!m_context.is_server) // server hello must contain one ALPN
-                            break;
-                    }
-                }
-            }
+        } else if (extension_type == ExtensionType::APPLICATION_LAYER_PROTOCOL_NEGOTIATION) {
+            // RFC 7301 section 3.1: The "extension_data" field of the ServerHello extension [...] MUST contain
+            //                       exactly one "ProtocolName", which must be one of the protocols we offered.
+            if (m_context.alpn.is_empty())
+                return (i8)Error::UnexpectedMessage;
+            if (extension_length < 3)
+                return (i8)Error::BrokenPacket;
+
+            auto protocol_name_list_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+            u8 protocol_name_length = buffer[res + 2];
+            if (protocol_name_list_length != extension_length - 2 || protocol_name_length == 0 || protocol_name_length != protocol_name_list_length - 1)
+                return (i8)Error::BrokenPacket;
+
+            ByteString protocol_name { (char const*)buffer.offset_pointer(res + 3), protocol_name_length };
+            if (!m_context.alpn.contains_slow(protocol_name))
+                return (i8)Error::UnexpectedMessage;
+
+            dbgln_if(TLS_DEBUG, "Negotiated ALPN protocol: {}", protocol_name);
+            m_context.negotiated_alpn = move(protocol_name);
             res += extension_length;
         } else if (extension_type == ExtensionType::SIGNATURE_ALGORITHMS) {
             dbgln("supported signatures: ");
@@ -190,12 +194,21 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         } else if (extension_type == ExtensionType::EXTENDED_MASTER_SECRET) {
             m_context.extensions.extended_master_secret = true;
             res += extension_length;
+        } else if (extension_type == ExtensionType::SESSION_TICKET) {
+            // RFC 5077 section 3.2: The server will send a NewSessionTicket message before its ChangeCipherSpec.
+            if (!m_context.options.session_cache)
+                return (i8)Error::UnexpectedMessage;
+            m_context.extensions.session_ticket = true;
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", enum_to_string(extension_type), extension_length);
             res += extension_length;
         }
     }
 
+    if (m_context.resumption.resumed && !resume_offered_session())
+        return (i8)Error::NotSafe;
+
     return res;
 }
 
@@ -212,6 +225,41 @@ ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
     return size + 3;
 }
 
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 5077 section 3.3:
+    // struct {
+    //     uint32 ticket_lifetime_hint;
+    //     opaque ticket<0..2^16-1>;
+    // } NewSessionTicket;
+    if (size < 6)
+        return (i8)Error::BrokenPacket;
+
+    u32 lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (ticket_length != size - 6)
+        return (i8)Error::BrokenPacket;
+
+    // An empty ticket means that the server changed its mind about issuing one.
+    auto ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket.is_error())
+        return (i8)Error::OutOfMemory;
+
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+    m_context.resumption.new_ticket = ticket.release_value();
+    m_context.resumption.new_ticket_lifetime_hint = lifetime_hint;
+
+    return size + 3;
+}
+
 ByteBuffer TLSv12::build_server_key_exchange()
 {
     dbgln("FIXME: build_server_key_exchange");
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+NonnullRefPtr<SessionCache> SessionCache::create(size_t capacity)
+{
+    return adopt_ref(*new SessionCache(capacity));
+}
+
+Optional<Session> SessionCache::find(ByteString const& host, u16 port)
+{
+    return m_sessions.with_locked([&](auto& sessions) -> Optional<Session> {
+        auto it = sessions.find(Key { host, port });
+        if (it == sessions.end())
+            return {};
+
+        if (it->value.expires_at <= MonotonicTime::now_coarse()) {
+            dbgln_if(TLS_DEBUG, "Cached session for {}:{} has expired", host, port);
+            sessions.remove(it);
+            return {};
+        }
+
+        auto session_id = ByteBuffer::copy(it->value.session_id);
+        auto ticket = ByteBuffer::copy(it->value.ticket);
+        auto master_key = ByteBuffer::copy(it->value.master_key);
+        if (session_id.is_error() || ticket.is_error() || master_key.is_error())
+            return {};
+
+        return Session {
+            .session_id = session_id.release_value(),
+            .ticket = ticket.release_value(),
+            .master_key = master_key.release_value(),
+            .cipher = it->value.cipher,
+            .extended_master_secret = it->value.extended_master_secret,
+            .expires_at = it->value.expires_at,
+        };
+    });
+}
+
+void SessionCache::store(ByteString const& host, u16 port, Session session)
+{
+    if (!session.can_be_resumed()) {
+        remove(host, port);
+        return;
+    }
+
+    auto now = MonotonicTime::now_coarse();
+    if (session.expires_at > now + maximum_session_lifetime)
+        session.expires_at = now + maximum_session_lifetime;
+
+    m_sessions.with_locked([&](auto& sessions) {
+        Key key { host, port };
+        if (!sessions.contains(key) && sessions.size() >= m_capacity) {
+            // Make room by dropping whatever is closest to expiring anyway.
+            auto oldest = sessions.begin();
+            for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+                if (it->value.expires_at < oldest->value.expires_at)
+                    oldest = it;
+            }
+            if (oldest != sessions.end())
+                sessions.remove(oldest);
+        }
+
+        dbgln_if(TLS_DEBUG, "Caching session for {}:{} (id: {} bytes, ticket: {} bytes)", host, port, session.session_id.size(), session.ticket.size());
+        sessions.set(move(key), move(session));
+    });
+}
+
+void SessionCache::remove(ByteString const& host, u16 port)
+{
+    m_sessions.with_locked([&](auto& sessions) {
+        sessions.remove(Key { host, port });
+    });
+}
+
+size_t SessionCache::size()
+{
+    return m_sessions.with_locked([](auto& sessions) { return sessions.size(); });
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Time.h>
+#include <LibTLS/CipherSuite.h>
+#include <LibThreading/MutexProtected.h>
+
+namespace TLS {
+
+// Everything a client needs to resume a TLS 1.2 session with an abbreviated handshake,
+// either through the server's session cache (RFC 5246 section 7.3) or through a
+// session ticket (RFC 5077).
+struct Session {
+    ByteBuffer session_id;
+    ByteBuffer ticket;
+    ByteBuffer master_key;
+    CipherSuite cipher { CipherSuite::TLS_NULL_WITH_NULL_NULL };
+    bool extended_master_secret { false };
+    MonotonicTime expires_at { MonotonicTime::now_coarse() };
+
+    bool can_be_resumed() const { return !master_key.is_empty() && (!session_id.is_empty() || !ticket.is_empty()); }
+};
+
+// A client-side cache of resumable sessions, keyed by the host and port they were negotiated with.
+// A single cache may be shared between any number of connections, on any number of threads.
+class SessionCache : public AtomicRefCounted<SessionCache> {
+public:
+    // RFC 5246 section F.1.4: "Applications that may be run in relatively insecure environments
+    //                          should not write session IDs to stable storage."
+    //                          [...] "an upper limit of 24 hours is suggested for session ID lifetimes"
+    static constexpr Duration maximum_session_lifetime = Duration::from_seconds(24 * 60 * 60);
+    // Used for sessions without a ticket lifetime hint; servers usually forget cached session IDs much sooner than 24 hours.
+    static constexpr Duration default_session_lifetime = Duration::from_seconds(5 * 60);
+    static constexpr size_t default_capacity = 256;
+
+    static NonnullRefPtr<SessionCache> create(size_t capacity = default_capacity);
+
+    Optional<Session> find(ByteString const& host, u16 port);
+    void store(ByteString const& host, u16 port, Session);
+    void remove(ByteString const& host, u16 port);
+
+    size_t size();
+
+private:
+    explicit SessionCache(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    struct Key {
+        ByteString host;
+        u16 port { 0 };
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(key.host.hash(), key.port); }
+    };
+
+    size_t m_capacity { 0 };
+    Threading::MutexProtected<HashMap<Key, Session, KeyTraits>> m_sessions;
+};
+
+}
@@ -82,6 +82,7 @@ Coroutine<ErrorOr<NonnullOwnPtr<TLSv12>>> TLSv12::async_connect(ByteString const
     CO_TRY(tcp_socket->set_blocking(false));
     auto tls_socket = make<TLSv12>(move(tcp_socket), move(options));
     tls_socket->set_sni(host);
+    tls_socket->m_context.resumption.port = port;
     tls_socket->on_connected = [promise] { promise->resolve(); };
     tls_socket->on_tls_error = [&tls_socket = *tls_socket, promise](auto alert) {
         tls_socket.try_disambiguate_error();
@@ -280,6 +281,9 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        if (m_context.connection_status != ConnectionStatus::Established)
+            forget_offered_session();
+
         m_context.has_invoked_finish_or_error_callback = true;
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
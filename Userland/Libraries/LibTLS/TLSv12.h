@@ -20,6 +20,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -194,6 +195,8 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
     OPTION_WITH_DEFAULTS(bool, enable_extended_master_secret, true)
+    OPTION_WITH_DEFAULTS(RefPtr<SessionCache>, session_cache, )
+    OPTION_WITH_DEFAULTS(Vector<ByteString>, alpn_protocols, )
 
 #undef OPTION_WITH_DEFAULTS
 };
@@ -285,8 +288,19 @@ struct Context {
         // Server Name Indicator
         ByteString SNI; // I hate your existence
         bool extended_master_secret { false };
+        bool session_ticket { false };
     } extensions;
 
+    struct {
+        // Only used to look up and store sessions in options.session_cache, zero if unknown.
+        u16 port { 0 };
+        // The cached session we offered in our ClientHello, if any.
+        Optional<Session> offered;
+        bool resumed { false };
+        Optional<ByteBuffer> new_ticket;
+        u32 new_ticket_lifetime_hint { 0 };
+    } resumption;
+
     u8 request_client_certificate { 0 };
 
     ByteBuffer cached_handshake;
@@ -303,7 +317,7 @@ struct Context {
     HashMap<ByteString, Certificate> root_certificates;
 
     Vector<ByteString> alpn;
-    StringView negotiated_alpn;
+    ByteString negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -449,6 +463,7 @@ private:
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_ecdhe_ecdsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
@@ -528,6 +543,11 @@ private:
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
+    void offer_cached_session();
+    bool resume_offered_session();
+    void update_session_cache();
+    void forget_offered_session();
+
     void try_disambiguate_error() const;
 
     bool m_eof { false };
@@ -25,6 +25,8 @@ struct ThreadPoolLooper {
             entry = pool.m_work_queue.with_locked([&](auto& queue) -> Optional<typename Pool::Work> {
                 if (queue.is_empty())
                     return {};
+                // Count the work as busy before it leaves the queue, so wait_for_all() can't miss it in between.
+                pool.m_busy_count++;
                 return queue.dequeue();
             });
             if (entry.has_value())
@@ -35,13 +37,19 @@ struct ThreadPoolLooper {
             if (!wait)
                 return IterationDecision::Continue;
 
+            // Work is submitted and exit is requested with m_mutex held, so checking again under it means we can't
+            // miss the broadcast that would have woken us up.
             pool.m_mutex.lock();
-            pool.m_work_available.wait();
+            if (!pool.m_should_exit && pool.m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
+                pool.m_work_available.wait();
             pool.m_mutex.unlock();
         }
 
-        pool.m_busy_count++;
         pool.m_handler(entry.release_value());
+
+        MutexLocker locker(pool.m_mutex);
+        pool.m_busy_count--;
+        pool.m_work_done.broadcast();
         return IterationDecision::Continue;
     }
 };
@@ -77,14 +85,13 @@ public:
     ~ThreadPool()
     {
         request_exit();
-        for (auto& worker : m_workers) {
-            m_work_available.broadcast();
+        for (auto& worker : m_workers)
             (void)worker->join();
-        }
     }
 
     void request_exit()
     {
+        MutexLocker locker(m_mutex);
         m_should_exit.store(true, AK::MemoryOrder::memory_order_release);
         m_work_available.broadcast();
     }
@@ -96,6 +103,7 @@ public:
 
     void submit(Work work)
     {
+        MutexLocker locker(m_mutex);
         m_work_queue.with_locked([&](auto& queue) {
             queue.enqueue({ move(work) });
         });
@@ -104,18 +112,12 @@ public:
 
     void wait_for_all()
     {
+        MutexLocker locker(m_mutex);
         while (true) {
-            if (m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
+            auto is_queue_empty = m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); });
+            if (is_queue_empty && m_busy_count.load(AK::MemoryOrder::memory_order_acquire) == 0)
                 break;
-            m_mutex.lock();
-            m_work_done.wait();
-            m_mutex.unlock();
-        }
-
-        while (m_busy_count.load(AK::MemoryOrder::memory_order_acquire) > 0) {
-            m_mutex.lock();
             m_work_done.wait();
-            m_mutex.unlock();
         }
     }
 
@@ -128,8 +130,6 @@ private:
                 Looper<ThreadPool> thread_looper { move(looper_args)... };
                 for (; !m_should_exit;) {
                     auto result = thread_looper.next(*this, true);
-                    m_busy_count--;
-                    m_work_done.signal();
                     if (result == IterationDecision::Break)
                         break;
                 }
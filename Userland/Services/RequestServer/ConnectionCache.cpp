@@ -14,6 +14,58 @@ namespace RequestServer::ConnectionCache {
 Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<Core::TCPSocket, Core::Socket>>>>>> g_tcp_connection_cache {};
 Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<TLS::TLSv12>>>>>> g_tls_connection_cache {};
 Threading::RWLockProtected<HashMap<ByteString, InferredServerProperties>> g_inferred_server_properties;
+NonnullRefPtr<TLS::SessionCache> g_tls_session_cache = TLS::SessionCache::create();
+thread_local HashMap<ConnectionKey, NonnullOwnPtr<Http2ConnectionEntry>> g_http2_connection_cache {};
+
+RefPtr<HTTP::Http2Connection> find_usable_http2_connection(ConnectionKey const& key)
+{
+    auto it = g_http2_connection_cache.find(key);
+    if (it == g_http2_connection_cache.end() || !it->value->connection->is_usable())
+        return nullptr;
+    return it->value->connection;
+}
+
+static void remove_http2_connection(ConnectionKey const& key, HTTP::Http2Connection const* connection)
+{
+    if (auto it = g_http2_connection_cache.find(key); it != g_http2_connection_cache.end() && it->value->connection.ptr() == connection)
+        g_http2_connection_cache.remove(it);
+}
+
+ErrorOr<NonnullRefPtr<HTTP::Http2Connection>> create_http2_connection(ConnectionKey const& key, NonnullOwnPtr<Core::Socket> socket)
+{
+    if (auto connection = find_usable_http2_connection(key)) {
+        dbgln_if(REQUESTSERVER_DEBUG, "Dropping new HTTP/2 connection to {}:{} in favour of {}", key.hostname, key.port, connection.ptr());
+        return connection.release_nonnull();
+    }
+
+    socket->set_notifications_enabled(true);
+    auto connection = TRY(HTTP::Http2Connection::try_create(move(socket)));
+    auto removal_timer = Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr);
+
+    removal_timer->on_timeout = [key, ptr = connection.ptr()] {
+        Core::deferred_invoke([key, ptr] {
+            auto it = g_http2_connection_cache.find(key);
+            if (it == g_http2_connection_cache.end() || it->value->connection.ptr() != ptr || !ptr->is_idle())
+                return;
+            NonnullRefPtr connection = it->value->connection;
+            g_http2_connection_cache.remove(it);
+            dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used HTTP/2 connection {}", connection.ptr());
+            connection->close();
+        });
+    };
+    connection->on_idle = [removal_timer] {
+        removal_timer->restart();
+    };
+    connection->on_close = [key, ptr = connection.ptr()] {
+        Core::deferred_invoke([key, ptr] {
+            remove_http2_connection(key, ptr);
+        });
+    };
+
+    g_http2_connection_cache.set(key, make<Http2ConnectionEntry>(connection, move(removal_timer)));
+    return connection;
+}
+
 
 void request_did_finish(URL::URL const& url, Core::Socket const* socket)
 {
@@ -143,6 +195,9 @@ void dump_jobs()
             }
         }
     });
+    dbgln("=========== HTTP/2 Connection Cache (current thread) ==========");
+    for (auto& entry : g_http2_connection_cache)
+        dbgln(" - {}:{} (connection={}) (usable={}) (idle={})", entry.key.hostname, entry.key.port, entry.value->connection.ptr(), entry.value->connection->is_usable(), entry.value->connection->is_idle());
     dbgln("=========== TCP Connection Cache ==========");
     g_tcp_connection_cache.with_read_locked([](auto& cache) {
         for (auto& connection : cache) {
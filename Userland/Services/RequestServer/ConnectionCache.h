@@ -16,6 +16,7 @@
 #include <LibCore/NetworkJob.h>
 #include <LibCore/SOCKSProxyClient.h>
 #include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibTLS/TLSv12.h>
 #include <LibThreading/RWLockProtected.h>
 #include <LibURL/URL.h>
@@ -61,6 +62,7 @@ struct Proxy {
 
 struct JobData {
     Function<void(Core::BufferedSocketBase&)> start {};
+    Function<void(HTTP::Http2Connection&)> start_http2 {};
     Function<void(Core::NetworkJob::Error)> fail {};
     Function<Vector<TLS::Certificate>()> provide_client_certificates {};
 #if REQUESTSERVER_DEBUG
@@ -85,6 +87,7 @@ struct JobData {
 
     JobData(JobData&& other)
         : start(move(other.start))
+        , start_http2(move(other.start_http2))
         , fail(move(other.fail))
         , provide_client_certificates(move(other.provide_client_certificates))
         , timing_info(move(other.timing_info))
@@ -94,10 +97,12 @@ struct JobData {
 
     JobData(
         Function<void(Core::BufferedSocketBase&)> start,
+        Function<void(HTTP::Http2Connection&)> start_http2,
         Function<void(Core::NetworkJob::Error)> fail,
         Function<Vector<TLS::Certificate>()> provide_client_certificates,
         decltype(timing_info) timing_info)
         : start(move(start))
+        , start_http2(move(start_http2))
         , fail(move(fail))
         , provide_client_certificates(move(provide_client_certificates))
         , timing_info(move(timing_info))
@@ -110,6 +115,11 @@ struct JobData {
     {
         return JobData {
             /* .start = */ [job](auto& socket) { job->start(socket); },
+            /* .start_http2 = */ [&] -> Function<void(HTTP::Http2Connection&)> {
+                if constexpr (requires { job->start(declval<HTTP::Http2Connection&>()); })
+                    return [job](auto& connection) { job->start(connection); };
+                return {};
+            }(),
             /* .fail = */ [job](auto error) { job->fail(error); },
             /* .provide_client_certificates = */ [job] {
                 if constexpr (requires { job->on_certificate_requested; }) {
@@ -169,13 +179,30 @@ namespace RequestServer::ConnectionCache {
 
 struct InferredServerProperties {
     size_t requests_served_per_connection { NumericLimits<size_t>::max() };
+    bool speaks_http2 { false };
+};
+
+struct Http2ConnectionEntry {
+    NonnullRefPtr<HTTP::Http2Connection> connection;
+    NonnullRefPtr<Core::Timer> removal_timer;
 };
 
 extern Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<Core::TCPSocket, Core::Socket>>>>>> g_tcp_connection_cache;
 extern Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<TLS::TLSv12>>>>>> g_tls_connection_cache;
 extern Threading::RWLockProtected<HashMap<ByteString, InferredServerProperties>> g_inferred_server_properties;
 
+// HTTP/2 connections multiplex all requests to a server, so there's only ever one per key, and no request queue.
+// A connection is driven by the event loop of the thread that created it, and nothing about it (the socket, the
+// HPACK state, its reference count) may be touched from anywhere else, so every worker thread has its own cache.
+extern thread_local HashMap<ConnectionKey, NonnullOwnPtr<Http2ConnectionEntry>> g_http2_connection_cache;
+
+// Shared by every TLS connection we make, so that new connections to a server we've talked to before can skip the full handshake.
+extern NonnullRefPtr<TLS::SessionCache> g_tls_session_cache;
+
 void request_did_finish(URL::URL const&, Core::Socket const*);
+RefPtr<HTTP::Http2Connection> find_usable_http2_connection(ConnectionKey const&);
+// Returns the connection to use, which is an already cached one if another request got there first.
+ErrorOr<NonnullRefPtr<HTTP::Http2Connection>> create_http2_connection(ConnectionKey const&, NonnullOwnPtr<Core::Socket>);
 void dump_jobs();
 
 constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
@@ -215,6 +242,7 @@ Coroutine<ErrorOr<void>> recreate_socket_if_needed(T& connection, URL::URL const
                     return connection.job_data->provide_client_certificates();
                 return {};
             });
+            options.set_session_cache(g_tls_session_cache);
             CO_TRY(set_socket(CO_TRY(co_await (connection.proxy.template tunnel<SocketType, SocketStorageType>(url, move(options))))));
         } else {
             CO_TRY(set_socket(CO_TRY(co_await (connection.proxy.template tunnel<SocketType, SocketStorageType>(url)))));
@@ -227,12 +255,28 @@ Coroutine<ErrorOr<void>> recreate_socket_if_needed(T& connection, URL::URL const
 Coroutine<void> async_get_or_create_connection(auto& cache, URL::URL url, auto job, Core::ProxyData proxy_data = {})
 {
     using CacheEntryType = RemoveCVReference<decltype(*declval<typename RemoveCVReference<decltype(cache)>::ProtectedType>().begin()->value)>;
+    using ConnectionType = RemoveCVReference<decltype(*declval<CacheEntryType>().at(0))>;
+
+    // HTTP/2 is only negotiated for direct connections, as the SOCKS proxy client is owned by the HTTP/1.1 connection.
+    constexpr bool can_use_http2 = IsSame<TLS::TLSv12, typename ConnectionType::SocketType> && requires { job->start(declval<HTTP::Http2Connection&>()); };
+    bool should_offer_http2 = can_use_http2 && proxy_data.type == Core::ProxyData::Direct;
 
     auto hostname = url.serialized_host().release_value_but_fixme_should_propagate_errors().to_byte_string();
     auto& properties = g_inferred_server_properties.with_write_locked([&](auto& map) -> InferredServerProperties& { return map.ensure(hostname); });
 
+    ConnectionKey key { hostname, url.port_or_default(), proxy_data };
+    if constexpr (can_use_http2) {
+        if (should_offer_http2) {
+            if (auto connection = find_usable_http2_connection(key)) {
+                dbgln_if(REQUESTSERVER_DEBUG, "Start request for URL {} on HTTP/2 connection {}", url, connection.ptr());
+                job->start(*connection);
+                co_return;
+            }
+        }
+    }
+
     auto& sockets_for_url = *cache.with_write_locked([&](auto& map) -> CacheEntryType* {
-        return map.ensure({ move(hostname), url.port_or_default(), proxy_data }, [] { return make<CacheEntryType>(); }).ptr();
+        return map.ensure(key, [] { return make<CacheEntryType>(); }).ptr();
     });
 
     // Find the connection with an empty queue; if none exist, we'll find the least backed-up connection later.
@@ -242,7 +286,10 @@ Coroutine<void> async_get_or_create_connection(auto& cache, URL::URL url, auto j
     // without trying it out first, and that's not worth the effort as HTTP/1.0 is a legacy protocol anyway.
     auto it = cache.with_read_locked([&](auto&) {
         return sockets_for_url.find_if([&](auto& connection) {
+            // While the first connection to an HTTP/2 server is being set up, pile requests onto it instead of
+            // making more connections, as they'll all be multiplexed over it anyway.
             return properties.requests_served_per_connection < 2
+                || (should_offer_http2 && properties.speaks_http2)
                 || connection->request_queue.with_read_locked([&](auto const& queue) { return queue.size(); }) < ConnectionCacheQueueHighWatermark;
         });
     });
@@ -253,7 +300,6 @@ Coroutine<void> async_get_or_create_connection(auto& cache, URL::URL url, auto j
 
     auto start_timer = Core::ElapsedTimer::start_new();
     if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
-        using ConnectionType = RemoveCVReference<decltype(*declval<CacheEntryType>().at(0))>;
         cache.with_write_locked([&](auto&) {
             sockets_for_url.append(make<ConnectionType>(
                 nullptr,
@@ -262,12 +308,23 @@ Coroutine<void> async_get_or_create_connection(auto& cache, URL::URL url, auto j
                 true));
             index = sockets_for_url.size() - 1;
         });
-        auto& socket_for_url = sockets_for_url[index];
+        auto* socket_for_url = sockets_for_url[index].ptr();
+        // Keeps the connection alive until the guard below has run, if it's handed off to HTTP/2.
+        OwnPtr<ConnectionType> replaced_connection;
         ScopeGuard created = [&] {
             socket_for_url->is_being_started = false;
         };
 
-        auto connection_result = co_await proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        TLS::Options options;
+        options.set_session_cache(g_tls_session_cache);
+        if (should_offer_http2)
+            options.set_alpn_protocols({ "h2", "http/1.1" });
+        auto connection_result = co_await [&] {
+            if constexpr (IsSame<TLS::TLSv12, typename ConnectionType::SocketType>)
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url, move(options));
+            else
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        }();
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([job] {
@@ -275,6 +332,45 @@ Coroutine<void> async_get_or_create_connection(auto& cache, URL::URL url, auto j
             });
             co_return;
         }
+
+        if constexpr (can_use_http2) {
+            if (should_offer_http2) {
+                properties.speaks_http2 = connection_result.value()->alpn() == "h2"sv;
+                if (properties.speaks_http2) {
+                    auto http2_connection = create_http2_connection(key, connection_result.release_value());
+
+                    // Everything that was queued up while connecting moves over to the HTTP/2 connection.
+                    cache.with_write_locked([&](auto& map) {
+                        auto it = sockets_for_url.find_if([&](auto& connection) { return connection.ptr() == socket_for_url; });
+                        replaced_connection = sockets_for_url.take(it.index());
+                        if (sockets_for_url.is_empty())
+                            map.remove(key);
+                    });
+                    auto queued_jobs = replaced_connection->request_queue.with_write_locked([](auto& queue) { return move(queue); });
+
+                    if (http2_connection.is_error()) {
+                        dbgln("ConnectionCache: Failed to start HTTP/2 connection to {}: {}", url, http2_connection.error());
+                        Core::deferred_invoke([job, queued_jobs = move(queued_jobs)] mutable {
+                            job->fail(Core::NetworkJob::Error::ConnectionFailed);
+                            for (auto& job_data : queued_jobs)
+                                job_data.fail(Core::NetworkJob::Error::ConnectionFailed);
+                        });
+                        co_return;
+                    }
+
+                    dbgln_if(REQUESTSERVER_DEBUG, "Negotiated HTTP/2 for {}, starting {} queued requests", url, queued_jobs.size() + 1);
+                    job->start(*http2_connection.value());
+                    for (auto& job_data : queued_jobs) {
+                        if (job_data.start_http2)
+                            job_data.start_http2(*http2_connection.value());
+                        else
+                            job_data.fail(Core::NetworkJob::Error::ConnectionFailed);
+                    }
+                    co_return;
+                }
+            }
+        }
+
         auto socket_result = Core::BufferedSocket<typename ConnectionType::StorageType>::create(connection_result.release_value());
         if (socket_result.is_error()) {
             dbgln("ConnectionCache: Failed to make a buffered socket for {}: {}", url, socket_result.error());
@@ -30,9 +30,15 @@ void init(TSelf* self, TJob job)
     };
 
     job->on_finish = [self](bool success) {
-        Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
-            ConnectionCache::request_did_finish(url, socket);
-        });
+        // HTTP/2 requests don't have a connection of their own, so there's no request queue to advance.
+        bool is_using_http2 = false;
+        if constexpr (requires { self->job().is_using_http2(); })
+            is_using_http2 = self->job().is_using_http2();
+        if (!is_using_http2) {
+            Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
+                ConnectionCache::request_did_finish(url, socket);
+            });
+        }
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
@@ -102,11 +108,20 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, i32 request_id, Connec
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream), request_id);
     protocol_request->set_request_fd(pipe_result.value().read_fd);
 
-    Core::deferred_invoke([=] {
+    auto ensure_connection = [url, proxy_data](NonnullRefPtr<TJob> job) {
         if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
-            ConnectionCache::ensure_connection(ConnectionCache::g_tls_connection_cache, url, job, proxy_data);
+            ConnectionCache::ensure_connection(ConnectionCache::g_tls_connection_cache, url, move(job), proxy_data);
         else
-            ConnectionCache::ensure_connection(ConnectionCache::g_tcp_connection_cache, url, job, proxy_data);
+            ConnectionCache::ensure_connection(ConnectionCache::g_tcp_connection_cache, url, move(job), proxy_data);
+    };
+
+    // The job owns this callback, so it mustn't hold a strong reference to the job.
+    job->on_request_refused = [job = job.ptr(), ensure_connection] {
+        ensure_connection(*job);
+    };
+
+    Core::deferred_invoke([=] {
+        ensure_connection(job);
     });
 
     return protocol_request;
@@ -6,6 +6,7 @@
 
 #include <LibCore/EventReceiver.h>
 #include <LibSQL/AST/Parser.h>
+#include <LibSQL/ResultCursor.h>
 #include <SQLServer/ConnectionFromClient.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
@@ -70,42 +71,85 @@ Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_
     auto execution_id = m_next_execution_id++;
 
     Core::deferred_invoke([this, strong_this = NonnullRefPtr(*this), placeholder_values = move(placeholder_values), execution_id] {
-        auto execution_result = m_statement->execute(connection().database(), placeholder_values);
+        auto cursor_or_error = m_statement->open_cursor(connection().database(), placeholder_values);
+        if (cursor_or_error.is_error()) {
+            report_error(cursor_or_error.release_error(), execution_id);
+            return;
+        }
 
-        if (execution_result.is_error()) {
-            report_error(execution_result.release_error(), execution_id);
+        auto cursor = cursor_or_error.release_value();
+        if (should_send_result_rows(cursor->command())) {
+            // Only the first batch is produced here; the rest is pulled from the cursor as the client asks for it.
+            auto first_batch = next_batch(*cursor);
+            if (first_batch.is_error()) {
+                report_error(first_batch.release_error(), execution_id);
+                return;
+            }
+
+            auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+            if (!client_connection) {
+                warnln("Cannot return statement execution results. Client disconnected");
+                return;
+            }
+
+            if (first_batch.value().is_empty()) {
+                client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), false, 0, 0, 0);
+                return;
+            }
+
+            client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), true, 0, 0, 0);
+
+            m_ongoing_executions.set(execution_id, { move(cursor), 0, first_batch.release_value() });
+            ready_for_next_result(execution_id);
             return;
         }
 
+        // Statements that don't return rows have already been executed in full when the cursor was opened.
+        size_t result_size = 0;
+        while (true) {
+            auto row = cursor->next();
+            if (row.is_error()) {
+                report_error(row.release_error(), execution_id);
+                return;
+            }
+            if (!row.value().has_value())
+                break;
+            ++result_size;
+        }
+
         auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
         if (!client_connection) {
             warnln("Cannot return statement execution results. Client disconnected");
             return;
         }
 
-        auto result = execution_result.release_value();
-        auto result_size = result.size();
-
-        if (should_send_result_rows(result)) {
-            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), true, 0, 0, 0);
-
-            m_ongoing_executions.set(execution_id, { move(result), result_size });
-            ready_for_next_result(execution_id);
-        } else {
-            if (result.command() == SQL::SQLCommand::Insert)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
-            else if (result.command() == SQL::SQLCommand::Update)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
-            else if (result.command() == SQL::SQLCommand::Delete)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
-            else
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
-        }
+        if (cursor->command() == SQL::SQLCommand::Insert)
+            client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), false, result_size, 0, 0);
+        else if (cursor->command() == SQL::SQLCommand::Update)
+            client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), false, 0, result_size, 0);
+        else if (cursor->command() == SQL::SQLCommand::Delete)
+            client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), false, 0, 0, result_size);
+        else
+            client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), false, 0, 0, 0);
     });
 
     return execution_id;
 }
 
+SQL::ResultOr<Vector<Vector<SQL::Value>>> SQLStatement::next_batch(SQL::ResultCursor& cursor)
+{
+    Vector<Vector<SQL::Value>> rows;
+
+    while (rows.size() < max_rows_per_batch) {
+        auto row = TRY(cursor.next());
+        if (!row.has_value())
+            break;
+        TRY(rows.try_append(row->take_data()));
+    }
+
+    return rows;
+}
+
 void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
 {
     auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
@@ -119,22 +163,30 @@ void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
         return;
     }
 
-    if (execution->result.is_empty()) {
+    if (execution->pending_rows.is_empty()) {
+        auto batch = next_batch(*execution->cursor);
+        if (batch.is_error()) {
+            m_ongoing_executions.remove(execution_id);
+            report_error(batch.release_error(), execution_id);
+            return;
+        }
+        execution->pending_rows = batch.release_value();
+    }
+
+    if (execution->pending_rows.is_empty()) {
         client_connection->async_results_exhausted(statement_id(), execution_id, execution->result_size);
         m_ongoing_executions.remove(execution_id);
         return;
     }
 
-    auto result_row = execution->result.take_first();
-    client_connection->async_next_result(statement_id(), execution_id, result_row.row.take_data());
+    execution->result_size += execution->pending_rows.size();
+    client_connection->async_next_results(statement_id(), execution_id, move(execution->pending_rows));
+    execution->pending_rows.clear();
 }
 
-bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
+bool SQLStatement::should_send_result_rows(SQL::SQLCommand command) const
 {
-    if (result.is_empty())
-        return false;
-
-    switch (result.command()) {
+    switch (command) {
     case SQL::SQLCommand::Describe:
     case SQL::SQLCommand::Select:
         return true;
@@ -6,12 +6,13 @@
 
 #pragma once
 
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Vector.h>
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Result.h>
-#include <LibSQL/ResultSet.h>
+#include <LibSQL/ResultCursor.h>
 #include <LibSQL/Type.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/Forward.h>
@@ -31,15 +32,20 @@ public:
 private:
     SQLStatement(DatabaseConnection&, NonnullRefPtr<SQL::AST::Statement> statement);
 
-    bool should_send_result_rows(SQL::ResultSet const& result) const;
+    bool should_send_result_rows(SQL::SQLCommand) const;
+    static SQL::ResultOr<Vector<Vector<SQL::Value>>> next_batch(SQL::ResultCursor&);
     void report_error(SQL::Result, SQL::ExecutionID execution_id);
 
     DatabaseConnection& m_connection;
     SQL::StatementID m_statement_id { 0 };
 
+    // Rows are sent to the client in batches of up to this many rows.
+    static constexpr size_t max_rows_per_batch = 64;
+
     struct Execution {
-        SQL::ResultSet result;
+        NonnullOwnPtr<SQL::ResultCursor> cursor;
         size_t result_size { 0 };
+        Vector<Vector<SQL::Value>> pending_rows;
     };
     HashMap<SQL::ExecutionID, Execution> m_ongoing_executions;
     SQL::ExecutionID m_next_execution_id { 0 };
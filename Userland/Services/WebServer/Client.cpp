@@ -176,7 +176,7 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
     return true;
 }
 
-ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::send_response_header(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
     TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
@@ -194,6 +194,23 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     auto builder_contents = TRY(builder.to_byte_buffer());
     TRY(m_socket->write_until_depleted(builder_contents));
     log_response(200, request);
+    return {};
+}
+
+void Client::finish_response(HTTP::HttpRequest const& request)
+{
+    auto keep_alive = false;
+    if (auto it = request.headers().headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
+        if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
+            keep_alive = true;
+    }
+    if (!keep_alive)
+        m_socket->close();
+}
+
+ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_header(request, content_info));
 
     char buffer[PAGE_SIZE];
     do {
@@ -213,14 +230,27 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
         }
     } while (true);
 
-    auto keep_alive = false;
-    if (auto it = request.headers().headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
-            keep_alive = true;
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response(Core::File& file, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    auto socket_fd = m_socket->fd();
+    if (!socket_fd.has_value())
+        return Error::from_errno(ENOTCONN);
+
+    TRY(send_response_header(request, content_info));
+
+    // Let the kernel move the file contents into the socket, instead of copying them through our own buffer.
+    off_t offset = 0;
+    while (static_cast<u64>(offset) < content_info.length) {
+        auto nsent = TRY(Core::System::sendfile(socket_fd.value(), file.fd(), &offset, content_info.length - offset));
+        if (nsent == 0)
+            break;
     }
-    if (!keep_alive)
-        m_socket->close();
 
+    finish_response(request);
     return {};
 }
 
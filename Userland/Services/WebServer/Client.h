@@ -9,6 +9,7 @@
 
 #include <AK/String.h>
 #include <LibCore/EventReceiver.h>
+#include <LibCore/File.h>
 #include <LibCore/Socket.h>
 #include <LibHTTP/Forward.h>
 #include <LibHTTP/HttpRequest.h>
@@ -34,6 +35,9 @@ private:
     ErrorOr<void, WrappedError> on_ready_to_read();
     ErrorOr<bool> handle_request(HTTP::HttpRequest const&);
     ErrorOr<void> send_response(Stream&, HTTP::HttpRequest const&, ContentInfo);
+    ErrorOr<void> send_response(Core::File&, HTTP::HttpRequest const&, ContentInfo);
+    ErrorOr<void> send_response_header(HTTP::HttpRequest const&, ContentInfo const&);
+    void finish_response(HTTP::HttpRequest const&);
     ErrorOr<void> send_redirect(StringView redirect, HTTP::HttpRequest const&);
     ErrorOr<void> send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void die();
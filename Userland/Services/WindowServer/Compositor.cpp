@@ -18,6 +18,7 @@
 #include <AK/Memory.h>
 #include <AK/ScopeGuard.h>
 #include <AK/TemporaryChange.h>
+#include <LibCore/System.h>
 #include <LibCore/Timer.h>
 #include <LibGfx/AntiAliasingPainter.h>
 #include <LibGfx/Font/Font.h>
@@ -27,6 +28,11 @@
 
 namespace WindowServer {
 
+// The dirty region of each screen is split along a grid of tiles of this size
+// (in logical pixels), and the tiles are painted in parallel.
+static constexpr int compose_tile_size = 256;
+static constexpr size_t max_tile_painter_count = 7;
+
 Compositor& Compositor::the()
 {
     static Compositor s_the;
@@ -69,6 +75,19 @@ Compositor::Compositor()
         this);
     m_compose_timer->start();
 
+    // The main thread paints tiles as well, so only spawn helpers for the remaining cores.
+    if (auto concurrency = Core::System::hardware_concurrency(); concurrency > 1) {
+        m_tile_painter_count = min<size_t>(concurrency - 1, max_tile_painter_count);
+        m_tile_painter_pool = make<Threading::ThreadPool<Empty>>(
+            [this](Empty) {
+                paint_pending_tiles();
+                Threading::MutexLocker locker(m_tile_painter_mutex);
+                if (--m_tile_painter_jobs_in_flight == 0)
+                    m_tile_painter_done.signal();
+            },
+            m_tile_painter_count);
+    }
+
     init_bitmaps();
 }
 
@@ -165,6 +184,238 @@ Gfx::IntPoint Compositor::window_transition_offset(Window& window)
     return window.window_stack().transition_offset();
 }
 
+Compositor::ComposeWindowState Compositor::compose_window_state(Window& window, Gfx::IntPoint transition_offset)
+{
+    ComposeWindowState state;
+    state.window = &window;
+    state.transition_offset = transition_offset;
+    state.window_rect = window.rect().translated(transition_offset);
+    state.frame_rects = window.frame().render_rect().translated(transition_offset).shatter(state.window_rect);
+    state.backing_store = window.backing_store();
+    state.paint_frame = !window.is_fullscreen();
+    state.is_unresponsive = window.client() && window.client()->is_unresponsive();
+
+    // Render the frame caches up front, tile painters only blit from them.
+    if (state.paint_frame) {
+        for (auto* screen : window.screens())
+            (void)window.frame().render_to_cache(*screen);
+    }
+
+    // Decide where we would paint this window's backing store.
+    // This is subtly different from widow.rect(), because window
+    // size may be different from its backing store size. This
+    // happens when the window has been resized and the client
+    // has not yet attached a new backing store. In this case,
+    // we want to try to blit the backing store at the same place
+    // it was previously, and fill the rest of the window with its
+    // background color.
+    auto& backing_rect = state.backing_rect;
+    auto& window_rect = state.window_rect;
+    backing_rect.set_size(window.backing_store_visible_size());
+    switch (WindowManager::the().resize_direction_of_window(window)) {
+    case ResizeDirection::None:
+    case ResizeDirection::Right:
+    case ResizeDirection::Down:
+    case ResizeDirection::DownRight:
+        backing_rect.set_location(window_rect.location());
+        break;
+    case ResizeDirection::Left:
+    case ResizeDirection::Up:
+    case ResizeDirection::UpLeft:
+        backing_rect.set_right_without_resize(window_rect.right());
+        backing_rect.set_bottom_without_resize(window_rect.bottom());
+        break;
+    case ResizeDirection::UpRight:
+        backing_rect.set_left(window.rect().left());
+        backing_rect.set_bottom_without_resize(window_rect.bottom());
+        break;
+    case ResizeDirection::DownLeft:
+        backing_rect.set_right_without_resize(window_rect.right());
+        backing_rect.set_top(window_rect.top());
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+        break;
+    }
+    return state;
+}
+
+void Compositor::paint_wallpaper(Screen& screen, Gfx::Painter& painter, Gfx::IntRect const& rect)
+{
+    auto screen_rect = screen.rect();
+    // FIXME: If the wallpaper is opaque and covers the whole rect, no need to fill with color!
+    painter.fill_rect(rect, m_compose_background_color);
+    if (m_wallpaper) {
+        if (m_wallpaper_mode == WallpaperMode::Center) {
+            Gfx::IntPoint offset { (screen.width() - m_wallpaper->width()) / 2, (screen.height() - m_wallpaper->height()) / 2 };
+            painter.blit_offset(rect.location(), *m_wallpaper, rect.translated(-screen_rect.location()), offset);
+        } else if (m_wallpaper_mode == WallpaperMode::Tile) {
+            painter.draw_tiled_bitmap(rect, *m_wallpaper);
+        } else if (m_wallpaper_mode == WallpaperMode::Stretch || m_wallpaper_mode == WallpaperMode::Fill) {
+            VERIFY(screen.compositor_screen_data().m_wallpaper_bitmap);
+            painter.blit(rect.location(), *screen.compositor_screen_data().m_wallpaper_bitmap, rect.translated(-screen.location()));
+        } else {
+            VERIFY_NOT_REACHED();
+        }
+    }
+}
+
+void Compositor::paint_window_rect(ComposeWindowState const& state, Screen& screen, Gfx::Painter& painter, Gfx::IntRect const& rect)
+{
+    auto& window = *state.window;
+    if (state.paint_frame) {
+        rect.for_each_intersected(state.frame_rects, [&](Gfx::IntRect const& intersected_rect) {
+            Gfx::PainterStateSaver saver(painter);
+            painter.add_clip_rect(intersected_rect);
+            painter.translate(state.transition_offset);
+            dbgln_if(COMPOSE_DEBUG, "    render frame: {}", intersected_rect);
+            window.frame().paint(screen, painter, intersected_rect.translated(-state.transition_offset));
+            return IterationDecision::Continue;
+        });
+    }
+
+    auto update_window_rect = state.window_rect.intersected(rect);
+    if (update_window_rect.is_empty())
+        return;
+
+    auto clear_window_rect = [&](Gfx::IntRect const& clear_rect) {
+        painter.fill_rect(clear_rect, m_compose_window_background_color);
+    };
+
+    if (!state.backing_store) {
+        clear_window_rect(update_window_rect);
+        return;
+    }
+
+    auto& backing_rect = state.backing_rect;
+    Gfx::IntRect dirty_rect_in_backing_coordinates = update_window_rect.intersected(backing_rect)
+                                                         .translated(-backing_rect.location());
+
+    if (!dirty_rect_in_backing_coordinates.is_empty()) {
+        auto dst = backing_rect.location().translated(dirty_rect_in_backing_coordinates.location());
+
+        if (state.is_unresponsive) {
+            painter.blit_filtered(dst, *state.backing_store, dirty_rect_in_backing_coordinates, [](Color src) {
+                return src.to_grayscale().darkened(0.75f);
+            });
+        } else {
+            painter.blit(dst, *state.backing_store, dirty_rect_in_backing_coordinates);
+        }
+    }
+
+    for (auto background_rect : update_window_rect.shatter(backing_rect))
+        clear_window_rect(background_rect);
+}
+
+void Compositor::split_render_rects_into_tiles()
+{
+    m_compose_tiles.clear_with_capacity();
+
+    Vector<Optional<size_t>> tile_for_cell;
+    Screen::for_each([&](Screen& screen) {
+        auto screen_rect = screen.rect();
+        auto columns = ceil_div(screen_rect.width(), compose_tile_size);
+        auto rows = ceil_div(screen_rect.height(), compose_tile_size);
+        tile_for_cell.clear_with_capacity();
+        tile_for_cell.resize(columns * rows);
+
+        // Render rects are bucketed in the order they were recorded, so every tile
+        // still paints back to front.
+        for (size_t i = 0; i < m_compose_render_rects.size(); ++i) {
+            auto& render_rect = m_compose_render_rects[i];
+            if (render_rect.screen != &screen)
+                continue;
+            auto rect = render_rect.rect.intersected(screen_rect).translated(-screen_rect.location());
+            if (rect.is_empty())
+                continue;
+            for (int row = rect.top() / compose_tile_size; row <= (rect.bottom() - 1) / compose_tile_size; ++row) {
+                for (int column = rect.left() / compose_tile_size; column <= (rect.right() - 1) / compose_tile_size; ++column) {
+                    auto& tile_index = tile_for_cell[row * columns + column];
+                    if (!tile_index.has_value()) {
+                        tile_index = m_compose_tiles.size();
+                        Gfx::IntRect cell_rect { column * compose_tile_size, row * compose_tile_size, compose_tile_size, compose_tile_size };
+                        m_compose_tiles.append({ &screen, cell_rect.translated(screen_rect.location()).intersected(screen_rect), {} });
+                    }
+                    m_compose_tiles[tile_index.value()].render_rect_indices.append(i);
+                }
+            }
+        }
+        return IterationDecision::Continue;
+    });
+}
+
+void Compositor::paint_tiles()
+{
+    if (m_compose_tiles.is_empty())
+        return;
+
+    m_next_compose_tile = 0;
+
+    size_t job_count = 0;
+    if (m_tile_painter_pool)
+        job_count = min(m_compose_tiles.size() - 1, m_tile_painter_count);
+
+    if (job_count > 0) {
+        {
+            Threading::MutexLocker locker(m_tile_painter_mutex);
+            m_tile_painter_jobs_in_flight = job_count;
+        }
+        for (size_t i = 0; i < job_count; ++i)
+            m_tile_painter_pool->submit({});
+    }
+
+    paint_pending_tiles();
+
+    if (job_count == 0)
+        return;
+
+    // The tiles are shared state, so don't let the next frame touch them until every job has returned.
+    Threading::MutexLocker locker(m_tile_painter_mutex);
+    while (m_tile_painter_jobs_in_flight > 0)
+        m_tile_painter_done.wait();
+}
+
+void Compositor::paint_pending_tiles()
+{
+    while (true) {
+        auto index = m_next_compose_tile.fetch_add(1);
+        if (index >= m_compose_tiles.size())
+            return;
+        paint_tile(m_compose_tiles[index]);
+    }
+}
+
+void Compositor::paint_tile(ComposeTile const& tile)
+{
+    auto& screen = *tile.screen;
+    auto& screen_data = screen.compositor_screen_data();
+    auto screen_location = screen.rect().location();
+
+    // Tiles never overlap, so each one can paint into the shared bitmaps with painters of its own.
+    Gfx::Painter back_painter(*screen_data.m_back_bitmap);
+    back_painter.translate(-screen_location);
+    back_painter.add_clip_rect(tile.rect);
+
+    Gfx::Painter temp_painter(*screen_data.m_temp_bitmap);
+    temp_painter.translate(-screen_location);
+    temp_painter.add_clip_rect(tile.rect);
+
+    for (auto index : tile.render_rect_indices) {
+        auto& render_rect = m_compose_render_rects[index];
+        auto rect = render_rect.rect.intersected(tile.rect);
+        if (rect.is_empty())
+            continue;
+
+        auto& painter = render_rect.target == ComposeTarget::BackBuffer ? back_painter : temp_painter;
+        Gfx::PainterStateSaver saver(painter);
+        painter.add_clip_rect(rect);
+        if (render_rect.content == ComposeContent::Wallpaper)
+            paint_wallpaper(screen, painter, rect);
+        else
+            paint_window_rect(m_compose_windows[render_rect.window_index], screen, painter, rect);
+    }
+}
+
 void Compositor::compose()
 {
     auto& wm = WindowManager::the();
@@ -237,9 +488,10 @@ void Compositor::compose()
         return IterationDecision::Continue;
     });
 
-    Color background_color = wm.palette().desktop_background();
+    m_compose_background_color = wm.palette().desktop_background();
     if (m_custom_background_color.has_value())
-        background_color = m_custom_background_color.value();
+        m_compose_background_color = m_custom_background_color.value();
+    m_compose_window_background_color = wm.palette().window();
 
     if constexpr (COMPOSE_DEBUG) {
         dbgln("COMPOSE: invalidated: window: {} cursor: {}, any: {}", m_invalidated_window, m_invalidated_cursor, m_invalidated_any);
@@ -309,22 +561,13 @@ void Compositor::compose()
     if (!cursor_screen.compositor_screen_data().m_cursor_back_bitmap || m_invalidated_cursor)
         check_restore_cursor_back(cursor_screen, cursor_rect);
 
-    auto paint_wallpaper = [&](Screen& screen, Gfx::Painter& painter, Gfx::IntRect const& rect, Gfx::IntRect const& screen_rect) {
-        // FIXME: If the wallpaper is opaque and covers the whole rect, no need to fill with color!
-        painter.fill_rect(rect, background_color);
-        if (m_wallpaper) {
-            if (m_wallpaper_mode == WallpaperMode::Center) {
-                Gfx::IntPoint offset { (screen.width() - m_wallpaper->width()) / 2, (screen.height() - m_wallpaper->height()) / 2 };
-                painter.blit_offset(rect.location(), *m_wallpaper, rect.translated(-screen_rect.location()), offset);
-            } else if (m_wallpaper_mode == WallpaperMode::Tile) {
-                painter.draw_tiled_bitmap(rect, *m_wallpaper);
-            } else if (m_wallpaper_mode == WallpaperMode::Stretch || m_wallpaper_mode == WallpaperMode::Fill) {
-                VERIFY(screen.compositor_screen_data().m_wallpaper_bitmap);
-                painter.blit(rect.location(), *screen.compositor_screen_data().m_wallpaper_bitmap, rect.translated(-screen.location()));
-            } else {
-                VERIFY_NOT_REACHED();
-            }
-        }
+    // Record what has to be painted where, back to front. Nothing is painted
+    // yet, that happens in parallel per tile once the whole frame is known.
+    m_compose_windows.clear_with_capacity();
+    m_compose_render_rects.clear_with_capacity();
+
+    auto add_render_rect = [&](Screen& screen, Gfx::IntRect const& rect, ComposeTarget target, ComposeContent content, size_t window_index = 0) {
+        m_compose_render_rects.append({ &screen, rect, target, content, window_index });
     };
 
     {
@@ -337,8 +580,7 @@ void Compositor::compose()
                 if (!screen_render_rect.is_empty()) {
                     dbgln_if(COMPOSE_DEBUG, "  render wallpaper opaque: {} on screen #{}", screen_render_rect, screen.index());
                     prepare_rect(screen, render_rect);
-                    auto& back_painter = *screen.compositor_screen_data().m_back_painter;
-                    paint_wallpaper(screen, back_painter, render_rect, screen_rect);
+                    add_render_rect(screen, render_rect, ComposeTarget::BackBuffer, ComposeContent::Wallpaper);
                 }
                 return IterationDecision::Continue;
             });
@@ -351,8 +593,7 @@ void Compositor::compose()
                 if (!screen_render_rect.is_empty()) {
                     dbgln_if(COMPOSE_DEBUG, "  render wallpaper transparent: {} on screen #{}", screen_render_rect, screen.index());
                     prepare_transparency_rect(screen, render_rect);
-                    auto& temp_painter = *screen.compositor_screen_data().m_temp_painter;
-                    paint_wallpaper(screen, temp_painter, render_rect, screen_rect);
+                    add_render_rect(screen, render_rect, ComposeTarget::TempBuffer, ComposeContent::Wallpaper);
                 }
                 return IterationDecision::Continue;
             });
@@ -366,91 +607,16 @@ void Compositor::compose()
             return IterationDecision::Continue;
         }
         auto transition_offset = window_transition_offset(window);
-        auto frame_rect = window.frame().render_rect().translated(transition_offset);
-        auto window_rect = window.rect().translated(transition_offset);
-        auto frame_rects = frame_rect.shatter(window_rect);
-
-        dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), frame_rect);
-
-        RefPtr<Gfx::Bitmap> backing_store = window.backing_store();
-        auto compose_window_rect = [&](Screen& screen, Gfx::Painter& painter, Gfx::IntRect const& rect) {
-            if (!window.is_fullscreen()) {
-                rect.for_each_intersected(frame_rects, [&](Gfx::IntRect const& intersected_rect) {
-                    Gfx::PainterStateSaver saver(painter);
-                    painter.add_clip_rect(intersected_rect);
-                    painter.translate(transition_offset);
-                    dbgln_if(COMPOSE_DEBUG, "    render frame: {}", intersected_rect);
-                    window.frame().paint(screen, painter, intersected_rect.translated(-transition_offset));
-                    return IterationDecision::Continue;
-                });
-            }
-
-            auto update_window_rect = window_rect.intersected(rect);
-            if (update_window_rect.is_empty())
-                return;
-
-            auto clear_window_rect = [&](Gfx::IntRect const& clear_rect) {
-                painter.fill_rect(clear_rect, wm.palette().window());
-            };
-
-            if (!backing_store) {
-                clear_window_rect(update_window_rect);
-                return;
-            }
-
-            // Decide where we would paint this window's backing store.
-            // This is subtly different from widow.rect(), because window
-            // size may be different from its backing store size. This
-            // happens when the window has been resized and the client
-            // has not yet attached a new backing store. In this case,
-            // we want to try to blit the backing store at the same place
-            // it was previously, and fill the rest of the window with its
-            // background color.
-            Gfx::IntRect backing_rect;
-            backing_rect.set_size(window.backing_store_visible_size());
-            switch (WindowManager::the().resize_direction_of_window(window)) {
-            case ResizeDirection::None:
-            case ResizeDirection::Right:
-            case ResizeDirection::Down:
-            case ResizeDirection::DownRight:
-                backing_rect.set_location(window_rect.location());
-                break;
-            case ResizeDirection::Left:
-            case ResizeDirection::Up:
-            case ResizeDirection::UpLeft:
-                backing_rect.set_right_without_resize(window_rect.right());
-                backing_rect.set_bottom_without_resize(window_rect.bottom());
-                break;
-            case ResizeDirection::UpRight:
-                backing_rect.set_left(window.rect().left());
-                backing_rect.set_bottom_without_resize(window_rect.bottom());
-                break;
-            case ResizeDirection::DownLeft:
-                backing_rect.set_right_without_resize(window_rect.right());
-                backing_rect.set_top(window_rect.top());
-                break;
-            default:
-                VERIFY_NOT_REACHED();
-                break;
-            }
-
-            Gfx::IntRect dirty_rect_in_backing_coordinates = update_window_rect.intersected(backing_rect)
-                                                                 .translated(-backing_rect.location());
 
-            if (!dirty_rect_in_backing_coordinates.is_empty()) {
-                auto dst = backing_rect.location().translated(dirty_rect_in_backing_coordinates.location());
+        dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), window.frame().render_rect().translated(transition_offset));
 
-                if (window.client() && window.client()->is_unresponsive()) {
-                    painter.blit_filtered(dst, *backing_store, dirty_rect_in_backing_coordinates, [](Color src) {
-                        return src.to_grayscale().darkened(0.75f);
-                    });
-                } else {
-                    painter.blit(dst, *backing_store, dirty_rect_in_backing_coordinates);
-                }
+        Optional<size_t> window_index;
+        auto add_window_render_rect = [&](Screen& screen, Gfx::IntRect const& rect, ComposeTarget target) {
+            if (!window_index.has_value()) {
+                window_index = m_compose_windows.size();
+                m_compose_windows.append(compose_window_state(window, transition_offset));
             }
-
-            for (auto background_rect : update_window_rect.shatter(backing_rect))
-                clear_window_rect(background_rect);
+            add_render_rect(screen, rect, target, ComposeContent::Window, window_index.value());
         };
 
         auto& dirty_rects = window.dirty_rects();
@@ -475,10 +641,7 @@ void Compositor::compose()
                     dbgln_if(COMPOSE_DEBUG, "    render opaque: {} on screen #{}", screen_render_rect, screen->index());
 
                     prepare_rect(*screen, screen_render_rect);
-                    auto& back_painter = *screen->compositor_screen_data().m_back_painter;
-                    Gfx::PainterStateSaver saver(back_painter);
-                    back_painter.add_clip_rect(screen_render_rect);
-                    compose_window_rect(*screen, back_painter, screen_render_rect);
+                    add_window_render_rect(*screen, screen_render_rect, ComposeTarget::BackBuffer);
                 }
                 return IterationDecision::Continue;
             });
@@ -496,9 +659,8 @@ void Compositor::compose()
                         continue;
                     dbgln_if(COMPOSE_DEBUG, "    render wallpaper: {} on screen #{}", screen_render_rect, screen->index());
 
-                    auto& temp_painter = *screen->compositor_screen_data().m_temp_painter;
                     prepare_transparency_rect(*screen, screen_render_rect);
-                    paint_wallpaper(*screen, temp_painter, screen_render_rect, screen_rect);
+                    add_render_rect(*screen, screen_render_rect, ComposeTarget::TempBuffer, ComposeContent::Wallpaper);
                 }
                 return IterationDecision::Continue;
             });
@@ -514,10 +676,7 @@ void Compositor::compose()
                     dbgln_if(COMPOSE_DEBUG, "    render transparent: {} on screen #{}", screen_render_rect, screen->index());
 
                     prepare_transparency_rect(*screen, screen_render_rect);
-                    auto& temp_painter = *screen->compositor_screen_data().m_temp_painter;
-                    Gfx::PainterStateSaver saver(temp_painter);
-                    temp_painter.add_clip_rect(screen_render_rect);
-                    compose_window_rect(*screen, temp_painter, screen_render_rect);
+                    add_window_render_rect(*screen, screen_render_rect, ComposeTarget::TempBuffer);
                 }
                 return IterationDecision::Continue;
             });
@@ -525,7 +684,7 @@ void Compositor::compose()
         return IterationDecision::Continue;
     };
 
-    // Paint the window stack.
+    // Record the window stack.
     if (m_invalidated_window) {
         auto* fullscreen_window = wm.active_fullscreen_window();
         // FIXME: Remove the !WindowSwitcher::the().is_visible() check when WindowSwitcher is an overlay
@@ -539,7 +698,14 @@ void Compositor::compose()
                 return IterationDecision::Continue;
             });
         }
+    }
+
+    // Paint everything recorded above, with the dirty area of each screen split into tiles
+    // that are painted in parallel.
+    split_render_rects_into_tiles();
+    paint_tiles();
 
+    if (m_invalidated_window) {
         // Check that there are no overlapping transparent and opaque flush rectangles
         VERIFY(![&]() {
             bool is_overlapping = false;
@@ -6,12 +6,17 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Vector.h>
 #include <LibCore/EventReceiver.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Font/Font.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
 #include <WindowServer/Overlays.h>
 
 namespace WindowServer {
@@ -190,6 +195,43 @@ public:
     }
 
 private:
+    // Everything a tile painter needs to know about a window, captured on the
+    // main thread so that painting never has to touch the window itself.
+    struct ComposeWindowState {
+        Window* window { nullptr };
+        Gfx::IntPoint transition_offset;
+        Gfx::IntRect window_rect;
+        Vector<Gfx::IntRect, 4> frame_rects;
+        Gfx::Bitmap const* backing_store { nullptr };
+        Gfx::IntRect backing_rect;
+        bool paint_frame { false };
+        bool is_unresponsive { false };
+    };
+
+    enum class ComposeTarget {
+        BackBuffer,
+        TempBuffer,
+    };
+
+    enum class ComposeContent {
+        Wallpaper,
+        Window,
+    };
+
+    struct ComposeRenderRect {
+        Screen* screen { nullptr };
+        Gfx::IntRect rect;
+        ComposeTarget target { ComposeTarget::BackBuffer };
+        ComposeContent content { ComposeContent::Wallpaper };
+        size_t window_index { 0 };
+    };
+
+    struct ComposeTile {
+        Screen* screen { nullptr };
+        Gfx::IntRect rect;
+        Vector<size_t> render_rect_indices;
+    };
+
     Compositor();
     void init_bitmaps();
     void invalidate_current_screen_number_rects();
@@ -213,6 +255,13 @@ private:
     void start_window_stack_switch_overlay_timer();
     void finish_window_stack_switch();
     void update_wallpaper_bitmap();
+    ComposeWindowState compose_window_state(Window&, Gfx::IntPoint transition_offset);
+    void paint_wallpaper(Screen&, Gfx::Painter&, Gfx::IntRect const&);
+    void paint_window_rect(ComposeWindowState const&, Screen&, Gfx::Painter&, Gfx::IntRect const&);
+    void split_render_rects_into_tiles();
+    void paint_tiles();
+    void paint_pending_tiles();
+    void paint_tile(ComposeTile const&);
 
     RefPtr<Core::Timer> m_compose_timer;
     RefPtr<Core::Timer> m_immediate_compose_timer;
@@ -251,6 +300,20 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    // Filled in by compose() on the main thread, then only read while tiles are being painted.
+    Color m_compose_background_color;
+    Color m_compose_window_background_color;
+    Vector<ComposeWindowState> m_compose_windows;
+    Vector<ComposeRenderRect> m_compose_render_rects;
+    Vector<ComposeTile> m_compose_tiles;
+    Atomic<size_t> m_next_compose_tile { 0 };
+
+    OwnPtr<Threading::ThreadPool<Empty>> m_tile_painter_pool;
+    size_t m_tile_painter_count { 0 };
+    Threading::Mutex m_tile_painter_mutex;
+    Threading::ConditionVariable m_tile_painter_done { m_tile_painter_mutex };
+    size_t m_tile_painter_jobs_in_flight { 0 };
 };
 
 }